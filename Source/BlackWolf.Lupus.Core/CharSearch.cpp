@@ -0,0 +1,507 @@
+/**
+ * Copyright (C) 2014 David Wolf <d.wolf@live.at>
+ *
+ * This file is part of Lupus.
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include "Internal/CharSearch.h"
+#include "Internal/Simd.h"
+#include <cstring>
+
+namespace Lupus {
+    namespace Text {
+        //! Character sets up to this size are compared lane by lane.
+        static const size_t sVectorSetSize = 8;
+
+        static inline unsigned FirstBit(unsigned mask)
+        {
+#ifdef _MSC_VER
+            unsigned long index;
+            _BitScanForward(&index, mask);
+            return index;
+#else
+            return __builtin_ctz(mask);
+#endif
+        }
+
+        static inline unsigned LastBit(unsigned mask)
+        {
+#ifdef _MSC_VER
+            unsigned long index;
+            _BitScanReverse(&index, mask);
+            return index;
+#else
+            return 31 - __builtin_clz(mask);
+#endif
+        }
+
+        /**
+         * Membership test for character sets that are too large to compare
+         * lane by lane: a bitmap for Latin-1 and a list for everything else.
+         */
+        class CharSet
+        {
+        public:
+
+            CharSet(const Char* chars, size_t count) :
+                mChars(chars), mCount(count)
+            {
+                memset(mBits, 0, sizeof(mBits));
+
+                for (size_t i = 0; i < count; i++) {
+                    if ((uint16_t)chars[i] < 256) {
+                        mBits[(uint16_t)chars[i] >> 5] |= 1u << (chars[i] & 31);
+                    } else {
+                        mHigh = true;
+                    }
+                }
+            }
+
+            inline bool Contains(Char ch) const
+            {
+                if ((uint16_t)ch < 256) {
+                    return (mBits[(uint16_t)ch >> 5] & (1u << (ch & 31))) != 0;
+                } else if (!mHigh) {
+                    return false;
+                }
+
+                for (size_t i = 0; i < mCount; i++) {
+                    if (mChars[i] == ch) {
+                        return true;
+                    }
+                }
+
+                return false;
+            }
+
+        private:
+
+            uint32_t mBits[8];
+            const Char* mChars;
+            size_t mCount;
+            bool mHigh = false;
+        };
+
+#ifdef LUPUS_AVX2
+        static bool DetectAvx2()
+        {
+#ifdef _MSC_VER
+            int info[4];
+
+            __cpuid(info, 0);
+
+            if (info[0] < 7) {
+                return false;
+            }
+
+            __cpuid(info, 1);
+
+            // AVX and OSXSAVE, then the OS must preserve the YMM registers.
+            if ((info[2] & (1 << 27)) == 0 || (info[2] & (1 << 28)) == 0 || (_xgetbv(0) & 6) != 6) {
+                return false;
+            }
+
+            __cpuidex(info, 7, 0);
+            return (info[1] & (1 << 5)) != 0;
+#else
+            return __builtin_cpu_supports("avx2") != 0;
+#endif
+        }
+
+        // Reads false until the library is initialized; the SSE2 path is used meanwhile.
+        static const bool sAvx2 = DetectAvx2();
+
+        LUPUS_TARGET_AVX2 static const Char* FindCharAvx2(const Char* it, const Char* end, Char ch, const Char** match)
+        {
+            const __m256i needle = _mm256_set1_epi16((short)ch);
+
+            for (; end - it >= 16; it += 16) {
+                __m256i block = _mm256_loadu_si256((const __m256i*)it);
+                unsigned mask = (unsigned)_mm256_movemask_epi8(_mm256_cmpeq_epi16(block, needle));
+
+                if (mask) {
+                    *match = it + (FirstBit(mask) >> 1);
+                    return it;
+                }
+            }
+
+            return it;
+        }
+
+        LUPUS_TARGET_AVX2 static const Char* FindLastCharAvx2(const Char* begin, const Char* it, Char ch, const Char** match)
+        {
+            const __m256i needle = _mm256_set1_epi16((short)ch);
+
+            for (; it - begin >= 16; it -= 16) {
+                __m256i block = _mm256_loadu_si256((const __m256i*)(it - 16));
+                unsigned mask = (unsigned)_mm256_movemask_epi8(_mm256_cmpeq_epi16(block, needle));
+
+                if (mask) {
+                    *match = it - 16 + (LastBit(mask) >> 1);
+                    return it;
+                }
+            }
+
+            return it;
+        }
+
+        LUPUS_TARGET_AVX2 static const Char* FindStringAvx2(const Char* it, const Char* last, const Char* str, size_t size, const Char** match)
+        {
+            const __m256i first = _mm256_set1_epi16((short)str[0]);
+            const __m256i final = _mm256_set1_epi16((short)str[size - 1]);
+
+            for (; last - it >= 15; it += 16) {
+                __m256i head = _mm256_cmpeq_epi16(_mm256_loadu_si256((const __m256i*)it), first);
+                __m256i tail = _mm256_cmpeq_epi16(_mm256_loadu_si256((const __m256i*)(it + size - 1)), final);
+                unsigned mask = (unsigned)_mm256_movemask_epi8(_mm256_and_si256(head, tail));
+
+                while (mask) {
+                    unsigned bit = FirstBit(mask);
+                    const Char* candidate = it + (bit >> 1);
+
+                    if (memcmp(candidate + 1, str + 1, (size - 2) * sizeof(Char)) == 0) {
+                        *match = candidate;
+                        return it;
+                    }
+
+                    mask &= ~(3u << bit);
+                }
+            }
+
+            return it;
+        }
+#endif
+
+        static inline Char FoldAscii(Char ch)
+        {
+            return (ch >= 'A' && ch <= 'Z') ? ch + ('a' - 'A') : ch;
+        }
+
+        // Flips bit 0x20 of every code unit between first and last.
+        template <Char First, Char Last>
+        static inline void ChangeCaseAscii(Char* dst, const Char* src, size_t length)
+        {
+            size_t i = 0;
+
+#ifdef LUPUS_SSE2
+            const __m128i below = _mm_set1_epi16((short)(First - 1));
+            const __m128i above = _mm_set1_epi16((short)(Last + 1));
+            const __m128i bit = _mm_set1_epi16(0x20);
+
+            for (; i + 8 <= length; i += 8) {
+                __m128i block = _mm_loadu_si128((const __m128i*)(src + i));
+                __m128i range = _mm_and_si128(_mm_cmpgt_epi16(block, below), _mm_cmplt_epi16(block, above));
+                _mm_storeu_si128((__m128i*)(dst + i), _mm_xor_si128(block, _mm_and_si128(range, bit)));
+            }
+#endif
+            for (; i < length; i++) {
+                dst[i] = (src[i] >= First && src[i] <= Last) ? src[i] ^ 0x20 : src[i];
+            }
+        }
+
+#ifdef LUPUS_SSE2
+        static inline unsigned MatchAny(__m128i block, const __m128i* needles, size_t count)
+        {
+            __m128i result = _mm_cmpeq_epi16(block, needles[0]);
+
+            for (size_t i = 1; i < count; i++) {
+                result = _mm_or_si128(result, _mm_cmpeq_epi16(block, needles[i]));
+            }
+
+            return (unsigned)_mm_movemask_epi8(result);
+        }
+#endif
+
+        const Char* FindChar(const Char* data, size_t length, Char ch)
+        {
+            const Char* it = data;
+            const Char* end = data + length;
+
+#ifdef LUPUS_AVX2
+            if (sAvx2) {
+                const Char* match = nullptr;
+                it = FindCharAvx2(it, end, ch, &match);
+
+                if (match) {
+                    return match;
+                }
+            }
+#endif
+#ifdef LUPUS_SSE2
+            const __m128i needle = _mm_set1_epi16((short)ch);
+
+            for (; end - it >= 8; it += 8) {
+                unsigned mask = (unsigned)_mm_movemask_epi8(_mm_cmpeq_epi16(_mm_loadu_si128((const __m128i*)it), needle));
+
+                if (mask) {
+                    return it + (FirstBit(mask) >> 1);
+                }
+            }
+#endif
+            for (; it != end; it++) {
+                if (*it == ch) {
+                    return it;
+                }
+            }
+
+            return nullptr;
+        }
+
+        const Char* FindLastChar(const Char* data, size_t length, Char ch)
+        {
+            const Char* it = data + length;
+
+#ifdef LUPUS_AVX2
+            if (sAvx2) {
+                const Char* match = nullptr;
+                it = FindLastCharAvx2(data, it, ch, &match);
+
+                if (match) {
+                    return match;
+                }
+            }
+#endif
+#ifdef LUPUS_SSE2
+            const __m128i needle = _mm_set1_epi16((short)ch);
+
+            for (; it - data >= 8; it -= 8) {
+                unsigned mask = (unsigned)_mm_movemask_epi8(_mm_cmpeq_epi16(_mm_loadu_si128((const __m128i*)(it - 8)), needle));
+
+                if (mask) {
+                    return it - 8 + (LastBit(mask) >> 1);
+                }
+            }
+#endif
+            while (it != data) {
+                if (*--it == ch) {
+                    return it;
+                }
+            }
+
+            return nullptr;
+        }
+
+        const Char* FindAnyChar(const Char* data, size_t length, const Char* chars, size_t count)
+        {
+            const Char* it = data;
+            const Char* end = data + length;
+
+            if (count == 0) {
+                return nullptr;
+            } else if (count == 1) {
+                return FindChar(data, length, chars[0]);
+            } else if (count <= sVectorSetSize) {
+#ifdef LUPUS_SSE2
+                __m128i needles[sVectorSetSize];
+
+                for (size_t i = 0; i < count; i++) {
+                    needles[i] = _mm_set1_epi16((short)chars[i]);
+                }
+
+                for (; end - it >= 8; it += 8) {
+                    unsigned mask = MatchAny(_mm_loadu_si128((const __m128i*)it), needles, count);
+
+                    if (mask) {
+                        return it + (FirstBit(mask) >> 1);
+                    }
+                }
+#endif
+            }
+
+            CharSet set(chars, count);
+
+            for (; it != end; it++) {
+                if (set.Contains(*it)) {
+                    return it;
+                }
+            }
+
+            return nullptr;
+        }
+
+        const Char* FindLastAnyChar(const Char* data, size_t length, const Char* chars, size_t count)
+        {
+            const Char* it = data + length;
+
+            if (count == 0) {
+                return nullptr;
+            } else if (count == 1) {
+                return FindLastChar(data, length, chars[0]);
+            } else if (count <= sVectorSetSize) {
+#ifdef LUPUS_SSE2
+                __m128i needles[sVectorSetSize];
+
+                for (size_t i = 0; i < count; i++) {
+                    needles[i] = _mm_set1_epi16((short)chars[i]);
+                }
+
+                for (; it - data >= 8; it -= 8) {
+                    unsigned mask = MatchAny(_mm_loadu_si128((const __m128i*)(it - 8)), needles, count);
+
+                    if (mask) {
+                        return it - 8 + (LastBit(mask) >> 1);
+                    }
+                }
+#endif
+            }
+
+            CharSet set(chars, count);
+
+            while (it != data) {
+                if (set.Contains(*--it)) {
+                    return it;
+                }
+            }
+
+            return nullptr;
+        }
+
+        const Char* FindString(const Char* data, size_t length, const Char* str, size_t size)
+        {
+            if (size == 0 || size > length) {
+                return nullptr;
+            } else if (size == 1) {
+                return FindChar(data, length, str[0]);
+            }
+
+            const Char* it = data;
+            const Char* last = data + length - size;
+
+#ifdef LUPUS_AVX2
+            if (sAvx2) {
+                const Char* match = nullptr;
+                it = FindStringAvx2(it, last, str, size, &match);
+
+                if (match) {
+                    return match;
+                }
+            }
+#endif
+#ifdef LUPUS_SSE2
+            const __m128i first = _mm_set1_epi16((short)str[0]);
+            const __m128i final = _mm_set1_epi16((short)str[size - 1]);
+
+            // The second load covers the last code unit of eight candidates.
+            for (; last - it >= 7; it += 8) {
+                __m128i head = _mm_cmpeq_epi16(_mm_loadu_si128((const __m128i*)it), first);
+                __m128i tail = _mm_cmpeq_epi16(_mm_loadu_si128((const __m128i*)(it + size - 1)), final);
+                unsigned mask = (unsigned)_mm_movemask_epi8(_mm_and_si128(head, tail));
+
+                while (mask) {
+                    unsigned bit = FirstBit(mask);
+                    const Char* candidate = it + (bit >> 1);
+
+                    if (memcmp(candidate + 1, str + 1, (size - 2) * sizeof(Char)) == 0) {
+                        return candidate;
+                    }
+
+                    mask &= ~(3u << bit);
+                }
+            }
+#endif
+            for (; it <= last; it++) {
+                if (it[0] == str[0] && it[size - 1] == str[size - 1] && memcmp(it + 1, str + 1, (size - 2) * sizeof(Char)) == 0) {
+                    return it;
+                }
+            }
+
+            return nullptr;
+        }
+
+        bool IsAscii(const Char* data, size_t length)
+        {
+            size_t i = 0;
+
+#ifdef LUPUS_SSE2
+            const __m128i high = _mm_set1_epi16((short)0xFF80);
+
+            for (; i + 32 <= length; i += 32) {
+                __m128i bits = _mm_or_si128(
+                    _mm_or_si128(_mm_loadu_si128((const __m128i*)(data + i)), _mm_loadu_si128((const __m128i*)(data + i + 8))),
+                    _mm_or_si128(_mm_loadu_si128((const __m128i*)(data + i + 16)), _mm_loadu_si128((const __m128i*)(data + i + 24))));
+
+                if (_mm_movemask_epi8(_mm_cmpeq_epi16(_mm_and_si128(bits, high), _mm_setzero_si128())) != 0xFFFF) {
+                    return false;
+                }
+            }
+#endif
+            Char bits = 0;
+
+            for (; i < length; i++) {
+                bits |= data[i];
+            }
+
+            return bits < 0x80;
+        }
+
+        void ToLowerAscii(Char* dst, const Char* src, size_t length)
+        {
+            ChangeCaseAscii<'A', 'Z'>(dst, src, length);
+        }
+
+        void ToUpperAscii(Char* dst, const Char* src, size_t length)
+        {
+            ChangeCaseAscii<'a', 'z'>(dst, src, length);
+        }
+
+        bool CompareIgnoreCaseAscii(const Char* lhs, const Char* rhs, size_t length, int* result)
+        {
+            size_t i = 0;
+
+#ifdef LUPUS_SSE2
+            const __m128i high = _mm_set1_epi16((short)0xFF80);
+            const __m128i below = _mm_set1_epi16('A' - 1);
+            const __m128i above = _mm_set1_epi16('Z' + 1);
+            const __m128i bit = _mm_set1_epi16(0x20);
+
+            for (; i + 8 <= length; i += 8) {
+                __m128i a = _mm_loadu_si128((const __m128i*)(lhs + i));
+                __m128i b = _mm_loadu_si128((const __m128i*)(rhs + i));
+                unsigned wide = ~_mm_movemask_epi8(_mm_cmpeq_epi16(_mm_and_si128(_mm_or_si128(a, b), high), _mm_setzero_si128())) & 0xFFFF;
+
+                a = _mm_or_si128(a, _mm_and_si128(_mm_and_si128(_mm_cmpgt_epi16(a, below), _mm_cmplt_epi16(a, above)), bit));
+                b = _mm_or_si128(b, _mm_and_si128(_mm_and_si128(_mm_cmpgt_epi16(b, below), _mm_cmplt_epi16(b, above)), bit));
+
+                unsigned stop = wide | (~_mm_movemask_epi8(_mm_cmpeq_epi16(a, b)) & 0xFFFF);
+
+                if (stop) {
+                    i += FirstBit(stop) >> 1;
+                    break;
+                }
+            }
+#endif
+            for (; i < length; i++) {
+                if (lhs[i] >= 0x80 || rhs[i] >= 0x80) {
+                    return false;
+                }
+
+                Char a = FoldAscii(lhs[i]);
+                Char b = FoldAscii(rhs[i]);
+
+                if (a != b) {
+                    *result = a < b ? -1 : 1;
+                    return true;
+                }
+            }
+
+            *result = 0;
+            return true;
+        }
+    }
+}
@@ -0,0 +1,358 @@
+/**
+ * Copyright (C) 2014 David Wolf <d.wolf@live.at>
+ *
+ * This file is part of Lupus.
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include "Collator.h"
+#include "Internal/CharSearch.h"
+#include "Internal/StringBuffer.h"
+#include <unicode/ucol.h>
+#include <unicode/ustring.h>
+#include <algorithm>
+#include <cstring>
+#include <thread>
+
+using namespace std;
+
+namespace Lupus {
+    namespace Text {
+        //! Below this many strings sorting stays on the calling thread.
+        static const size_t sParallelThreshold = 4096;
+
+        //! Sort key of one string; the units are compared in order.
+        template <typename T>
+        struct SortEntry
+        {
+            const T* Key;
+            size_t Length;
+            size_t Index;
+        };
+
+        static inline int CompareUnits(const uint8_t* lhs, const uint8_t* rhs, size_t count)
+        {
+            return memcmp(lhs, rhs, count);
+        }
+
+        static inline int CompareUnits(const Char* lhs, const Char* rhs, size_t count)
+        {
+            for (size_t i = 0; i < count; i++) {
+                if (lhs[i] != rhs[i]) {
+                    return (uint16_t)lhs[i] < (uint16_t)rhs[i] ? -1 : 1;
+                }
+            }
+
+            return 0;
+        }
+
+        // Equal keys keep their input order, so the result is stable.
+        template <typename T>
+        static inline bool operator<(const SortEntry<T>& lhs, const SortEntry<T>& rhs)
+        {
+            int result = CompareUnits(lhs.Key, rhs.Key, min(lhs.Length, rhs.Length));
+
+            if (result != 0) {
+                return result < 0;
+            } else if (lhs.Length != rhs.Length) {
+                return lhs.Length < rhs.Length;
+            }
+
+            return lhs.Index < rhs.Index;
+        }
+
+        static size_t WorkerCount(size_t count)
+        {
+            size_t workers = thread::hardware_concurrency();
+
+            if (count < sParallelThreshold || workers < 2) {
+                return 1;
+            }
+
+            return min(workers, count / (sParallelThreshold / 2));
+        }
+
+        //! Runs function(worker) for every worker; the calling thread is worker 0.
+        template <typename Function>
+        static void ParallelFor(size_t workers, const Function& function)
+        {
+            vector<thread> threads;
+
+            for (size_t i = 1; i < workers; i++) {
+                threads.push_back(thread([&function, i] { function(i); }));
+            }
+
+            function(0);
+
+            for (thread& t : threads) {
+                t.join();
+            }
+        }
+
+        //! Sorts the entries, which were split into equal ranges per worker,
+        //! and moves the strings into that order.
+        template <typename T>
+        static void SortEntries(vector<String>& strings, vector<SortEntry<T>>& entries, size_t workers)
+        {
+            size_t count = entries.size();
+
+            ParallelFor(workers, [&](size_t worker) {
+                sort(entries.begin() + count * worker / workers, entries.begin() + count * (worker + 1) / workers);
+            });
+
+            // Merge neighbouring ranges until one is left.
+            for (size_t width = 1; width < workers; width *= 2) {
+                size_t merges = (workers + 2 * width - 1) / (2 * width);
+
+                ParallelFor(merges, [&](size_t merge) {
+                    size_t first = merge * 2 * width;
+                    size_t middle = min(first + width, workers);
+                    size_t last = min(first + 2 * width, workers);
+
+                    if (middle < last) {
+                        inplace_merge(
+                            entries.begin() + count * first / workers,
+                            entries.begin() + count * middle / workers,
+                            entries.begin() + count * last / workers);
+                    }
+                });
+            }
+
+            vector<String> sorted;
+            sorted.reserve(count);
+
+            for (const SortEntry<T>& entry : entries) {
+                sorted.push_back(move(strings[entry.Index]));
+            }
+
+            strings.swap(sorted);
+        }
+
+        Collator::Collator() :
+            Collator(String())
+        {
+        }
+
+        Collator::Collator(const String& locale)
+        {
+            UErrorCode error = U_ZERO_ERROR;
+            mCollator = ucol_open(locale.IsEmpty() ? nullptr : locale.ToUTF8().c_str(), &error);
+
+            if (U_FAILURE(error)) {
+                if (mCollator) {
+                    ucol_close((UCollator*)mCollator);
+                    mCollator = nullptr;
+                }
+
+                throw runtime_error("Could not create collator.");
+            }
+        }
+
+        Collator::Collator(void* collator) :
+            mCollator(collator)
+        {
+        }
+
+        Collator::~Collator()
+        {
+            if (mCollator) {
+                ucol_close((UCollator*)mCollator);
+                mCollator = nullptr;
+            }
+        }
+
+        shared_ptr<Collator> Collator::Clone() const
+        {
+            UErrorCode error = U_ZERO_ERROR;
+            return shared_ptr<Collator>(new Collator(ucol_safeClone((const UCollator*)mCollator, nullptr, nullptr, &error)));
+        }
+
+        int Collator::Compare(StringView lhs, StringView rhs) const
+        {
+            switch (ucol_strcoll((const UCollator*)mCollator, lhs.Data(), (int32_t)lhs.Length(), rhs.Data(), (int32_t)rhs.Length())) {
+                case UCOL_LESS:
+                    return -1;
+                case UCOL_GREATER:
+                    return 1;
+                default:
+                    return 0;
+            }
+        }
+
+        vector<uint8_t> Collator::GetSortKey(StringView str) const
+        {
+            vector<uint8_t> key(str.Length() * 2 + 16);
+            int32_t length = ucol_getSortKey((const UCollator*)mCollator, str.Data(), (int32_t)str.Length(), key.data(), (int32_t)key.size());
+
+            if ((size_t)length > key.size()) {
+                key.resize(length);
+                ucol_getSortKey((const UCollator*)mCollator, str.Data(), (int32_t)str.Length(), key.data(), (int32_t)key.size());
+            }
+
+            key.resize(length);
+            return key;
+        }
+
+        void Collator::Sort(vector<String>& strings) const
+        {
+            size_t count = strings.size();
+            size_t workers = WorkerCount(count);
+            vector<SortEntry<uint8_t>> entries(count);
+            vector<vector<uint8_t>> keys(workers);
+
+            // Each worker writes the keys of its range into one buffer and
+            // uses a collator of its own.
+            ParallelFor(workers, [&](size_t worker) {
+                size_t first = count * worker / workers;
+                size_t last = count * (worker + 1) / workers;
+                vector<uint8_t>& buffer = keys[worker];
+                vector<size_t> offsets(last - first);
+                UErrorCode error = U_ZERO_ERROR;
+                UCollator* collator = worker ? ucol_safeClone((const UCollator*)mCollator, nullptr, nullptr, &error) : (UCollator*)mCollator;
+                size_t used = 0;
+
+                buffer.resize((last - first) * 32);
+
+                for (size_t i = first; i < last; i++) {
+                    const String& str = strings[i];
+                    StringChars chars(str);
+                    size_t length;
+
+                    for (;;) {
+                        length = ucol_getSortKey(collator, chars.Data(), (int32_t)str.Length(), buffer.data() + used, (int32_t)min(buffer.size() - used, (size_t)INT32_MAX));
+
+                        if (used + length <= buffer.size()) {
+                            break;
+                        }
+
+                        buffer.resize(max(buffer.size() * 2, used + length));
+                    }
+
+                    offsets[i - first] = used;
+                    entries[i].Length = length;
+                    entries[i].Index = i;
+                    used += length;
+                }
+
+                for (size_t i = first; i < last; i++) {
+                    entries[i].Key = buffer.data() + offsets[i - first];
+                }
+
+                if (worker) {
+                    ucol_close(collator);
+                }
+            });
+
+            SortEntries(strings, entries, workers);
+        }
+
+        CollatorStrength Collator::Strength() const
+        {
+            switch (ucol_getStrength((const UCollator*)mCollator)) {
+                case UCOL_PRIMARY:
+                    return CollatorStrength::Primary;
+                case UCOL_SECONDARY:
+                    return CollatorStrength::Secondary;
+                case UCOL_QUATERNARY:
+                    return CollatorStrength::Quaternary;
+                case UCOL_IDENTICAL:
+                    return CollatorStrength::Identical;
+                default:
+                    return CollatorStrength::Tertiary;
+            }
+        }
+
+        void Collator::Strength(CollatorStrength strength)
+        {
+            static const UCollationStrength strengths[] = { UCOL_PRIMARY, UCOL_SECONDARY, UCOL_TERTIARY, UCOL_QUATERNARY, UCOL_IDENTICAL };
+            ucol_setStrength((UCollator*)mCollator, strengths[(int)strength]);
+        }
+
+        void Collator::Sort(vector<String>& strings, StringCaseSensitivity sensitivity)
+        {
+            size_t count = strings.size();
+            size_t workers = WorkerCount(count);
+            vector<SortEntry<Char>> entries(count);
+            vector<vector<Char>> keys(workers);
+
+            // The case sensitive order compares the code units themselves;
+            // the insensitive one their case folding, built once per string.
+            ParallelFor(workers, [&](size_t worker) {
+                size_t first = count * worker / workers;
+                size_t last = count * (worker + 1) / workers;
+                vector<Char>& buffer = keys[worker];
+                vector<size_t> offsets;
+                size_t used = 0;
+
+                for (size_t i = first; i < last; i++) {
+                    const String& str = strings[i];
+                    StringChars chars(str);
+                    size_t length = str.Length();
+                    entries[i].Length = length;
+                    entries[i].Index = i;
+
+                    // Compact strings are widened into the key buffer, not into a copy kept by the string.
+                    if (sensitivity == StringCaseSensitivity::CaseSensitive && !chars.IsTemporary()) {
+                        entries[i].Key = chars.Data();
+                        continue;
+                    } else if (buffer.empty()) {
+                        buffer.resize((last - first) * 16);
+                        offsets.resize(last - first);
+                    }
+
+                    if (sensitivity == StringCaseSensitivity::CaseSensitive) {
+                        if (buffer.size() - used < length) {
+                            buffer.resize(max(buffer.size() * 2, used + length));
+                        }
+
+                        copy(chars.Data(), chars.Data() + length, buffer.data() + used);
+                    } else if (IsAscii(chars.Data(), length)) {
+                        if (buffer.size() - used < length) {
+                            buffer.resize(max(buffer.size() * 2, used + length));
+                        }
+
+                        ToLowerAscii(buffer.data() + used, chars.Data(), length);
+                    } else {
+                        for (;;) {
+                            UErrorCode error = U_ZERO_ERROR;
+                            length = u_strFoldCase(buffer.data() + used, (int32_t)(buffer.size() - used), chars.Data(), (int32_t)str.Length(), U_FOLD_CASE_DEFAULT, &error);
+
+                            if (used + length <= buffer.size()) {
+                                break;
+                            }
+
+                            buffer.resize(max(buffer.size() * 2, used + length));
+                        }
+                    }
+
+                    offsets[i - first] = used;
+                    entries[i].Length = length;
+                    used += length;
+                }
+
+                for (size_t i = first; i < last; i++) {
+                    if (!entries[i].Key) {
+                        entries[i].Key = buffer.data() + offsets[i - first];
+                    }
+                }
+            });
+
+            SortEntries(strings, entries, workers);
+        }
+    }
+}
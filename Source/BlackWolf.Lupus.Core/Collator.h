@@ -0,0 +1,80 @@
+/**
+ * Copyright (C) 2014 David Wolf <d.wolf@live.at>
+ *
+ * This file is part of Lupus.
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#pragma once
+
+#include "String.h"
+#include "StringView.h"
+#include "IClonable.h"
+#include <vector>
+
+namespace Lupus {
+    namespace Text {
+        //! How fine the differences are that a Collator distinguishes.
+        enum class CollatorStrength {
+            Primary, //!< Base letters only.
+            Secondary, //!< Also accents.
+            Tertiary, //!< Also case; the default.
+            Quaternary, //!< Also punctuation when it is ignored otherwise.
+            Identical //!< Also code points when everything else is equal.
+        };
+
+        //! Locale aware string comparison backed by an ICU collator.
+        //!
+        //! Comparing two strings runs the collation algorithm on both. To
+        //! order many strings, build a sort key for each once and compare
+        //! the keys with memcmp, which is what Sort() does.
+        class LUPUSCORE_API Collator : public NonCopyable, public IClonable<Collator>
+        {
+        public:
+
+            //! Collator of the default locale.
+            Collator() throw(std::runtime_error);
+            //! Collator of an ICU locale id such as "de_AT". Unknown ids
+            //! fall back to the root collation.
+            explicit Collator(const String& locale) throw(std::runtime_error);
+            virtual ~Collator();
+
+            virtual std::shared_ptr<Collator> Clone() const NOEXCEPT override;
+
+            virtual int Compare(StringView lhs, StringView rhs) const NOEXCEPT;
+            //! Null terminated key; memcmp of two keys orders like Compare().
+            virtual std::vector<uint8_t> GetSortKey(StringView str) const NOEXCEPT;
+            //! Sorts into collation order. Large inputs build their keys
+            //! and sort them on several threads.
+            virtual void Sort(std::vector<String>& strings) const NOEXCEPT;
+            virtual CollatorStrength Strength() const NOEXCEPT;
+            virtual void Strength(CollatorStrength strength) NOEXCEPT;
+
+            //! Sorts like String::Compare with the given sensitivity. The
+            //! case insensitive order folds every string once instead of in
+            //! every comparison.
+            static void Sort(std::vector<String>& strings, StringCaseSensitivity sensitivity) NOEXCEPT;
+
+        private:
+
+            explicit Collator(void* collator);
+
+            void* mCollator = nullptr;
+        };
+    }
+}
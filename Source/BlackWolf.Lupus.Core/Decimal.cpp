@@ -0,0 +1,967 @@
+/**
+ * Copyright (C) 2014 David Wolf <d.wolf@live.at>
+ *
+ * This file is part of Lupus.
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include "Decimal.h"
+#include "Float.h"
+#include "Integer.h"
+#include "StringView.h"
+#include "Internal/StringBuffer.h"
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+using namespace std;
+
+namespace Lupus {
+    //! Unsigned 256-bit integer, least significant word first. Holds the
+    //! product of two coefficients or one aligned to a scale 38 higher.
+    struct WideInteger
+    {
+        uint32_t Words[8];
+    };
+
+    //! 10^38, the first value a coefficient may not reach.
+    static const uint64_t sLimitHigh = 0x4B3B4CA85A86C47AULL;
+    static const uint64_t sLimitLow = 0x098A224000000000ULL;
+
+    static const uint64_t sPowers[] = {
+        1ULL, 10ULL, 100ULL, 1000ULL, 10000ULL, 100000ULL, 1000000ULL, 10000000ULL,
+        100000000ULL, 1000000000ULL, 10000000000ULL, 100000000000ULL, 1000000000000ULL,
+        10000000000000ULL, 100000000000000ULL, 1000000000000000ULL, 10000000000000000ULL,
+        100000000000000000ULL, 1000000000000000000ULL, 10000000000000000000ULL
+    };
+
+    static inline void WideLoad(WideInteger& value, uint64_t high, uint64_t low)
+    {
+        memset(&value, 0, sizeof(value));
+        value.Words[0] = (uint32_t)low;
+        value.Words[1] = (uint32_t)(low >> 32);
+        value.Words[2] = (uint32_t)high;
+        value.Words[3] = (uint32_t)(high >> 32);
+    }
+
+    static inline bool WideIsZero(const WideInteger& value)
+    {
+        for (size_t i = 0; i < 8; i++) {
+            if (value.Words[i] != 0) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    //! True if value is below 10^38.
+    static inline bool WideFits(const WideInteger& value)
+    {
+        if ((value.Words[4] | value.Words[5] | value.Words[6] | value.Words[7]) != 0) {
+            return false;
+        }
+
+        uint64_t high = ((uint64_t)value.Words[3] << 32) | value.Words[2];
+        uint64_t low = ((uint64_t)value.Words[1] << 32) | value.Words[0];
+
+        return high < sLimitHigh || (high == sLimitHigh && low < sLimitLow);
+    }
+
+    //! value = value * factor + addend; returns what did not fit.
+    static uint32_t WideMultiplyAdd(WideInteger& value, uint32_t factor, uint32_t addend)
+    {
+        uint64_t carry = addend;
+
+        for (size_t i = 0; i < 8; i++) {
+            carry += (uint64_t)value.Words[i] * factor;
+            value.Words[i] = (uint32_t)carry;
+            carry >>= 32;
+        }
+
+        return (uint32_t)carry;
+    }
+
+    //! value /= divisor; returns the remainder.
+    static uint32_t WideDivideSmall(WideInteger& value, uint32_t divisor)
+    {
+        uint64_t remainder = 0;
+
+        for (size_t i = 8; i > 0; i--) {
+            uint64_t current = (remainder << 32) | value.Words[i - 1];
+            value.Words[i - 1] = (uint32_t)(current / divisor);
+            remainder = current % divisor;
+        }
+
+        return (uint32_t)remainder;
+    }
+
+    //! value *= 10^exponent; false if the result does not fit.
+    static bool WideMultiplyPow10(WideInteger& value, unsigned exponent)
+    {
+        for (; exponent > 9; exponent -= 9) {
+            if (WideMultiplyAdd(value, (uint32_t)sPowers[9], 0) != 0) {
+                return false;
+            }
+        }
+
+        return WideMultiplyAdd(value, (uint32_t)sPowers[exponent], 0) == 0;
+    }
+
+    static int WideCompare(const WideInteger& lhs, const WideInteger& rhs)
+    {
+        for (size_t i = 8; i > 0; i--) {
+            if (lhs.Words[i - 1] != rhs.Words[i - 1]) {
+                return lhs.Words[i - 1] < rhs.Words[i - 1] ? -1 : 1;
+            }
+        }
+
+        return 0;
+    }
+
+    //! lhs += rhs; callers make sure the sum fits.
+    static void WideAdd(WideInteger& lhs, const WideInteger& rhs)
+    {
+        uint64_t carry = 0;
+
+        for (size_t i = 0; i < 8; i++) {
+            carry += (uint64_t)lhs.Words[i] + rhs.Words[i];
+            lhs.Words[i] = (uint32_t)carry;
+            carry >>= 32;
+        }
+    }
+
+    //! lhs -= rhs for lhs >= rhs.
+    static void WideSubtract(WideInteger& lhs, const WideInteger& rhs)
+    {
+        uint64_t borrow = 0;
+
+        for (size_t i = 0; i < 8; i++) {
+            uint64_t difference = (uint64_t)lhs.Words[i] - rhs.Words[i] - borrow;
+            lhs.Words[i] = (uint32_t)difference;
+            borrow = (difference >> 32) & 1;
+        }
+    }
+
+    //! Lower 256 bits of lhs * rhs.
+    static void WideMultiply(const WideInteger& lhs, const WideInteger& rhs, WideInteger& result)
+    {
+        memset(&result, 0, sizeof(result));
+
+        for (size_t i = 0; i < 8; i++) {
+            if (lhs.Words[i] == 0) {
+                continue;
+            }
+
+            uint64_t carry = 0;
+
+            for (size_t j = 0; i + j < 8; j++) {
+                carry += (uint64_t)lhs.Words[i] * rhs.Words[j] + result.Words[i + j];
+                result.Words[i + j] = (uint32_t)carry;
+                carry >>= 32;
+            }
+        }
+    }
+
+    //! quotient = numerator / divisor by shifting and subtracting; the
+    //! numerator is left holding the remainder.
+    static void WideDivide(WideInteger& numerator, const WideInteger& divisor, WideInteger& quotient)
+    {
+        WideInteger remainder;
+        int bit = 255;
+
+        memset(&remainder, 0, sizeof(remainder));
+        memset(&quotient, 0, sizeof(quotient));
+
+        while (bit >= 0 && ((numerator.Words[bit / 32] >> (bit % 32)) & 1) == 0) {
+            bit--;
+        }
+
+        for (; bit >= 0; bit--) {
+            uint32_t carry = (numerator.Words[bit / 32] >> (bit % 32)) & 1;
+
+            for (size_t i = 0; i < 8; i++) {
+                uint32_t word = remainder.Words[i];
+                remainder.Words[i] = (word << 1) | carry;
+                carry = word >> 31;
+            }
+
+            if (WideCompare(remainder, divisor) >= 0) {
+                WideSubtract(remainder, divisor);
+                quotient.Words[bit / 32] |= 1u << (bit % 32);
+            }
+        }
+
+        numerator = remainder;
+    }
+
+    /**
+     * Drops digits, rounding half to even, until the scale is at most
+     * maxScale and the value is below 10^38, then appends zeros to a
+     * negative scale. last is the first of the digits already dropped and
+     * sticky tells whether any other of them was not zero. Returns false
+     * if the value does not fit.
+     */
+    static bool Reduce(WideInteger& value, int& scale, int maxScale, uint32_t last, bool sticky)
+    {
+        while (scale > maxScale || !WideFits(value)) {
+            if (scale <= 0) {
+                return false;
+            }
+
+            sticky |= last != 0;
+            last = WideDivideSmall(value, 10);
+            scale--;
+        }
+
+        if (last > 5 || (last == 5 && (sticky || (value.Words[0] & 1) != 0))) {
+            WideMultiplyAdd(value, 1, 1);
+
+            // 99...9 rounded up to 10^38 loses its last zero.
+            if (!WideFits(value)) {
+                if (scale <= 0) {
+                    return false;
+                }
+
+                WideDivideSmall(value, 10);
+                scale--;
+            }
+        }
+
+        if (scale < 0) {
+            if (!WideMultiplyPow10(value, -scale) || !WideFits(value)) {
+                return false;
+            }
+
+            scale = 0;
+        }
+
+        return true;
+    }
+
+    static inline uint16_t ReadBigEndian16(const uint8_t* data)
+    {
+        return (uint16_t)((data[0] << 8) | data[1]);
+    }
+
+    static inline Decimal MakeDecimal(const WideInteger& value, bool negative, int scale)
+    {
+        return Decimal(
+            ((uint64_t)value.Words[3] << 32) | value.Words[2],
+            ((uint64_t)value.Words[1] << 32) | value.Words[0],
+            negative, (unsigned)scale);
+    }
+
+    //! Loads both magnitudes at the larger scale and returns that scale.
+    static int Align(const Decimal& lhs, const Decimal& rhs, WideInteger& left, WideInteger& right)
+    {
+        int scale = (int)max(lhs.Scale(), rhs.Scale());
+
+        WideLoad(left, lhs.High(), lhs.Low());
+        WideLoad(right, rhs.High(), rhs.Low());
+        WideMultiplyPow10(left, scale - lhs.Scale());
+        WideMultiplyPow10(right, scale - rhs.Scale());
+        return scale;
+    }
+
+    static Decimal AddDecimal(const Decimal& lhs, const Decimal& rhs, bool subtract)
+    {
+        bool negative = lhs.IsNegative();
+        bool rhsNegative = rhs.IsNegative() != subtract;
+
+        // Equal scales and 64-bit coefficients cover most amounts of money.
+        if (lhs.Scale() == rhs.Scale() && lhs.High() == 0 && rhs.High() == 0) {
+            uint64_t left = lhs.Low();
+            uint64_t right = rhs.Low();
+
+            if (negative == rhsNegative) {
+                uint64_t sum = left + right;
+                return Decimal(sum < left ? 1 : 0, sum, negative, lhs.Scale());
+            } else if (left >= right) {
+                return Decimal(0, left - right, negative, lhs.Scale());
+            }
+
+            return Decimal(0, right - left, rhsNegative, lhs.Scale());
+        }
+
+        WideInteger left, right;
+        int scale = Align(lhs, rhs, left, right);
+
+        if (negative == rhsNegative) {
+            WideAdd(left, right);
+        } else if (WideCompare(left, right) >= 0) {
+            WideSubtract(left, right);
+        } else {
+            WideSubtract(right, left);
+            left = right;
+            negative = rhsNegative;
+        }
+
+        if (!Reduce(left, scale, Decimal::MaxScale, 0, false)) {
+            throw overflow_error("Decimal overflow");
+        }
+
+        return MakeDecimal(left, negative, scale);
+    }
+
+    //! Writes the digits of a coefficient and returns how many there are.
+    static size_t CoefficientDigits(uint64_t high, uint64_t low, char* digits)
+    {
+        if (high == 0) {
+            return Integer::FormatTo((unsigned long long)low, (uint8_t*)digits);
+        }
+
+        WideInteger value;
+        char reversed[48];
+        size_t length = 0;
+
+        WideLoad(value, high, low);
+
+        while (!WideIsZero(value)) {
+            uint32_t chunk = WideDivideSmall(value, 1000000000);
+
+            for (size_t i = 0; i < 9; i++) {
+                reversed[length++] = (char)('0' + chunk % 10);
+                chunk /= 10;
+            }
+        }
+
+        while (reversed[length - 1] == '0') {
+            length--;
+        }
+
+        for (size_t i = 0; i < length; i++) {
+            digits[i] = reversed[length - 1 - i];
+        }
+
+        return length;
+    }
+
+    template <typename C>
+    static size_t FormatDecimal(const Decimal& value, C* buffer)
+    {
+        char digits[48];
+        size_t length = CoefficientDigits(value.High(), value.Low(), digits);
+        size_t scale = value.Scale();
+        C* it = buffer;
+
+        if (value.IsNegative()) {
+            *it++ = (C)'-';
+        }
+
+        if (length <= scale) {
+            *it++ = (C)'0';
+            *it++ = (C)'.';
+
+            for (size_t i = length; i < scale; i++) {
+                *it++ = (C)'0';
+            }
+
+            for (size_t i = 0; i < length; i++) {
+                *it++ = (C)digits[i];
+            }
+        } else {
+            for (size_t i = 0; i < length - scale; i++) {
+                *it++ = (C)digits[i];
+            }
+
+            if (scale > 0) {
+                *it++ = (C)'.';
+
+                for (size_t i = length - scale; i < length; i++) {
+                    *it++ = (C)digits[i];
+                }
+            }
+        }
+
+        return it - buffer;
+    }
+
+    /**
+     * Reads an optional minus sign, digits with an optional point and an
+     * optional exponent. The first 39 significant digits are kept; the
+     * rest only take part in rounding.
+     */
+    template <typename C>
+    static size_t ReadDecimal(const C* data, size_t length, Decimal& result)
+    {
+        size_t i = length > 0 && (unsigned)data[0] == '-' ? 1 : 0;
+        bool negative = i == 1;
+        bool point = false;
+        WideInteger value;
+        uint64_t head = 0;
+        size_t digits = 0;
+        size_t kept = 0;
+        long long fraction = 0;
+        long long dropped = 0;
+        uint32_t last = 0;
+        bool sticky = false;
+
+        for (; i < length; i++) {
+            unsigned digit = (unsigned)data[i] - '0';
+
+            if ((unsigned)data[i] == '.' && !point) {
+                point = true;
+                continue;
+            } else if (digit >= 10) {
+                break;
+            }
+
+            digits++;
+            fraction += point;
+
+            if (kept == 0 && digit == 0) {
+                continue;
+            } else if (kept == 39) {
+                if (dropped++ == 0) {
+                    last = digit;
+                } else {
+                    sticky |= digit != 0;
+                }
+
+                continue;
+            }
+
+            // Up to 19 digits are collected in 64 bits.
+            if (kept < 19) {
+                head = head * 10 + digit;
+            } else {
+                if (kept == 19) {
+                    WideLoad(value, 0, head);
+                }
+
+                WideMultiplyAdd(value, 10, digit);
+            }
+
+            kept++;
+        }
+
+        if (digits == 0) {
+            return 0;
+        } else if (kept <= 19) {
+            WideLoad(value, 0, head);
+        }
+
+        long long exponent = 0;
+
+        if (i < length && ((unsigned)data[i] | 0x20) == 'e') {
+            size_t j = i + 1;
+            bool negativeExponent = false;
+
+            if (j < length && ((unsigned)data[j] == '+' || (unsigned)data[j] == '-')) {
+                negativeExponent = (unsigned)data[j++] == '-';
+            }
+
+            if (j < length && (unsigned)data[j] - '0' < 10) {
+                for (; j < length && (unsigned)data[j] - '0' < 10; j++) {
+                    exponent = exponent < 100000 ? exponent * 10 + ((unsigned)data[j] - '0') : exponent;
+                }
+
+                exponent = negativeExponent ? -exponent : exponent;
+                i = j;
+            }
+        }
+
+        long long scale = fraction - exponent - dropped;
+
+        if (kept <= 19 && scale >= 0 && scale <= Decimal::MaxScale) {
+            result = Decimal(0, head, negative, (unsigned)scale);
+            return i;
+        } else if (kept == 0) {
+            scale = min(max(scale, 0LL), (long long)Decimal::MaxScale);
+        } else if (scale > Decimal::MaxScale + 80) {
+            // Far below half of the last digit.
+            WideLoad(value, 0, 0);
+            scale = Decimal::MaxScale;
+            last = 0;
+            sticky = false;
+        } else if (scale < -80) {
+            return 0;
+        }
+
+        int reduced = (int)scale;
+
+        if (!Reduce(value, reduced, Decimal::MaxScale, last, sticky)) {
+            return 0;
+        }
+
+        result = MakeDecimal(value, negative, reduced);
+        return i;
+    }
+
+    //! Accepts white space and a sign in front, and anything after the number.
+    template <typename C>
+    static bool ParseLenient(const C* data, size_t length, Decimal& result)
+    {
+        size_t i = 0;
+        bool negative = false;
+
+        while (i < length && ((unsigned)data[i] == ' ' || (unsigned)data[i] - '\t' < 5)) {
+            i++;
+        }
+
+        if (i < length && ((unsigned)data[i] == '+' || (unsigned)data[i] == '-')) {
+            negative = (unsigned)data[i++] == '-';
+        }
+
+        if (i == length || (unsigned)data[i] == '-' || ReadDecimal(data + i, length - i, result) == 0) {
+            return false;
+        }
+
+        result = negative ? -result : result;
+        return true;
+    }
+
+    Decimal::Decimal()
+    {
+    }
+
+    Decimal::Decimal(int value) :
+        Decimal((long long)value)
+    {
+    }
+
+    Decimal::Decimal(long value) :
+        Decimal((long long)value)
+    {
+    }
+
+    Decimal::Decimal(long long value) :
+        mLow(value < 0 ? 0 - (uint64_t)value : (uint64_t)value), mNegative(value < 0)
+    {
+    }
+
+    Decimal::Decimal(unsigned int value) :
+        mLow(value)
+    {
+    }
+
+    Decimal::Decimal(unsigned long value) :
+        mLow(value)
+    {
+    }
+
+    Decimal::Decimal(unsigned long long value) :
+        mLow(value)
+    {
+    }
+
+    Decimal::Decimal(long long coefficient, unsigned scale) :
+        Decimal(0, coefficient < 0 ? 0 - (uint64_t)coefficient : (uint64_t)coefficient, coefficient < 0, scale)
+    {
+    }
+
+    Decimal::Decimal(uint64_t high, uint64_t low, bool negative, unsigned scale)
+    {
+        if (scale > MaxScale) {
+            throw out_of_range("scale");
+        } else if (high > sLimitHigh || (high == sLimitHigh && low >= sLimitLow)) {
+            throw out_of_range("coefficient");
+        }
+
+        mLow = low;
+        mHigh = high;
+        mScale = (uint8_t)scale;
+        mNegative = negative && (high | low) != 0;
+    }
+
+    uint64_t Decimal::High() const
+    {
+        return mHigh;
+    }
+
+    uint64_t Decimal::Low() const
+    {
+        return mLow;
+    }
+
+    unsigned Decimal::Scale() const
+    {
+        return mScale;
+    }
+
+    bool Decimal::IsNegative() const
+    {
+        return mNegative;
+    }
+
+    bool Decimal::IsZero() const
+    {
+        return (mHigh | mLow) == 0;
+    }
+
+    int Decimal::Compare(const Decimal& value) const
+    {
+        int result = 0;
+
+        if (mNegative != value.mNegative) {
+            return mNegative ? -1 : 1;
+        } else if (mScale == value.mScale) {
+            if (mHigh != value.mHigh) {
+                result = mHigh < value.mHigh ? -1 : 1;
+            } else if (mLow != value.mLow) {
+                result = mLow < value.mLow ? -1 : 1;
+            }
+        } else {
+            WideInteger lhs, rhs;
+            Align(*this, value, lhs, rhs);
+            result = WideCompare(lhs, rhs);
+        }
+
+        return mNegative ? -result : result;
+    }
+
+    Decimal Decimal::Round(unsigned scale) const
+    {
+        WideInteger value;
+        int current = mScale;
+
+        scale = scale > MaxScale ? (unsigned)MaxScale : scale;
+        WideLoad(value, mHigh, mLow);
+
+        if ((int)scale > current) {
+            if (!WideMultiplyPow10(value, scale - current) || !WideFits(value)) {
+                throw overflow_error("Decimal overflow");
+            }
+
+            current = (int)scale;
+        } else {
+            Reduce(value, current, (int)scale, 0, false);
+        }
+
+        return MakeDecimal(value, mNegative, current);
+    }
+
+    double Decimal::ToDouble() const
+    {
+        uint8_t buffer[MaxLength];
+        size_t length = FormatTo(buffer);
+        double result = 0;
+
+        Float::FromChars((const char*)buffer, (const char*)buffer + length, result);
+        return result;
+    }
+
+    String Decimal::ToString() const
+    {
+        Char buffer[MaxLength];
+        return StringView(buffer, FormatTo(buffer)).ToString();
+    }
+
+    size_t Decimal::FormatTo(Char* buffer) const
+    {
+        return FormatDecimal(*this, buffer);
+    }
+
+    size_t Decimal::FormatTo(uint8_t* buffer) const
+    {
+        return FormatDecimal(*this, buffer);
+    }
+
+    Decimal Decimal::operator-() const
+    {
+        return Decimal(mHigh, mLow, !mNegative, mScale);
+    }
+
+    Decimal Decimal::operator+(const Decimal& value) const
+    {
+        return AddDecimal(*this, value, false);
+    }
+
+    Decimal Decimal::operator-(const Decimal& value) const
+    {
+        return AddDecimal(*this, value, true);
+    }
+
+    Decimal Decimal::operator*(const Decimal& value) const
+    {
+        bool negative = mNegative != value.mNegative;
+        int scale = mScale + value.mScale;
+
+        if (mHigh == 0 && value.mHigh == 0 && mLow <= 0xFFFFFFFF && value.mLow <= 0xFFFFFFFF && scale <= (int)MaxScale) {
+            return Decimal(0, mLow * value.mLow, negative, scale);
+        }
+
+        WideInteger lhs, rhs, product;
+
+        WideLoad(lhs, mHigh, mLow);
+        WideLoad(rhs, value.mHigh, value.mLow);
+        WideMultiply(lhs, rhs, product);
+
+        if (!Reduce(product, scale, MaxScale, 0, false)) {
+            throw overflow_error("Decimal overflow");
+        }
+
+        return MakeDecimal(product, negative, scale);
+    }
+
+    Decimal Decimal::operator/(const Decimal& value) const
+    {
+        if (value.IsZero()) {
+            throw domain_error("Division by zero");
+        }
+
+        bool negative = mNegative != value.mNegative;
+        int preferred = max((int)mScale - (int)value.mScale, 0);
+        int scale = 0;
+        WideInteger numerator, divisor, quotient;
+
+        // Both at the same scale, the quotient of the coefficients is the
+        // integral part.
+        WideLoad(numerator, mHigh, mLow);
+        WideLoad(divisor, value.mHigh, value.mLow);
+        WideMultiplyPow10(mScale < value.mScale ? numerator : divisor, max(mScale, value.mScale) - min(mScale, value.mScale));
+        WideDivide(numerator, divisor, quotient);
+
+        if (!WideFits(quotient)) {
+            throw overflow_error("Decimal overflow");
+        }
+
+        // Long division, one digit at a time while there is room for it.
+        for (; scale < (int)MaxScale && (!WideIsZero(numerator) || scale < preferred); scale++) {
+            WideInteger next = quotient;
+            uint32_t digit = 0;
+
+            if (WideMultiplyAdd(next, 10, 9) != 0 || !WideFits(next)) {
+                break;
+            }
+
+            WideMultiplyAdd(numerator, 10, 0);
+
+            while (WideCompare(numerator, divisor) >= 0) {
+                WideSubtract(numerator, divisor);
+                digit++;
+            }
+
+            WideMultiplyAdd(quotient, 10, digit);
+        }
+
+        // Twice the remainder against the divisor tells where the rest lies:
+        // below half is passed to Reduce as digit 4, above half as a sticky 5.
+        uint32_t last = 0;
+        bool sticky = false;
+
+        if (!WideIsZero(numerator)) {
+            WideAdd(numerator, numerator);
+            int result = WideCompare(numerator, divisor);
+            last = result < 0 ? 4 : 5;
+            sticky = result > 0;
+        }
+
+        if (!Reduce(quotient, scale, MaxScale, last, sticky)) {
+            throw overflow_error("Decimal overflow");
+        }
+
+        return MakeDecimal(quotient, negative, scale);
+    }
+
+    Decimal& Decimal::operator+=(const Decimal& value)
+    {
+        return *this = *this + value;
+    }
+
+    Decimal& Decimal::operator-=(const Decimal& value)
+    {
+        return *this = *this - value;
+    }
+
+    Decimal& Decimal::operator*=(const Decimal& value)
+    {
+        return *this = *this * value;
+    }
+
+    Decimal& Decimal::operator/=(const Decimal& value)
+    {
+        return *this = *this / value;
+    }
+
+    bool Decimal::operator==(const Decimal& value) const
+    {
+        return Compare(value) == 0;
+    }
+
+    bool Decimal::operator!=(const Decimal& value) const
+    {
+        return Compare(value) != 0;
+    }
+
+    bool Decimal::operator<(const Decimal& value) const
+    {
+        return Compare(value) < 0;
+    }
+
+    bool Decimal::operator<=(const Decimal& value) const
+    {
+        return Compare(value) <= 0;
+    }
+
+    bool Decimal::operator>(const Decimal& value) const
+    {
+        return Compare(value) > 0;
+    }
+
+    bool Decimal::operator>=(const Decimal& value) const
+    {
+        return Compare(value) >= 0;
+    }
+
+    Decimal Decimal::Parse(const String& value)
+    {
+        Decimal result;
+
+        if (!TryParse(value, result)) {
+            throw format_error("Invalid decimal number");
+        }
+
+        return result;
+    }
+
+    bool Decimal::TryParse(const String& value, Decimal& result)
+    {
+        StringChars chars(value);
+        return ParseLenient(chars.Data(), value.Length(), result);
+    }
+
+    size_t Decimal::FromChars(const Char* first, const Char* last, Decimal& result)
+    {
+        return ReadDecimal(first, last - first, result);
+    }
+
+    size_t Decimal::FromChars(const char* first, const char* last, Decimal& result)
+    {
+        return ReadDecimal(first, last - first, result);
+    }
+
+    bool Decimal::FromDigitGroups(const uint16_t* groups, size_t count, int weight, bool negative, unsigned scale, Decimal& result)
+    {
+        // The last group holds the digits down to 10^(4 * (weight - count + 1)).
+        long long natural = 4 * ((long long)count - weight - 1);
+        long long target = scale > MaxScale ? MaxScale : scale;
+
+        // Up to 16 digits are scaled in 64 bits.
+        if (count <= 4) {
+            uint64_t coefficient = 0;
+
+            for (size_t i = 0; i < count; i++) {
+                if (groups[i] > 9999) {
+                    return false;
+                }
+
+                coefficient = coefficient * 10000 + groups[i];
+            }
+
+            if (natural >= target && natural - target < 20 && coefficient % sPowers[natural - target] == 0) {
+                result = Decimal(0, coefficient / sPowers[natural - target], negative, (unsigned)target);
+                return true;
+            } else if (natural < target && target - natural < 20 && coefficient <= 0xFFFFFFFFFFFFFFFFULL / sPowers[target - natural]) {
+                result = Decimal(0, coefficient * sPowers[target - natural], negative, (unsigned)target);
+                return true;
+            }
+        }
+
+        // Eleven groups hold at least 41 significant digits, enough to
+        // round to 38; later groups only take part in rounding.
+        WideInteger value;
+        size_t kept = 0;
+        long long dropped = 0;
+        uint32_t last = 0;
+        bool sticky = false;
+
+        WideLoad(value, 0, 0);
+
+        for (size_t i = 0; i < count; i++) {
+            if (groups[i] > 9999) {
+                return false;
+            } else if (kept == 11) {
+                if (dropped++ == 0) {
+                    last = groups[i] / 1000;
+                    sticky |= groups[i] % 1000 != 0;
+                } else {
+                    sticky |= groups[i] != 0;
+                }
+            } else if (kept > 0 || groups[i] != 0) {
+                WideMultiplyAdd(value, 10000, groups[i]);
+                kept++;
+            }
+        }
+
+        long long digits = natural - 4 * dropped;
+
+        if (kept == 0) {
+            digits = target;
+        } else if (digits > target + 80) {
+            WideLoad(value, 0, 0);
+            digits = target;
+            last = 0;
+            sticky = false;
+        } else if (digits < -80) {
+            return false;
+        }
+
+        int reduced = (int)digits;
+
+        if (!Reduce(value, reduced, (int)target, last, sticky)) {
+            return false;
+        } else if (reduced < target) {
+            if (!WideMultiplyPow10(value, (unsigned)(target - reduced)) || !WideFits(value)) {
+                return false;
+            }
+
+            reduced = (int)target;
+        }
+
+        result = MakeDecimal(value, negative, reduced);
+        return true;
+    }
+
+    bool Decimal::FromNumeric(const uint8_t* data, size_t length, Decimal& result)
+    {
+        static const uint16_t positive = 0x0000;
+        static const uint16_t negative = 0x4000;
+
+        if (length < 8) {
+            return false;
+        }
+
+        size_t count = ReadBigEndian16(data);
+        int weight = (int16_t)ReadBigEndian16(data + 2);
+        uint16_t sign = ReadBigEndian16(data + 4);
+        unsigned scale = ReadBigEndian16(data + 6);
+
+        // NaN (0xC000) and the infinities (0xD000, 0xF000) have no Decimal.
+        if ((sign != positive && sign != negative) || length != 8 + 2 * count) {
+            return false;
+        }
+
+        // Money columns need a handful of groups at most.
+        uint16_t local[16];
+        vector<uint16_t> heap;
+        uint16_t* groups = local;
+
+        if (count > 16) {
+            heap.resize(count);
+            groups = heap.data();
+        }
+
+        for (size_t i = 0; i < count; i++) {
+            groups[i] = ReadBigEndian16(data + 8 + 2 * i);
+        }
+
+        return FromDigitGroups(groups, count, weight, sign == negative, scale, result);
+    }
+}
@@ -0,0 +1,139 @@
+/**
+ * Copyright (C) 2014 David Wolf <d.wolf@live.at>
+ *
+ * This file is part of Lupus.
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#pragma once
+
+#include "String.h"
+#include <cstdint>
+
+namespace Lupus {
+    //! Fixed-point decimal number with a 128-bit coefficient below 10^38
+    //! and a scale of 0 to 38 digits after the point, like NUMERIC(38, s).
+    //!
+    //! Results keep as many digits after the point as fit into 38 digits
+    //! and are rounded half to even beyond that. Results that need more
+    //! than 38 digits before the point throw std::overflow_error. Values
+    //! compare by value, so 1.5 equals 1.50.
+    class LUPUSCORE_API Decimal
+    {
+    public:
+
+        //! Largest number of digits after the point.
+        static const unsigned MaxScale = 38;
+        //! Maximum number of characters written by FormatTo.
+        static const size_t MaxLength = 41;
+
+        Decimal() NOEXCEPT;
+        Decimal(int value) NOEXCEPT;
+        Decimal(long value) NOEXCEPT;
+        Decimal(long long value) NOEXCEPT;
+        Decimal(unsigned int value) NOEXCEPT;
+        Decimal(unsigned long value) NOEXCEPT;
+        Decimal(unsigned long long value) NOEXCEPT;
+        //! Value coefficient * 10^-scale.
+        Decimal(long long coefficient, unsigned scale) throw(std::out_of_range);
+        //! Value (high * 2^64 + low) * 10^-scale, negated if negative is set.
+        Decimal(uint64_t high, uint64_t low, bool negative, unsigned scale) throw(std::out_of_range);
+        Decimal(const Decimal&) = default;
+        ~Decimal() = default;
+
+        //! Upper 64 bits of the coefficient's magnitude.
+        uint64_t High() const NOEXCEPT;
+        //! Lower 64 bits of the coefficient's magnitude.
+        uint64_t Low() const NOEXCEPT;
+        unsigned Scale() const NOEXCEPT;
+        bool IsNegative() const NOEXCEPT;
+        bool IsZero() const NOEXCEPT;
+
+        int Compare(const Decimal& value) const NOEXCEPT;
+        //! Rounds half to even to scale digits, at most MaxScale, after the
+        //! point; a scale above the current one appends zeros.
+        Decimal Round(unsigned scale) const throw(std::overflow_error);
+        //! Closest double, correctly rounded.
+        double ToDouble() const NOEXCEPT;
+        //! All digits of the scale, without exponent: "-12.50".
+        String ToString() const NOEXCEPT;
+        //! Writes ToString() without terminator into MaxLength characters.
+        size_t FormatTo(Char* buffer) const NOEXCEPT;
+        //! \sa Decimal::FormatTo(Char*)
+        size_t FormatTo(uint8_t* buffer) const NOEXCEPT;
+
+        Decimal operator-() const NOEXCEPT;
+        Decimal operator+(const Decimal& value) const throw(std::overflow_error);
+        Decimal operator-(const Decimal& value) const throw(std::overflow_error);
+        Decimal operator*(const Decimal& value) const throw(std::overflow_error);
+        //! The quotient's scale is at least the dividend's minus the
+        //! divisor's; inexact quotients are rounded to 38 digits.
+        Decimal operator/(const Decimal& value) const throw(std::overflow_error, std::domain_error);
+        Decimal& operator+=(const Decimal& value) throw(std::overflow_error);
+        Decimal& operator-=(const Decimal& value) throw(std::overflow_error);
+        Decimal& operator*=(const Decimal& value) throw(std::overflow_error);
+        Decimal& operator/=(const Decimal& value) throw(std::overflow_error, std::domain_error);
+        Decimal& operator=(const Decimal&) = default;
+
+        bool operator==(const Decimal& value) const NOEXCEPT;
+        bool operator!=(const Decimal& value) const NOEXCEPT;
+        bool operator<(const Decimal& value) const NOEXCEPT;
+        bool operator<=(const Decimal& value) const NOEXCEPT;
+        bool operator>(const Decimal& value) const NOEXCEPT;
+        bool operator>=(const Decimal& value) const NOEXCEPT;
+
+        static Decimal Parse(const String& value) throw(format_error);
+        //! Skips leading white space and a sign, and ignores what follows
+        //! the number. Digits beyond the scale of 38 are rounded.
+        static bool TryParse(const String& value, Decimal& result) NOEXCEPT;
+        /**
+         * Reads "-12.5", "12", ".5" or "1.25e3" at the start of [first,
+         * last) without white space or '+'.
+         *
+         * \returns Number of characters read, 0 if there was no number or
+         *          it did not fit; result is then unchanged.
+         */
+        static size_t FromChars(const Char* first, const Char* last, Decimal& result) NOEXCEPT;
+        //! \sa Decimal::FromChars(const Char*, const Char*, Decimal&)
+        static size_t FromChars(const char* first, const char* last, Decimal& result) NOEXCEPT;
+        /**
+         * Builds the value sum(groups[i] * 10000^(weight - i)) from groups of
+         * four decimal digits, most significant first, as in PostgreSQL's
+         * binary NUMERIC format, and rounds it to scale digits.
+         *
+         * \returns False if a group exceeds 9999 or the value does not fit.
+         */
+        static bool FromDigitGroups(const uint16_t* groups, size_t count, int weight, bool negative, unsigned scale, Decimal& result) NOEXCEPT;
+        /**
+         * Reads a value in PostgreSQL's binary NUMERIC format: digit count,
+         * weight, sign and display scale as 16-bit big-endian words, then
+         * the digit groups.
+         *
+         * \returns False for NaN and infinities, for malformed input and
+         *          if the value does not fit.
+         */
+        static bool FromNumeric(const uint8_t* data, size_t length, Decimal& result) NOEXCEPT;
+
+    private:
+
+        uint64_t mLow = 0;
+        uint64_t mHigh = 0;
+        uint8_t mScale = 0;
+        bool mNegative = false;
+    };
+}
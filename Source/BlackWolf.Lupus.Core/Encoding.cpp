@@ -21,40 +21,268 @@
  * THE SOFTWARE.
  */
 #include "Encoding.h"
+#include "StringView.h"
+#include "Internal/StringBuffer.h"
+#include "Internal/Transcode.h"
 #include <unicode/ucnv.h>
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <mutex>
 
 using namespace std;
 
 namespace Lupus {
     namespace Text {
+        static const size_t sConverterPoolSize = 16;
+        static const size_t sEncodingCacheSize = 64;
+
+        //! Encodings with a built-in transcoder, see Internal/Transcode.h.
+        enum class Transcoder {
+            None,
+            Ascii,
+            Latin1,
+            Utf8,
+            Utf16LE,
+            Utf16BE
+        };
+
+        //! Idle converters of one encoding. ICU converters keep conversion
+        //! state and must not be used by two threads at once.
+        struct ConverterPool
+        {
+            string Name;
+            Transcoder Builtin = Transcoder::None;
+            mutex Lock;
+            vector<UConverter*> Converters;
+
+            ~ConverterPool()
+            {
+                for (UConverter* converter : Converters) {
+                    ucnv_close(converter);
+                }
+            }
+
+            UConverter* Acquire()
+            {
+                {
+                    lock_guard<mutex> lock(Lock);
+
+                    if (!Converters.empty()) {
+                        UConverter* converter = Converters.back();
+                        Converters.pop_back();
+                        return converter;
+                    }
+                }
+
+                UErrorCode error = U_ZERO_ERROR;
+                UConverter* converter = ucnv_open(Name.c_str(), &error);
+
+                if (U_FAILURE(error)) {
+                    if (converter) {
+                        ucnv_close(converter);
+                    }
+
+                    throw runtime_error("Could not create converter.");
+                }
+
+                return converter;
+            }
+
+            void Release(UConverter* converter)
+            {
+                {
+                    lock_guard<mutex> lock(Lock);
+
+                    if (Converters.size() < sConverterPoolSize) {
+                        Converters.push_back(converter);
+                        return;
+                    }
+                }
+
+                ucnv_close(converter);
+            }
+        };
+
+        //! Returns a borrowed converter to its pool when leaving the scope.
+        class ConverterLease
+        {
+        public:
+
+            ConverterLease(ConverterPool* pool) :
+                mPool(pool), mConverter(pool->Acquire())
+            {
+            }
+
+            ~ConverterLease()
+            {
+                mPool->Release(mConverter);
+            }
+
+            inline operator UConverter*() const { return mConverter; }
+
+        private:
+
+            ConverterLease(const ConverterLease&) = delete;
+            ConverterLease& operator=(const ConverterLease&) = delete;
+
+            ConverterPool* mPool;
+            UConverter* mConverter;
+        };
+
+        //! Shared encodings by the name they were requested with.
+        struct EncodingCache
+        {
+            mutex Lock;
+            vector<pair<String, shared_ptr<Encoding>>> Entries;
+        };
+
+        static atomic<EncodingCache*> sEncodingCache;
+        static atomic<shared_ptr<Encoding>*> sASCII;
+        static atomic<shared_ptr<Encoding>*> sDefault;
+        static atomic<shared_ptr<Encoding>*> sUTF32;
+        static atomic<shared_ptr<Encoding>*> sUTF16;
+        static atomic<shared_ptr<Encoding>*> sUTF8;
+        static atomic<shared_ptr<Encoding>*> sUTF7;
+
+        static EncodingCache* GetEncodingCache()
+        {
+            EncodingCache* cache = sEncodingCache.load(memory_order_acquire);
+
+            if (!cache) {
+                EncodingCache* created = new EncodingCache();
+
+                if (sEncodingCache.compare_exchange_strong(cache, created, memory_order_acq_rel)) {
+                    cache = created;
+                } else {
+                    delete created;
+                }
+            }
+
+            return cache;
+        }
+
+        static shared_ptr<Encoding> FindCached(EncodingCache* cache, const String& name)
+        {
+            for (const auto& entry : cache->Entries) {
+                if (entry.first == name) {
+                    return entry.second;
+                }
+            }
+
+            return nullptr;
+        }
+
+        static shared_ptr<Encoding> GetShared(const String& name) throw(runtime_error)
+        {
+            EncodingCache* cache = GetEncodingCache();
+
+            {
+                lock_guard<mutex> lock(cache->Lock);
+                shared_ptr<Encoding> encoding = FindCached(cache, name);
+
+                if (encoding) {
+                    return encoding;
+                }
+            }
+
+            // Aliases of one converter share its instance. Once the cache is
+            // full further aliases are resolved again on every request.
+            shared_ptr<Encoding> encoding(new Encoding(name));
+            String canonical = encoding->Name();
+
+            lock_guard<mutex> lock(cache->Lock);
+            shared_ptr<Encoding> cached = FindCached(cache, name);
+
+            if (cached) {
+                return cached;
+            }
+
+            for (const auto& entry : cache->Entries) {
+                if (entry.second->Name() == canonical) {
+                    encoding = entry.second;
+                    break;
+                }
+            }
+
+            if (cache->Entries.size() < sEncodingCacheSize) {
+                cache->Entries.push_back(make_pair(name, encoding));
+            }
+
+            return encoding;
+        }
+
+        static shared_ptr<Encoding> GetShared(atomic<shared_ptr<Encoding>*>& slot, const char* name)
+        {
+            shared_ptr<Encoding>* encoding = slot.load(memory_order_acquire);
+
+            if (!encoding) {
+                shared_ptr<Encoding>* created = new shared_ptr<Encoding>(GetShared(String(name)));
+
+                if (slot.compare_exchange_strong(encoding, created, memory_order_acq_rel)) {
+                    encoding = created;
+                } else {
+                    delete created;
+                }
+            }
+
+            return *encoding;
+        }
+
+        static void ThrowConversionError(UErrorCode error, const char* message) throw(format_error, runtime_error)
+        {
+            switch (error) {
+                case U_INDEX_OUTOFBOUNDS_ERROR:
+                    throw format_error("Source data does not produce an Unicode character.");
+
+                case U_INVALID_CHAR_FOUND:
+                    throw format_error("No mapping was found from source to target encoding.");
+
+                case U_TRUNCATED_CHAR_FOUND:
+                    throw format_error("A character sequence was incomplete.");
+
+                case U_ILLEGAL_CHAR_FOUND:
+                    throw format_error("A character was found which is disallowed in the source encoding.");
+
+                case U_INVALID_TABLE_FORMAT:
+                    throw format_error("An error occured trying to read the backing data for the converter.");
+
+                case U_BUFFER_OVERFLOW_ERROR:
+                    throw format_error("More output characters were produced than fit in the target buffer.");
+
+                default:
+                    throw runtime_error(message);
+            }
+        }
+
         shared_ptr<Encoding> Encoding::ASCII()
         {
-            return shared_ptr<Encoding>(new Encoding("US-ASCII"));
+            return GetShared(sASCII, "US-ASCII");
         }
         
         shared_ptr<Encoding> Encoding::Default()
         {
-            return shared_ptr<Encoding>(new Encoding(""));
+            return GetShared(sDefault, "");
         }
 
         shared_ptr<Encoding> Encoding::UTF32()
         {
-            return shared_ptr<Encoding>(new Encoding("UTF-32"));
+            return GetShared(sUTF32, "UTF-32");
         }
 
         shared_ptr<Encoding> Encoding::UTF16()
         {
-            return shared_ptr<Encoding>(new Encoding("UTF-16"));
+            return GetShared(sUTF16, "UTF-16");
         }
 
         shared_ptr<Encoding> Encoding::UTF8()
         {
-            return shared_ptr<Encoding>(new Encoding("UTF-8"));
+            return GetShared(sUTF8, "UTF-8");
         }
 
         shared_ptr<Encoding> Encoding::UTF7()
         {
-            return shared_ptr<Encoding>(new Encoding("UTF-7"));
+            return GetShared(sUTF7, "UTF-7");
         }
 
         Encoding::Encoding(String str)
@@ -67,7 +295,7 @@ namespace Lupus {
                 mConverter = ucnv_openU(str.Data(), &error);
             }
 
-            if (error != U_ZERO_ERROR) {
+            if (U_FAILURE(error)) {
                 if (mConverter) {
                     ucnv_close((UConverter*)mConverter);
                     mConverter = nullptr;
@@ -75,10 +303,30 @@ namespace Lupus {
 
                 throw runtime_error("Could not create converter.");
             }
+
+            // The pool opens its converters by the canonical name, which
+            // stays valid if the default converter changes later on.
+            mPool = new ConverterPool();
+            mPool->Name = ucnv_getName((UConverter*)mConverter, &error);
+
+            if (mPool->Name == "US-ASCII") {
+                mPool->Builtin = Transcoder::Ascii;
+            } else if (mPool->Name == "ISO-8859-1") {
+                mPool->Builtin = Transcoder::Latin1;
+            } else if (mPool->Name == "UTF-8") {
+                mPool->Builtin = Transcoder::Utf8;
+            } else if (mPool->Name == "UTF-16LE") {
+                mPool->Builtin = Transcoder::Utf16LE;
+            } else if (mPool->Name == "UTF-16BE") {
+                mPool->Builtin = Transcoder::Utf16BE;
+            }
         }
 
         Encoding::~Encoding()
         {
+            delete mPool;
+            mPool = nullptr;
+
             if (mConverter) {
                 ucnv_close((UConverter*)mConverter);
                 mConverter = nullptr;
@@ -103,43 +351,30 @@ namespace Lupus {
                 throw out_of_range("size");
             }
 
-            UErrorCode error = U_ZERO_ERROR;
-            int32_t length = (int32_t)size * 4;
-            UChar* dest = new UChar[length + 1];
-            memset(dest, 0, length + 1);
-
-            int32_t outLength = ucnv_toUChars((UConverter*)mConverter, dest, length, (const char*)buffer.data() + offset, (int32_t)size, &error);
+            String result;
 
-            if (error != U_ZERO_ERROR) {
-                delete dest;
-
-                switch (error) {
-                    case U_INDEX_OUTOFBOUNDS_ERROR:
-                        throw format_error("Source data does not produce an Unicode character.");
-
-                    case U_INVALID_CHAR_FOUND:
-                        throw format_error("No mapping was found from source to target encoding.");
-
-                    case U_TRUNCATED_CHAR_FOUND:
-                        throw format_error("A character sequence was incomplete.");
-
-                    case U_ILLEGAL_CHAR_FOUND:
-                        throw format_error("A character was found which is disallowed in the source encoding.");
-
-                    case U_INVALID_TABLE_FORMAT:
-                        throw format_error("An error occured trying to read the backing data for the converter.");
+            if (Decode(buffer.data() + offset, size, result)) {
+                return result;
+            }
 
-                    case U_BUFFER_OVERFLOW_ERROR:
-                        throw format_error("More output characters were produced than fit in the target buffer.");
+            ConverterLease converter(mPool);
+            UErrorCode error = U_ZERO_ERROR;
+            // Most encodings produce at most one unit per byte; the others
+            // report the length they need and are converted a second time.
+            vector<Char> dest(size + 1);
+            int32_t length = ucnv_toUChars(converter, (UChar*)dest.data(), (int32_t)dest.size(), (const char*)buffer.data() + offset, (int32_t)size, &error);
+
+            if (error == U_BUFFER_OVERFLOW_ERROR) {
+                error = U_ZERO_ERROR;
+                dest.resize((size_t)length + 1);
+                length = ucnv_toUChars(converter, (UChar*)dest.data(), (int32_t)dest.size(), (const char*)buffer.data() + offset, (int32_t)size, &error);
+            }
 
-                    default:
-                        throw runtime_error("Could not convert buffer to string.");
-                }
+            if (U_FAILURE(error)) {
+                ThrowConversionError(error, "Could not convert buffer to string.");
             }
 
-            String result(dest);
-            delete dest;
-            return result;
+            return StringView(dest.data(), (size_t)length).ToString();
         }
 
         vector<uint8_t> Encoding::GetBytes(const String& str) const
@@ -154,44 +389,142 @@ namespace Lupus {
             } else if (size > str.Length() - offset) {
                 throw out_of_range("size");
             }
-            
+
+            vector<uint8_t> result;
+
+            if (Encode(str, offset, size, result)) {
+                return result;
+            }
+
+            ConverterLease converter(mPool);
+            StringChars chars(str);
             UErrorCode error = U_ZERO_ERROR;
-            int32_t length = UCNV_GET_MAX_BYTES_FOR_STRING(str.Length(), ucnv_getMaxCharSize((UConverter*)mConverter));
-            char* dest = new char[length];
-            memset(dest, 0, length);
+            result.resize(UCNV_GET_MAX_BYTES_FOR_STRING(size, ucnv_getMaxCharSize(converter)));
+            int32_t length = ucnv_fromUChars(converter, (char*)result.data(), (int32_t)result.size(), chars.Data() + offset, (int32_t)size, &error);
 
-            int32_t outLength = ucnv_fromUChars((UConverter*)mConverter, dest, length, str.Data(), (int32_t)str.Length(), &error);
+            if (U_FAILURE(error)) {
+                ThrowConversionError(error, "Could not convert string to buffer.");
+            }
 
-            if (error != U_ZERO_ERROR) {
-                delete dest;
+            result.resize((size_t)length);
+            return result;
+        }
 
-                switch (error) {
-                    case U_INDEX_OUTOFBOUNDS_ERROR:
-                        throw format_error("Source data does not produce an Unicode character.");
+        bool Encoding::Decode(const uint8_t* data, size_t size, String& result) const
+        {
+            size_t length = size;
+            bool latin1 = true;
+
+            switch (mPool->Builtin) {
+                case Transcoder::Ascii:
+                    if (size > String::SmallCapacity) {
+                        if (!CopyAscii(result.InitializeCompact(size), data, size)) {
+                            return false;
+                        }
+
+                        result.MarkAscii(true);
+                        return true;
+                    }
+
+                    for (size_t i = 0; i < size; i++) {
+                        if (data[i] >= 0x80) {
+                            return false;
+                        }
+                    }
+
+                    WidenLatin1(result.Initialize(size), data, size);
+                    return true;
+
+                case Transcoder::Latin1:
+                    if (size > String::SmallCapacity) {
+                        memcpy(result.InitializeCompact(size), data, size);
+                    } else {
+                        WidenLatin1(result.Initialize(size), data, size);
+                    }
+
+                    return true;
+
+                case Transcoder::Utf8:
+                    if (!MeasureUtf8(data, size, &length, &latin1)) {
+                        return false;
+                    } else if (latin1 && length > String::SmallCapacity) {
+                        DecodeUtf8Latin1(result.InitializeCompact(length), data, size);
+                        result.MarkAscii(length == size);
+                    } else {
+                        DecodeUtf8(result.Initialize(length), data, size);
+                    }
+
+                    return true;
+
+                case Transcoder::Utf16LE:
+                case Transcoder::Utf16BE:
+                    if (size % 2 != 0 || !ReadUtf16(result.Initialize(size / 2), data, size / 2, mPool->Builtin == Transcoder::Utf16BE)) {
+                        return false;
+                    }
+
+                    result.Compact();
+                    return true;
+
+                default:
+                    return false;
+            }
+        }
 
-                    case U_INVALID_CHAR_FOUND:
-                        throw format_error("No mapping was found from source to target encoding.");
+        bool Encoding::Encode(const String& str, size_t offset, size_t size, vector<uint8_t>& result) const
+        {
+            // Compact strings are read as they are stored instead of widening them.
+            const uint8_t* bytes = nullptr;
+            const Char* chars = nullptr;
+            size_t length = 0;
 
-                    case U_TRUNCATED_CHAR_FOUND:
-                        throw format_error("A character sequence was incomplete.");
+            if (str.mLength > String::SmallCapacity && str.mBuffer->Compact) {
+                bytes = str.mBuffer->Bytes() + offset;
+            } else {
+                chars = str.Data() + offset;
+            }
 
-                    case U_ILLEGAL_CHAR_FOUND:
-                        throw format_error("A character was found which is disallowed in the source encoding.");
+            switch (mPool->Builtin) {
+                case Transcoder::Ascii:
+                    result.resize(size);
+                    return bytes ? CopyAscii(result.data(), bytes, size) : NarrowLatin1(result.data(), chars, size, 0x7F);
 
-                    case U_INVALID_TABLE_FORMAT:
-                        throw format_error("An error occured trying to read the backing data for the converter.");
+                case Transcoder::Latin1:
+                    result.resize(size);
 
-                    case U_BUFFER_OVERFLOW_ERROR:
-                        throw format_error("More output characters were produced than fit in the target buffer.");
+                    if (bytes) {
+                        copy(bytes, bytes + size, result.begin());
+                        return true;
+                    }
 
-                    default:
-                        throw runtime_error("Could not convert buffer to string.");
-                }
-            }
+                    return NarrowLatin1(result.data(), chars, size, 0xFF);
 
-            vector<uint8_t> result((uint8_t*)dest, (uint8_t*)dest + outLength);
-            delete dest;
-            return result;
+                case Transcoder::Utf8:
+                    if (bytes) {
+                        result.resize(MeasureLatin1(bytes, size));
+                        EncodeLatin1(result.data(), bytes, size);
+                        return true;
+                    } else if (!MeasureUtf16(chars, size, &length)) {
+                        return false;
+                    }
+
+                    result.resize(length);
+                    EncodeUtf8(result.data(), chars, size);
+                    return true;
+
+                case Transcoder::Utf16LE:
+                case Transcoder::Utf16BE:
+                    result.resize(size * 2);
+
+                    if (bytes) {
+                        WriteUtf16(result.data(), bytes, size, mPool->Builtin == Transcoder::Utf16BE);
+                        return true;
+                    }
+
+                    return WriteUtf16(result.data(), chars, size, mPool->Builtin == Transcoder::Utf16BE);
+
+                default:
+                    return false;
+            }
         }
 
         String Encoding::Name() const
@@ -209,7 +542,7 @@ namespace Lupus {
         shared_ptr<Encoding> Encoding::GetEncoding(String encoding)
         {
             try {
-                return shared_ptr<Encoding>(new Encoding(encoding));
+                return GetShared(encoding);
             } catch (runtime_error&) {
                 return nullptr;
             }
@@ -28,6 +28,17 @@
 
 namespace Lupus {
     namespace Text {
+        struct ConverterPool;
+
+        /**
+         * Converts between String and the byte encodings known to ICU.
+         *
+         * An Encoding is immutable and may be shared between threads; the
+         * static factories return process-wide instances. The common Unicode
+         * and single byte encodings are converted by built-in transcoders;
+         * the others borrow an ICU converter from a pool, so concurrent
+         * calls never share one.
+         */
         class LUPUSCORE_API Encoding : public NonCopyable, public IClonable<Encoding>
         {
         public:
@@ -54,12 +65,20 @@ namespace Lupus {
             static std::shared_ptr<Encoding> UTF8() NOEXCEPT;
             static std::shared_ptr<Encoding> UTF7() NOEXCEPT;
 
+            //! Returns the shared instance of the encoding or nullptr if ICU does not know it.
             static std::shared_ptr<Encoding> GetEncoding(String encoding) NOEXCEPT;
             static std::vector<String> GetEncodings() NOEXCEPT;
 
         private:
 
+            //! Converts ASCII, Latin-1, UTF-8 and UTF-16LE/BE without ICU. Fails
+            //! for other encodings and for input that ICU would substitute.
+            bool Decode(const uint8_t* data, size_t size, String& result) const;
+            bool Encode(const String& str, size_t offset, size_t size, std::vector<uint8_t>& result) const;
+
+            //! Opened once and only cloned from; conversions use the pool.
             void* mConverter = nullptr;
+            ConverterPool* mPool = nullptr;
         };
     }
 }
@@ -21,55 +21,1145 @@
  * THE SOFTWARE.
  */
 #include "Float.h"
+#include "StringView.h"
+#include "Internal/FloatTables.h"
+#include "Internal/StringBuffer.h"
+#include <cfloat>
+#include <clocale>
+#include <cmath>
 #include <cstdio>
+#include <cstdlib>
 #include <cstring>
+#include <limits>
+#include <string>
+#include <vector>
 
-#ifdef _MSC_VER
-#define snprintf _snprintf_s
-#define sscanf sscanf_s
+#if defined(_MSC_VER) && defined(_M_X64)
+#include <intrin.h>
 #endif
 
+using namespace std;
+
 namespace Lupus {
-    static const size_t sFloatCount = 32;
-
-	String Float::ToString(float value)
-	{
-		char result[sFloatCount];
-		memset(result, 0, sFloatCount);
-		snprintf(result, sFloatCount, ("%f"), value);
-		return result;
-	}
-
-	String Float::ToString(double value)
-	{
-		char result[sFloatCount];
-		memset(result, 0, sFloatCount);
-        snprintf(result, sFloatCount, ("%lf"), value);
-		return result;
-	}
-		
-	String Float::ToString(long double value)
-	{
-		char result[sFloatCount];
-		memset(result, 0, sFloatCount);
-        snprintf(result, sFloatCount, ("%Lf"), value);
-		return result;
-	}
-
-	bool Float::TryParse(const String& str, float& result)
-	{
-        return (sscanf(str.ToUTF8().c_str(), ("%f"), &result) == 1);
-	}
-
-	bool Float::TryParse(const String& str, double& result)
-	{
-        return (sscanf(str.ToUTF8().c_str(), ("%lf"), &result) == 1);
-	}
-
-	bool Float::TryParse(const String& str, long double& result)
-	{
-        return (sscanf(str.ToUTF8().c_str(), ("%Lf"), &result) == 1);
-	}
+    //! Digits and power of ten of a finite value, most significant first.
+    struct DecimalDigits
+    {
+        char Digits[24];
+        size_t Length;
+        int Exponent;
+    };
+
+    static inline uint64_t Multiply128(uint64_t a, uint64_t b, uint64_t* high)
+    {
+#if defined(_MSC_VER) && defined(_M_X64)
+        return _umul128(a, b, high);
+#elif defined(__SIZEOF_INT128__)
+        unsigned __int128 product = (unsigned __int128)a * b;
+        *high = (uint64_t)(product >> 64);
+        return (uint64_t)product;
+#else
+        uint64_t b00 = (a & 0xFFFFFFFF) * (b & 0xFFFFFFFF);
+        uint64_t b01 = (a & 0xFFFFFFFF) * (b >> 32);
+        uint64_t b10 = (a >> 32) * (b & 0xFFFFFFFF);
+        uint64_t b11 = (a >> 32) * (b >> 32);
+        uint64_t middle = (b00 >> 32) + (b01 & 0xFFFFFFFF) + (b10 & 0xFFFFFFFF);
+        *high = b11 + (b01 >> 32) + (b10 >> 32) + (middle >> 32);
+        return (middle << 32) | (b00 & 0xFFFFFFFF);
+#endif
+    }
+
+    //! floor(log10(2^e)) for 0 <= e <= 1650.
+    static inline int Log10Pow2(int e)
+    {
+        return (int)(((uint32_t)e * 78913) >> 18);
+    }
+
+    //! floor(log10(5^e)) for 0 <= e <= 2620.
+    static inline int Log10Pow5(int e)
+    {
+        return (int)(((uint32_t)e * 732923) >> 20);
+    }
+
+    //! Bit length of 5^e for 0 <= e <= 3528.
+    static inline int Pow5Bits(int e)
+    {
+        return (int)((((uint32_t)e * 1217359) >> 19) + 1);
+    }
+
+    static inline int Pow5Factor(uint64_t value)
+    {
+        int count = 0;
+
+        while (value % 5 == 0) {
+            value /= 5;
+            count++;
+        }
+
+        return count;
+    }
+
+    static inline bool MultipleOfPowerOf5(uint64_t value, int p)
+    {
+        return Pow5Factor(value) >= p;
+    }
+
+    static inline bool MultipleOfPowerOf2(uint64_t value, int p)
+    {
+        return (value & ((1ULL << p) - 1)) == 0;
+    }
+
+    //! (m * mul) >> j for a 128-bit mul and 64 < j < 128.
+    static inline uint64_t MulShift64(uint64_t m, const uint64_t* mul, int j)
+    {
+        uint64_t high0, high1;
+        uint64_t low1 = Multiply128(m, mul[1], &high1);
+        Multiply128(m, mul[0], &high0);
+        uint64_t sum = high0 + low1;
+
+        if (sum < high0) {
+            high1++;
+        }
+
+        return (high1 << (128 - j)) | (sum >> (j - 64));
+    }
+
+    //! (m * factor) >> shift for 32 < shift.
+    static inline uint32_t MulShift32(uint32_t m, uint64_t factor, int shift)
+    {
+        uint64_t low = (uint64_t)m * (uint32_t)factor;
+        uint64_t high = (uint64_t)m * (uint32_t)(factor >> 32);
+        return (uint32_t)(((low >> 32) + high) >> (shift - 32));
+    }
+
+    static void StoreDigits(DecimalDigits& result, uint64_t output, int exponent)
+    {
+        char digits[24];
+        size_t length = 0;
+
+        while (output % 10 == 0) {
+            output /= 10;
+            exponent++;
+        }
+
+        do {
+            digits[length++] = (char)('0' + output % 10);
+            output /= 10;
+        } while (output != 0);
+
+        for (size_t i = 0; i < length; i++) {
+            result.Digits[i] = digits[length - 1 - i];
+        }
+
+        result.Length = length;
+        result.Exponent = exponent;
+    }
+
+    /**
+     * Shortest digits that read back as the same double (Ulf Adams, "Ryu:
+     * fast float-to-string conversion"). The interval of decimals that
+     * round to the value is scaled by a power of five from the tables and
+     * digits are removed while its bounds still differ.
+     */
+    static void ShortestDigits(double value, DecimalDigits& result)
+    {
+        uint64_t bits;
+        memcpy(&bits, &value, sizeof(bits));
+
+        uint64_t ieeeMantissa = bits & ((1ULL << 52) - 1);
+        int ieeeExponent = (int)((bits >> 52) & 0x7FF);
+        int e2;
+        uint64_t m2;
+
+        if (ieeeExponent == 0) {
+            e2 = 1 - 1023 - 52 - 2;
+            m2 = ieeeMantissa;
+        } else {
+            e2 = ieeeExponent - 1023 - 52 - 2;
+            m2 = (1ULL << 52) | ieeeMantissa;
+        }
+
+        bool acceptBounds = (m2 & 1) == 0;
+        uint64_t mv = 4 * m2;
+        uint32_t mmShift = ieeeMantissa != 0 || ieeeExponent <= 1;
+        uint64_t vr, vp, vm;
+        int e10;
+        bool vmIsTrailingZeros = false;
+        bool vrIsTrailingZeros = false;
+
+        if (e2 >= 0) {
+            int q = Log10Pow2(e2) - (e2 > 3);
+            int k = 125 + Pow5Bits(q) - 1;
+            int i = -e2 + q + k;
+            e10 = q;
+            vr = MulShift64(4 * m2, sDoublePow5InvSplit[q], i);
+            vp = MulShift64(4 * m2 + 2, sDoublePow5InvSplit[q], i);
+            vm = MulShift64(4 * m2 - 1 - mmShift, sDoublePow5InvSplit[q], i);
+
+            // Only one of mp, mv and mm can be a multiple of five.
+            if (q <= 21) {
+                if (mv % 5 == 0) {
+                    vrIsTrailingZeros = MultipleOfPowerOf5(mv, q);
+                } else if (acceptBounds) {
+                    vmIsTrailingZeros = MultipleOfPowerOf5(mv - 1 - mmShift, q);
+                } else {
+                    vp -= MultipleOfPowerOf5(mv + 2, q);
+                }
+            }
+        } else {
+            int q = Log10Pow5(-e2) - (-e2 > 1);
+            int i = -e2 - q;
+            int k = Pow5Bits(i) - 125;
+            int j = q - k;
+            e10 = q + e2;
+            vr = MulShift64(4 * m2, sDoublePow5Split[i], j);
+            vp = MulShift64(4 * m2 + 2, sDoublePow5Split[i], j);
+            vm = MulShift64(4 * m2 - 1 - mmShift, sDoublePow5Split[i], j);
+
+            if (q <= 1) {
+                // mv has at least two trailing zero bits, so vr is exact.
+                vrIsTrailingZeros = true;
+
+                if (acceptBounds) {
+                    vmIsTrailingZeros = mmShift == 1;
+                } else {
+                    vp--;
+                }
+            } else if (q < 63) {
+                vrIsTrailingZeros = MultipleOfPowerOf2(mv, q);
+            }
+        }
+
+        int removed = 0;
+        uint8_t lastRemovedDigit = 0;
+        uint64_t output;
+
+        if (vmIsTrailingZeros || vrIsTrailingZeros) {
+            // Rare case: the bounds or the value itself are exact decimals.
+            while (vp / 10 > vm / 10) {
+                vmIsTrailingZeros &= vm % 10 == 0;
+                vrIsTrailingZeros &= lastRemovedDigit == 0;
+                lastRemovedDigit = (uint8_t)(vr % 10);
+                vr /= 10;
+                vp /= 10;
+                vm /= 10;
+                removed++;
+            }
+
+            if (vmIsTrailingZeros) {
+                while (vm % 10 == 0) {
+                    vrIsTrailingZeros &= lastRemovedDigit == 0;
+                    lastRemovedDigit = (uint8_t)(vr % 10);
+                    vr /= 10;
+                    vp /= 10;
+                    vm /= 10;
+                    removed++;
+                }
+            }
+
+            // Round half to even if the exact value ends in 5.
+            if (vrIsTrailingZeros && lastRemovedDigit == 5 && vr % 2 == 0) {
+                lastRemovedDigit = 4;
+            }
+
+            output = vr + ((vr == vm && (!acceptBounds || !vmIsTrailingZeros)) || lastRemovedDigit >= 5);
+        } else {
+            bool roundUp = false;
+
+            if (vp / 100 > vm / 100) {
+                roundUp = vr % 100 >= 50;
+                vr /= 100;
+                vp /= 100;
+                vm /= 100;
+                removed += 2;
+            }
+
+            while (vp / 10 > vm / 10) {
+                roundUp = vr % 10 >= 5;
+                vr /= 10;
+                vp /= 10;
+                vm /= 10;
+                removed++;
+            }
+
+            output = vr + (vr == vm || roundUp);
+        }
+
+        StoreDigits(result, output, e10 + removed);
+    }
+
+    //! Same as above with the 64-bit tables for float.
+    static void ShortestDigits(float value, DecimalDigits& result)
+    {
+        uint32_t bits;
+        memcpy(&bits, &value, sizeof(bits));
+
+        uint32_t ieeeMantissa = bits & ((1u << 23) - 1);
+        int ieeeExponent = (int)((bits >> 23) & 0xFF);
+        int e2;
+        uint32_t m2;
+
+        if (ieeeExponent == 0) {
+            e2 = 1 - 127 - 23 - 2;
+            m2 = ieeeMantissa;
+        } else {
+            e2 = ieeeExponent - 127 - 23 - 2;
+            m2 = (1u << 23) | ieeeMantissa;
+        }
+
+        bool acceptBounds = (m2 & 1) == 0;
+        uint32_t mv = 4 * m2;
+        uint32_t mp = 4 * m2 + 2;
+        uint32_t mmShift = ieeeMantissa != 0 || ieeeExponent <= 1;
+        uint32_t mm = 4 * m2 - 1 - mmShift;
+        uint32_t vr, vp, vm;
+        int e10;
+        bool vmIsTrailingZeros = false;
+        bool vrIsTrailingZeros = false;
+        uint8_t lastRemovedDigit = 0;
+
+        if (e2 >= 0) {
+            int q = Log10Pow2(e2);
+            int k = 59 + Pow5Bits(q) - 1;
+            int i = -e2 + q + k;
+            e10 = q;
+            vr = MulShift32(mv, sFloatPow5InvSplit[q], i);
+            vp = MulShift32(mp, sFloatPow5InvSplit[q], i);
+            vm = MulShift32(mm, sFloatPow5InvSplit[q], i);
+
+            // The removed digit is needed even if the loop below does not run.
+            if (q != 0 && (vp - 1) / 10 <= vm / 10) {
+                int l = 59 + Pow5Bits(q - 1) - 1;
+                lastRemovedDigit = (uint8_t)(MulShift32(mv, sFloatPow5InvSplit[q - 1], -e2 + q - 1 + l) % 10);
+            }
+
+            if (q <= 9) {
+                if (mv % 5 == 0) {
+                    vrIsTrailingZeros = MultipleOfPowerOf5(mv, q);
+                } else if (acceptBounds) {
+                    vmIsTrailingZeros = MultipleOfPowerOf5(mm, q);
+                } else {
+                    vp -= MultipleOfPowerOf5(mp, q);
+                }
+            }
+        } else {
+            int q = Log10Pow5(-e2);
+            int i = -e2 - q;
+            int k = Pow5Bits(i) - 61;
+            int j = q - k;
+            e10 = q + e2;
+            vr = MulShift32(mv, sFloatPow5Split[i], j);
+            vp = MulShift32(mp, sFloatPow5Split[i], j);
+            vm = MulShift32(mm, sFloatPow5Split[i], j);
+
+            if (q != 0 && (vp - 1) / 10 <= vm / 10) {
+                j = q - 1 - (Pow5Bits(i + 1) - 61);
+                lastRemovedDigit = (uint8_t)(MulShift32(mv, sFloatPow5Split[i + 1], j) % 10);
+            }
+
+            if (q <= 1) {
+                vrIsTrailingZeros = true;
+
+                if (acceptBounds) {
+                    vmIsTrailingZeros = mmShift == 1;
+                } else {
+                    vp--;
+                }
+            } else if (q < 31) {
+                vrIsTrailingZeros = MultipleOfPowerOf2(mv, q - 1);
+            }
+        }
+
+        int removed = 0;
+        uint32_t output;
+
+        if (vmIsTrailingZeros || vrIsTrailingZeros) {
+            while (vp / 10 > vm / 10) {
+                vmIsTrailingZeros &= vm % 10 == 0;
+                vrIsTrailingZeros &= lastRemovedDigit == 0;
+                lastRemovedDigit = (uint8_t)(vr % 10);
+                vr /= 10;
+                vp /= 10;
+                vm /= 10;
+                removed++;
+            }
+
+            if (vmIsTrailingZeros) {
+                while (vm % 10 == 0) {
+                    vrIsTrailingZeros &= lastRemovedDigit == 0;
+                    lastRemovedDigit = (uint8_t)(vr % 10);
+                    vr /= 10;
+                    vp /= 10;
+                    vm /= 10;
+                    removed++;
+                }
+            }
+
+            if (vrIsTrailingZeros && lastRemovedDigit == 5 && vr % 2 == 0) {
+                lastRemovedDigit = 4;
+            }
+
+            output = vr + ((vr == vm && (!acceptBounds || !vmIsTrailingZeros)) || lastRemovedDigit >= 5);
+        } else {
+            while (vp / 10 > vm / 10) {
+                lastRemovedDigit = (uint8_t)(vr % 10);
+                vr /= 10;
+                vp /= 10;
+                vm /= 10;
+                removed++;
+            }
+
+            output = vr + (vr == vm || lastRemovedDigit >= 5);
+        }
+
+        StoreDigits(result, output, e10 + removed);
+    }
+
+    //! Long double is double with MSVC; wider formats search the shortest
+    //! printf precision that reads back unchanged.
+    static void ShortestDigits(long double value, DecimalDigits& result)
+    {
+        if (sizeof(long double) == sizeof(double)) {
+            ShortestDigits((double)value, result);
+            return;
+        }
+
+        char text[64];
+
+        for (int precision = 0; precision < LDBL_DIG + 3; precision++) {
+            snprintf(text, sizeof(text), "%.*Le", precision, value);
+
+            if (strtold(text, nullptr) == value) {
+                break;
+            }
+        }
+
+        // d[.ddd]e[+-]xx with the decimal point of the current locale.
+        const char* it = text + (text[0] == '-');
+        size_t length = 0;
+
+        for (; *it != 'e'; it++) {
+            if (*it >= '0' && *it <= '9') {
+                result.Digits[length++] = *it;
+            }
+        }
+
+        while (length > 1 && result.Digits[length - 1] == '0') {
+            length--;
+        }
+
+        result.Length = length;
+        result.Exponent = atoi(it + 1) - (int)(length - 1);
+    }
+
+    template <typename C>
+    static C* WriteAscii(C* it, const char* text, size_t length)
+    {
+        for (size_t i = 0; i < length; i++) {
+            *it++ = (C)text[i];
+        }
+
+        return it;
+    }
+
+    //! Lays out the digits like JavaScript's Number.prototype.toString.
+    template <typename T, typename C>
+    static size_t FormatFloat(T value, C* buffer)
+    {
+        C* it = buffer;
+
+        if (value != value) {
+            return WriteAscii(it, "nan", 3) - buffer;
+        } else if (signbit(value)) {
+            *it++ = (C)'-';
+            value = -value;
+        }
+
+        if (value > numeric_limits<T>::max()) {
+            return WriteAscii(it, "inf", 3) - buffer;
+        } else if (value == 0) {
+            *it++ = (C)'0';
+            return it - buffer;
+        }
+
+        DecimalDigits digits;
+        ShortestDigits(value, digits);
+
+        int length = (int)digits.Length;
+        int point = length + digits.Exponent;
+
+        if (digits.Exponent >= 0 && point <= 21) {
+            it = WriteAscii(it, digits.Digits, length);
+
+            for (int i = 0; i < digits.Exponent; i++) {
+                *it++ = (C)'0';
+            }
+        } else if (point > 0 && point <= 21) {
+            it = WriteAscii(it, digits.Digits, point);
+            *it++ = (C)'.';
+            it = WriteAscii(it, digits.Digits + point, length - point);
+        } else if (point > -6 && point <= 0) {
+            *it++ = (C)'0';
+            *it++ = (C)'.';
+
+            for (int i = point; i < 0; i++) {
+                *it++ = (C)'0';
+            }
+
+            it = WriteAscii(it, digits.Digits, length);
+        } else {
+            int exponent = point - 1;
+            char text[8];
+            size_t count = 0;
+
+            *it++ = (C)digits.Digits[0];
+
+            if (length > 1) {
+                *it++ = (C)'.';
+                it = WriteAscii(it, digits.Digits + 1, length - 1);
+            }
+
+            *it++ = (C)'e';
+            *it++ = (C)(exponent < 0 ? '-' : '+');
+            exponent = exponent < 0 ? -exponent : exponent;
+
+            do {
+                text[count++] = (char)('0' + exponent % 10);
+                exponent /= 10;
+            } while (exponent != 0);
+
+            while (count > 0) {
+                *it++ = (C)text[--count];
+            }
+        }
+
+        return it - buffer;
+    }
+
+    //! Parameters of the binary formats for the Eisel-Lemire parser.
+    template <typename T>
+    struct BinaryFormat;
+
+    template <>
+    struct BinaryFormat<double>
+    {
+        typedef uint64_t Bits;
+        static const int MantissaBits = 52;
+        static const int MinimumExponent = -1023;
+        static const int InfinitePower = 0x7FF;
+        static const int SmallestPower = -342;
+        static const int LargestPower = 308;
+        static const int MinRoundToEven = -4;
+        static const int MaxRoundToEven = 23;
+        static const int MaxExactPower = 22;
+    };
+
+    template <>
+    struct BinaryFormat<float>
+    {
+        typedef uint32_t Bits;
+        static const int MantissaBits = 23;
+        static const int MinimumExponent = -127;
+        static const int InfinitePower = 0xFF;
+        static const int SmallestPower = -65;
+        static const int LargestPower = 38;
+        static const int MinRoundToEven = -17;
+        static const int MaxRoundToEven = 10;
+        static const int MaxExactPower = 10;
+    };
+
+    /**
+     * Rounds w * 10^q to the binary format (Daniel Lemire, "Number Parsing
+     * at a Gigabyte per Second"). Returns false if the truncated product
+     * cannot decide the rounding; bits then hold a neighbour within one
+     * unit in the last place.
+     */
+    template <typename T>
+    static bool EiselLemire(uint64_t w, int q, uint64_t& bits)
+    {
+        typedef BinaryFormat<T> Format;
+
+        if (w == 0 || q < Format::SmallestPower) {
+            bits = 0;
+            return true;
+        } else if (q > Format::LargestPower) {
+            bits = (uint64_t)Format::InfinitePower << Format::MantissaBits;
+            return true;
+        }
+
+        int zeros = 0;
+
+        while ((w & (1ULL << 63)) == 0) {
+            w <<= 1;
+            zeros++;
+        }
+
+        const uint64_t* power = sPow5Normalized[q + 342];
+        const uint64_t precisionMask = 0xFFFFFFFFFFFFFFFFULL >> (Format::MantissaBits + 3);
+        uint64_t high;
+        uint64_t low = Multiply128(w, power[1], &high);
+        bool exact = true;
+
+        // The high word of the power suffices unless the bits right of the
+        // mantissa are all ones.
+        if ((high & precisionMask) == precisionMask) {
+            uint64_t secondHigh;
+            Multiply128(w, power[0], &secondHigh);
+            low += secondHigh;
+
+            if (secondHigh > low) {
+                high++;
+            }
+        }
+
+        if (low == 0xFFFFFFFFFFFFFFFFULL && (q < -27 || q > 55)) {
+            exact = false;
+        }
+
+        int upperBit = (int)(high >> 63);
+        int shift = upperBit + 64 - Format::MantissaBits - 3;
+        uint64_t mantissa = high >> shift;
+        int power2 = (((152170 + 65536) * q) >> 16) + 63 + upperBit - zeros - Format::MinimumExponent;
+
+        if (power2 <= 0) {
+            // Subnormal results, or zero.
+            if (-power2 + 1 >= 64) {
+                bits = 0;
+                return exact;
+            }
+
+            mantissa >>= -power2 + 1;
+            mantissa += mantissa & 1;
+            mantissa >>= 1;
+            power2 = mantissa < (1ULL << Format::MantissaBits) ? 0 : 1;
+            bits = (mantissa & ((1ULL << Format::MantissaBits) - 1)) | ((uint64_t)power2 << Format::MantissaBits);
+            return exact;
+        }
+
+        // Exactly halfway between two values: round to even.
+        if (low <= 1 && q >= Format::MinRoundToEven && q <= Format::MaxRoundToEven && (mantissa & 3) == 1 && (mantissa << shift) == high) {
+            mantissa &= ~1ULL;
+        }
+
+        mantissa += mantissa & 1;
+        mantissa >>= 1;
+
+        if (mantissa >= (2ULL << Format::MantissaBits)) {
+            mantissa = 1ULL << Format::MantissaBits;
+            power2++;
+        }
+
+        mantissa &= ~(1ULL << Format::MantissaBits);
+
+        if (power2 >= Format::InfinitePower) {
+            power2 = Format::InfinitePower;
+            mantissa = 0;
+        }
+
+        bits = mantissa | ((uint64_t)power2 << Format::MantissaBits);
+        return exact;
+    }
+
+    //! Unsigned integer of arbitrary size for the exact comparisons.
+    class BigInteger
+    {
+    public:
+
+        explicit BigInteger(uint64_t value)
+        {
+            mWords.push_back((uint32_t)value);
+            mWords.push_back((uint32_t)(value >> 32));
+            Trim();
+        }
+
+        void MultiplyAdd(uint32_t factor, uint32_t addend)
+        {
+            uint64_t carry = addend;
+
+            for (size_t i = 0; i < mWords.size(); i++) {
+                carry += (uint64_t)mWords[i] * factor;
+                mWords[i] = (uint32_t)carry;
+                carry >>= 32;
+            }
+
+            if (carry != 0) {
+                mWords.push_back((uint32_t)carry);
+            }
+        }
+
+        void MultiplyPow5(int exponent)
+        {
+            static const uint32_t sPowers[] = {
+                1, 5, 25, 125, 625, 3125, 15625, 78125, 390625, 1953125,
+                9765625, 48828125, 244140625, 1220703125
+            };
+
+            for (; exponent >= 13; exponent -= 13) {
+                MultiplyAdd(sPowers[13], 0);
+            }
+
+            MultiplyAdd(sPowers[exponent], 0);
+        }
+
+        void ShiftLeft(int bits)
+        {
+            if (mWords.empty()) {
+                return;
+            }
+
+            size_t words = bits / 32;
+            int shift = bits % 32;
+
+            if (shift != 0) {
+                uint32_t carry = 0;
+
+                for (size_t i = 0; i < mWords.size(); i++) {
+                    uint32_t word = mWords[i];
+                    mWords[i] = (word << shift) | carry;
+                    carry = word >> (32 - shift);
+                }
+
+                if (carry != 0) {
+                    mWords.push_back(carry);
+                }
+            }
+
+            mWords.insert(mWords.begin(), words, 0);
+        }
+
+        int Compare(const BigInteger& other) const
+        {
+            if (mWords.size() != other.mWords.size()) {
+                return mWords.size() < other.mWords.size() ? -1 : 1;
+            }
+
+            for (size_t i = mWords.size(); i > 0; i--) {
+                if (mWords[i - 1] != other.mWords[i - 1]) {
+                    return mWords[i - 1] < other.mWords[i - 1] ? -1 : 1;
+                }
+            }
+
+            return 0;
+        }
+
+    private:
+
+        void Trim()
+        {
+            while (!mWords.empty() && mWords.back() == 0) {
+                mWords.pop_back();
+            }
+        }
+
+        vector<uint32_t> mWords;
+    };
+
+    //! Position of the decimal digits of a number within its text.
+    template <typename C>
+    struct DecimalText
+    {
+        const C* Integer;
+        size_t IntegerLength;
+        const C* Fraction;
+        size_t FractionLength;
+        int Exponent;
+
+        unsigned Digit(size_t index) const
+        {
+            return (unsigned)(index < IntegerLength ? Integer[index] : Fraction[index - IntegerLength]) - '0';
+        }
+    };
+
+    /**
+     * Compares the full decimal value with the point halfway between the
+     * binary value bits and its successor. At most 800 significant digits
+     * are needed: halfway points have no more than 767 of them.
+     */
+    template <typename T, typename C>
+    static int CompareHalfway(const DecimalText<C>& text, size_t first, uint64_t bits)
+    {
+        typedef BinaryFormat<T> Format;
+        size_t count = text.IntegerLength + text.FractionLength;
+        size_t last = count - first > 800 ? first + 800 : count;
+        bool sticky = false;
+        BigInteger decimal(0);
+        uint64_t mantissa = bits & ((1ULL << Format::MantissaBits) - 1);
+        int exponent = (int)(bits >> Format::MantissaBits);
+
+        for (size_t i = first; i < last; i++) {
+            decimal.MultiplyAdd(10, text.Digit(i));
+        }
+
+        for (size_t i = last; i < count && !sticky; i++) {
+            sticky = text.Digit(i) != 0;
+        }
+
+        if (exponent == 0) {
+            exponent = 1 + Format::MinimumExponent - Format::MantissaBits;
+        } else {
+            mantissa |= 1ULL << Format::MantissaBits;
+            exponent += Format::MinimumExponent - Format::MantissaBits;
+        }
+
+        // decimal * 10^power against (2 * mantissa + 1) * 2^(exponent - 1)
+        BigInteger halfway(2 * mantissa + 1);
+        int power = text.Exponent + (int)text.IntegerLength - (int)last;
+        int shift = power - (exponent - 1);
+
+        if (power >= 0) {
+            decimal.MultiplyPow5(power);
+        } else {
+            halfway.MultiplyPow5(-power);
+        }
+
+        if (shift >= 0) {
+            decimal.ShiftLeft(shift);
+        } else {
+            halfway.ShiftLeft(-shift);
+        }
+
+        int result = decimal.Compare(halfway);
+        return result == 0 && sticky ? 1 : result;
+    }
+
+    //! Moves bits to the correctly rounded value by exact comparisons.
+    template <typename T, typename C>
+    static uint64_t RoundExactly(const DecimalText<C>& text, size_t first, uint64_t bits)
+    {
+        typedef BinaryFormat<T> Format;
+        const uint64_t infinity = (uint64_t)Format::InfinitePower << Format::MantissaBits;
+
+        while (bits < infinity) {
+            int result = CompareHalfway<T>(text, first, bits);
+
+            if (result < 0 || (result == 0 && (bits & 1) == 0)) {
+                break;
+            }
+
+            bits++;
+        }
+
+        while (bits > 0) {
+            int result = CompareHalfway<T>(text, first, bits - 1);
+
+            if (result > 0 || (result == 0 && (bits & 1) == 0)) {
+                break;
+            }
+
+            bits--;
+        }
+
+        return bits;
+    }
+
+    static inline bool IsDigit(unsigned ch)
+    {
+        return ch - '0' < 10;
+    }
+
+    template <typename C>
+    static size_t MatchIgnoreCase(const C* data, size_t length, const char* word)
+    {
+        size_t i = 0;
+
+        for (; word[i] != 0; i++) {
+            if (i == length || ((unsigned)data[i] | 0x20) != (unsigned)word[i]) {
+                return 0;
+            }
+        }
+
+        return i;
+    }
+
+    template <typename T>
+    static T FromBits(uint64_t bits)
+    {
+        typename BinaryFormat<T>::Bits narrow = (typename BinaryFormat<T>::Bits)bits;
+        T result;
+        memcpy(&result, &narrow, sizeof(result));
+        return result;
+    }
+
+    /**
+     * Reads an optional minus sign and a decimal number, infinity or NaN.
+     * Up to 19 significant digits go into one integer; values that fit
+     * are computed exactly in floating point, the rest by Eisel-Lemire
+     * with exact big integer comparisons when it cannot decide.
+     */
+    template <typename T, typename C>
+    static size_t ReadFloat(const C* data, size_t length, T& result)
+    {
+        typedef BinaryFormat<T> Format;
+        size_t i = length > 0 && (unsigned)data[0] == '-' ? 1 : 0;
+        bool negative = i == 1;
+        DecimalText<C> text;
+        size_t count;
+
+        if ((count = MatchIgnoreCase(data + i, length - i, "infinity")) != 0 || (count = MatchIgnoreCase(data + i, length - i, "inf")) != 0) {
+            result = negative ? -numeric_limits<T>::infinity() : numeric_limits<T>::infinity();
+            return i + count;
+        } else if ((count = MatchIgnoreCase(data + i, length - i, "nan")) != 0) {
+            size_t j = i + count;
+
+            // An optional (n-char-sequence) as accepted by strtod.
+            if (j < length && (unsigned)data[j] == '(') {
+                size_t k = j + 1;
+
+                while (k < length && (IsDigit((unsigned)data[k]) || ((unsigned)data[k] | 0x20) - 'a' < 26 || (unsigned)data[k] == '_')) {
+                    k++;
+                }
+
+                j = k < length && (unsigned)data[k] == ')' ? k + 1 : j;
+            }
+
+            result = numeric_limits<T>::quiet_NaN();
+            return j;
+        }
+
+        text.Integer = data + i;
+
+        while (i < length && IsDigit((unsigned)data[i])) {
+            i++;
+        }
+
+        text.IntegerLength = data + i - text.Integer;
+        text.Fraction = data + i;
+        text.FractionLength = 0;
+
+        if (i < length && (unsigned)data[i] == '.') {
+            text.Fraction = data + ++i;
+
+            while (i < length && IsDigit((unsigned)data[i])) {
+                i++;
+            }
+
+            text.FractionLength = data + i - text.Fraction;
+        }
+
+        if (text.IntegerLength + text.FractionLength == 0) {
+            return 0;
+        }
+
+        text.Exponent = 0;
+
+        if (i < length && ((unsigned)data[i] | 0x20) == 'e') {
+            size_t j = i + 1;
+            bool negativeExponent = false;
+
+            if (j < length && ((unsigned)data[j] == '+' || (unsigned)data[j] == '-')) {
+                negativeExponent = (unsigned)data[j++] == '-';
+            }
+
+            if (j < length && IsDigit((unsigned)data[j])) {
+                int exponent = 0;
+
+                // Far beyond any representable value, but no overflow.
+                for (; j < length && IsDigit((unsigned)data[j]); j++) {
+                    exponent = exponent < 100000 ? exponent * 10 + (int)((unsigned)data[j] - '0') : exponent;
+                }
+
+                text.Exponent = negativeExponent ? -exponent : exponent;
+                i = j;
+            }
+        }
+
+        size_t digits = text.IntegerLength + text.FractionLength;
+        size_t first = 0;
+        size_t last;
+        uint64_t w = 0;
+
+        while (first < digits && text.Digit(first) == 0) {
+            first++;
+        }
+
+        for (last = first; last < digits && last - first < 19; last++) {
+            w = w * 10 + text.Digit(last);
+        }
+
+        bool truncated = false;
+
+        for (size_t k = last; k < digits && !truncated; k++) {
+            truncated = text.Digit(k) != 0;
+        }
+
+        int q = text.Exponent + (int)text.IntegerLength - (int)last;
+        uint64_t bits;
+
+        if (!truncated && q >= -Format::MaxExactPower && q <= Format::MaxExactPower && w <= (2ULL << Format::MantissaBits)) {
+            static const T sPowers[] = {
+                (T)1e0, (T)1e1, (T)1e2, (T)1e3, (T)1e4, (T)1e5, (T)1e6, (T)1e7, (T)1e8, (T)1e9, (T)1e10, (T)1e11,
+                (T)1e12, (T)1e13, (T)1e14, (T)1e15, (T)1e16, (T)1e17, (T)1e18, (T)1e19, (T)1e20, (T)1e21, (T)1e22
+            };
+            T value = (T)w;
+
+            value = q < 0 ? value / sPowers[-q] : value * sPowers[q];
+            result = negative ? -value : value;
+            return i;
+        }
+
+        bool exact = EiselLemire<T>(w, q, bits);
+
+        if (exact && truncated) {
+            // The value lies between w and w + 1 scaled alike.
+            uint64_t upper;
+            exact = EiselLemire<T>(w + 1, q, upper) && upper == bits;
+        }
+
+        if (!exact) {
+            bits = RoundExactly<T>(text, first, bits);
+        }
+
+        T value = FromBits<T>(bits);
+        result = negative ? -value : value;
+        return i;
+    }
+
+    //! Wider long double formats are rounded by strtold.
+    template <typename C>
+    static size_t ReadFloat(const C* data, size_t length, long double& result)
+    {
+        double value;
+        size_t count = ReadFloat(data, length, value);
+
+        if (count == 0 || sizeof(long double) == sizeof(double)) {
+            result = count > 0 ? value : result;
+            return count;
+        }
+
+        string text(count, '\0');
+        char point = *localeconv()->decimal_point;
+
+        for (size_t i = 0; i < count; i++) {
+            text[i] = (unsigned)data[i] == '.' ? point : (char)data[i];
+        }
+
+        result = strtold(text.c_str(), nullptr);
+        return count;
+    }
+
+    //! Accepts what scanf accepts for decimal numbers.
+    template <typename T, typename C>
+    static bool ParseLenient(const C* data, size_t length, T& result)
+    {
+        size_t i = 0;
+        bool negative = false;
+
+        while (i < length && ((unsigned)data[i] == ' ' || (unsigned)data[i] - '\t' < 5)) {
+            i++;
+        }
+
+        if (i < length && ((unsigned)data[i] == '+' || (unsigned)data[i] == '-')) {
+            negative = (unsigned)data[i++] == '-';
+        }
+
+        if (i == length || (unsigned)data[i] == '-' || (unsigned)data[i] == '+') {
+            return false;
+        } else if (ReadFloat(data + i, length - i, result) == 0) {
+            return false;
+        }
+
+        result = negative ? -result : result;
+        return true;
+    }
+
+    template <typename T>
+    static String FloatToString(T value)
+    {
+        Char result[Float::MaxLength];
+        return StringView(result, FormatFloat(value, result)).ToString();
+    }
+
+    String Float::ToString(float value)
+    {
+        return FloatToString(value);
+    }
+
+    String Float::ToString(double value)
+    {
+        return FloatToString(value);
+    }
+
+    String Float::ToString(long double value)
+    {
+        return FloatToString(value);
+    }
+
+    size_t Float::FormatTo(float value, Char* buffer)
+    {
+        return FormatFloat(value, buffer);
+    }
+
+    size_t Float::FormatTo(float value, uint8_t* buffer)
+    {
+        return FormatFloat(value, buffer);
+    }
+
+    size_t Float::FormatTo(double value, Char* buffer)
+    {
+        return FormatFloat(value, buffer);
+    }
+
+    size_t Float::FormatTo(double value, uint8_t* buffer)
+    {
+        return FormatFloat(value, buffer);
+    }
+
+    size_t Float::FormatTo(long double value, Char* buffer)
+    {
+        return FormatFloat(value, buffer);
+    }
+
+    size_t Float::FormatTo(long double value, uint8_t* buffer)
+    {
+        return FormatFloat(value, buffer);
+    }
+
+    bool Float::TryParse(const String& str, float& result)
+    {
+        StringChars chars(str);
+        return ParseLenient(chars.Data(), str.Length(), result);
+    }
+
+    bool Float::TryParse(const String& str, double& result)
+    {
+        StringChars chars(str);
+        return ParseLenient(chars.Data(), str.Length(), result);
+    }
+
+    bool Float::TryParse(const String& str, long double& result)
+    {
+        StringChars chars(str);
+        return ParseLenient(chars.Data(), str.Length(), result);
+    }
+
+    size_t Float::FromChars(const Char* first, const Char* last, float& result)
+    {
+        return ReadFloat(first, last - first, result);
+    }
+
+    size_t Float::FromChars(const char* first, const char* last, float& result)
+    {
+        return ReadFloat(first, last - first, result);
+    }
+
+    size_t Float::FromChars(const Char* first, const Char* last, double& result)
+    {
+        return ReadFloat(first, last - first, result);
+    }
+
+    size_t Float::FromChars(const char* first, const char* last, double& result)
+    {
+        return ReadFloat(first, last - first, result);
+    }
+
+    size_t Float::FromChars(const Char* first, const Char* last, long double& result)
+    {
+        return ReadFloat(first, last - first, result);
+    }
+
+    size_t Float::FromChars(const char* first, const char* last, long double& result)
+    {
+        return ReadFloat(first, last - first, result);
+    }
 
     float Float::ParseFloat(const String& str)
     {
@@ -23,14 +23,22 @@
 #pragma once
 
 #include "String.h"
+#include <cstdint>
 
 namespace Lupus {
 	//! Klasse für die Konvertierung von Gleitpunktzahlen
     class LUPUSCORE_API Float
 	{
 	public:
+		//! Höchstanzahl der Zeichen, die Float::FormatTo schreibt.
+		static const size_t MaxLength = 32;
+
 		/**
-		 * Konvertiert eine Gleitpunktzahl in ihre entsprechende Zeichenkette.
+		 * Konvertiert eine Gleitpunktzahl in die kürzeste Zeichenkette, aus
+		 * der TryParse wieder genau denselben Wert liest. Die Darstellung
+		 * hängt nicht von der Locale ab: Zahlen von 1e-6 bis unter 1e21
+		 * werden ohne Exponent geschrieben, alle anderen wie "1.5e+300".
+		 * Sonderwerte ergeben "nan", "inf" und "-inf".
 		 *
 		 * \param[in] f Gleitpunktzahl.
 		 * \returns Zeichenkette der Gleitpunktzahl.
@@ -40,9 +48,31 @@ namespace Lupus {
 		static String ToString(double d) NOEXCEPT;
 		/// \sa Float::ToString(float)
         static String ToString(long double r) NOEXCEPT;
+		/**
+		 * Schreibt eine Gleitpunktzahl wie ToString ohne Nullterminierung in
+		 * einen Puffer.
+		 *
+		 * \param[in] f Gleitpunktzahl.
+		 * \param[out] buffer Puffer mit Platz für Float::MaxLength Zeichen.
+		 * \returns Anzahl der geschriebenen Zeichen.
+		 */
+		static size_t FormatTo(float f, Char* buffer) NOEXCEPT;
+		/// \sa Float::FormatTo(float, Char*)
+		static size_t FormatTo(float f, uint8_t* buffer) NOEXCEPT;
+		/// \sa Float::FormatTo(float, Char*)
+		static size_t FormatTo(double d, Char* buffer) NOEXCEPT;
+		/// \sa Float::FormatTo(float, Char*)
+		static size_t FormatTo(double d, uint8_t* buffer) NOEXCEPT;
+		/// \sa Float::FormatTo(float, Char*)
+		static size_t FormatTo(long double r, Char* buffer) NOEXCEPT;
+		/// \sa Float::FormatTo(float, Char*)
+		static size_t FormatTo(long double r, uint8_t* buffer) NOEXCEPT;
 		/**
 		 * Versucht eine Zeichenkette in ihre entsprechende Gleitpunktzahl zu
-		 * konvertieren.
+		 * konvertieren. Der Wert wird unabhängig von der Locale korrekt
+		 * gerundet. Führender Leerraum und ein Vorzeichen werden
+		 * übersprungen, Zeichen nach der Zahl ignoriert; "inf", "infinity"
+		 * und "nan" werden erkannt.
 		 *
 		 * \param[in] String Zeichenkette die konvertiert werden soll.
 		 * \param[out] result Variable in der das Ergebnis gespeichert wird.
@@ -54,6 +84,28 @@ namespace Lupus {
 		static bool TryParse(const String& string, double& result) NOEXCEPT;
 		/// \sa Float::TryParse(const String&, float&)
         static bool TryParse(const String& string, long double& result) NOEXCEPT;
+		/**
+		 * Liest eine Gleitpunktzahl am Anfang von [first, last), ähnlich wie
+		 * std::from_chars. Anders als TryParse werden kein Leerraum und
+		 * kein '+' akzeptiert.
+		 *
+		 * \param[in] first Erstes Zeichen.
+		 * \param[in] last Ende der Zeichen.
+		 * \param[out] result Variable in der das Ergebnis gespeichert wird.
+		 * \returns Anzahl der gelesenen Zeichen. 0 wenn keine Zahl gefunden
+		 *			wurde; result bleibt dann unverändert.
+		 */
+		static size_t FromChars(const Char* first, const Char* last, float& result) NOEXCEPT;
+		/// \sa Float::FromChars(const Char*, const Char*, float&)
+		static size_t FromChars(const char* first, const char* last, float& result) NOEXCEPT;
+		/// \sa Float::FromChars(const Char*, const Char*, float&)
+		static size_t FromChars(const Char* first, const Char* last, double& result) NOEXCEPT;
+		/// \sa Float::FromChars(const Char*, const Char*, float&)
+		static size_t FromChars(const char* first, const char* last, double& result) NOEXCEPT;
+		/// \sa Float::FromChars(const Char*, const Char*, float&)
+		static size_t FromChars(const Char* first, const Char* last, long double& result) NOEXCEPT;
+		/// \sa Float::FromChars(const Char*, const Char*, float&)
+		static size_t FromChars(const char* first, const char* last, long double& result) NOEXCEPT;
 
         static float ParseFloat(const String&) throw(std::invalid_argument);
         static double ParseDouble(const String&) throw(std::invalid_argument);
@@ -0,0 +1,601 @@
+/**
+ * Copyright (C) 2014 David Wolf <d.wolf@live.at>
+ *
+ * This file is part of Lupus.
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include "Format.h"
+#include "Float.h"
+#include "StringBuilder.h"
+#include "StringView.h"
+#include "Internal/CharSearch.h"
+#include "Internal/StringBuffer.h"
+#include <cstdio>
+#include <cstring>
+
+#ifdef _MSC_VER
+#define snprintf _snprintf_s
+#endif
+
+using namespace std;
+
+namespace Lupus {
+    namespace Text {
+        static const int sMaximumNumber = 1000000;
+        static const int sMaximumPrecision = 99;
+        static const size_t sIntegerEstimate = 20;
+        static const size_t sFloatEstimate = 24;
+        static const Char sBraces[] = { '{', '}' };
+        static const Char sTrue[] = { 'T', 'r', 'u', 'e' };
+        static const Char sFalse[] = { 'F', 'a', 'l', 's', 'e' };
+
+        static void ThrowFormatError()
+        {
+            throw format_error("Input string was not in a correct format");
+        }
+
+        // Reads an unsigned decimal number as used for index, alignment and precision.
+        static bool ParseNumber(const Char* format, size_t length, size_t& position, int& result)
+        {
+            size_t start = position;
+            result = 0;
+
+            while (position < length && format[position] >= '0' && format[position] <= '9') {
+                result = result * 10 + (format[position++] - '0');
+
+                if (result >= sMaximumNumber) {
+                    ThrowFormatError();
+                }
+            }
+
+            return position > start;
+        }
+
+        static void SkipSpaces(const Char* format, size_t length, size_t& position)
+        {
+            while (position < length && format[position] == ' ') {
+                position++;
+            }
+        }
+
+        // Parses "index[,alignment][:format]}" with position just behind the
+        // opening brace and leaves position behind the closing one.
+        static void ParseItem(const Char* format, size_t length, size_t& position, FormatItem& item)
+        {
+            item.Offset = 0;
+            item.Length = 0;
+            item.Alignment = 0;
+            item.Specifier = 0;
+            item.Precision = -1;
+
+            if (!ParseNumber(format, length, position, item.Index)) {
+                ThrowFormatError();
+            }
+
+            SkipSpaces(format, length, position);
+
+            if (position < length && format[position] == ',') {
+                bool left = false;
+
+                SkipSpaces(format, length, ++position);
+
+                if (position < length && format[position] == '-') {
+                    left = true;
+                    position++;
+                }
+
+                if (!ParseNumber(format, length, position, item.Alignment)) {
+                    ThrowFormatError();
+                }
+
+                item.Alignment = left ? -item.Alignment : item.Alignment;
+                SkipSpaces(format, length, position);
+            }
+
+            if (position < length && format[position] == ':') {
+                Char ch = ++position < length ? format[position] : 0;
+
+                if ((ch >= 'A' && ch <= 'Z') || (ch >= 'a' && ch <= 'z')) {
+                    item.Specifier = ch;
+                    position++;
+
+                    int precision = 0;
+
+                    if (ParseNumber(format, length, position, precision)) {
+                        if (precision > sMaximumPrecision) {
+                            ThrowFormatError();
+                        }
+
+                        item.Precision = precision;
+                    }
+                }
+            }
+
+            if (position >= length || format[position] != '}') {
+                ThrowFormatError();
+            }
+
+            position++;
+        }
+
+        // Walks the literal runs and placeholders of a composite format.
+        // Escaped braces end a run that includes one of them.
+        template <typename Handler>
+        static void ParseFormat(const Char* format, size_t length, Handler& handler)
+        {
+            size_t start = 0;
+            size_t position = 0;
+
+            while (position < length) {
+                const Char* brace = FindAnyChar(format + position, length - position, sBraces, 2);
+
+                if (!brace) {
+                    break;
+                }
+
+                position = brace - format;
+
+                if (position + 1 < length && format[position + 1] == *brace) {
+                    handler.Literal(start, position + 1 - start);
+                    start = position = position + 2;
+                    continue;
+                } else if (*brace == '}') {
+                    ThrowFormatError();
+                }
+
+                FormatItem item;
+
+                handler.Literal(start, position - start);
+                ParseItem(format, length, ++position, item);
+                handler.Argument(item);
+                start = position;
+            }
+
+            handler.Literal(start, length - start);
+        }
+
+        // Appends to a StringBuilder with one Grow per piece instead of
+        // going through its virtual interface.
+        class FormatWriter
+        {
+        public:
+
+            explicit FormatWriter(StringBuilder& builder) :
+                mBuilder(builder)
+            {
+            }
+
+            void Write(const Char* data, size_t length)
+            {
+                if (length > 0) {
+                    memcpy(mBuilder.Grow(length), data, length * sizeof(Char));
+                    Commit(length);
+                }
+            }
+
+            //! Pads with spaces to the alignment; negative values align left.
+            void Write(const Char* data, size_t length, int alignment)
+            {
+                size_t padding = Padding(length, alignment);
+
+                if (length + padding == 0) {
+                    return;
+                }
+
+                Char* it = mBuilder.Grow(length + padding);
+
+                if (alignment > 0) {
+                    it = Fill(it, padding);
+                }
+
+                memcpy(it, data, length * sizeof(Char));
+
+                if (alignment < 0) {
+                    Fill(it + length, padding);
+                }
+
+                Commit(length + padding);
+            }
+
+            //! Widens ASCII or Latin-1 characters while copying them.
+            void WriteLatin1(const uint8_t* data, size_t length, int alignment)
+            {
+                size_t padding = Padding(length, alignment);
+                Char* it = mBuilder.Grow(length + padding);
+
+                if (alignment > 0) {
+                    it = Fill(it, padding);
+                }
+
+                for (size_t i = 0; i < length; i++) {
+                    it[i] = (Char)data[i];
+                }
+
+                if (alignment < 0) {
+                    Fill(it + length, padding);
+                }
+
+                Commit(length + padding);
+            }
+
+        private:
+
+            FormatWriter& operator=(const FormatWriter&);
+
+            static size_t Padding(size_t length, int alignment)
+            {
+                size_t width = (size_t)(alignment < 0 ? -alignment : alignment);
+                return width > length ? width - length : 0;
+            }
+
+            static Char* Fill(Char* it, size_t count)
+            {
+                for (size_t i = 0; i < count; i++) {
+                    *it++ = (Char)' ';
+                }
+
+                return it;
+            }
+
+            void Commit(size_t length)
+            {
+                mBuilder.mLength += length;
+                mBuilder.mBuffer->Data[mBuilder.mLength] = 0;
+            }
+
+            StringBuilder& mBuilder;
+        };
+
+        // Writes value right-aligned in front of end and returns the first digit.
+        static Char* FormatUnsigned(Char* end, unsigned long long value, Char specifier, int precision)
+        {
+            static const char sLower[] = "0123456789abcdef";
+            static const char sUpper[] = "0123456789ABCDEF";
+            Char* it = end;
+
+            if (specifier == 'X' || specifier == 'x') {
+                const char* digits = specifier == 'X' ? sUpper : sLower;
+
+                do {
+                    *--it = (Char)digits[value & 0xF];
+                    value >>= 4;
+                } while (value != 0);
+            } else {
+                do {
+                    *--it = (Char)('0' + value % 10);
+                    value /= 10;
+                } while (value != 0);
+            }
+
+            while (end - it < precision) {
+                *--it = (Char)'0';
+            }
+
+            return it;
+        }
+
+        static void AppendFloat(FormatWriter& writer, double value, size_t size, const FormatItem& item)
+        {
+            char format[8] = "%.*";
+            char result[512];
+            int precision = item.Precision;
+            int length = 0;
+
+            switch (item.Specifier) {
+                case 'F': case 'f': case 'E': case 'e': case 'G': case 'g':
+                    format[3] = (char)item.Specifier;
+                    break;
+                case 0: {
+                    // Without a format the value round-trips like Float::ToString.
+                    uint8_t shortest[Float::MaxLength];
+                    size_t count = size == sizeof(float) ? Float::FormatTo((float)value, shortest) : Float::FormatTo(value, shortest);
+                    writer.WriteLatin1(shortest, count, item.Alignment);
+                    return;
+                }
+                default:
+                    ThrowFormatError();
+            }
+
+            if (precision < 0) {
+                switch (format[3]) {
+                    case 'F': case 'f': precision = 2; break;
+                    case 'E': case 'e': precision = 6; break;
+                    default: precision = size == sizeof(float) ? 7 : 15; break;
+                }
+            }
+
+            length = snprintf(result, sizeof(result), format, precision, value);
+
+            if (length < 0 || length >= (int)sizeof(result)) {
+                ThrowFormatError();
+            }
+
+            writer.WriteLatin1((const uint8_t*)result, length, item.Alignment);
+        }
+
+        static void AppendInteger(FormatWriter& writer, const FormatArgument& argument, const FormatItem& item)
+        {
+            Char digits[sMaximumPrecision + 24];
+            Char* end = digits + sizeof(digits) / sizeof(Char);
+            Char* it = nullptr;
+            bool negative = argument.Type() == FormatArgumentType::Integer && argument.IntegerValue() < 0;
+            unsigned long long value = argument.UnsignedValue();
+
+            switch (item.Specifier) {
+                case 'X': case 'x':
+                    // Negative numbers show their two's complement in the original width.
+                    if (argument.Size() < sizeof(value)) {
+                        value &= (1ULL << (argument.Size() * 8)) - 1;
+                    }
+
+                    negative = false;
+                    break;
+                case 0: case 'D': case 'd':
+                    value = negative ? 0ULL - value : value;
+                    break;
+                case 'F': case 'f': case 'E': case 'e': case 'G': case 'g':
+                    AppendFloat(writer, negative ? (double)argument.IntegerValue() : (double)value, sizeof(double), item);
+                    return;
+                default:
+                    ThrowFormatError();
+            }
+
+            it = FormatUnsigned(end, value, item.Specifier, item.Precision);
+
+            if (negative) {
+                *--it = (Char)'-';
+            }
+
+            writer.Write(it, end - it, item.Alignment);
+        }
+
+        static void AppendUtf8(FormatWriter& writer, const char* data, size_t length, int alignment)
+        {
+            for (size_t i = 0; i < length; i++) {
+                if ((uint8_t)data[i] >= 0x80) {
+                    String str(data);
+                    StringChars chars(str);
+                    writer.Write(chars.Data(), str.Length(), alignment);
+                    return;
+                }
+            }
+
+            writer.WriteLatin1((const uint8_t*)data, length, alignment);
+        }
+
+        static void AppendArgument(FormatWriter& writer, const FormatArgument& argument, const FormatItem& item)
+        {
+            switch (argument.Type()) {
+                case FormatArgumentType::Boolean:
+                    if (argument.UnsignedValue()) {
+                        writer.Write(sTrue, sizeof(sTrue) / sizeof(Char), item.Alignment);
+                    } else {
+                        writer.Write(sFalse, sizeof(sFalse) / sizeof(Char), item.Alignment);
+                    }
+                    break;
+                case FormatArgumentType::Character: {
+                    Char ch = (Char)argument.UnsignedValue();
+                    writer.Write(&ch, 1, item.Alignment);
+                    break;
+                }
+                case FormatArgumentType::Integer:
+                case FormatArgumentType::Unsigned:
+                    AppendInteger(writer, argument, item);
+                    break;
+                case FormatArgumentType::Float:
+                    AppendFloat(writer, argument.FloatValue(), argument.Size(), item);
+                    break;
+                case FormatArgumentType::String:
+                    writer.Write(argument.StringValue(), argument.Length(), item.Alignment);
+                    break;
+                case FormatArgumentType::Utf8:
+                    AppendUtf8(writer, argument.Utf8Value(), argument.Length(), item.Alignment);
+                    break;
+                case FormatArgumentType::Latin1:
+                    writer.WriteLatin1(argument.Latin1Value(), argument.Length(), item.Alignment);
+                    break;
+                default:
+                    break;
+            }
+        }
+
+        static size_t EstimateLength(const FormatArgument* args, size_t count)
+        {
+            size_t result = 0;
+
+            for (size_t i = 0; i < count; i++) {
+                switch (args[i].Type()) {
+                    case FormatArgumentType::Boolean:
+                    case FormatArgumentType::Character:
+                        result += 5;
+                        break;
+                    case FormatArgumentType::Integer:
+                    case FormatArgumentType::Unsigned:
+                        result += sIntegerEstimate;
+                        break;
+                    case FormatArgumentType::Float:
+                        result += sFloatEstimate;
+                        break;
+                    case FormatArgumentType::String:
+                    case FormatArgumentType::Utf8:
+                    case FormatArgumentType::Latin1:
+                        result += args[i].Length();
+                        break;
+                    default:
+                        break;
+                }
+            }
+
+            return result;
+        }
+
+        // Writes while parsing; used by String::Format(const String&, ...).
+        class WriteHandler
+        {
+        public:
+
+            WriteHandler(FormatWriter& writer, const Char* format, const FormatArgument* args, size_t count) :
+                mWriter(writer), mFormat(format), mArguments(args), mCount(count)
+            {
+            }
+
+            void Literal(size_t offset, size_t length)
+            {
+                mWriter.Write(mFormat + offset, length);
+            }
+
+            void Argument(const FormatItem& item)
+            {
+                if ((size_t)item.Index >= mCount) {
+                    throw format_error("Index (zero based) must be less than the size of the argument list");
+                }
+
+                AppendArgument(mWriter, mArguments[item.Index], item);
+            }
+
+        private:
+
+            WriteHandler& operator=(const WriteHandler&);
+
+            FormatWriter& mWriter;
+            const Char* mFormat;
+            const FormatArgument* mArguments;
+            size_t mCount;
+        };
+
+        // Collects the items for FormatString.
+        class ParseHandler
+        {
+        public:
+
+            ParseHandler(vector<FormatItem>& items, size_t& literalLength, size_t& argumentCount) :
+                mItems(items), mLiteralLength(literalLength), mArgumentCount(argumentCount)
+            {
+            }
+
+            void Literal(size_t offset, size_t length)
+            {
+                if (length > 0) {
+                    FormatItem item = { offset, length, -1, 0, 0, -1 };
+                    mItems.push_back(item);
+                    mLiteralLength += length;
+                }
+            }
+
+            void Argument(const FormatItem& item)
+            {
+                mItems.push_back(item);
+                mArgumentCount = max(mArgumentCount, (size_t)item.Index + 1);
+            }
+
+        private:
+
+            ParseHandler& operator=(const ParseHandler&);
+
+            vector<FormatItem>& mItems;
+            size_t& mLiteralLength;
+            size_t& mArgumentCount;
+        };
+
+        FormatArgument::FormatArgument(const String& value) :
+            mType(FormatArgumentType::String), mLength(value.Length())
+        {
+            if (value.mLength > String::SmallCapacity && value.mBuffer->Compact) {
+                mType = FormatArgumentType::Latin1;
+                mLatin1 = value.mBuffer->Bytes();
+            } else {
+                mString = value.Data();
+            }
+        }
+
+        FormatArgument::FormatArgument(const StringView& value) :
+            mType(FormatArgumentType::String), mLength(value.Length())
+        {
+            mString = value.Data();
+        }
+
+        FormatString::FormatString(const String& format) :
+            mPattern(StringChars::Widen(format))
+        {
+            ParseHandler handler(mItems, mLiteralLength, mArgumentCount);
+            ParseFormat(mPattern.Data(), mPattern.Length(), handler);
+        }
+
+        size_t FormatString::ArgumentCount() const
+        {
+            return mArgumentCount;
+        }
+
+        const vector<FormatItem>& FormatString::Items() const
+        {
+            return mItems;
+        }
+
+        size_t FormatString::LiteralLength() const
+        {
+            return mLiteralLength;
+        }
+
+        const String& FormatString::Pattern() const
+        {
+            return mPattern;
+        }
+    }
+
+    String String::FormatArguments(const String& format, const Text::FormatArgument* args, size_t count)
+    {
+        Text::StringBuilder builder(format.Length() + Text::EstimateLength(args, count));
+        return FormatArgumentsTo(builder, format, args, count).ToString();
+    }
+
+    String String::FormatArguments(const Text::FormatString& format, const Text::FormatArgument* args, size_t count)
+    {
+        Text::StringBuilder builder(format.LiteralLength() + Text::EstimateLength(args, count));
+        return FormatArgumentsTo(builder, format, args, count).ToString();
+    }
+
+    Text::StringBuilder& String::FormatArgumentsTo(Text::StringBuilder& builder, const String& format, const Text::FormatArgument* args, size_t count)
+    {
+        Text::FormatWriter writer(builder);
+        StringChars chars(format);
+        Text::WriteHandler handler(writer, chars.Data(), args, count);
+        Text::ParseFormat(chars.Data(), format.Length(), handler);
+        return builder;
+    }
+
+    Text::StringBuilder& String::FormatArgumentsTo(Text::StringBuilder& builder, const Text::FormatString& format, const Text::FormatArgument* args, size_t count)
+    {
+        Text::FormatWriter writer(builder);
+        const Char* pattern = format.Pattern().Data();
+
+        if (format.ArgumentCount() > count) {
+            throw format_error("Index (zero based) must be less than the size of the argument list");
+        }
+
+        for (const Text::FormatItem& item : format.Items()) {
+            if (item.Index < 0) {
+                writer.Write(pattern + item.Offset, item.Length);
+            } else {
+                Text::AppendArgument(writer, args[item.Index], item);
+            }
+        }
+
+        return builder;
+    }
+}
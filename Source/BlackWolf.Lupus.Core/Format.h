@@ -0,0 +1,80 @@
+/**
+ * Copyright (C) 2014 David Wolf <d.wolf@live.at>
+ *
+ * This file is part of Lupus.
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#pragma once
+
+#include "String.h"
+
+#ifdef _MSC_VER
+#pragma warning(push)
+#pragma warning(disable: 4251)
+#endif
+
+namespace Lupus {
+    namespace Text {
+        //! One literal run or placeholder of a parsed format string.
+        struct FormatItem
+        {
+            size_t Offset;      //!< Start of a literal run in the format string
+            size_t Length;      //!< Length of a literal run
+            int Index;          //!< Argument index, -1 for a literal run
+            int Alignment;      //!< Minimum width; negative values align left
+            Char Specifier;     //!< Format letter or 0
+            int Precision;      //!< Digits after the letter or -1
+        };
+
+        //! Composite format string that is parsed once and reused.
+        //!
+        //! String::Format parses its format while writing. Format strings
+        //! used on hot paths can be parsed ahead, e.g. into a static
+        //! FormatString, so that formatting only copies literals and
+        //! arguments and sizes the result buffer exactly for literals.
+        class LUPUSCORE_API FormatString
+        {
+        public:
+
+            explicit FormatString(const String& format) throw(format_error);
+            FormatString(const FormatString&) = default;
+            ~FormatString() = default;
+
+            //! Number of arguments referred to, i.e. the highest index plus one.
+            size_t ArgumentCount() const NOEXCEPT;
+            const std::vector<FormatItem>& Items() const NOEXCEPT;
+            //! Number of characters contributed by literal runs.
+            size_t LiteralLength() const NOEXCEPT;
+            const String& Pattern() const NOEXCEPT;
+
+            FormatString& operator=(const FormatString&) = default;
+
+        private:
+
+            String mPattern;
+            std::vector<FormatItem> mItems;
+            size_t mLiteralLength = 0;
+            size_t mArgumentCount = 0;
+        };
+    }
+}
+
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
@@ -28,10 +28,12 @@
 #include "IPEndPoint.h"
 #include "Stream.h"
 #include "NetUtility.h"
-#include "Integer.h"
 #include "MemoryStream.h"
 #include "X509Certificate.h"
 #include "Cookie.h"
+#include "StringView.h"
+#include "SplitEnumerator.h"
+#include "Internal/StringBuffer.h"
 
 using namespace std;
 using namespace Lupus::Text;
@@ -40,36 +42,95 @@ using namespace Lupus::Security::Cryptography::X509Certificates;
 
 namespace Lupus {
     namespace Net {
+        // Header names sent with nearly every request. Parsed names equal to
+        // one of these share its buffer instead of a copy per request. Both
+        // tables are never written after start-up, so lookups take no lock.
+        static const char* const sKnownHeaderNames[] = {
+            "Accept", "Accept-Charset", "Accept-Encoding", "Accept-Language", "Authorization",
+            "Cache-Control", "Connection", "Content-Length", "Content-Type", "Cookie", "Host",
+            "If-Modified-Since", "If-None-Match", "Origin", "Pragma", "Referer",
+            "Upgrade-Insecure-Requests", "User-Agent", "X-Forwarded-For", "X-Requested-With"
+        };
+        static const vector<String> sKnownHeaders(begin(sKnownHeaderNames), end(sKnownHeaderNames));
+
+        // Name of a header line, shared with the known names where possible.
+        static String HeaderName(Utf8View name)
+        {
+            for (size_t i = 0; i < sKnownHeaders.size(); i++) {
+                if (sKnownHeaders[i].Length() == name.Length() && name == sKnownHeaderNames[i]) {
+                    return sKnownHeaders[i];
+                }
+            }
+
+            return name.ToString();
+        }
+
+        // Value up to the first parameter, e.g. "a, b" of "a, b;q=0.8".
+        static StringView FirstParameter(StringView value)
+        {
+            int index = value.IndexOf(';');
+            return index == -1 ? value : value.Substring(0, index);
+        }
+
+        // Next non-empty line of a CRLF separated header.
+        static bool NextLine(Utf8View header, size_t& position, Utf8View& line)
+        {
+            while (position < header.Length()) {
+                int index = header.IndexOf("\r\n", position);
+                size_t end = index == -1 ? header.Length() : index;
+
+                line = header.Substring(position, end - position);
+                position = index == -1 ? end : end + 2;
+
+                if (!line.IsEmpty()) {
+                    return true;
+                }
+            }
+
+            return false;
+        }
+
         HttpListenerRequest::HttpListenerRequest(const vector<uint8_t>& buffer, shared_ptr<IPEndPoint> local, shared_ptr<IPEndPoint> remote, bool auth, bool sec) :
+            HttpListenerRequest(Utf8View((const char*)buffer.data(), buffer.size()), local, remote, auth, sec)
+        {
+        }
+
+        HttpListenerRequest::HttpListenerRequest(Utf8View request, shared_ptr<IPEndPoint> local, shared_ptr<IPEndPoint> remote, bool auth, bool sec) :
             mLocalEP(local), mRemoteEP(remote), mAuthenticated(auth), mSecure(sec)
         {
             NameValueCollection::const_iterator citum;
 
-            for (auto it = begin(buffer); it != end(buffer); it++) {
-                char ch = static_cast<char>(*it);
-                
-                if (ch == '\r' && static_cast<char>(*(it + 1)) == '\n' && static_cast<char>(*(it + 2)) == '\r' && static_cast<char>(*(it + 3)) == '\n') {
-                    it += 4;
-                    mRawHeader = Encoding::ASCII()->GetString(vector<uint8_t>(begin(buffer), it));
-                    mStream = make_shared<MemoryStream>(buffer, distance(begin(buffer), it), distance(it, end(buffer)), false, true);
-                    break;
-                }
+            // The header is sliced as UTF-8 straight from the request; only the values that are kept get converted.
+            Utf8View header;
+            int headerEnd = request.IndexOf("\r\n\r\n");
+
+            if (headerEnd != -1) {
+                header = request.Substring(0, headerEnd + 4);
+
+                // The body is the only part that is copied, straight into the stream.
+                mStream = make_shared<MemoryStream>(vector<uint8_t>(request.begin() + header.Length(), request.end()), false);
             }
 
-            vector<String> lines = mRawHeader.Split("\r\n", StringSplitOption::RemoveEmptyEntries);
-            vector<String> fields(begin(lines) + 1, end(lines));
-            String version = lines[0].Substring(lines[0].LastIndexOf("/") + 1);
-            
-            mMethod = lines[0].Substring(0, lines[0].IndexOf(" "));
-            mVersion = Version::Parse(version);
+            mRawHeader = header.ToString();
+
+            size_t position = 0;
+            Utf8View requestLine, line;
+            NextLine(header, position, requestLine);
+            Utf8View version = requestLine.Substring(requestLine.LastIndexOf('/') + 1);
+
+            mMethod = requestLine.Substring(0, requestLine.IndexOf(' ')).ToString();
+            mVersion = Version::Parse(version.ToString());
+
+            while (NextLine(header, position, line)) {
+                int index = line.IndexOf(": ");
 
-            for (String str : fields) {
-                vector<String> field = str.Split(": ");
-                mHeaders[field[0]] = field[1];
+                if (index != -1) {
+                    mHeaders[HeaderName(line.Substring(0, index))] = line.Substring(index + 2).ToString();
+                }
             }
 
-            int index = lines[0].IndexOf(" ") + 1;
-            mUrl = make_shared<Uri>((mSecure ? "https://" : "http://") + mHeaders["Host"] + lines[0].Substring(index, lines[0].LastIndexOf(" ") - index));
+            int index = requestLine.IndexOf(' ') + 1;
+            mUrl = make_shared<Uri>((mSecure ? "https://" : "http://") + mHeaders["Host"] + requestLine.Substring(index, requestLine.LastIndexOf(' ') - index).ToString());
             String query = mUrl->Query();
             String cookie = (citum = mHeaders.find("Cookie")) != end(mHeaders) ? citum->second : "";
             String language = (citum = mHeaders.find("Accept-Language")) != end(mHeaders) ? citum->second : "";
@@ -79,33 +140,38 @@ namespace Lupus {
             mContentType = (citum = mHeaders.find("Content-Type")) != end(mHeaders) ? citum->second : "";
             mUserAgent = (citum = mHeaders.find("User-Agent")) != end(mHeaders) ? citum->second : "";
 
-            mAcceptedTypes = accepttypes.IsEmpty() ? vector<String>() : accepttypes.Split(";")[0].Split(",", StringSplitOption::RemoveEmptyEntries);
-            mLanguages = language.IsEmpty() ? vector<String>() : language.Split(";")[0].Split(",", StringSplitOption::RemoveEmptyEntries);
-            auto queries = query.IsEmpty() ? vector<String>() : query.Split("&", StringSplitOption::RemoveEmptyEntries);
+            // Viewing a compact String widens it for good; the header values are only
+            // split, so they are viewed through temporary UTF-16 copies instead.
+            StringChars accepttypesChars(accepttypes), languageChars(language), queryChars(query), cookieChars(cookie), charsetChars(charset);
 
-            for (auto str : queries) {
-                auto nameValuePair = str.Split("=");
-                mQuery[nameValuePair[0]] = nameValuePair[1];
+            for (StringView type : SplitEnumerator(FirstParameter(accepttypesChars.View()), ',', StringSplitOption::RemoveEmptyEntries)) {
+                mAcceptedTypes.push_back(type.ToString());
             }
 
-            auto cookies = cookie.Split(";", StringSplitOption::RemoveEmptyEntries);
+            for (StringView lang : SplitEnumerator(FirstParameter(languageChars.View()), ',', StringSplitOption::RemoveEmptyEntries)) {
+                mLanguages.push_back(lang.ToString());
+            }
 
-            for (auto str : cookies) {
-                auto nameValuePair = str.Split("=");
-                mCookies[nameValuePair[0]] = make_shared<Cookie>(nameValuePair[0], nameValuePair[1]);
+            for (StringView str : SplitEnumerator(queryChars.View(), '&', StringSplitOption::RemoveEmptyEntries)) {
+                int index = str.IndexOf('=');
+                mQuery[(index == -1 ? str : str.Substring(0, index)).ToString()] = index == -1 ? String() : str.Substring(index + 1).ToString();
+            }
+
+            for (StringView str : SplitEnumerator(cookieChars.View(), ';', StringSplitOption::RemoveEmptyEntries)) {
+                int index = str.IndexOf('=');
+                String name = (index == -1 ? str : str.Substring(0, index)).Trim().ToString();
+                mCookies[name] = make_shared<Cookie>(name, index == -1 ? String() : str.Substring(index + 1).ToString());
             }
 
             if (charset.IsEmpty()) {
                 mEncoding = Encoding::UTF8();
             } else {
-                auto encodings = charset.Split(";", StringSplitOption::RemoveEmptyEntries)[0].Split(",", StringSplitOption::RemoveEmptyEntries);
-
-                for (auto enc : encodings) {
-                    if (enc.Compare("utf-8", StringCaseSensitivity::CaseInsensitive) == 0) {
+                for (StringView enc : SplitEnumerator(FirstParameter(charsetChars.View()), ',', StringSplitOption::RemoveEmptyEntries)) {
+                    if (enc.Compare(String("utf-8"), StringCaseSensitivity::CaseInsensitive) == 0) {
                         mEncoding = Encoding::UTF8();
                         break;
                     } else if (!mEncoding) {
-                        mEncoding = Encoding::GetEncoding(enc);
+                        mEncoding = Encoding::GetEncoding(enc.ToString());
                     }
                 }
 
@@ -186,7 +252,11 @@ namespace Lupus {
 
         String HttpListenerRequest::LocalAddress() const
         {
-            return mLocalEP->Address()->ToString() + (mLocalEP->Port() != 80 && mLocalEP->Port() != 443 ? ":" + Integer::ToString(mLocalEP->Port()) : "");
+            if (mLocalEP->Port() == 80 || mLocalEP->Port() == 443) {
+                return mLocalEP->Address()->ToString();
+            }
+
+            return String::Format("{0}:{1}", mLocalEP->Address()->ToString(), mLocalEP->Port());
         }
         
         shared_ptr<Sockets::IPEndPoint> HttpListenerRequest::LocalEndPoint() const
@@ -211,7 +281,11 @@ namespace Lupus {
 
         String HttpListenerRequest::RemoteAddress() const
         {
-            return mRemoteEP->Address()->ToString() + (mRemoteEP->Port() != 80 && mRemoteEP->Port() != 443 ? ":" + Integer::ToString(mRemoteEP->Port()) : "");
+            if (mRemoteEP->Port() == 80 || mRemoteEP->Port() == 443) {
+                return mRemoteEP->Address()->ToString();
+            }
+
+            return String::Format("{0}:{1}", mRemoteEP->Address()->ToString(), mRemoteEP->Port());
         }
         
         shared_ptr<Sockets::IPEndPoint> HttpListenerRequest::RemoteEndPoint() const
@@ -23,6 +23,7 @@
 #pragma once
 
 #include "String.h"
+#include "Utf8View.h"
 #include "Task.h"
 #include <vector>
 #include <memory>
@@ -69,6 +70,13 @@ namespace Lupus {
                 std::shared_ptr<Sockets::IPEndPoint> remoteEP,
                 bool authenticated = false,
                 bool secure = false);
+            //! Parses a request that is already held as UTF-8 text.
+            HttpListenerRequest(
+                Utf8View request,
+                std::shared_ptr<Sockets::IPEndPoint> localEP,
+                std::shared_ptr<Sockets::IPEndPoint> remoteEP,
+                bool authenticated = false,
+                bool secure = false);
             virtual ~HttpListenerRequest() = default;
 
             virtual const std::vector<String>& AcceptTypes() const NOEXCEPT;
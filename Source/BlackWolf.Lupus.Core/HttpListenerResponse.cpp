@@ -34,7 +34,7 @@
 #include "MemoryStream.h"
 #include "Cookie.h"
 #include "NetworkStream.h"
-#include "Integer.h"
+#include "StringBuilder.h"
 
 using namespace std;
 using namespace Lupus::Text;
@@ -241,30 +241,38 @@ namespace Lupus {
 
         String HttpListenerResponse::ToString() const
         {
-            String result;
-            result += "HTTP/" + (mVersion->Minor() < 0 ? (Integer::ToString(mVersion->Major()) + ".x") : mVersion->ToString());
+            StringBuilder result(256);
+            result.Append("HTTP/");
+
+            if (mVersion->Minor() < 0) {
+                result.Append(mVersion->Major()).Append(".x");
+            } else {
+                result.Append(mVersion->ToString());
+            }
+
+            result.Append(" ");
 
             if (mHeaders.find("Location") == end(mHeaders)) {
-                result += Integer::ToString(mStatus) + " " + (mStatusDescription.IsEmpty() ? StatusToString(mStatus) : mStatusDescription) + "\r\n";
-                result += "Content-Length: " + Integer::ToString(mContentLength) + "\r\n";
+                result.Append(mStatus).Append(" ").Append(mStatusDescription.IsEmpty() ? StatusToString(mStatus) : mStatusDescription).Append("\r\n");
+                result.Append("Content-Length: ").Append(mContentLength).Append("\r\n");
 
                 if (mEncoding) {
-                    result += "Content-Encoding: " + mEncoding->Name() + "\r\n";
+                    result.Append("Content-Encoding: ").Append(mEncoding->Name()).Append("\r\n");
                 }
 
                 for_each(begin(mCookies), end(mCookies), [&result](const CookiePair& pair) {
-                    result += "Set-Cookie: " + pair.second->ToString() + "\r\n";
+                    result.Append("Set-Cookie: ").Append(pair.second->ToString()).Append("\r\n");
                 });
 
                 for_each(begin(mHeaders), end(mHeaders), [&result](const NameValuePair& pair) {
-                    result += pair.first + ": " + pair.second + "\r\n";
+                    result.Append(pair.first).Append(": ").Append(pair.second).Append("\r\n");
                 });
             } else {
-                result += "302 " + StatusToString(302) + "\r\n";
-                result += "Location: " + mHeaders.at("Location") + "\r\n";
+                result.Append("302 ").Append(StatusToString(302)).Append("\r\n");
+                result.Append("Location: ").Append(mHeaders.at("Location")).Append("\r\n");
             }
 
-            return (result + "\r\n");
+            return result.Append("\r\n").ToString();
         }
 
         bool HttpListenerResponse::ValidStatusCode(int32_t value)
@@ -21,335 +21,629 @@
  * THE SOFTWARE.
  */
 #include "Integer.h"
-#include <cstdio>
+#include "StringView.h"
+#include "Internal/StringBuffer.h"
 #include <cstring>
+#include <type_traits>
 
-#ifdef _MSC_VER
-#define snprintf _snprintf_s
-#define sscanf sscanf_s
-#endif
+using namespace std;
 
 namespace Lupus {
-    static const size_t sIntegerCount = 32;
+    static const char sDigitPairs[] =
+        "00010203040506070809"
+        "10111213141516171819"
+        "20212223242526272829"
+        "30313233343536373839"
+        "40414243444546474849"
+        "50515253545556575859"
+        "60616263646566676869"
+        "70717273747576777879"
+        "80818283848586878889"
+        "90919293949596979899";
+
+    static const char sHexDigits[] = "0123456789abcdef";
+
+    static inline size_t CountDigits(uint32_t value)
+    {
+        size_t count = 1;
+
+        for (;;) {
+            if (value < 10) {
+                return count;
+            } else if (value < 100) {
+                return count + 1;
+            } else if (value < 1000) {
+                return count + 2;
+            } else if (value < 10000) {
+                return count + 3;
+            }
+
+            value /= 10000;
+            count += 4;
+        }
+    }
 
-    String Integer::ToString(int8_t value, IntegerBase base)
+    //! Writes two digits per step from the back, so the digit count has
+    //! to be known first.
+    template <typename T, typename C>
+    static size_t WriteDecimal(T value, size_t length, C* buffer)
     {
-        char result[sIntegerCount];
-        memset(result, 0, sIntegerCount);
+        C* it = buffer + length;
 
-        switch (base) {
-            case IntegerBase::Decimal:
-                snprintf(result, sIntegerCount, ("%hhd"), value);
-                break;
-            case IntegerBase::Hexadecimal:
-                snprintf(result, sIntegerCount, ("%#hhx"), value);
-                break;
-            case IntegerBase::Octal:
-                snprintf(result, sIntegerCount, ("%#hho"), value);
-                break;
+        while (value >= 100) {
+            size_t pair = (size_t)(value % 100) * 2;
+            value /= 100;
+            *--it = (C)sDigitPairs[pair + 1];
+            *--it = (C)sDigitPairs[pair];
         }
-        return result;
+
+        if (value >= 10) {
+            size_t pair = (size_t)value * 2;
+            *--it = (C)sDigitPairs[pair + 1];
+            *--it = (C)sDigitPairs[pair];
+        } else {
+            *--it = (C)('0' + value);
+        }
+
+        return length;
     }
 
-    String Integer::ToString(short value, IntegerBase base)
+    template <typename C>
+    static size_t WriteDecimal(uint64_t value, C* buffer)
     {
-        char result[sIntegerCount];
-        memset(result, 0, sIntegerCount);
+        if (value <= 0xFFFFFFFFULL) {
+            return WriteDecimal((uint32_t)value, CountDigits((uint32_t)value), buffer);
+        }
 
-        switch (base) {
-            case IntegerBase::Decimal:
-                snprintf(result, sIntegerCount, ("%hd"), value);
-                break;
-            case IntegerBase::Hexadecimal:
-                snprintf(result, sIntegerCount, ("%#hx"), value);
-                break;
-            case IntegerBase::Octal:
-                snprintf(result, sIntegerCount, ("%#ho"), value);
-                break;
+        // Above 32 bits the value has 10 to 20 digits.
+        uint64_t high = value / 1000000000ULL;
+        size_t length = 9 + (high <= 0xFFFFFFFFULL ? CountDigits((uint32_t)high) : 9 + CountDigits((uint32_t)(high / 1000000000ULL)));
+        return WriteDecimal(value, length, buffer);
+    }
+
+    //! Hexadecimal and octal with the prefix of printf's '#' flag.
+    template <typename C>
+    static size_t WritePower(uint64_t value, unsigned shift, C* buffer)
+    {
+        uint64_t mask = (1ULL << shift) - 1;
+        size_t prefix = shift == 4 ? 2 : 1;
+        size_t length = 1;
+
+        if (value == 0) {
+            *buffer = (C)'0';
+            return 1;
         }
-        return result;
+
+        for (uint64_t rest = value >> shift; rest != 0; rest >>= shift) {
+            length++;
+        }
+
+        buffer[0] = (C)'0';
+
+        if (shift == 4) {
+            buffer[1] = (C)'x';
+        }
+
+        for (C* it = buffer + prefix + length; it != buffer + prefix; value >>= shift) {
+            *--it = (C)sHexDigits[value & mask];
+        }
+
+        return prefix + length;
     }
 
-    String Integer::ToString(int value, IntegerBase base)
+    //! Hexadecimal and octal show negative values in their two's complement,
+    //! like printf does.
+    template <typename T, typename C>
+    static size_t FormatInteger(T value, C* buffer, IntegerBase base)
     {
-        char result[sIntegerCount];
-        memset(result, 0, sIntegerCount);
+        typedef typename make_unsigned<T>::type Unsigned;
+        Unsigned bits = (Unsigned)value;
 
         switch (base) {
             case IntegerBase::Decimal:
-                snprintf(result, sIntegerCount, ("%d"), value);
-                break;
+                if (is_signed<T>::value && value < 0) {
+                    *buffer = (C)'-';
+                    return WriteDecimal((uint64_t)(Unsigned)(0 - bits), buffer + 1) + 1;
+                }
+
+                return WriteDecimal((uint64_t)bits, buffer);
             case IntegerBase::Hexadecimal:
-                snprintf(result, sIntegerCount, ("%#x"), value);
-                break;
+                return WritePower((uint64_t)bits, 4, buffer);
             case IntegerBase::Octal:
-                snprintf(result, sIntegerCount, ("%#o"), value);
-                break;
+                return WritePower((uint64_t)bits, 3, buffer);
         }
-        return result;
+
+        return 0;
     }
 
-    String Integer::ToString(long value, IntegerBase base)
+    //! Value of a digit in any base up to 16, or 16 for anything else.
+    static inline unsigned DigitValue(unsigned ch)
     {
-        char result[sIntegerCount];
-        memset(result, 0, sIntegerCount);
+        if (ch - '0' < 10) {
+            return ch - '0';
+        } else if ((ch | 0x20) - 'a' < 6) {
+            return (ch | 0x20) - 'a' + 10;
+        }
 
-        switch (base) {
-            case IntegerBase::Decimal:
-                snprintf(result, sIntegerCount, ("%ld"), value);
-                break;
-            case IntegerBase::Hexadecimal:
-                snprintf(result, sIntegerCount, ("%#lx"), value);
-                break;
-            case IntegerBase::Octal:
-                snprintf(result, sIntegerCount, ("%#lo"), value);
-                break;
+        return 16;
+    }
+
+    static inline unsigned Unit(char ch)
+    {
+        return (uint8_t)ch;
+    }
+
+    static inline unsigned Unit(Char ch)
+    {
+        return (unsigned)ch;
+    }
+
+    //! Reads eight decimal digits at once if all of them are digits.
+    static inline bool EightDigits(const char* data, uint64_t& value)
+    {
+        uint64_t word;
+        memcpy(&word, data, sizeof(word));
+
+        if (((word & 0xF0F0F0F0F0F0F0F0ULL) | (((word + 0x0606060606060606ULL) & 0xF0F0F0F0F0F0F0F0ULL) >> 4)) != 0x3333333333333333ULL) {
+            return false;
         }
-        return result;
+
+        // Pairs, then quadruples of digits are combined by multiplication.
+        word -= 0x3030303030303030ULL;
+        word = (word * 10) + (word >> 8);
+        value = (((word & 0x000000FF000000FFULL) * (100 + (1000000ULL << 32))) + (((word >> 16) & 0x000000FF000000FFULL) * (1 + (10000ULL << 32)))) >> 32;
+        return true;
     }
 
-    String Integer::ToString(long long value, IntegerBase base)
+    //! Same with four UTF-16 digits per word.
+    static inline bool FourDigits(const Char* data, uint64_t& value)
     {
-        char result[sIntegerCount];
-        memset(result, 0, sIntegerCount);
+        uint64_t word;
+        memcpy(&word, data, sizeof(word));
 
-        switch (base) {
-            case IntegerBase::Decimal:
-                snprintf(result, sIntegerCount, ("%lld"), value);
-                break;
-            case IntegerBase::Hexadecimal:
-                snprintf(result, sIntegerCount, ("%#llx"), value);
-                break;
-            case IntegerBase::Octal:
-                snprintf(result, sIntegerCount, ("%#llo"), value);
-                break;
+        if (((word & 0xFFF0FFF0FFF0FFF0ULL) | (((word + 0x0006000600060006ULL) & 0xFFF0FFF0FFF0FFF0ULL) >> 4)) != 0x0033003300330033ULL) {
+            return false;
         }
-        return result;
+
+        word -= 0x0030003000300030ULL;
+        word = (word * 10) + (word >> 16);
+        value = (word & 0xFFFF) * 100 + ((word >> 32) & 0xFFFF);
+        return true;
     }
 
-    String Integer::ToString(uint8_t value, IntegerBase base)
+    static inline bool EightDigits(const Char* data, uint64_t& value)
     {
-        char result[sIntegerCount];
-        memset(result, 0, sIntegerCount);
+        uint64_t high, low;
 
-        switch (base) {
-            case IntegerBase::Decimal:
-                snprintf(result, sIntegerCount, ("%hhu"), value);
-                break;
-            case IntegerBase::Hexadecimal:
-                snprintf(result, sIntegerCount, ("%#hhx"), value);
-                break;
-            case IntegerBase::Octal:
-                snprintf(result, sIntegerCount, ("%#hho"), value);
-                break;
+        if (sizeof(Char) != 2 || !FourDigits(data, high) || !FourDigits(data + 4, low)) {
+            return false;
         }
-        return result;
+
+        value = high * 10000 + low;
+        return true;
     }
 
-    String Integer::ToString(unsigned short value, IntegerBase base)
+    /**
+     * Reads the digits at the start of data and returns how many were
+     * read. Decimal input is consumed eight digits at a time while the
+     * value cannot overflow yet; overflow sets the flag but still consumes
+     * the remaining digits.
+     */
+    template <typename C>
+    static size_t ParseDigits(const C* data, size_t length, IntegerBase base, uint64_t& value, bool& overflow)
     {
-        char result[sIntegerCount];
-        memset(result, 0, sIntegerCount);
+        uint64_t result = 0;
+        size_t i = 0;
 
-        switch (base) {
-            case IntegerBase::Decimal:
-                snprintf(result, sIntegerCount, ("%hu"), value);
-                break;
-            case IntegerBase::Hexadecimal:
-                snprintf(result, sIntegerCount, ("%#hx"), value);
-                break;
-            case IntegerBase::Octal:
-                snprintf(result, sIntegerCount, ("%#ho"), value);
-                break;
+        overflow = false;
+
+        if (base == IntegerBase::Decimal) {
+            uint64_t eight;
+
+            while (i <= 8 && i + 8 <= length && EightDigits(data + i, eight)) {
+                result = result * 100000000 + eight;
+                i += 8;
+            }
+
+            for (; i < length; i++) {
+                unsigned digit = Unit(data[i]) - '0';
+
+                if (digit > 9) {
+                    break;
+                } else if (result > 1844674407370955161ULL || (result == 1844674407370955161ULL && digit > 5)) {
+                    overflow = true;
+                }
+
+                result = result * 10 + digit;
+            }
+        } else {
+            unsigned shift = base == IntegerBase::Hexadecimal ? 4 : 3;
+
+            for (; i < length; i++) {
+                unsigned digit = DigitValue(Unit(data[i]));
+
+                if (digit >= (1u << shift)) {
+                    break;
+                } else if (result >> (64 - shift)) {
+                    overflow = true;
+                }
+
+                result = (result << shift) | digit;
+            }
         }
-        return result;
+
+        value = result;
+        return i;
     }
 
-    String Integer::ToString(unsigned int value, IntegerBase base)
+    template <typename T, typename C>
+    static size_t ParseValue(const C* data, size_t length, bool negative, T& result, IntegerBase base)
     {
-        char result[sIntegerCount];
-        memset(result, 0, sIntegerCount);
+        typedef typename make_unsigned<T>::type Unsigned;
+        uint64_t limit = (Unsigned)~(Unsigned)0;
+        uint64_t value = 0;
+        bool overflow = false;
+        size_t count = ParseDigits(data, length, base, value, overflow);
+
+        if (base == IntegerBase::Decimal && is_signed<T>::value) {
+            limit = negative ? limit / 2 + 1 : limit / 2;
+        } else if (base == IntegerBase::Decimal && negative) {
+            limit = 0;
+        }
 
-        switch (base) {
-            case IntegerBase::Decimal:
-                snprintf(result, sIntegerCount, ("%u"), value);
-                break;
-            case IntegerBase::Hexadecimal:
-                snprintf(result, sIntegerCount, ("%#x"), value);
-                break;
-            case IntegerBase::Octal:
-                snprintf(result, sIntegerCount, ("%#o"), value);
-                break;
+        if (count == 0 || overflow || value > limit) {
+            return 0;
         }
-        return result;
+
+        result = (T)(Unsigned)(negative ? 0 - value : value);
+        return count;
     }
 
-    String Integer::ToString(unsigned long value, IntegerBase base)
+    template <typename T, typename C>
+    static size_t ParseStrict(const C* data, size_t length, T& result, IntegerBase base)
     {
-        char result[sIntegerCount];
-        memset(result, 0, sIntegerCount);
+        size_t sign = length > 0 && Unit(data[0]) == '-' ? 1 : 0;
+        size_t count = ParseValue(data + sign, length - sign, sign == 1, result, base);
+        return count > 0 ? sign + count : 0;
+    }
 
-        switch (base) {
-            case IntegerBase::Decimal:
-                snprintf(result, sIntegerCount, ("%lu"), value);
-                break;
-            case IntegerBase::Hexadecimal:
-                snprintf(result, sIntegerCount, ("%#lx"), value);
-                break;
-            case IntegerBase::Octal:
-                snprintf(result, sIntegerCount, ("%#lo"), value);
-                break;
+    //! Accepts what sscanf accepts for the base's conversion.
+    template <typename T, typename C>
+    static bool ParseLenient(const C* data, size_t length, T& result, IntegerBase base)
+    {
+        size_t i = 0;
+        bool negative = false;
+
+        while (i < length && (Unit(data[i]) == ' ' || Unit(data[i]) - '\t' < 5)) {
+            i++;
         }
-        return result;
+
+        if (i < length && (Unit(data[i]) == '+' || Unit(data[i]) == '-')) {
+            negative = Unit(data[i++]) == '-';
+        }
+
+        if (base == IntegerBase::Hexadecimal && i + 2 < length && Unit(data[i]) == '0' && (Unit(data[i + 1]) | 0x20) == 'x' && DigitValue(Unit(data[i + 2])) < 16) {
+            i += 2;
+        }
+
+        return ParseValue(data + i, length - i, negative, result, base) > 0;
+    }
+
+    template <typename T>
+    static String IntegerToString(T value, IntegerBase base)
+    {
+        Char result[Integer::MaxLength];
+        return StringView(result, FormatInteger(value, result, base)).ToString();
+    }
+
+    String Integer::ToString(int8_t value, IntegerBase base)
+    {
+        return IntegerToString(value, base);
+    }
+
+    String Integer::ToString(short value, IntegerBase base)
+    {
+        return IntegerToString(value, base);
+    }
+
+    String Integer::ToString(int value, IntegerBase base)
+    {
+        return IntegerToString(value, base);
+    }
+
+    String Integer::ToString(long value, IntegerBase base)
+    {
+        return IntegerToString(value, base);
+    }
+
+    String Integer::ToString(long long value, IntegerBase base)
+    {
+        return IntegerToString(value, base);
+    }
+
+    String Integer::ToString(uint8_t value, IntegerBase base)
+    {
+        return IntegerToString(value, base);
+    }
+
+    String Integer::ToString(unsigned short value, IntegerBase base)
+    {
+        return IntegerToString(value, base);
+    }
+
+    String Integer::ToString(unsigned int value, IntegerBase base)
+    {
+        return IntegerToString(value, base);
+    }
+
+    String Integer::ToString(unsigned long value, IntegerBase base)
+    {
+        return IntegerToString(value, base);
     }
 
     String Integer::ToString(unsigned long long value, IntegerBase base)
     {
-        char result[sIntegerCount];
-        memset(result, 0, sIntegerCount);
+        return IntegerToString(value, base);
+    }
 
-        switch (base) {
-            case IntegerBase::Decimal:
-                snprintf(result, sIntegerCount, ("%llu"), value);
-                break;
-            case IntegerBase::Hexadecimal:
-                snprintf(result, sIntegerCount, ("%#llx"), value);
-                break;
-            case IntegerBase::Octal:
-                snprintf(result, sIntegerCount, ("%#llo"), value);
-                break;
-        }
-        return result;
+    size_t Integer::FormatTo(int8_t value, Char* buffer, IntegerBase base)
+    {
+        return FormatInteger(value, buffer, base);
+    }
+
+    size_t Integer::FormatTo(int8_t value, uint8_t* buffer, IntegerBase base)
+    {
+        return FormatInteger(value, buffer, base);
+    }
+
+    size_t Integer::FormatTo(short value, Char* buffer, IntegerBase base)
+    {
+        return FormatInteger(value, buffer, base);
+    }
+
+    size_t Integer::FormatTo(short value, uint8_t* buffer, IntegerBase base)
+    {
+        return FormatInteger(value, buffer, base);
+    }
+
+    size_t Integer::FormatTo(int value, Char* buffer, IntegerBase base)
+    {
+        return FormatInteger(value, buffer, base);
+    }
+
+    size_t Integer::FormatTo(int value, uint8_t* buffer, IntegerBase base)
+    {
+        return FormatInteger(value, buffer, base);
+    }
+
+    size_t Integer::FormatTo(long value, Char* buffer, IntegerBase base)
+    {
+        return FormatInteger(value, buffer, base);
+    }
+
+    size_t Integer::FormatTo(long value, uint8_t* buffer, IntegerBase base)
+    {
+        return FormatInteger(value, buffer, base);
+    }
+
+    size_t Integer::FormatTo(long long value, Char* buffer, IntegerBase base)
+    {
+        return FormatInteger(value, buffer, base);
+    }
+
+    size_t Integer::FormatTo(long long value, uint8_t* buffer, IntegerBase base)
+    {
+        return FormatInteger(value, buffer, base);
+    }
+
+    size_t Integer::FormatTo(uint8_t value, Char* buffer, IntegerBase base)
+    {
+        return FormatInteger(value, buffer, base);
+    }
+
+    size_t Integer::FormatTo(uint8_t value, uint8_t* buffer, IntegerBase base)
+    {
+        return FormatInteger(value, buffer, base);
+    }
+
+    size_t Integer::FormatTo(unsigned short value, Char* buffer, IntegerBase base)
+    {
+        return FormatInteger(value, buffer, base);
+    }
+
+    size_t Integer::FormatTo(unsigned short value, uint8_t* buffer, IntegerBase base)
+    {
+        return FormatInteger(value, buffer, base);
+    }
+
+    size_t Integer::FormatTo(unsigned int value, Char* buffer, IntegerBase base)
+    {
+        return FormatInteger(value, buffer, base);
+    }
+
+    size_t Integer::FormatTo(unsigned int value, uint8_t* buffer, IntegerBase base)
+    {
+        return FormatInteger(value, buffer, base);
+    }
+
+    size_t Integer::FormatTo(unsigned long value, Char* buffer, IntegerBase base)
+    {
+        return FormatInteger(value, buffer, base);
+    }
+
+    size_t Integer::FormatTo(unsigned long value, uint8_t* buffer, IntegerBase base)
+    {
+        return FormatInteger(value, buffer, base);
+    }
+
+    size_t Integer::FormatTo(unsigned long long value, Char* buffer, IntegerBase base)
+    {
+        return FormatInteger(value, buffer, base);
+    }
+
+    size_t Integer::FormatTo(unsigned long long value, uint8_t* buffer, IntegerBase base)
+    {
+        return FormatInteger(value, buffer, base);
     }
 
     bool Integer::TryParse(const String& str, int8_t& result, IntegerBase base)
     {
-        switch (base) {
-            case IntegerBase::Decimal:
-                return (sscanf(str.ToUTF8().c_str(), ("%hhd"), &result) == 1);
-            case IntegerBase::Hexadecimal:
-                return (sscanf(str.ToUTF8().c_str(), ("%hhx"), &result) == 1);
-            case IntegerBase::Octal:
-                return (sscanf(str.ToUTF8().c_str(), ("%hho"), &result) == 1);
-        }
-        return false;
+        StringChars chars(str);
+        return ParseLenient(chars.Data(), str.Length(), result, base);
     }
 
     bool Integer::TryParse(const String& str, short& result, IntegerBase base)
     {
-        switch (base) {
-            case IntegerBase::Decimal:
-                return (sscanf(str.ToUTF8().c_str(), ("%hd"), &result) == 1);
-            case IntegerBase::Hexadecimal:
-                return (sscanf(str.ToUTF8().c_str(), ("%hx"), &result) == 1);
-            case IntegerBase::Octal:
-                return (sscanf(str.ToUTF8().c_str(), ("%ho"), &result) == 1);
-        }
-        return false;
+        StringChars chars(str);
+        return ParseLenient(chars.Data(), str.Length(), result, base);
     }
 
     bool Integer::TryParse(const String& str, int& result, IntegerBase base)
     {
-        switch (base) {
-            case IntegerBase::Decimal:
-                return (sscanf(str.ToUTF8().c_str(), ("%d"), &result) == 1);
-            case IntegerBase::Hexadecimal:
-                return (sscanf(str.ToUTF8().c_str(), ("%x"), &result) == 1);
-            case IntegerBase::Octal:
-                return (sscanf(str.ToUTF8().c_str(), ("%o"), &result) == 1);
-        }
-        return false;
+        StringChars chars(str);
+        return ParseLenient(chars.Data(), str.Length(), result, base);
     }
 
     bool Integer::TryParse(const String& str, long& result, IntegerBase base)
     {
-        switch (base) {
-            case IntegerBase::Decimal:
-                return (sscanf(str.ToUTF8().c_str(), ("%ld"), &result) == 1);
-            case IntegerBase::Hexadecimal:
-                return (sscanf(str.ToUTF8().c_str(), ("%lx"), &result) == 1);
-            case IntegerBase::Octal:
-                return (sscanf(str.ToUTF8().c_str(), ("%lo"), &result) == 1);
-        }
-        return false;
+        StringChars chars(str);
+        return ParseLenient(chars.Data(), str.Length(), result, base);
     }
 
     bool Integer::TryParse(const String& str, long long& result, IntegerBase base)
     {
-        switch (base) {
-            case IntegerBase::Decimal:
-                return (sscanf(str.ToUTF8().c_str(), ("%lld"), &result) == 1);
-            case IntegerBase::Hexadecimal:
-                return (sscanf(str.ToUTF8().c_str(), ("%llx"), &result) == 1);
-            case IntegerBase::Octal:
-                return (sscanf(str.ToUTF8().c_str(), ("%llo"), &result) == 1);
-        }
-        return false;
+        StringChars chars(str);
+        return ParseLenient(chars.Data(), str.Length(), result, base);
     }
 
     bool Integer::TryParse(const String& str, uint8_t& result, IntegerBase base)
     {
-        switch (base) {
-            case IntegerBase::Decimal:
-                return (sscanf(str.ToUTF8().c_str(), ("%hhu"), &result) == 1);
-            case IntegerBase::Hexadecimal:
-                return (sscanf(str.ToUTF8().c_str(), ("%hhx"), &result) == 1);
-            case IntegerBase::Octal:
-                return (sscanf(str.ToUTF8().c_str(), ("%hho"), &result) == 1);
-        }
-        return false;
+        StringChars chars(str);
+        return ParseLenient(chars.Data(), str.Length(), result, base);
     }
 
     bool Integer::TryParse(const String& str, unsigned short& result, IntegerBase base)
     {
-        switch (base) {
-            case IntegerBase::Decimal:
-                return (sscanf(str.ToUTF8().c_str(), ("%hu"), &result) == 1);
-            case IntegerBase::Hexadecimal:
-                return (sscanf(str.ToUTF8().c_str(), ("%hx"), &result) == 1);
-            case IntegerBase::Octal:
-                return (sscanf(str.ToUTF8().c_str(), ("%ho"), &result) == 1);
-        }
-        return false;
+        StringChars chars(str);
+        return ParseLenient(chars.Data(), str.Length(), result, base);
     }
 
     bool Integer::TryParse(const String& str, unsigned int& result, IntegerBase base)
     {
-        switch (base) {
-            case IntegerBase::Decimal:
-                return (sscanf(str.ToUTF8().c_str(), ("%u"), &result) == 1);
-            case IntegerBase::Hexadecimal:
-                return (sscanf(str.ToUTF8().c_str(), ("%x"), &result) == 1);
-            case IntegerBase::Octal:
-                return (sscanf(str.ToUTF8().c_str(), ("%o"), &result) == 1);
-        }
-        return false;
+        StringChars chars(str);
+        return ParseLenient(chars.Data(), str.Length(), result, base);
     }
 
     bool Integer::TryParse(const String& str, unsigned long& result, IntegerBase base)
     {
-        switch (base) {
-            case IntegerBase::Decimal:
-                return (sscanf(str.ToUTF8().c_str(), ("%lu"), &result) == 1);
-            case IntegerBase::Hexadecimal:
-                return (sscanf(str.ToUTF8().c_str(), ("%lx"), &result) == 1);
-            case IntegerBase::Octal:
-                return (sscanf(str.ToUTF8().c_str(), ("%lo"), &result) == 1);
-        }
-        return false;
+        StringChars chars(str);
+        return ParseLenient(chars.Data(), str.Length(), result, base);
     }
 
     bool Integer::TryParse(const String& str, unsigned long long& result, IntegerBase base)
     {
-        switch (base) {
-            case IntegerBase::Decimal:
-                return (sscanf(str.ToUTF8().c_str(), ("%llu"), &result) == 1);
-            case IntegerBase::Hexadecimal:
-                return (sscanf(str.ToUTF8().c_str(), ("%llx"), &result) == 1);
-            case IntegerBase::Octal:
-                return (sscanf(str.ToUTF8().c_str(), ("%llo"), &result) == 1);
-        }
-        return false;
+        StringChars chars(str);
+        return ParseLenient(chars.Data(), str.Length(), result, base);
+    }
+
+    size_t Integer::FromChars(const Char* first, const Char* last, int8_t& result, IntegerBase base)
+    {
+        return ParseStrict(first, (size_t)(last - first), result, base);
+    }
+
+    size_t Integer::FromChars(const char* first, const char* last, int8_t& result, IntegerBase base)
+    {
+        return ParseStrict(first, (size_t)(last - first), result, base);
+    }
+
+    size_t Integer::FromChars(const Char* first, const Char* last, short& result, IntegerBase base)
+    {
+        return ParseStrict(first, (size_t)(last - first), result, base);
+    }
+
+    size_t Integer::FromChars(const char* first, const char* last, short& result, IntegerBase base)
+    {
+        return ParseStrict(first, (size_t)(last - first), result, base);
+    }
+
+    size_t Integer::FromChars(const Char* first, const Char* last, int& result, IntegerBase base)
+    {
+        return ParseStrict(first, (size_t)(last - first), result, base);
+    }
+
+    size_t Integer::FromChars(const char* first, const char* last, int& result, IntegerBase base)
+    {
+        return ParseStrict(first, (size_t)(last - first), result, base);
+    }
+
+    size_t Integer::FromChars(const Char* first, const Char* last, long& result, IntegerBase base)
+    {
+        return ParseStrict(first, (size_t)(last - first), result, base);
+    }
+
+    size_t Integer::FromChars(const char* first, const char* last, long& result, IntegerBase base)
+    {
+        return ParseStrict(first, (size_t)(last - first), result, base);
+    }
+
+    size_t Integer::FromChars(const Char* first, const Char* last, long long& result, IntegerBase base)
+    {
+        return ParseStrict(first, (size_t)(last - first), result, base);
+    }
+
+    size_t Integer::FromChars(const char* first, const char* last, long long& result, IntegerBase base)
+    {
+        return ParseStrict(first, (size_t)(last - first), result, base);
+    }
+
+    size_t Integer::FromChars(const Char* first, const Char* last, uint8_t& result, IntegerBase base)
+    {
+        return ParseStrict(first, (size_t)(last - first), result, base);
+    }
+
+    size_t Integer::FromChars(const char* first, const char* last, uint8_t& result, IntegerBase base)
+    {
+        return ParseStrict(first, (size_t)(last - first), result, base);
+    }
+
+    size_t Integer::FromChars(const Char* first, const Char* last, unsigned short& result, IntegerBase base)
+    {
+        return ParseStrict(first, (size_t)(last - first), result, base);
+    }
+
+    size_t Integer::FromChars(const char* first, const char* last, unsigned short& result, IntegerBase base)
+    {
+        return ParseStrict(first, (size_t)(last - first), result, base);
+    }
+
+    size_t Integer::FromChars(const Char* first, const Char* last, unsigned int& result, IntegerBase base)
+    {
+        return ParseStrict(first, (size_t)(last - first), result, base);
+    }
+
+    size_t Integer::FromChars(const char* first, const char* last, unsigned int& result, IntegerBase base)
+    {
+        return ParseStrict(first, (size_t)(last - first), result, base);
+    }
+
+    size_t Integer::FromChars(const Char* first, const Char* last, unsigned long& result, IntegerBase base)
+    {
+        return ParseStrict(first, (size_t)(last - first), result, base);
+    }
+
+    size_t Integer::FromChars(const char* first, const char* last, unsigned long& result, IntegerBase base)
+    {
+        return ParseStrict(first, (size_t)(last - first), result, base);
+    }
+
+    size_t Integer::FromChars(const Char* first, const Char* last, unsigned long long& result, IntegerBase base)
+    {
+        return ParseStrict(first, (size_t)(last - first), result, base);
+    }
+
+    size_t Integer::FromChars(const char* first, const char* last, unsigned long long& result, IntegerBase base)
+    {
+        return ParseStrict(first, (size_t)(last - first), result, base);
     }
 
     int8_t Integer::ParseByte(const String& str, IntegerBase base)
@@ -37,6 +37,9 @@ namespace Lupus {
     class LUPUSCORE_API Integer
 	{
 	public:
+		//! Höchstanzahl der Zeichen, die Integer::FormatTo schreibt.
+		static const size_t MaxLength = 23;
+
 		//! \sa Integer::ToString(int, IntegerBase)
 		static String ToString(int8_t value, IntegerBase base = IntegerBase::Decimal) NOEXCEPT;
 		//! \sa Integer::ToString(int, IntegerBase)
@@ -63,13 +66,64 @@ namespace Lupus {
         static String ToString(unsigned long value, IntegerBase base = IntegerBase::Decimal) NOEXCEPT;
 		//! \sa Integer::ToString(int, IntegerBase)
         static String ToString(unsigned long long value, IntegerBase base = IntegerBase::Decimal) NOEXCEPT;
+		//! \sa Integer::FormatTo(int, Char*, IntegerBase)
+        static size_t FormatTo(int8_t value, Char* buffer, IntegerBase base = IntegerBase::Decimal) NOEXCEPT;
+		//! \sa Integer::FormatTo(int, Char*, IntegerBase)
+        static size_t FormatTo(int8_t value, uint8_t* buffer, IntegerBase base = IntegerBase::Decimal) NOEXCEPT;
+		//! \sa Integer::FormatTo(int, Char*, IntegerBase)
+        static size_t FormatTo(short value, Char* buffer, IntegerBase base = IntegerBase::Decimal) NOEXCEPT;
+		//! \sa Integer::FormatTo(int, Char*, IntegerBase)
+        static size_t FormatTo(short value, uint8_t* buffer, IntegerBase base = IntegerBase::Decimal) NOEXCEPT;
+		/**
+		 * Schreibt eine Ganzzahl ohne Nullterminierung in einen Puffer.
+		 * Genau wie ToString, aber ohne eine Zeichenkette anzulegen.
+		 *
+		 * \param[in] value Ganzzahl für die Konvertierung
+		 * \param[out] buffer Puffer mit Platz für Integer::MaxLength Zeichen
+		 * \param[in] base Basis der Ganzzahl (8, 10, 16)
+		 * \returns Anzahl der geschriebenen Zeichen
+		 */
+        static size_t FormatTo(int value, Char* buffer, IntegerBase base = IntegerBase::Decimal) NOEXCEPT;
+		//! \sa Integer::FormatTo(int, Char*, IntegerBase)
+        static size_t FormatTo(int value, uint8_t* buffer, IntegerBase base = IntegerBase::Decimal) NOEXCEPT;
+		//! \sa Integer::FormatTo(int, Char*, IntegerBase)
+        static size_t FormatTo(long value, Char* buffer, IntegerBase base = IntegerBase::Decimal) NOEXCEPT;
+		//! \sa Integer::FormatTo(int, Char*, IntegerBase)
+        static size_t FormatTo(long value, uint8_t* buffer, IntegerBase base = IntegerBase::Decimal) NOEXCEPT;
+		//! \sa Integer::FormatTo(int, Char*, IntegerBase)
+        static size_t FormatTo(long long value, Char* buffer, IntegerBase base = IntegerBase::Decimal) NOEXCEPT;
+		//! \sa Integer::FormatTo(int, Char*, IntegerBase)
+        static size_t FormatTo(long long value, uint8_t* buffer, IntegerBase base = IntegerBase::Decimal) NOEXCEPT;
+		//! \sa Integer::FormatTo(int, Char*, IntegerBase)
+        static size_t FormatTo(uint8_t value, Char* buffer, IntegerBase base = IntegerBase::Decimal) NOEXCEPT;
+		//! \sa Integer::FormatTo(int, Char*, IntegerBase)
+        static size_t FormatTo(uint8_t value, uint8_t* buffer, IntegerBase base = IntegerBase::Decimal) NOEXCEPT;
+		//! \sa Integer::FormatTo(int, Char*, IntegerBase)
+        static size_t FormatTo(unsigned short value, Char* buffer, IntegerBase base = IntegerBase::Decimal) NOEXCEPT;
+		//! \sa Integer::FormatTo(int, Char*, IntegerBase)
+        static size_t FormatTo(unsigned short value, uint8_t* buffer, IntegerBase base = IntegerBase::Decimal) NOEXCEPT;
+		//! \sa Integer::FormatTo(int, Char*, IntegerBase)
+        static size_t FormatTo(unsigned int value, Char* buffer, IntegerBase base = IntegerBase::Decimal) NOEXCEPT;
+		//! \sa Integer::FormatTo(int, Char*, IntegerBase)
+        static size_t FormatTo(unsigned int value, uint8_t* buffer, IntegerBase base = IntegerBase::Decimal) NOEXCEPT;
+		//! \sa Integer::FormatTo(int, Char*, IntegerBase)
+        static size_t FormatTo(unsigned long value, Char* buffer, IntegerBase base = IntegerBase::Decimal) NOEXCEPT;
+		//! \sa Integer::FormatTo(int, Char*, IntegerBase)
+        static size_t FormatTo(unsigned long value, uint8_t* buffer, IntegerBase base = IntegerBase::Decimal) NOEXCEPT;
+		//! \sa Integer::FormatTo(int, Char*, IntegerBase)
+        static size_t FormatTo(unsigned long long value, Char* buffer, IntegerBase base = IntegerBase::Decimal) NOEXCEPT;
+		//! \sa Integer::FormatTo(int, Char*, IntegerBase)
+        static size_t FormatTo(unsigned long long value, uint8_t* buffer, IntegerBase base = IntegerBase::Decimal) NOEXCEPT;
 		//! \sa Integer::TryParse(const String&, int, IntegerBase)
         static bool TryParse(const String& string, int8_t& result, IntegerBase base = IntegerBase::Decimal) NOEXCEPT;
 		//! \sa Integer::TryParse(const String&, int, IntegerBase)
         static bool TryParse(const String& string, short& result, IntegerBase base = IntegerBase::Decimal) NOEXCEPT;
 		/**
 		 * Versucht eine Zeichenkette zu ihrer entsprechenden Ganzzahl zu 
-		 * konvertieren.
+		 * konvertieren. Führender Leerraum, ein Vorzeichen und bei Basis 16
+		 * das Präfix "0x" werden übersprungen, Zeichen nach der Zahl
+		 * ignoriert. Werte außerhalb des Typs schlagen fehl; bei Basis 8
+		 * und 16 gilt das Zweierkomplement wie bei ToString.
 		 *
 		 * \param[in] String Zeichenkette die konvertiert werden soll.
 		 * \param[out] result Variable in der das Ergebnis gespeichert wird.
@@ -93,6 +147,60 @@ namespace Lupus {
 		//! \sa Integer::TryParse(const String&, int, IntegerBase)
         static bool TryParse(const String& string, unsigned long long& result, IntegerBase base = IntegerBase::Decimal) NOEXCEPT;
 
+		//! \sa Integer::FromChars(const Char*, const Char*, int&, IntegerBase)
+        static size_t FromChars(const Char* first, const Char* last, int8_t& result, IntegerBase base = IntegerBase::Decimal) NOEXCEPT;
+		//! \sa Integer::FromChars(const Char*, const Char*, int&, IntegerBase)
+        static size_t FromChars(const char* first, const char* last, int8_t& result, IntegerBase base = IntegerBase::Decimal) NOEXCEPT;
+		//! \sa Integer::FromChars(const Char*, const Char*, int&, IntegerBase)
+        static size_t FromChars(const Char* first, const Char* last, short& result, IntegerBase base = IntegerBase::Decimal) NOEXCEPT;
+		//! \sa Integer::FromChars(const Char*, const Char*, int&, IntegerBase)
+        static size_t FromChars(const char* first, const char* last, short& result, IntegerBase base = IntegerBase::Decimal) NOEXCEPT;
+		/**
+		 * Liest eine Ganzzahl am Anfang von [first, last), ähnlich wie
+		 * std::from_chars. Anders als TryParse werden kein Leerraum, kein
+		 * '+' und kein Präfix "0x" akzeptiert; danach folgende Zeichen
+		 * werden nicht gelesen.
+		 *
+		 * \param[in] first Erstes Zeichen
+		 * \param[in] last Ende der Zeichen
+		 * \param[out] result Variable in der das Ergebnis gespeichert wird.
+		 * \param[in] base Basis der Ganzzahl (8, 10, 16)
+		 * \returns Anzahl der gelesenen Zeichen. 0 wenn keine Ganzzahl
+		 *          gefunden wurde oder sie nicht in den Typ passt; result
+		 *          bleibt dann unverändert.
+		 */
+        static size_t FromChars(const Char* first, const Char* last, int& result, IntegerBase base = IntegerBase::Decimal) NOEXCEPT;
+		//! \sa Integer::FromChars(const Char*, const Char*, int&, IntegerBase)
+        static size_t FromChars(const char* first, const char* last, int& result, IntegerBase base = IntegerBase::Decimal) NOEXCEPT;
+		//! \sa Integer::FromChars(const Char*, const Char*, int&, IntegerBase)
+        static size_t FromChars(const Char* first, const Char* last, long& result, IntegerBase base = IntegerBase::Decimal) NOEXCEPT;
+		//! \sa Integer::FromChars(const Char*, const Char*, int&, IntegerBase)
+        static size_t FromChars(const char* first, const char* last, long& result, IntegerBase base = IntegerBase::Decimal) NOEXCEPT;
+		//! \sa Integer::FromChars(const Char*, const Char*, int&, IntegerBase)
+        static size_t FromChars(const Char* first, const Char* last, long long& result, IntegerBase base = IntegerBase::Decimal) NOEXCEPT;
+		//! \sa Integer::FromChars(const Char*, const Char*, int&, IntegerBase)
+        static size_t FromChars(const char* first, const char* last, long long& result, IntegerBase base = IntegerBase::Decimal) NOEXCEPT;
+		//! \sa Integer::FromChars(const Char*, const Char*, int&, IntegerBase)
+        static size_t FromChars(const Char* first, const Char* last, uint8_t& result, IntegerBase base = IntegerBase::Decimal) NOEXCEPT;
+		//! \sa Integer::FromChars(const Char*, const Char*, int&, IntegerBase)
+        static size_t FromChars(const char* first, const char* last, uint8_t& result, IntegerBase base = IntegerBase::Decimal) NOEXCEPT;
+		//! \sa Integer::FromChars(const Char*, const Char*, int&, IntegerBase)
+        static size_t FromChars(const Char* first, const Char* last, unsigned short& result, IntegerBase base = IntegerBase::Decimal) NOEXCEPT;
+		//! \sa Integer::FromChars(const Char*, const Char*, int&, IntegerBase)
+        static size_t FromChars(const char* first, const char* last, unsigned short& result, IntegerBase base = IntegerBase::Decimal) NOEXCEPT;
+		//! \sa Integer::FromChars(const Char*, const Char*, int&, IntegerBase)
+        static size_t FromChars(const Char* first, const Char* last, unsigned int& result, IntegerBase base = IntegerBase::Decimal) NOEXCEPT;
+		//! \sa Integer::FromChars(const Char*, const Char*, int&, IntegerBase)
+        static size_t FromChars(const char* first, const char* last, unsigned int& result, IntegerBase base = IntegerBase::Decimal) NOEXCEPT;
+		//! \sa Integer::FromChars(const Char*, const Char*, int&, IntegerBase)
+        static size_t FromChars(const Char* first, const Char* last, unsigned long& result, IntegerBase base = IntegerBase::Decimal) NOEXCEPT;
+		//! \sa Integer::FromChars(const Char*, const Char*, int&, IntegerBase)
+        static size_t FromChars(const char* first, const char* last, unsigned long& result, IntegerBase base = IntegerBase::Decimal) NOEXCEPT;
+		//! \sa Integer::FromChars(const Char*, const Char*, int&, IntegerBase)
+        static size_t FromChars(const Char* first, const Char* last, unsigned long long& result, IntegerBase base = IntegerBase::Decimal) NOEXCEPT;
+		//! \sa Integer::FromChars(const Char*, const Char*, int&, IntegerBase)
+        static size_t FromChars(const char* first, const char* last, unsigned long long& result, IntegerBase base = IntegerBase::Decimal) NOEXCEPT;
+
         static int8_t ParseByte(const String& string, IntegerBase base = IntegerBase::Decimal) throw(std::invalid_argument);
         static short ParseShort(const String& string, IntegerBase base = IntegerBase::Decimal) throw(std::invalid_argument);
         static int ParseInt(const String& string, IntegerBase base = IntegerBase::Decimal) throw(std::invalid_argument);
@@ -0,0 +1,61 @@
+/**
+ * Copyright (C) 2014 David Wolf <d.wolf@live.at>
+ *
+ * This file is part of Lupus.
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#pragma once
+
+#include "../String.h"
+
+namespace Lupus {
+    namespace Text {
+        /**
+         * Vectorized kernels over UTF-16 code units. SSE2 or AVX2 kernels
+         * are chosen at runtime; other targets use a scalar loop. The
+         * searches compare code units only and know nothing of surrogate
+         * pairs. They return nullptr when nothing matches.
+         */
+        const Char* FindChar(const Char* data, size_t length, Char ch);
+        const Char* FindLastChar(const Char* data, size_t length, Char ch);
+        const Char* FindAnyChar(const Char* data, size_t length, const Char* chars, size_t count);
+        const Char* FindLastAnyChar(const Char* data, size_t length, const Char* chars, size_t count);
+
+        /**
+         * Finds str by filtering candidates on its first and last code unit
+         * and comparing the rest only where both match. Meant for short
+         * needles; Text::Searcher picks an algorithm by needle length.
+         */
+        const Char* FindString(const Char* data, size_t length, const Char* str, size_t size);
+
+        //! True if no code unit is above 0x7F.
+        bool IsAscii(const Char* data, size_t length);
+        //! Maps A-Z to a-z and copies everything else; dst may equal src.
+        void ToLowerAscii(Char* dst, const Char* src, size_t length);
+        //! Maps a-z to A-Z and copies everything else; dst may equal src.
+        void ToUpperAscii(Char* dst, const Char* src, size_t length);
+
+        /**
+         * Compares with ASCII case folding up to the first difference. Gives
+         * up and returns false if a non-ASCII code unit comes first, since
+         * full case folding may change lengths from there on.
+         */
+        bool CompareIgnoreCaseAscii(const Char* lhs, const Char* rhs, size_t length, int* result);
+    }
+}
@@ -0,0 +1,256 @@
+/**
+ * Copyright (C) 2014 David Wolf <d.wolf@live.at>
+ *
+ * This file is part of Lupus.
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#pragma once
+
+#include "../String.h"
+#include "../StringView.h"
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <new>
+
+namespace Lupus {
+    /**
+     * Heap storage of a string. Reference count, cached hash and ASCII flag,
+     * capacity and the null terminated characters are placed in a single
+     * allocation; the UTF-8 encoding is attached on first request. The
+     * count is atomic, so copies of one string may live on different
+     * threads. Whoever writes to a buffer in place must call Invalidate().
+     *
+     * Compact buffers hold text whose code units all fit into one byte as
+     * Latin-1 bytes instead of UTF-16. They are never written in place. A
+     * UTF-16 copy is attached by Widen(), which only the accessors handing
+     * out pointers call: String::Data(), the const operator[] and
+     * StringView(const String&). Everything else reads the bytes or goes
+     * through StringChars.
+     */
+    struct String::Buffer
+    {
+        //! States of the cached ASCII flag.
+        enum { AsciiUnknown, AsciiOnly, NotAscii };
+
+        //! Null terminated UTF-8 encoding of Data.
+        struct Utf8Cache
+        {
+            size_t Length;
+            char Data[1];
+        };
+
+        std::atomic<size_t> RefCount;
+        std::atomic<size_t> Hash;
+        std::atomic<int> Ascii;
+        bool Compact;
+        std::atomic<Utf8Cache*> Utf8;
+        std::atomic<Char*> Wide;
+        size_t Capacity;
+        Char Data[1];
+
+        //! Allocates room for capacity characters plus the terminator.
+        static Buffer* Create(size_t capacity)
+        {
+            return Allocate(capacity * sizeof(Char), false, capacity);
+        }
+
+        //! Allocates room for length Latin-1 bytes plus the terminator.
+        static Buffer* CreateCompact(size_t length)
+        {
+            return Allocate(length, true, length);
+        }
+
+        //! Latin-1 characters of a compact buffer.
+        uint8_t* Bytes()
+        {
+            return reinterpret_cast<uint8_t*>(Data);
+        }
+
+        const uint8_t* Bytes() const
+        {
+            return reinterpret_cast<const uint8_t*>(Data);
+        }
+
+        //! Heap bytes of the buffer without the attached caches.
+        size_t Size() const
+        {
+            return sizeof(Buffer) + (Compact ? Capacity : Capacity * sizeof(Char));
+        }
+
+        //! Copies count characters starting at offset as UTF-16.
+        void CopyTo(Char* dst, size_t offset, size_t count) const
+        {
+            if (Compact) {
+                const uint8_t* bytes = Bytes() + offset;
+
+                for (size_t i = 0; i < count; i++) {
+                    dst[i] = (Char)bytes[i];
+                }
+            } else {
+                memcpy(dst, Data + offset, count * sizeof(Char));
+            }
+        }
+
+        //! UTF-16 characters of the buffer. Compact ones are widened once
+        //! and keep the copy, so only call this for pointers handed out.
+        const Char* Widen(size_t length)
+        {
+            if (!Compact) {
+                return Data;
+            }
+
+            Char* wide = Wide.load(std::memory_order_acquire);
+
+            if (!wide) {
+                Char* created = static_cast<Char*>(::operator new((length + 1) * sizeof(Char)));
+                CopyTo(created, 0, length + 1);
+
+                // Another thread may have widened the same buffer meanwhile.
+                if (Wide.compare_exchange_strong(wide, created, std::memory_order_acq_rel)) {
+                    wide = created;
+                } else {
+                    ::operator delete(created);
+                }
+            }
+
+            return wide;
+        }
+
+        //! Forgets the cached values after the characters were changed.
+        //! Only the single owner of a buffer writes to it, so nobody else
+        //! can be reading the UTF-8 cache that is dropped here.
+        void Invalidate()
+        {
+            Hash.store(0, std::memory_order_relaxed);
+            Ascii.store(AsciiUnknown, std::memory_order_relaxed);
+
+            if (Utf8.load(std::memory_order_relaxed)) {
+                ::operator delete(Utf8.exchange(nullptr, std::memory_order_relaxed));
+            }
+        }
+
+        static void Destroy(Buffer* buffer)
+        {
+            ::operator delete(buffer->Utf8.load(std::memory_order_acquire));
+            ::operator delete(buffer->Wide.load(std::memory_order_acquire));
+            ::operator delete(buffer);
+        }
+
+        //! Drops one reference and frees the buffer with the last one.
+        static void Release(Buffer* buffer)
+        {
+            if (buffer->RefCount.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                Destroy(buffer);
+            }
+        }
+
+    private:
+
+        static Buffer* Allocate(size_t size, bool compact, size_t capacity)
+        {
+            Buffer* buffer = static_cast<Buffer*>(::operator new(sizeof(Buffer) + size));
+            new (&buffer->RefCount) std::atomic<size_t>(1);
+            new (&buffer->Hash) std::atomic<size_t>(0);
+            new (&buffer->Ascii) std::atomic<int>(AsciiUnknown);
+            new (&buffer->Utf8) std::atomic<Utf8Cache*>(nullptr);
+            new (&buffer->Wide) std::atomic<Char*>(nullptr);
+            buffer->Compact = compact;
+            buffer->Capacity = capacity;
+            return buffer;
+        }
+    };
+
+    /**
+     * UTF-16 characters of a string for as long as this object lives.
+     * Compact strings are widened into a temporary, unless their buffer
+     * already holds a copy, instead of attaching one as String::Data()
+     * does. Use it wherever UTF-16 is only needed for the current call.
+     */
+    class StringChars
+    {
+    public:
+
+        explicit StringChars(const String& str) :
+            mData(nullptr), mLength(str.mLength), mHeap(nullptr)
+        {
+            if (str.mLength <= String::SmallCapacity) {
+                mData = str.mSmall;
+            } else if (!str.mBuffer->Compact) {
+                mData = str.mBuffer->Data;
+            } else if (Char* wide = str.mBuffer->Wide.load(std::memory_order_acquire)) {
+                mData = wide;
+            } else {
+                Char* data = mStack;
+
+                if (str.mLength >= sizeof(mStack) / sizeof(Char)) {
+                    data = mHeap = static_cast<Char*>(::operator new((str.mLength + 1) * sizeof(Char)));
+                }
+
+                str.mBuffer->CopyTo(data, 0, str.mLength + 1);
+                mData = data;
+            }
+        }
+
+        StringChars(const StringChars&) = delete;
+
+        ~StringChars()
+        {
+            ::operator delete(mHeap);
+        }
+
+        const Char* Data() const
+        {
+            return mData;
+        }
+
+        //! The characters as a view, valid as long as this object.
+        StringView View() const
+        {
+            return StringView(mData, mLength);
+        }
+
+        //! True if the characters were widened for this object and vanish with it.
+        bool IsTemporary() const
+        {
+            return mData == mStack || mData == mHeap;
+        }
+
+        //! Copy of str stored as UTF-16, for objects that keep a pointer.
+        static String Widen(const String& str)
+        {
+            if (str.mLength <= String::SmallCapacity || !str.mBuffer->Compact) {
+                return str;
+            }
+
+            String result;
+            str.mBuffer->CopyTo(result.Initialize(str.mLength), 0, str.mLength);
+            return result;
+        }
+
+        StringChars& operator=(const StringChars&) = delete;
+
+    private:
+
+        const Char* mData;
+        size_t mLength;
+        Char* mHeap;
+        Char mStack[128];
+    };
+}
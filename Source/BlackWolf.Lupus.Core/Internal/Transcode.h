@@ -0,0 +1,69 @@
+/**
+ * Copyright (C) 2014 David Wolf <d.wolf@live.at>
+ *
+ * This file is part of Lupus.
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#pragma once
+
+#include "../String.h"
+
+namespace Lupus {
+    namespace Text {
+        /**
+         * Vectorized transcoders between UTF-16 and the byte encodings that
+         * Text::Encoding converts without ICU. Every target is sized by the
+         * caller, usually from one of the Measure functions. The functions
+         * returning bool validate as they go and return false on the first
+         * byte or code unit they cannot convert; the target is left
+         * partially written in that case.
+         */
+
+        //! Copies bytes that are all below 0x80.
+        bool CopyAscii(uint8_t* dst, const uint8_t* src, size_t length);
+        //! Widens Latin-1 bytes to UTF-16.
+        void WidenLatin1(Char* dst, const uint8_t* src, size_t length);
+        //! Narrows UTF-16 to single bytes; fails on code units above limit.
+        bool NarrowLatin1(uint8_t* dst, const Char* src, size_t length, Char limit);
+
+        //! Validates UTF-8 and counts the UTF-16 code units it decodes to;
+        //! latin1 tells whether all of them are below 0x100.
+        bool MeasureUtf8(const uint8_t* data, size_t size, size_t* length, bool* latin1);
+        //! Decodes UTF-8 that passed MeasureUtf8.
+        void DecodeUtf8(Char* dst, const uint8_t* src, size_t size);
+        //! Decodes UTF-8 that passed MeasureUtf8 with latin1 set.
+        void DecodeUtf8Latin1(uint8_t* dst, const uint8_t* src, size_t size);
+
+        //! Counts the UTF-8 bytes of UTF-16; fails on unpaired surrogates.
+        bool MeasureUtf16(const Char* data, size_t length, size_t* size);
+        //! Encodes UTF-16 that passed MeasureUtf16.
+        void EncodeUtf8(uint8_t* dst, const Char* src, size_t length);
+        //! Counts the UTF-8 bytes of Latin-1.
+        size_t MeasureLatin1(const uint8_t* data, size_t length);
+        //! Encodes Latin-1 as UTF-8.
+        void EncodeLatin1(uint8_t* dst, const uint8_t* src, size_t length);
+
+        //! Reads length code units in either byte order; fails on unpaired surrogates.
+        bool ReadUtf16(Char* dst, const uint8_t* src, size_t length, bool bigEndian);
+        //! Writes length code units in either byte order; fails on unpaired surrogates.
+        bool WriteUtf16(uint8_t* dst, const Char* src, size_t length, bool bigEndian);
+        //! Writes Latin-1 bytes as UTF-16 code units in either byte order.
+        void WriteUtf16(uint8_t* dst, const uint8_t* src, size_t length, bool bigEndian);
+    }
+}
@@ -46,6 +46,13 @@ namespace Lupus {
         mIterator = begin(mBuffer);
     }
 
+    MemoryStream::MemoryStream(vector<uint8_t>&& buffer, bool canWrite)
+    {
+        mBuffer = move(buffer);
+        mWritable = canWrite;
+        mIterator = begin(mBuffer);
+    }
+
     MemoryStream::MemoryStream(const vector<uint8_t>& buffer, size_t offset, size_t size)
     {
         if (offset > buffer.size()) {
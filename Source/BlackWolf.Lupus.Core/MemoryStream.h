@@ -38,6 +38,8 @@ namespace Lupus {
         MemoryStream(const std::vector<uint8_t>&) NOEXCEPT;
         MemoryStream(size_t size) NOEXCEPT;
         MemoryStream(const std::vector<uint8_t>&, bool writable) NOEXCEPT;
+        //! Takes over the buffer instead of copying it.
+        MemoryStream(std::vector<uint8_t>&&, bool writable) NOEXCEPT;
         MemoryStream(const std::vector<uint8_t>&, size_t offset, size_t size) throw(std::out_of_range);
         MemoryStream(const std::vector<uint8_t>&, size_t offset, size_t size, bool writable) throw(std::out_of_range);
         MemoryStream(const std::vector<uint8_t>&, size_t offset, size_t size, bool writable, bool visible) throw(std::out_of_range);
@@ -0,0 +1,276 @@
+/**
+ * Copyright (C) 2014 David Wolf <d.wolf@live.at>
+ *
+ * This file is part of Lupus.
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include "MultiReplacer.h"
+#include "Internal/CharSearch.h"
+#include "Internal/StringBuffer.h"
+#include <algorithm>
+#include <cstring>
+#include <queue>
+
+using namespace std;
+
+namespace Lupus {
+    namespace Text {
+        //! Up to this many distinct first characters are skipped by a vectorized scan.
+        static const size_t sSkipSetSize = 8;
+        static const size_t sNoMatch = (size_t)-1;
+        //! Marks transitions into states that end a pattern.
+        static const uint32_t sOutputFlag = 0x80000000u;
+
+        MultiReplacer::MultiReplacer(const vector<pair<String, String>>& replacements)
+        {
+            memset(mLowClasses, 0, sizeof(mLowClasses));
+
+            // Give every character used by a pattern its own column.
+            vector<Char> high;
+
+            for (const auto& pair : replacements) {
+                StringChars chars(pair.first);
+                const Char* str = chars.Data();
+
+                for (size_t i = 0; i < pair.first.Length(); i++) {
+                    if ((uint16_t)str[i] < 256) {
+                        if (!mLowClasses[(uint16_t)str[i]]) {
+                            mLowClasses[(uint16_t)str[i]] = (uint16_t)mClassCount++;
+                        }
+                    } else {
+                        high.push_back(str[i]);
+                    }
+                }
+            }
+
+            sort(high.begin(), high.end());
+            high.erase(unique(high.begin(), high.end()), high.end());
+
+            for (Char ch : high) {
+                mHighClasses.push_back(make_pair(ch, (uint32_t)mClassCount++));
+            }
+
+            // Trie of all patterns; 0 marks a missing edge, since no edge
+            // leads back to the root.
+            vector<uint32_t> trie(mClassCount, 0);
+            vector<uint32_t> depth(1, 0);
+            vector<int> output(1, -1);
+
+            for (const auto& pair : replacements) {
+                StringChars chars(pair.first);
+                const Char* str = chars.Data();
+                size_t size = pair.first.Length();
+                uint32_t state = 0;
+
+                if (size == 0) {
+                    continue;
+                }
+
+                for (size_t i = 0; i < size; i++) {
+                    size_t edge = state * mClassCount + ClassOf(str[i]);
+
+                    if (!trie[edge]) {
+                        trie[edge] = (uint32_t)depth.size();
+                        trie.resize(trie.size() + mClassCount, 0);
+                        depth.push_back((uint32_t)i + 1);
+                        output.push_back(-1);
+                    }
+
+                    state = trie[edge];
+                }
+
+                if (output[state] < 0) {
+                    output[state] = (int)mPatterns.size();
+                    mPatterns.push_back(pair.first);
+                    mReplacements.push_back(pair.second);
+
+                    if (find(mFirst.begin(), mFirst.end(), str[0]) == mFirst.end()) {
+                        mFirst.push_back(str[0]);
+                    }
+                }
+            }
+
+            // Breadth first, every state falls back to the longest proper
+            // suffix that is also in the trie; missing edges are replaced by
+            // the edge of that suffix, which yields a complete automaton.
+            vector<uint32_t> fail(depth.size(), 0);
+            queue<uint32_t> states;
+            states.push(0);
+
+            while (!states.empty()) {
+                uint32_t state = states.front();
+                uint32_t* row = &trie[state * mClassCount];
+                const uint32_t* fallback = &trie[fail[state] * mClassCount];
+                states.pop();
+
+                for (size_t c = 0; c < mClassCount; c++) {
+                    if (row[c]) {
+                        uint32_t next = row[c];
+                        fail[next] = state ? fallback[c] : 0;
+
+                        if (output[next] < 0) {
+                            output[next] = output[fail[next]];
+                        }
+
+                        states.push(next);
+                    } else if (state) {
+                        row[c] = fallback[c];
+                    }
+                }
+            }
+
+            // Each row holds the transitions followed by depth and output of
+            // its state. Transitions store row offsets and flag the states
+            // that end a pattern, so the scan needs neither a multiplication
+            // nor a lookup per character.
+            size_t stride = mClassCount + 3;
+            mTransitions.resize(depth.size() * stride);
+
+            for (size_t state = 0; state < depth.size(); state++) {
+                uint32_t* row = &mTransitions[state * stride];
+
+                for (size_t c = 0; c < mClassCount; c++) {
+                    uint32_t next = trie[state * mClassCount + c];
+                    row[c] = next * (uint32_t)stride | (output[next] >= 0 ? sOutputFlag : 0);
+                }
+
+                row[mClassCount] = depth[state];
+                row[mClassCount + 1] = (uint32_t)output[state];
+                row[mClassCount + 2] = output[state] >= 0 ? (uint32_t)mPatterns[output[state]].Length() : 0;
+            }
+        }
+
+        String MultiReplacer::Replace(const String& str) const
+        {
+            StringChars chars(str);
+            vector<Match> matches;
+            Find(chars.Data(), str.Length(), matches);
+
+            if (matches.empty()) {
+                return str;
+            }
+
+            size_t length = str.Length();
+
+            for (const Match& match : matches) {
+                length += mReplacements[match.Pattern].Length() - match.Length;
+            }
+
+            String result;
+            Char* it = result.Initialize(length);
+            const Char* data = chars.Data();
+            size_t previous = 0;
+
+            for (const Match& match : matches) {
+                const String& replacement = mReplacements[match.Pattern];
+                memcpy(it, data + previous, (match.Offset - previous) * sizeof(Char));
+                it += match.Offset - previous;
+                replacement.Read(it, 0, replacement.Length());
+                it += replacement.Length();
+                previous = match.Offset + match.Length;
+            }
+
+            memcpy(it, data + previous, (str.Length() - previous) * sizeof(Char));
+            return result;
+        }
+
+        size_t MultiReplacer::ClassOf(Char ch) const
+        {
+            if ((uint16_t)ch < 256) {
+                return mLowClasses[(uint16_t)ch];
+            } else if (mHighClasses.empty()) {
+                return 0;
+            }
+
+            auto it = lower_bound(mHighClasses.begin(), mHighClasses.end(), make_pair(ch, 0u));
+            return (it != mHighClasses.end() && it->first == ch) ? it->second : 0;
+        }
+
+        void MultiReplacer::Find(const Char* data, size_t length, vector<Match>& matches) const
+        {
+            const uint32_t* transitions = mTransitions.data();
+            uint32_t state = 0;
+            Match pending = { sNoMatch, 0, 0 };
+            size_t i = 0;
+
+            if (mPatterns.empty()) {
+                return;
+            }
+
+            while (i < length || pending.Offset != sNoMatch) {
+                if (state == 0 && pending.Offset == sNoMatch && mFirst.size() <= sSkipSetSize) {
+                    const Char* candidate = FindAnyChar(data + i, length - i, mFirst.data(), mFirst.size());
+
+                    if (!candidate) {
+                        break;
+                    }
+
+                    i = candidate - data;
+                }
+
+                uint32_t next = 0;
+
+                // Most characters neither end a pattern nor decide a pending
+                // match; they only move the automaton.
+                for (; i < length; i++) {
+                    Char ch = data[i];
+                    next = transitions[state + ((uint16_t)ch < 256 ? mLowClasses[(uint16_t)ch] : ClassOf(ch))];
+
+                    if (pending.Offset != sNoMatch || (next & sOutputFlag)) {
+                        break;
+                    }
+
+                    state = next;
+                }
+
+                if (i == length && pending.Offset == sNoMatch) {
+                    break;
+                }
+
+                state = next & ~sOutputFlag;
+                const uint32_t* row = transitions + state;
+
+                // The pending match is final once no partial match that
+                // starts at or before it is alive. Characters read past its
+                // end are scanned again from the root, so matches never
+                // overlap.
+                if (pending.Offset != sNoMatch && (i == length || i + 1 - row[mClassCount] > pending.Offset)) {
+                    matches.push_back(pending);
+                    i = pending.Offset + pending.Length;
+                    pending.Offset = sNoMatch;
+                    state = 0;
+                    continue;
+                }
+
+                if (next & sOutputFlag) {
+                    size_t size = row[mClassCount + 2];
+                    size_t start = i + 1 - size;
+
+                    if (pending.Offset == sNoMatch || start < pending.Offset || (start == pending.Offset && size > pending.Length)) {
+                        pending.Offset = start;
+                        pending.Length = size;
+                        pending.Pattern = row[mClassCount + 1];
+                    }
+                }
+
+                i++;
+            }
+        }
+    }
+}
@@ -0,0 +1,79 @@
+/**
+ * Copyright (C) 2014 David Wolf <d.wolf@live.at>
+ *
+ * This file is part of Lupus.
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#pragma once
+
+#include "String.h"
+#include <utility>
+#include <vector>
+
+namespace Lupus {
+    namespace Text {
+        //! Precompiled replacement of several patterns in one pass.
+        //!
+        //! The patterns are compiled into an Aho-Corasick automaton over
+        //! the characters they use, so the input is scanned once no matter
+        //! how many pairs are given. Matches are found leftmost first and,
+        //! among those starting at the same position, longest first; they
+        //! never overlap and replaced text is not searched again. The result
+        //! is written into a single allocation of its exact size. Empty
+        //! patterns are ignored, and of equal patterns the first one wins.
+        class LUPUSCORE_API MultiReplacer
+        {
+        public:
+
+            explicit MultiReplacer(const std::vector<std::pair<String, String>>& replacements) NOEXCEPT;
+            MultiReplacer(const MultiReplacer&) = default;
+            ~MultiReplacer() = default;
+
+            //! Returns str with all matches replaced, or str itself if none matched.
+            String Replace(const String& str) const NOEXCEPT;
+
+            MultiReplacer& operator=(const MultiReplacer&) = default;
+
+        private:
+
+            struct Match
+            {
+                size_t Offset;
+                size_t Length;
+                size_t Pattern;
+            };
+
+            size_t ClassOf(Char ch) const;
+            void Find(const Char* data, size_t length, std::vector<Match>& matches) const;
+
+            std::vector<String> mPatterns;
+            std::vector<String> mReplacements;
+            //! Characters used by the patterns map to 1..n, all others to 0.
+            uint16_t mLowClasses[256];
+            std::vector<std::pair<Char, uint32_t>> mHighClasses;
+            size_t mClassCount = 1;
+            //! Complete automaton; per state one transition for each class,
+            //! its depth, and index and length of the longest pattern ending
+            //! there or -1.
+            std::vector<uint32_t> mTransitions;
+            //! First characters of all patterns, used to skip ahead from the root.
+            std::vector<Char> mFirst;
+        };
+    }
+}
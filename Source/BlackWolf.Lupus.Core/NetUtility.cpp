@@ -117,7 +117,8 @@ namespace Lupus {
                 return addresses;
 #else
                 std::vector<std::shared_ptr<IPEndPoint>> addresses;
-                const char* nodename = node.IsEmpty() ? nullptr : node.ToUTF8().c_str();
+                StringUtf8 nodeUtf8 = node.Utf8();
+                const char* nodename = node.IsEmpty() ? nullptr : nodeUtf8.Data();
                 AddrInfo hints, *begin = nullptr, *it = nullptr;
 
                 memset(&hints, 0, sizeof(hints));
@@ -129,7 +130,7 @@ namespace Lupus {
                     hints.ai_flags = AI_PASSIVE;
                 }
 
-                if (getaddrinfo(nodename, service.ToUTF8().c_str(), &hints, &begin) != 0) {
+                if (getaddrinfo(nodename, service.Utf8().Data(), &hints, &begin) != 0) {
                     if (begin) {
                         freeaddrinfo(begin);
                     }
@@ -0,0 +1,549 @@
+/**
+ * Copyright (C) 2014 David Wolf <d.wolf@live.at>
+ *
+ * This file is part of Lupus.
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include "Regex.h"
+#include "StringBuilder.h"
+#include "Internal/StringBuffer.h"
+#include <unicode/regex.h>
+#include <unicode/utext.h>
+#include <atomic>
+#include <list>
+#include <mutex>
+
+using namespace std;
+
+namespace Lupus {
+    namespace Text {
+        //! Idle matchers kept per compiled pattern.
+        static const size_t sContextPoolSize = 8;
+        static const size_t sDefaultCacheSize = 15;
+
+        struct RegexContext
+        {
+            unique_ptr<RegexMatcher> Matcher;
+        };
+
+        struct RegexData
+        {
+            String Pattern;
+            RegexOptions Options;
+            unique_ptr<RegexPattern> Compiled;
+            //! Capture groups plus group 0.
+            size_t GroupCount = 0;
+            mutex Lock;
+            vector<RegexContext*> Pool;
+
+            ~RegexData()
+            {
+                for (RegexContext* context : Pool) {
+                    delete context;
+                }
+            }
+
+            //! Borrows a matcher and points it at input.
+            RegexContext* Acquire(StringView input)
+            {
+                RegexContext* context = nullptr;
+
+                {
+                    lock_guard<mutex> lock(Lock);
+
+                    if (!Pool.empty()) {
+                        context = Pool.back();
+                        Pool.pop_back();
+                    }
+                }
+
+                UErrorCode status = U_ZERO_ERROR;
+
+                if (!context) {
+                    context = new RegexContext();
+                    context->Matcher.reset(Compiled->matcher(status));
+                }
+
+                // The matcher keeps a shallow clone, which refers to the
+                // characters of input but not to this UText.
+                UText text = UTEXT_INITIALIZER;
+                utext_openUChars(&text, input.Data(), (int64_t)input.Length(), &status);
+                context->Matcher->reset(&text);
+                utext_close(&text);
+                return context;
+            }
+
+            void Release(RegexContext* context)
+            {
+                {
+                    lock_guard<mutex> lock(Lock);
+
+                    if (Pool.size() < sContextPoolSize) {
+                        Pool.push_back(context);
+                        return;
+                    }
+                }
+
+                delete context;
+            }
+
+            //! Copies the group boundaries of the current match.
+            void Read(RegexContext* context, StringView input, RegexMatch& match) const
+            {
+                match.mInput = input;
+                match.mSpans.resize(GroupCount * 2);
+
+                for (size_t i = 0; i < GroupCount; i++) {
+                    UErrorCode status = U_ZERO_ERROR;
+                    match.mSpans[i * 2] = context->Matcher->start((int32_t)i, status);
+                    match.mSpans[i * 2 + 1] = context->Matcher->end((int32_t)i, status);
+                }
+            }
+        };
+
+        //! Returns a borrowed matcher to its pattern when leaving the scope.
+        class RegexLease
+        {
+        public:
+
+            RegexLease(RegexData* data, StringView input) :
+                mData(data), mContext(data->Acquire(input))
+            {
+            }
+
+            ~RegexLease()
+            {
+                mData->Release(mContext);
+            }
+
+            inline RegexMatcher* operator->() const { return mContext->Matcher.get(); }
+            inline RegexContext* Context() const { return mContext; }
+
+        private:
+
+            RegexLease(const RegexLease&) = delete;
+            RegexLease& operator=(const RegexLease&) = delete;
+
+            RegexData* mData;
+            RegexContext* mContext;
+        };
+
+        //! Compiled patterns, most recently used first.
+        struct RegexCache
+        {
+            mutex Lock;
+            list<shared_ptr<RegexData>> Entries;
+            size_t Capacity = sDefaultCacheSize;
+        };
+
+        static atomic<RegexCache*> sRegexCache;
+
+        static RegexCache* GetRegexCache()
+        {
+            RegexCache* cache = sRegexCache.load(memory_order_acquire);
+
+            if (!cache) {
+                RegexCache* created = new RegexCache();
+
+                if (sRegexCache.compare_exchange_strong(cache, created, memory_order_acq_rel)) {
+                    cache = created;
+                } else {
+                    delete created;
+                }
+            }
+
+            return cache;
+        }
+
+        static shared_ptr<RegexData> FindCached(RegexCache* cache, const String& pattern, RegexOptions options)
+        {
+            for (auto it = cache->Entries.begin(); it != cache->Entries.end(); it++) {
+                if ((*it)->Options == options && (*it)->Pattern == pattern) {
+                    cache->Entries.splice(cache->Entries.begin(), cache->Entries, it);
+                    return cache->Entries.front();
+                }
+            }
+
+            return nullptr;
+        }
+
+        static uint32_t ToFlags(RegexOptions options)
+        {
+            uint32_t flags = 0;
+
+            if ((options & RegexOptions::IgnoreCase) != RegexOptions::None) {
+                flags |= UREGEX_CASE_INSENSITIVE;
+            }
+            if ((options & RegexOptions::Multiline) != RegexOptions::None) {
+                flags |= UREGEX_MULTILINE;
+            }
+            if ((options & RegexOptions::Singleline) != RegexOptions::None) {
+                flags |= UREGEX_DOTALL;
+            }
+            if ((options & RegexOptions::IgnorePatternWhitespace) != RegexOptions::None) {
+                flags |= UREGEX_COMMENTS;
+            }
+
+            return flags;
+        }
+
+        static shared_ptr<RegexData> Compile(const String& pattern, RegexOptions options)
+        {
+            RegexCache* cache = GetRegexCache();
+
+            {
+                lock_guard<mutex> lock(cache->Lock);
+                shared_ptr<RegexData> data = FindCached(cache, pattern, options);
+
+                if (data) {
+                    return data;
+                }
+            }
+
+            // Compile outside the lock; a concurrent compilation of the same
+            // pattern merely loses the race below.
+            shared_ptr<RegexData> data = make_shared<RegexData>();
+            UParseError error;
+            UErrorCode status = U_ZERO_ERROR;
+            // Kept as UTF-16 so that compiling never widens the caller's string.
+            data->Pattern = StringChars::Widen(pattern);
+            data->Options = options;
+            data->Compiled.reset(RegexPattern::compile(UnicodeString(TRUE, data->Pattern.Data(), (int32_t)data->Pattern.Length()), ToFlags(options), error, status));
+
+            if (U_FAILURE(status)) {
+                throw format_error(String::Format("Invalid regular expression at offset {0}: {1}", error.offset, u_errorName(status)).ToUTF8());
+            }
+
+            RegexContext* context = new RegexContext();
+            context->Matcher.reset(data->Compiled->matcher(status));
+            data->GroupCount = (size_t)context->Matcher->groupCount() + 1;
+            data->Pool.push_back(context);
+
+            lock_guard<mutex> lock(cache->Lock);
+            shared_ptr<RegexData> cached = FindCached(cache, pattern, options);
+
+            if (cached) {
+                return cached;
+            } else if (cache->Capacity == 0) {
+                return data;
+            }
+
+            cache->Entries.push_front(data);
+
+            while (cache->Entries.size() > cache->Capacity) {
+                cache->Entries.pop_back();
+            }
+
+            return data;
+        }
+
+        RegexMatch::RegexMatch()
+        {
+        }
+
+        bool RegexMatch::Success() const
+        {
+            return !mSpans.empty();
+        }
+
+        size_t RegexMatch::Index() const
+        {
+            return mSpans.empty() ? 0 : mSpans[0];
+        }
+
+        size_t RegexMatch::Length() const
+        {
+            return mSpans.empty() ? 0 : mSpans[1] - mSpans[0];
+        }
+
+        StringView RegexMatch::Value() const
+        {
+            return mSpans.empty() ? StringView() : StringView(mInput.Data() + mSpans[0], mSpans[1] - mSpans[0]);
+        }
+
+        size_t RegexMatch::GroupCount() const
+        {
+            return mSpans.size() / 2;
+        }
+
+        StringView RegexMatch::Group(size_t index) const
+        {
+            if (index >= mSpans.size() / 2) {
+                throw out_of_range("index");
+            } else if (mSpans[index * 2] < 0) {
+                return StringView();
+            }
+
+            return StringView(mInput.Data() + mSpans[index * 2], mSpans[index * 2 + 1] - mSpans[index * 2]);
+        }
+
+        int RegexMatch::GroupIndex(size_t index) const
+        {
+            if (index >= mSpans.size() / 2) {
+                throw out_of_range("index");
+            }
+
+            return mSpans[index * 2];
+        }
+
+        Regex::Regex(const String& pattern, RegexOptions options) :
+            mData(Compile(pattern, options))
+        {
+        }
+
+        bool Regex::IsMatch(StringView input) const
+        {
+            RegexLease matcher(mData.get(), input);
+            return matcher->find() == TRUE;
+        }
+
+        RegexMatch Regex::Match(StringView input) const
+        {
+            RegexLease matcher(mData.get(), input);
+            RegexMatch match;
+
+            if (matcher->find()) {
+                mData->Read(matcher.Context(), input, match);
+            }
+
+            return match;
+        }
+
+        RegexMatch Regex::Match(StringView input, size_t offset) const
+        {
+            if (offset > input.Length()) {
+                throw out_of_range("offset");
+            }
+
+            RegexLease matcher(mData.get(), input);
+            UErrorCode status = U_ZERO_ERROR;
+            RegexMatch match;
+
+            if (matcher->find((int64_t)offset, status)) {
+                mData->Read(matcher.Context(), input, match);
+            }
+
+            return match;
+        }
+
+        RegexMatchEnumerator Regex::Matches(StringView input) const
+        {
+            return RegexMatchEnumerator(mData, input);
+        }
+
+        String Regex::Replace(const String& input, const String& replacement) const
+        {
+            // Split the replacement into literal text and group references
+            // once; every match then only copies.
+            struct Part
+            {
+                size_t Offset;
+                size_t Length;
+                int Group;
+            };
+
+            vector<Part> parts;
+            StringBuilder literal;
+            StringChars replacementChars(replacement);
+            const Char* str = replacementChars.Data();
+            size_t size = replacement.Length();
+            size_t start = 0;
+
+            for (size_t i = 0; i < size; i++) {
+                if (str[i] == '\\' && i + 1 < size) {
+                    literal.Append(str[++i]);
+                    continue;
+                } else if (str[i] != '$') {
+                    literal.Append(str[i]);
+                    continue;
+                } else if (i + 1 == size || str[i + 1] < '0' || str[i + 1] > '9') {
+                    throw format_error("$ is not followed by a group number");
+                }
+
+                size_t group = str[++i] - '0';
+
+                // Take further digits as long as the group exists, like ICU.
+                while (i + 1 < size && str[i + 1] >= '0' && str[i + 1] <= '9' && group * 10 + (str[i + 1] - '0') < mData->GroupCount) {
+                    group = group * 10 + (str[++i] - '0');
+                }
+
+                if (group >= mData->GroupCount) {
+                    throw format_error("Replacement refers to a missing group");
+                }
+
+                if (literal.Length() > start) {
+                    parts.push_back({ start, literal.Length() - start, -1 });
+                    start = literal.Length();
+                }
+
+                parts.push_back({ 0, 0, (int)group });
+            }
+
+            if (literal.Length() > start) {
+                parts.push_back({ start, literal.Length() - start, -1 });
+            }
+
+            String text = literal.ToString();
+            StringChars textChars(text);
+            StringChars chars(input);
+            StringView view(chars.Data(), input.Length());
+            size_t last = 0;
+
+            RegexLease matcher(mData.get(), view);
+            StringBuilder result;
+            RegexMatch match;
+
+            while (matcher->find()) {
+                mData->Read(matcher.Context(), view, match);
+
+                if (result.Capacity() == 0) {
+                    result.Reserve(input.Length() + input.Length() / 4);
+                }
+
+                result.Append(view.Substring(last, match.Index() - last));
+
+                for (const Part& part : parts) {
+                    result.Append(part.Group < 0 ? StringView(textChars.Data() + part.Offset, part.Length) : match.Group(part.Group));
+                }
+
+                last = match.Index() + match.Length();
+            }
+
+            if (match.GroupCount() == 0) {
+                return input;
+            }
+
+            result.Append(view.Substring(last));
+            return result.ToString();
+        }
+
+        vector<String> Regex::Split(const String& input) const
+        {
+            vector<String> result;
+            StringChars chars(input);
+            size_t last = 0;
+
+            for (const RegexMatch& match : Matches(StringView(chars.Data(), input.Length()))) {
+                result.push_back(input.Substring(last, match.Index() - last));
+                last = match.Index() + match.Length();
+            }
+
+            result.push_back(input.Substring(last));
+            return result;
+        }
+
+        const String& Regex::Pattern() const
+        {
+            return mData->Pattern;
+        }
+
+        RegexOptions Regex::Options() const
+        {
+            return mData->Options;
+        }
+
+        bool Regex::IsMatch(StringView input, const String& pattern, RegexOptions options)
+        {
+            return Regex(pattern, options).IsMatch(input);
+        }
+
+        RegexMatch Regex::Match(StringView input, const String& pattern, RegexOptions options)
+        {
+            return Regex(pattern, options).Match(input);
+        }
+
+        String Regex::Replace(const String& input, const String& pattern, const String& replacement, RegexOptions options)
+        {
+            return Regex(pattern, options).Replace(input, replacement);
+        }
+
+        vector<String> Regex::Split(const String& input, const String& pattern, RegexOptions options)
+        {
+            return Regex(pattern, options).Split(input);
+        }
+
+        size_t Regex::CacheSize()
+        {
+            RegexCache* cache = GetRegexCache();
+            lock_guard<mutex> lock(cache->Lock);
+            return cache->Capacity;
+        }
+
+        void Regex::CacheSize(size_t size)
+        {
+            RegexCache* cache = GetRegexCache();
+            lock_guard<mutex> lock(cache->Lock);
+            cache->Capacity = size;
+
+            while (cache->Entries.size() > size) {
+                cache->Entries.pop_back();
+            }
+        }
+
+        RegexMatchEnumerator::RegexMatchEnumerator(const shared_ptr<RegexData>& data, StringView input) :
+            mData(data), mContext(data->Acquire(input))
+        {
+            mCurrent.mInput = input;
+        }
+
+        RegexMatchEnumerator::RegexMatchEnumerator(RegexMatchEnumerator&& enumerator) :
+            mData(move(enumerator.mData)), mContext(enumerator.mContext), mCurrent(move(enumerator.mCurrent))
+        {
+            enumerator.mContext = nullptr;
+        }
+
+        RegexMatchEnumerator::~RegexMatchEnumerator()
+        {
+            if (mContext) {
+                mData->Release(mContext);
+            }
+        }
+
+        const RegexMatch& RegexMatchEnumerator::Current() const
+        {
+            return mCurrent;
+        }
+
+        bool RegexMatchEnumerator::MoveNext()
+        {
+            if (!mContext) {
+                return false;
+            } else if (!mContext->Matcher->find()) {
+                // Hand the matcher back as soon as the input is exhausted.
+                mData->Release(mContext);
+                mContext = nullptr;
+                mCurrent = RegexMatch();
+                return false;
+            }
+
+            mData->Read(mContext, mCurrent.mInput, mCurrent);
+            return true;
+        }
+
+        RegexMatchEnumerator::iterator RegexMatchEnumerator::begin()
+        {
+            return MoveNext() ? iterator(this) : iterator();
+        }
+
+        RegexMatchEnumerator::iterator RegexMatchEnumerator::end()
+        {
+            return iterator();
+        }
+    }
+}
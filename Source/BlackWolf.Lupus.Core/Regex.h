@@ -0,0 +1,187 @@
+/**
+ * Copyright (C) 2014 David Wolf <d.wolf@live.at>
+ *
+ * This file is part of Lupus.
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#pragma once
+
+#include "String.h"
+#include "StringView.h"
+#include <iterator>
+#include <memory>
+
+#ifdef _MSC_VER
+#pragma warning(push)
+#pragma warning(disable: 4251)
+#endif
+
+namespace Lupus {
+    namespace Text {
+        class RegexMatchEnumerator;
+        struct RegexContext;
+        struct RegexData;
+
+        enum class RegexOptions {
+            LupusCreateNoFlag(None),
+            LupusCreateFlag(IgnoreCase, 0), //!< Case insensitive matching.
+            LupusCreateFlag(Multiline, 1), //!< ^ and $ match at line ends.
+            LupusCreateFlag(Singleline, 2), //!< . matches line terminators.
+            LupusCreateFlag(IgnorePatternWhitespace, 3) //!< Allows white space and #comments in the pattern.
+        };
+        LupusFlagEnumeration(RegexOptions);
+
+        //! Result of a regular expression search.
+        //!
+        //! Values are views into the searched input, which has to outlive
+        //! the match. Group 0 is the whole match.
+        class LUPUSCORE_API RegexMatch
+        {
+        public:
+
+            RegexMatch() NOEXCEPT;
+            RegexMatch(const RegexMatch&) = default;
+            ~RegexMatch() = default;
+
+            bool Success() const NOEXCEPT;
+            size_t Index() const NOEXCEPT;
+            size_t Length() const NOEXCEPT;
+            StringView Value() const NOEXCEPT;
+            //! Number of groups including group 0, or 0 without a match.
+            size_t GroupCount() const NOEXCEPT;
+            //! Returns an empty view if the group did not take part in the match.
+            StringView Group(size_t index) const throw(std::out_of_range);
+            //! Returns -1 if the group did not take part in the match.
+            int GroupIndex(size_t index) const throw(std::out_of_range);
+
+            RegexMatch& operator=(const RegexMatch&) = default;
+
+        private:
+
+            friend class RegexMatchEnumerator;
+            friend struct RegexData;
+
+            StringView mInput;
+            //! Start and end of every group, -1 if it did not match.
+            std::vector<int> mSpans;
+        };
+
+        //! Regular expression in ICU syntax.
+        //!
+        //! Compiled patterns are kept in a process wide LRU cache, so
+        //! constructing a Regex or calling the static functions with a
+        //! recently used pattern does not compile it again. A Regex may be
+        //! shared by several threads; each search borrows a matcher from a
+        //! small pool of the compiled pattern and returns it afterwards.
+        //! Searches work on the characters of the input in place.
+        class LUPUSCORE_API Regex
+        {
+        public:
+
+            explicit Regex(const String& pattern, RegexOptions options = RegexOptions::None) throw(format_error);
+            Regex(const Regex&) = default;
+            ~Regex() = default;
+
+            bool IsMatch(StringView input) const NOEXCEPT;
+            //! Returns the first match, check RegexMatch::Success().
+            RegexMatch Match(StringView input) const NOEXCEPT;
+            RegexMatch Match(StringView input, size_t offset) const throw(std::out_of_range);
+            //! Enumerates all matches; input has to outlive the enumerator.
+            RegexMatchEnumerator Matches(StringView input) const NOEXCEPT;
+            //! Replaces every match. The replacement may refer to groups
+            //! as $n; \ escapes the next character.
+            String Replace(const String& input, const String& replacement) const throw(format_error);
+            //! Returns the parts between the matches.
+            std::vector<String> Split(const String& input) const NOEXCEPT;
+            const String& Pattern() const NOEXCEPT;
+            RegexOptions Options() const NOEXCEPT;
+
+            Regex& operator=(const Regex&) = default;
+
+            static bool IsMatch(StringView input, const String& pattern, RegexOptions options = RegexOptions::None) throw(format_error);
+            static RegexMatch Match(StringView input, const String& pattern, RegexOptions options = RegexOptions::None) throw(format_error);
+            static String Replace(const String& input, const String& pattern, const String& replacement, RegexOptions options = RegexOptions::None) throw(format_error);
+            static std::vector<String> Split(const String& input, const String& pattern, RegexOptions options = RegexOptions::None) throw(format_error);
+            //! Maximum number of compiled patterns kept, 15 by default.
+            static size_t CacheSize() NOEXCEPT;
+            static void CacheSize(size_t size) NOEXCEPT;
+
+        private:
+
+            std::shared_ptr<RegexData> mData;
+        };
+
+        //! Enumerates the matches of a Regex, one per MoveNext().
+        //!
+        //! The enumerator holds a matcher until it is destroyed and reuses
+        //! the storage of Current(), so no allocation happens per match. It
+        //! is single pass and can be used in a range-based for.
+        class LUPUSCORE_API RegexMatchEnumerator
+        {
+        public:
+
+            class iterator : public std::iterator<std::input_iterator_tag, RegexMatch>
+            {
+            public:
+
+                iterator() : mOwner(nullptr) {}
+                explicit iterator(RegexMatchEnumerator* owner) : mOwner(owner) {}
+
+                inline const RegexMatch& operator*() const { return mOwner->mCurrent; }
+                inline const RegexMatch* operator->() const { return &mOwner->mCurrent; }
+                inline iterator& operator++() { mOwner = mOwner->MoveNext() ? mOwner : nullptr; return *this; }
+                inline bool operator==(const iterator& it) const { return mOwner == it.mOwner; }
+                inline bool operator!=(const iterator& it) const { return mOwner != it.mOwner; }
+
+            private:
+
+                RegexMatchEnumerator* mOwner;
+            };
+
+            RegexMatchEnumerator(RegexMatchEnumerator&& enumerator) NOEXCEPT;
+            RegexMatchEnumerator(const RegexMatchEnumerator&) = delete;
+            ~RegexMatchEnumerator();
+
+            //! Match found by the last successful MoveNext().
+            const RegexMatch& Current() const NOEXCEPT;
+            //! Advances to the next match; false once there is none.
+            bool MoveNext() NOEXCEPT;
+
+            //! Advances to the first remaining match.
+            iterator begin() NOEXCEPT;
+            iterator end() NOEXCEPT;
+
+            RegexMatchEnumerator& operator=(const RegexMatchEnumerator&) = delete;
+
+        private:
+
+            friend class Regex;
+
+            RegexMatchEnumerator(const std::shared_ptr<RegexData>& data, StringView input);
+
+            std::shared_ptr<RegexData> mData;
+            RegexContext* mContext;
+            RegexMatch mCurrent;
+        };
+    }
+}
+
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
@@ -0,0 +1,238 @@
+/**
+ * Copyright (C) 2014 David Wolf <d.wolf@live.at>
+ *
+ * This file is part of Lupus.
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include "Searcher.h"
+#include "Internal/CharSearch.h"
+#include "Internal/StringBuffer.h"
+#include <unicode/utf16.h>
+#include <cstring>
+
+using namespace std;
+
+namespace Lupus {
+    namespace Text {
+        //! Patterns longer than this use Two-Way instead of the vectorized filter.
+        static const size_t sLongPattern = 32;
+
+        // Maximal suffix of the pattern under the given order; returns its
+        // start minus one and stores the period of the suffix.
+        static size_t MaximalSuffix(const Char* str, size_t size, bool reversed, size_t* period)
+        {
+            size_t i = (size_t)-1;
+            size_t j = 0;
+            size_t k = 1;
+            size_t p = 1;
+
+            while (j + k < size) {
+                Char a = str[i + k];
+                Char b = str[j + k];
+
+                if (a == b) {
+                    if (k == p) {
+                        j += p;
+                        k = 1;
+                    } else {
+                        k++;
+                    }
+                } else if (reversed ? a < b : a > b) {
+                    j += k;
+                    k = 1;
+                    p = j - i;
+                } else {
+                    i = j++;
+                    k = p = 1;
+                }
+            }
+
+            *period = p;
+            return i;
+        }
+
+        Searcher::Searcher(const String& pattern) :
+            mStorage(StringChars::Widen(pattern)), mPattern(mStorage)
+        {
+            Prepare();
+        }
+
+        Searcher::Searcher(StringView pattern) :
+            mPattern(pattern)
+        {
+            Prepare();
+        }
+
+        Searcher::Searcher(const Searcher& searcher)
+        {
+            *this = searcher;
+        }
+
+        Searcher& Searcher::operator=(const Searcher& searcher)
+        {
+            // A copied pattern has to be viewed in the own copy.
+            mStorage = searcher.mStorage;
+            mPattern = searcher.mStorage.IsEmpty() ? searcher.mPattern : StringView(mStorage);
+            mSuffix = searcher.mSuffix;
+            mPeriod = searcher.mPeriod;
+            mMemory = searcher.mMemory;
+            mLong = searcher.mLong;
+            mSurrogates = searcher.mSurrogates;
+
+            if (mLong) {
+                memcpy(mShift, searcher.mShift, sizeof(mShift));
+            }
+
+            return *this;
+        }
+
+        void Searcher::Prepare()
+        {
+            const Char* str = mPattern.Data();
+            size_t size = mPattern.Length();
+
+            if (size == 0) {
+                return;
+            }
+
+            mSurrogates = U16_IS_TRAIL(str[0]) || U16_IS_LEAD(str[size - 1]);
+            mLong = size > sLongPattern;
+
+            if (!mLong) {
+                return;
+            }
+
+            // Bad-character shift keyed by the low byte. Characters sharing a
+            // byte keep the rightmost position, so shifts stay conservative.
+            memset(mShift, 0, sizeof(mShift));
+
+            for (size_t i = 0; i < size; i++) {
+                mShift[(uint8_t)str[i]] = i + 1;
+            }
+
+            // Critical factorization: the later of both maximal suffixes.
+            size_t period, reversedPeriod;
+            size_t suffix = MaximalSuffix(str, size, false, &period);
+            size_t reversedSuffix = MaximalSuffix(str, size, true, &reversedPeriod);
+
+            if (reversedSuffix + 1 > suffix + 1) {
+                suffix = reversedSuffix;
+                period = reversedPeriod;
+            }
+
+            mSuffix = suffix;
+
+            if (memcmp(str, str + period, (suffix + 1) * sizeof(Char)) != 0) {
+                mPeriod = max(suffix, size - suffix - 1) + 1;
+                mMemory = 0;
+            } else {
+                mPeriod = period;
+                mMemory = size - period;
+            }
+        }
+
+        const Char* Searcher::Find(const Char* data, size_t length) const
+        {
+            const Char* str = mPattern.Data();
+            size_t size = mPattern.Length();
+            const Char* end = data + length;
+
+            for (const Char* it = data;; it++) {
+                it = mLong ? FindTwoWay(it, end - it) : FindString(it, end - it, str, size);
+
+                if (!it || !mSurrogates || IsBoundary(data, length, it)) {
+                    return it;
+                }
+            }
+        }
+
+        int Searcher::IndexOf(StringView str) const
+        {
+            const Char* result = Find(str.Data(), str.Length());
+            return result ? (int)(result - str.Data()) : -1;
+        }
+
+        int Searcher::IndexOf(StringView str, size_t offset) const
+        {
+            if (offset > str.Length()) {
+                throw out_of_range("offset");
+            }
+
+            const Char* result = Find(str.Data() + offset, str.Length() - offset);
+            return result ? (int)(result - str.Data()) : -1;
+        }
+
+        StringView Searcher::Pattern() const
+        {
+            return mPattern;
+        }
+
+        const Char* Searcher::FindTwoWay(const Char* data, size_t length) const
+        {
+            const Char* str = mPattern.Data();
+            const size_t size = mPattern.Length();
+            const Char* it = data;
+            const Char* end = data + length;
+            size_t memory = 0;
+
+            while ((size_t)(end - it) >= size) {
+                // Skip by the last character first; most windows end here.
+                size_t k = size - mShift[(uint8_t)it[size - 1]];
+
+                if (k) {
+                    it += max(k, memory);
+                    memory = 0;
+                    continue;
+                }
+
+                for (k = max(mSuffix + 1, memory); k < size && str[k] == it[k]; k++);
+
+                if (k < size) {
+                    it += k - mSuffix;
+                    memory = 0;
+                    continue;
+                }
+
+                for (k = mSuffix + 1; k > memory && str[k - 1] == it[k - 1]; k--);
+
+                if (k <= memory) {
+                    return it;
+                }
+
+                it += mPeriod;
+                memory = mMemory;
+            }
+
+            return nullptr;
+        }
+
+        bool Searcher::IsBoundary(const Char* data, size_t length, const Char* match) const
+        {
+            size_t size = mPattern.Length();
+
+            if (U16_IS_TRAIL(*match) && match > data && U16_IS_LEAD(match[-1])) {
+                return false;
+            } else if (U16_IS_LEAD(match[size - 1]) && (size_t)(match - data) + size < length && U16_IS_TRAIL(match[size])) {
+                return false;
+            }
+
+            return true;
+        }
+    }
+}
@@ -0,0 +1,74 @@
+/**
+ * Copyright (C) 2014 David Wolf <d.wolf@live.at>
+ *
+ * This file is part of Lupus.
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#pragma once
+
+#include "String.h"
+#include "StringView.h"
+
+namespace Lupus {
+    namespace Text {
+        //! Precompiled substring search for one pattern.
+        //!
+        //! Short patterns are located by a vectorized scan for their first
+        //! and last character. Longer patterns use the Two-Way algorithm
+        //! with a bad-character shift, which skips ahead by up to the
+        //! pattern length and never degrades beyond linear time. Build a
+        //! Searcher once when the same pattern is looked up repeatedly.
+        //!
+        //! Like ICU, matches never start or end inside a surrogate pair.
+        class LUPUSCORE_API Searcher
+        {
+        public:
+
+            //! Keeps a copy of the pattern.
+            explicit Searcher(const String& pattern) NOEXCEPT;
+            //! Refers to the pattern, which has to outlive the searcher.
+            explicit Searcher(StringView pattern) NOEXCEPT;
+            Searcher(const Searcher& searcher) NOEXCEPT;
+            ~Searcher() = default;
+
+            //! Returns the first match in [data, data + length) or nullptr.
+            const Char* Find(const Char* data, size_t length) const NOEXCEPT;
+            int IndexOf(StringView str) const NOEXCEPT;
+            int IndexOf(StringView str, size_t offset) const throw(std::out_of_range);
+            StringView Pattern() const NOEXCEPT;
+
+            Searcher& operator=(const Searcher& searcher) NOEXCEPT;
+
+        private:
+
+            void Prepare();
+            const Char* FindTwoWay(const Char* data, size_t length) const;
+            bool IsBoundary(const Char* data, size_t length, const Char* match) const;
+
+            String mStorage;
+            StringView mPattern;
+            size_t mSuffix = 0;
+            size_t mPeriod = 0;
+            size_t mMemory = 0;
+            size_t mShift[256];
+            bool mLong = false;
+            bool mSurrogates = false;
+        };
+    }
+}
@@ -0,0 +1,122 @@
+/**
+ * Copyright (C) 2014 David Wolf <d.wolf@live.at>
+ *
+ * This file is part of Lupus.
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include "SplitEnumerator.h"
+#include "Internal/CharSearch.h"
+#include "Internal/StringBuffer.h"
+
+using namespace std;
+
+namespace Lupus {
+    namespace Text {
+        SplitEnumerator::SplitEnumerator(StringView str, Char delimiter, StringSplitOption option) :
+            SplitEnumerator(str, delimiter, (size_t)-1, option)
+        {
+        }
+
+        SplitEnumerator::SplitEnumerator(StringView str, Char delimiter, size_t count, StringSplitOption option) :
+            mSource(str), mChars(delimiter, 1), mSearcher(StringView()), mDelimiterLength(1), mRemaining(count), mOption(option), mFinished(count == 0)
+        {
+        }
+
+        SplitEnumerator::SplitEnumerator(StringView str, const vector<Char>& delimiter, StringSplitOption option) :
+            SplitEnumerator(str, delimiter, (size_t)-1, option)
+        {
+        }
+
+        SplitEnumerator::SplitEnumerator(StringView str, const vector<Char>& delimiter, size_t count, StringSplitOption option) :
+            mSource(str), mChars(StringChars::Widen(StringView(delimiter.data(), delimiter.size()).ToString())), mSearcher(StringView()), mDelimiterLength(1), mRemaining(count), mOption(option), mFinished(count == 0)
+        {
+        }
+
+        SplitEnumerator::SplitEnumerator(StringView str, const String& delimiter, StringSplitOption option) :
+            SplitEnumerator(str, delimiter, (size_t)-1, option)
+        {
+        }
+
+        SplitEnumerator::SplitEnumerator(StringView str, const String& delimiter, size_t count, StringSplitOption option) :
+            mSource(str), mSearcher(delimiter), mDelimiterLength(delimiter.Length()), mRemaining(count), mOption(option), mFinished(count == 0)
+        {
+        }
+
+        SplitEnumerator::SplitEnumerator(StringView str, StringView delimiter, StringSplitOption option) :
+            SplitEnumerator(str, delimiter, (size_t)-1, option)
+        {
+        }
+
+        SplitEnumerator::SplitEnumerator(StringView str, StringView delimiter, size_t count, StringSplitOption option) :
+            mSource(str), mSearcher(delimiter), mDelimiterLength(delimiter.Length()), mRemaining(count), mOption(option), mFinished(count == 0)
+        {
+        }
+
+        StringView SplitEnumerator::Current() const
+        {
+            return mCurrent;
+        }
+
+        bool SplitEnumerator::MoveNext()
+        {
+            const Char* data = mSource.Data();
+            size_t length = mSource.Length();
+
+            while (!mFinished) {
+                size_t previous = mPosition;
+                const Char* match = mRemaining > 1 ? Find(data + previous, length - previous) : nullptr;
+                size_t index = length;
+
+                if (match) {
+                    index = match - data;
+                    mPosition = index + mDelimiterLength;
+                } else {
+                    mFinished = true;
+                }
+
+                if (mOption == StringSplitOption::None || index != previous) {
+                    mCurrent = StringView(data + previous, index - previous);
+                    mRemaining--;
+                    return true;
+                }
+            }
+
+            return false;
+        }
+
+        SplitEnumerator::iterator SplitEnumerator::begin()
+        {
+            return MoveNext() ? iterator(this) : iterator();
+        }
+
+        SplitEnumerator::iterator SplitEnumerator::end()
+        {
+            return iterator();
+        }
+
+        const Char* SplitEnumerator::Find(const Char* data, size_t length) const
+        {
+            if (mSearcher.Pattern().IsEmpty()) {
+                return FindAnyChar(data, length, mChars.Data(), mChars.Length());
+            }
+
+            return mSearcher.Find(data, length);
+        }
+    }
+}
@@ -0,0 +1,104 @@
+/**
+ * Copyright (C) 2014 David Wolf <d.wolf@live.at>
+ *
+ * This file is part of Lupus.
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#pragma once
+
+#include "String.h"
+#include "StringView.h"
+#include "Searcher.h"
+#include <iterator>
+
+#ifdef _MSC_VER
+#pragma warning(push)
+#pragma warning(disable: 4251)
+#endif
+
+namespace Lupus {
+    namespace Text {
+        //! Splits a string lazily into views, one part per MoveNext().
+        //!
+        //! The parts follow String::Split, including the count limit and
+        //! RemoveEmptyEntries, but nothing is allocated: every part is a
+        //! view into the source, which has to outlive the enumerator.
+        //! Delimiters are copied, so temporaries may be passed, except for
+        //! a StringView delimiter, which has to outlive it as well. The
+        //! enumerator is single pass and can be used in a range-based for.
+        class LUPUSCORE_API SplitEnumerator
+        {
+        public:
+
+            class iterator : public std::iterator<std::input_iterator_tag, StringView>
+            {
+            public:
+
+                iterator() : mOwner(nullptr) {}
+                explicit iterator(SplitEnumerator* owner) : mOwner(owner) {}
+
+                inline const StringView& operator*() const { return mOwner->mCurrent; }
+                inline const StringView* operator->() const { return &mOwner->mCurrent; }
+                inline iterator& operator++() { mOwner = mOwner->MoveNext() ? mOwner : nullptr; return *this; }
+                inline bool operator==(const iterator& it) const { return mOwner == it.mOwner; }
+                inline bool operator!=(const iterator& it) const { return mOwner != it.mOwner; }
+
+            private:
+
+                SplitEnumerator* mOwner;
+            };
+
+            SplitEnumerator(StringView str, Char delimiter, StringSplitOption = StringSplitOption::None) NOEXCEPT;
+            SplitEnumerator(StringView str, Char delimiter, size_t count, StringSplitOption = StringSplitOption::None) NOEXCEPT;
+            SplitEnumerator(StringView str, const std::vector<Char>& delimiter, StringSplitOption = StringSplitOption::None) NOEXCEPT;
+            SplitEnumerator(StringView str, const std::vector<Char>& delimiter, size_t count, StringSplitOption = StringSplitOption::None) NOEXCEPT;
+            SplitEnumerator(StringView str, const String& delimiter, StringSplitOption = StringSplitOption::None) NOEXCEPT;
+            SplitEnumerator(StringView str, const String& delimiter, size_t count, StringSplitOption = StringSplitOption::None) NOEXCEPT;
+            SplitEnumerator(StringView str, StringView delimiter, StringSplitOption = StringSplitOption::None) NOEXCEPT;
+            SplitEnumerator(StringView str, StringView delimiter, size_t count, StringSplitOption = StringSplitOption::None) NOEXCEPT;
+
+            //! Part found by the last successful MoveNext().
+            StringView Current() const NOEXCEPT;
+            //! Advances to the next part; false once the source is exhausted.
+            bool MoveNext() NOEXCEPT;
+
+            //! Advances to the first remaining part.
+            iterator begin() NOEXCEPT;
+            iterator end() NOEXCEPT;
+
+        private:
+
+            const Char* Find(const Char* data, size_t length) const;
+
+            StringView mSource;
+            StringView mCurrent;
+            String mChars;
+            Searcher mSearcher;
+            size_t mDelimiterLength;
+            size_t mPosition = 0;
+            size_t mRemaining;
+            StringSplitOption mOption;
+            bool mFinished;
+        };
+    }
+}
+
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
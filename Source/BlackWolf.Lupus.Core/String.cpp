@@ -21,11 +21,23 @@
  * THE SOFTWARE.
  */
 #include "String.h"
+#include "StringView.h"
+#include "Internal/StringBuffer.h"
+#include "Internal/CharSearch.h"
+#include "Internal/Transcode.h"
+#include "Searcher.h"
+#include "MultiReplacer.h"
+#include "SplitEnumerator.h"
 #include "Encoding.h"
 #include <unicode/uchar.h>
 #include <unicode/ustring.h>
 #include <unicode/unistr.h>
+#include <unicode/locid.h>
+#include <unicode/utf16.h>
 #include <unicode/regex.h>
+#include <mutex>
+#include <unordered_set>
+#include <algorithm>
 
 using namespace std;
 
@@ -38,31 +50,320 @@ using namespace std;
 namespace Lupus {
     const size_t String::Capacity = 1024;
 
-    String::String()
+    struct InternPool
     {
-        mString = new UnicodeString();
-        mCount = new size_t(1);
+        mutex Lock;
+        unordered_set<String> Entries;
+        StringInternStatistics Statistics = StringInternStatistics();
+    };
+
+    // Zero-initialized before any constructor runs, so static String
+    // constants in other translation units may intern safely.
+    static atomic<InternPool*> sInternPool;
+
+    // Counters of the UTF-8 cache. They are shared by all threads, so
+    // only debug builds pay for updating them.
+    static atomic<size_t> sUtf8Requests;
+    static atomic<size_t> sUtf8Hits;
+    static atomic<size_t> sUtf8Encoded;
+    static atomic<size_t> sUtf8Bytes;
+
 #ifdef _DEBUG
-        mDebugString = ToUTF8();
+    static inline void CountUtf8(atomic<size_t>& counter, size_t value = 1)
+    {
+        counter.fetch_add(value, memory_order_relaxed);
+    }
+#else
+    static inline void CountUtf8(atomic<size_t>&, size_t = 1)
+    {
+    }
 #endif
+
+    static InternPool* GetInternPool()
+    {
+        InternPool* pool = sInternPool.load(memory_order_acquire);
+
+        if (!pool) {
+            InternPool* created = new InternPool();
+
+            if (sInternPool.compare_exchange_strong(pool, created, memory_order_acq_rel)) {
+                pool = created;
+            } else {
+                delete created;
+            }
+        }
+
+        return pool;
+    }
+
+    static inline void CopyChars(Char* dst, const Char* src, size_t count)
+    {
+        memcpy(dst, src, count * sizeof(Char));
+    }
+
+    /**
+     * Searches [offset, offset + size) for ch. Surrogates only match when
+     * unpaired, which the vector kernels do not know about, so they go
+     * through ICU.
+     */
+    static int FindChar(const Char* data, size_t length, size_t offset, size_t size, Char ch, bool last)
+    {
+        if (U16_IS_SURROGATE(ch)) {
+            UnicodeString str(TRUE, data, (int32_t)length);
+            return last ? str.lastIndexOf(ch, offset, size) : str.indexOf(ch, offset, size);
+        }
+
+        const Char* result = last ? Text::FindLastChar(data + offset, size, ch) : Text::FindChar(data + offset, size, ch);
+        return result ? (int)(result - data) : -1;
+    }
+
+    static inline int Closer(int result, int index, bool last)
+    {
+        if (index == -1 || (result != -1 && (last ? index < result : index > result))) {
+            return result;
+        }
+
+        return index;
+    }
+
+    //! Earliest (or latest) position of any of chars within [offset, offset + size).
+    static int FindAnyChar(const Char* data, size_t length, size_t offset, size_t size, const vector<Char>& chars, bool last)
+    {
+        const Char* set = chars.data();
+        size_t count = chars.size();
+        vector<Char> plain;
+        int result = -1;
+
+        // Surrogates are rare in a set; they are searched one by one.
+        if (any_of(chars.begin(), chars.end(), [](Char ch) { return U16_IS_SURROGATE(ch); })) {
+            for (Char ch : chars) {
+                if (U16_IS_SURROGATE(ch)) {
+                    result = Closer(result, FindChar(data, length, offset, size, ch, last), last);
+                } else {
+                    plain.push_back(ch);
+                }
+            }
+
+            set = plain.data();
+            count = plain.size();
+        }
+
+        const Char* match = last ? Text::FindLastAnyChar(data + offset, size, set, count) : Text::FindAnyChar(data + offset, size, set, count);
+        return Closer(result, match ? (int)(match - data) : -1, last);
+    }
+
+    //! FindChar for compact strings, which hold no character above 0xFF.
+    static int FindByte(const uint8_t* data, size_t offset, size_t size, Char ch, bool last)
+    {
+        if (ch > 0xFF || size == 0) {
+            return -1;
+        } else if (!last) {
+            const void* result = memchr(data + offset, (int)ch, size);
+            return result ? (int)(static_cast<const uint8_t*>(result) - data) : -1;
+        }
+
+        for (size_t i = offset + size; i > offset; i--) {
+            if (data[i - 1] == ch) {
+                return (int)(i - 1);
+            }
+        }
+
+        return -1;
+    }
+
+    //! FindAnyChar for compact strings.
+    static int FindAnyByte(const uint8_t* data, size_t offset, size_t size, const vector<Char>& chars, bool last)
+    {
+        bool set[256] = {};
+
+        for (Char ch : chars) {
+            if (ch <= 0xFF) {
+                set[ch] = true;
+            }
+        }
+
+        for (size_t i = 0; i < size; i++) {
+            size_t index = last ? offset + size - 1 - i : offset + i;
+
+            if (set[data[index]]) {
+                return (int)index;
+            }
+        }
+
+        return -1;
+    }
+
+    //! Code unit order of two ranges, -1, 0 or 1.
+    template <typename L, typename R>
+    static int CompareRanges(const L* lhs, size_t lhsSize, const R* rhs, size_t rhsSize)
+    {
+        size_t size = min(lhsSize, rhsSize);
+
+        for (size_t i = 0; i < size; i++) {
+            if (lhs[i] != rhs[i]) {
+                return (Char)lhs[i] < (Char)rhs[i] ? -1 : 1;
+            }
+        }
+
+        return (lhsSize > rhsSize) - (lhsSize < rhsSize);
+    }
+
+    //! Turkish and Azeri map I and i to dotless and dotted forms, and
+    //! Lithuanian keeps the dot of i below accents. ToLower and ToUpper
+    //! go through ICU with the default locale in these languages.
+    static bool HasLocaleCasing()
+    {
+        const char* language = Locale::getDefault().getLanguage();
+        return strcmp(language, "tr") == 0 || strcmp(language, "az") == 0 || strcmp(language, "lt") == 0;
+    }
+
+    static inline uint64_t HashMix(uint64_t hash, uint64_t word)
+    {
+        hash = (hash ^ word) * 0x9E3779B97F4A7C15ULL;
+        return hash ^ (hash >> 32);
+    }
+
+    /**
+     * Non-cryptographic hash over UTF-16 code units. Four units are consumed
+     * per step; the result is finalized so the low bits used by hash tables
+     * depend on every character.
+     */
+    static size_t HashChars(const Char* data, size_t length)
+    {
+        uint64_t hash = 0xCBF29CE484222325ULL ^ (length * 0x100000001B3ULL);
+        uint64_t tail = 0;
+        size_t i = 0;
+
+        for (; i + 4 <= length; i += 4) {
+            uint64_t word;
+            memcpy(&word, data + i, sizeof(word));
+            hash = HashMix(hash, word);
+        }
+
+        for (; i < length; i++) {
+            tail = (tail << 16) | (uint16_t)data[i];
+        }
+
+        hash = HashMix(hash, tail);
+        hash ^= hash >> 29;
+        hash *= 0xBF58476D1CE4E5B9ULL;
+        hash ^= hash >> 32;
+        return (size_t)hash;
+    }
+
+    //! HashChars over the UTF-16 units of Latin-1 bytes.
+    static size_t HashBytes(const uint8_t* data, size_t length)
+    {
+        uint64_t hash = 0xCBF29CE484222325ULL ^ (length * 0x100000001B3ULL);
+        uint64_t tail = 0;
+        size_t i = 0;
+
+        // Spreads four bytes into the little-endian layout of four units.
+        for (; i + 4 <= length; i += 4) {
+            uint32_t bytes;
+            memcpy(&bytes, data + i, sizeof(bytes));
+            uint64_t word = bytes;
+            word = (word | (word << 16)) & 0x0000FFFF0000FFFFULL;
+            word = (word | (word << 8)) & 0x00FF00FF00FF00FFULL;
+            hash = HashMix(hash, word);
+        }
+
+        for (; i < length; i++) {
+            tail = (tail << 16) | data[i];
+        }
+
+        hash = HashMix(hash, tail);
+        hash ^= hash >> 29;
+        hash *= 0xBF58476D1CE4E5B9ULL;
+        hash ^= hash >> 32;
+        return (size_t)hash;
+    }
+
+    static bool IsLatin1(const Char* data, size_t length)
+    {
+        Char bits = 0;
+
+        for (size_t i = 0; i < length; i++) {
+            bits |= data[i];
+        }
+
+        return bits <= 0xFF;
+    }
+
+    static bool IsAsciiBytes(const uint8_t* data, size_t length)
+    {
+        uint8_t bits = 0;
+
+        for (size_t i = 0; i < length; i++) {
+            bits |= data[i];
+        }
+
+        return bits < 0x80;
+    }
+
+    //! Counts the characters of UTF-8 text that only encodes U+0000 to
+    //! U+00FF; fails for anything else, including malformed sequences.
+    static bool MeasureLatin1(const char* data, size_t size, size_t* length)
+    {
+        size_t count = 0;
+
+        for (size_t i = 0; i < size; i++, count++) {
+            uint8_t byte = (uint8_t)data[i];
+
+            if (byte >= 0x80) {
+                if ((byte != 0xC2 && byte != 0xC3) || i + 1 == size || ((uint8_t)data[i + 1] & 0xC0) != 0x80) {
+                    return false;
+                }
+
+                i++;
+            }
+        }
+
+        *length = count;
+        return true;
+    }
+
+    String::String()
+    {
+        mSmall[0] = 0;
     }
 
     String::String(Char ch, size_t count)
     {
-        mString = new UnicodeString(ComputeCapacity(count), ch, count);
-        mCount = new size_t(1);
-#ifdef _DEBUG
-        mDebugString = ToUTF8();
-#endif
+        if (count > SmallCapacity && ch <= 0xFF) {
+            memset(InitializeCompact(count), (int)ch, count);
+            return;
+        }
+
+        Char* data = Initialize(count);
+
+        for (size_t i = 0; i < count; i++) {
+            data[i] = ch;
+        }
     }
 
     String::String(const char* str)
     {
-        mString = new UnicodeString(UnicodeString::fromUTF8(StringPiece(str, strlen(str))));
-        mCount = new size_t(1);
-#ifdef _DEBUG
-        mDebugString = ToUTF8();
-#endif
+        size_t length = strlen(str);
+        size_t i = 0;
+
+        while (i < length && (uint8_t)str[i] < 0x80) {
+            i++;
+        }
+
+        if (i == length && length > SmallCapacity) {
+            memcpy(InitializeCompact(length), str, length);
+            MarkAscii(true);
+        } else if (i == length) {
+            Char* data = Initialize(length);
+
+            for (i = 0; i < length; i++) {
+                data[i] = (Char)str[i];
+            }
+        } else {
+            mSmall[0] = 0;
+            *this = FromUTF8(string(str, length));
+        }
     }
 
     String::String(const Char* str) : String(str, 0, u_strlen(str))
@@ -79,20 +380,13 @@ namespace Lupus {
             throw out_of_range("size");
         }
 
-        mString = new UnicodeString(str + offset, size);
-        mCount = new size_t(1);
-#ifdef _DEBUG
-        mDebugString = ToUTF8();
-#endif
+        Assign(str + offset, size);
     }
 
     String::String(const string& str)
     {
-        mString = new UnicodeString(UnicodeString::fromUTF8(StringPiece(str.c_str(), str.length())));
-        mCount = new size_t(1);
-#ifdef _DEBUG
-        mDebugString = ToUTF8();
-#endif
+        mSmall[0] = 0;
+        *this = FromUTF8(str);
     }
 
     String::String(const string& str, size_t offset, size_t size)
@@ -103,21 +397,20 @@ namespace Lupus {
             throw out_of_range("size");
         }
 
-        mString = new UnicodeString(UnicodeString::fromUTF8(StringPiece(str.c_str() + offset, size)));
-        mCount = new size_t(1);
-#ifdef _DEBUG
-        mDebugString = ToUTF8();
-#endif
+        mSmall[0] = 0;
+        *this = FromUTF8(str.substr(offset, size));
     }
 
     String::String(const String& str)
     {
-        mString = str.mString;
-        mCount = str.mCount;
-        AddRef();
-#ifdef _DEBUG
-        mDebugString = ToUTF8();
-#endif
+        mLength = str.mLength;
+
+        if (mLength <= SmallCapacity) {
+            CopyChars(mSmall, str.mSmall, mLength + 1);
+        } else {
+            mBuffer = str.mBuffer;
+            AddRef();
+        }
     }
 
     String::String(const String& str, size_t offset, size_t size)
@@ -128,105 +421,140 @@ namespace Lupus {
             throw out_of_range("size");
         }
 
-        mString = new UnicodeString(*((UnicodeString*)str.mString), offset, size);
-        mCount = new size_t(1);
-#ifdef _DEBUG
-        mDebugString = ToUTF8();
-#endif
+        if (size > SmallCapacity && str.mBuffer->Compact) {
+            memcpy(InitializeCompact(size), str.mBuffer->Bytes() + offset, size);
+        } else {
+            str.Read(Initialize(size), offset, size);
+        }
+
+        if (str.mLength > SmallCapacity && str.mBuffer->Ascii.load(memory_order_relaxed) == Buffer::AsciiOnly) {
+            MarkAscii(true);
+        }
     }
 
     String::String(String&& str)
     {
-        mString = str.mString;
-        mCount = str.mCount;
-        str.mString = nullptr;
-        str.mCount = nullptr;
-#ifdef _DEBUG
-        mDebugString = ToUTF8();
-#endif
+        mLength = str.mLength;
+
+        if (mLength <= SmallCapacity) {
+            CopyChars(mSmall, str.mSmall, mLength + 1);
+        } else {
+            mBuffer = str.mBuffer;
+            str.mLength = 0;
+            str.mSmall[0] = 0;
+        }
     }
 
-    String::String(void* string)
+    String::String(const StringConcat& concat)
     {
-        mString = string;
-        mCount = new size_t(1);
-#ifdef _DEBUG
-        mDebugString = ToUTF8();
-#endif
+        const StringConcat::Operand& operand = concat.mOperands[0];
+
+        // A single moved string keeps its buffer instead of being copied.
+        if (concat.mCount == 1 && operand.mType == StringConcat::Operand::Type::Buffer) {
+            mLength = operand.mLength;
+            mBuffer = static_cast<Buffer*>(const_cast<void*>(operand.mPointer));
+            AddRef();
+        } else {
+            concat.Write(Initialize(concat.Measure()));
+        }
     }
 
     String::~String()
     {
-        if (mString && ReleaseRef() == 0) {
-            if (mCount) {
-                delete mCount;
-                mCount = nullptr;
-            }
-
-            delete mString;
-            mString = nullptr;
-        }
+        Release();
     }
 
     Char& String::operator[](size_t index)
     {
-        if (index > (size_t)((UnicodeString*)mString)->length()) {
+        if (index > mLength) {
             throw out_of_range("index");
         }
 
-        return *(const_cast<Char*>(((UnicodeString*)mString)->getTerminatedBuffer() + index));
+        return MutableData()[index];
     }
 
     const Char& String::operator[](size_t index) const
     {
-        if (index > (size_t)((UnicodeString*)mString)->length()) {
+        if (index > mLength) {
             throw out_of_range("index");
         }
 
-        return *(((UnicodeString*)mString)->getTerminatedBuffer() + index);
+        return Data()[index];
+    }
+
+    String::const_iterator String::begin() const
+    {
+        if (mLength <= SmallCapacity) {
+            return const_iterator(mSmall);
+        } else if (mBuffer->Compact) {
+            return const_iterator(mBuffer->Bytes());
+        }
+
+        return const_iterator(mBuffer->Data);
     }
 
     String String::Clone() const
     {
-        return String(new UnicodeString(*((UnicodeString*)mString)));
+        return String(*this, 0, mLength);
     }
 
     const Char* String::Data() const
     {
-        return ((UnicodeString*)mString)->getTerminatedBuffer();
+        return (mLength <= SmallCapacity) ? mSmall : mBuffer->Widen(mLength);
     }
 
     const Char* String::Data(size_t startIndex) const
     {
-        if (startIndex > (size_t)((UnicodeString*)mString)->length()) {
+        if (startIndex > mLength) {
             throw out_of_range("startIndex");
         }
 
-        return ((UnicodeString*)mString)->getTerminatedBuffer() + startIndex;
+        return Data() + startIndex;
+    }
+
+    bool String::IsAscii() const
+    {
+        if (mLength <= SmallCapacity) {
+            return Text::IsAscii(mSmall, mLength);
+        }
+
+        int ascii = mBuffer->Ascii.load(memory_order_relaxed);
+
+        if (ascii == Buffer::AsciiUnknown) {
+            bool result = mBuffer->Compact ? IsAsciiBytes(mBuffer->Bytes(), mLength) : Text::IsAscii(mBuffer->Data, mLength);
+            ascii = result ? Buffer::AsciiOnly : Buffer::NotAscii;
+            mBuffer->Ascii.store(ascii, memory_order_relaxed);
+        }
+
+        return ascii == Buffer::AsciiOnly;
     }
 
     bool String::IsEmpty() const
     {
-        return ((UnicodeString*)mString)->isEmpty() == TRUE;
+        return mLength == 0;
     }
 
     size_t String::Length() const
     {
-        return ((UnicodeString*)mString)->length();
+        return mLength;
     }
 
     String String::Append(Char ch) const
     {
-        auto result = new UnicodeString(*((UnicodeString*)mString));
-        result->append(ch);
-        return String(result);
+        String result;
+        Char* data = result.Initialize(mLength + 1);
+        Read(data, 0, mLength);
+        data[mLength] = ch;
+        return result;
     }
 
     String String::Append(String str) const
     {
-        auto result = new UnicodeString(*((UnicodeString*)mString));
-        result->append(*((UnicodeString*)str.mString));
-        return String(result);
+        String result;
+        Char* data = result.Initialize(mLength + str.mLength);
+        Read(data, 0, mLength);
+        str.Read(data + mLength, 0, str.mLength);
+        return result;
     }
 
     String String::Append(String str, size_t offset, size_t size) const
@@ -237,19 +565,21 @@ namespace Lupus {
             throw out_of_range("size");
         }
 
-        auto result = new UnicodeString(*((UnicodeString*)mString));
-        result->append(*((UnicodeString*)str.mString), offset, size);
-        return String(result);
+        String result;
+        Char* data = result.Initialize(mLength + size);
+        Read(data, 0, mLength);
+        str.Read(data + mLength, offset, size);
+        return result;
     }
 
     int String::Compare(String str, StringCaseSensitivity sens) const
     {
-        switch (sens) {
-            case StringCaseSensitivity::CaseSensitive:
-                return ((UnicodeString*)mString)->compare(*((UnicodeString*)str.mString));
-            case StringCaseSensitivity::CaseInsensitive:
-                return ((UnicodeString*)mString)->caseCompare(*((UnicodeString*)str.mString), 0);
+        if (sens == StringCaseSensitivity::CaseInsensitive) {
+            StringChars lhs(*this), rhs(str);
+            return StringView(lhs.Data(), mLength).Compare(StringView(rhs.Data(), str.mLength), sens);
         }
+
+        return CompareUnits(*this, 0, mLength, str, 0, str.mLength);
     }
 
     int String::Compare(String str, size_t offset, size_t size, StringCaseSensitivity sens) const
@@ -260,19 +590,19 @@ namespace Lupus {
             throw out_of_range("size");
         }
 
-        switch (sens) {
-            case StringCaseSensitivity::CaseSensitive:
-                return ((UnicodeString*)mString)->compare(0, ((UnicodeString*)mString)->length(), *((UnicodeString*)str.mString), offset, size);
-            case StringCaseSensitivity::CaseInsensitive:
-                return ((UnicodeString*)mString)->caseCompare(0, ((UnicodeString*)mString)->length(), *((UnicodeString*)str.mString), offset, size, 0);
+        if (sens == StringCaseSensitivity::CaseInsensitive) {
+            StringChars lhs(*this), rhs(str);
+            return StringView(lhs.Data(), mLength).Compare(StringView(rhs.Data() + offset, size), sens);
         }
+
+        return CompareUnits(*this, 0, mLength, str, offset, size);
     }
 
     int String::Compare(size_t offset, size_t size, String cmpStr, size_t cmpOffset, size_t cmpSize, StringCaseSensitivity sens) const
     {
-        if (offset > (size_t)((UnicodeString*)mString)->length()) {
+        if (offset > mLength) {
             throw out_of_range("offset");
-        } else if (size > (size_t)((UnicodeString*)mString)->length() - offset) {
+        } else if (size > mLength - offset) {
             throw out_of_range("size");
         } else if (cmpOffset > cmpStr.Length()) {
             throw out_of_range("cmpOffset");
@@ -280,22 +610,22 @@ namespace Lupus {
             throw out_of_range("cmpSize");
         }
 
-        switch (sens) {
-            case StringCaseSensitivity::CaseSensitive:
-                return ((UnicodeString*)mString)->compare(offset, size, *((UnicodeString*)cmpStr.mString), offset, size);
-            case StringCaseSensitivity::CaseInsensitive:
-                return ((UnicodeString*)mString)->caseCompare(offset, size, *((UnicodeString*)cmpStr.mString), offset, size, 0);
+        if (sens == StringCaseSensitivity::CaseInsensitive) {
+            StringChars lhs(*this), rhs(cmpStr);
+            return StringView(lhs.Data() + offset, size).Compare(StringView(rhs.Data() + cmpOffset, cmpSize), sens);
         }
+
+        return CompareUnits(*this, offset, size, cmpStr, cmpOffset, cmpSize);
     }
 
     bool String::Contains(String str) const
     {
-        return ((UnicodeString*)mString)->indexOf(*((UnicodeString*)str.mString)) != -1;
+        return str.mLength == 1 ? IndexOf(str.mSmall[0]) != -1 : IndexOf(str) != -1;
     }
 
     void String::CopyTo(size_t srcIndex, std::vector<Char>& dst, size_t dstIndex, size_t dstSize) const
     {
-        if (srcIndex > (size_t)((UnicodeString*)mString)->length()) {
+        if (srcIndex > mLength) {
             throw out_of_range("srcIndex");
         } else if (dstIndex > dst.size()) {
             throw out_of_range("dstIndex");
@@ -303,12 +633,13 @@ namespace Lupus {
             throw out_of_range("dstSize");
         }
 
-        ((UnicodeString*)mString)->extract((int32_t)srcIndex, (int32_t)dstSize, &dst[0], (int32_t)dstIndex);
+        StringChars chars(*this);
+        UnicodeString(TRUE, chars.Data(), (int32_t)mLength).extract((int32_t)srcIndex, (int32_t)dstSize, &dst[0], (int32_t)dstIndex);
     }
 
     bool String::EndsWith(String str) const
     {
-        return ((UnicodeString*)mString)->endsWith(*((UnicodeString*)str.mString)) == TRUE;
+        return mLength >= str.mLength && CompareUnits(*this, mLength - str.mLength, str.mLength, str, 0, str.mLength) == 0;
     }
 
     bool String::EndsWith(String str, size_t offset, size_t size) const
@@ -319,335 +650,372 @@ namespace Lupus {
             throw out_of_range("size");
         }
 
-        return ((UnicodeString*)mString)->endsWith(*((UnicodeString*)str.mString), offset, size) == TRUE;
+        return mLength >= size && CompareUnits(*this, mLength - size, size, str, offset, size) == 0;
+    }
+
+    size_t String::GetHashCode(StringCaseSensitivity sens) const
+    {
+        if (sens == StringCaseSensitivity::CaseInsensitive) {
+            StringChars chars(*this);
+            const Char* data = chars.Data();
+            Char folded[64];
+            size_t i = 0;
+
+            // ASCII keys such as header names are folded on the stack.
+            for (; i < mLength && i < 64 && data[i] < 0x80; i++) {
+                folded[i] = (data[i] >= 'A' && data[i] <= 'Z') ? data[i] + ('a' - 'A') : data[i];
+            }
+
+            if (i == mLength) {
+                return HashChars(folded, mLength);
+            }
+
+            UErrorCode error = U_ZERO_ERROR;
+            int32_t length = u_strFoldCase(nullptr, 0, data, (int32_t)mLength, U_FOLD_CASE_DEFAULT, &error);
+            vector<Char> buffer(length + 1);
+            error = U_ZERO_ERROR;
+            u_strFoldCase(&buffer[0], length + 1, data, (int32_t)mLength, U_FOLD_CASE_DEFAULT, &error);
+            return HashChars(&buffer[0], length);
+        } else if (mLength <= SmallCapacity) {
+            return HashChars(mSmall, mLength);
+        }
+
+        size_t hash = mBuffer->Hash.load(memory_order_relaxed);
+
+        if (hash == 0) {
+            hash = mBuffer->Compact ? HashBytes(mBuffer->Bytes(), mLength) : HashChars(mBuffer->Data, mLength);
+            mBuffer->Hash.store(hash, memory_order_relaxed);
+        }
+
+        return hash;
     }
 
     int String::IndexOf(Char ch) const
     {
-        return ((UnicodeString*)mString)->indexOf(ch);
+        return Find(ch, 0, mLength, false);
     }
 
     int String::IndexOf(String str) const
     {
-        return ((UnicodeString*)mString)->indexOf(*((UnicodeString*)str.mString));
+        StringChars chars(*this), pattern(str);
+        return Text::Searcher(StringView(pattern.Data(), str.mLength)).IndexOf(StringView(chars.Data(), mLength));
     }
 
     int String::IndexOf(Char ch, size_t offset) const
     {
-        if (offset > (size_t)((UnicodeString*)mString)->length()) {
+        if (offset > mLength) {
             throw out_of_range("offset");
         }
 
-        return ((UnicodeString*)mString)->indexOf(ch, offset);
+        return Find(ch, offset, mLength - offset, false);
     }
 
     int String::IndexOf(String str, size_t offset) const
     {
-        if (offset > (size_t)((UnicodeString*)mString)->length()) {
+        if (offset > mLength) {
             throw out_of_range("offset");
         }
 
-        return ((UnicodeString*)mString)->indexOf(*((UnicodeString*)str.mString), offset);
+        StringChars chars(*this), pattern(str);
+        return Text::Searcher(StringView(pattern.Data(), str.mLength)).IndexOf(StringView(chars.Data(), mLength), offset);
     }
 
     int String::IndexOf(Char ch, size_t offset, size_t size) const
     {
-        if (offset > (size_t)((UnicodeString*)mString)->length()) {
+        if (offset > mLength) {
             throw out_of_range("offset");
-        } else if (size > (size_t)((UnicodeString*)mString)->length() - offset) {
+        } else if (size > mLength - offset) {
             throw out_of_range("size");
         }
 
-        return ((UnicodeString*)mString)->indexOf(ch, offset, size);
+        return Find(ch, offset, size, false);
     }
 
     int String::IndexOf(String str, size_t offset, size_t size) const
     {
-        if (offset > (size_t)((UnicodeString*)mString)->length()) {
+        if (offset > mLength) {
             throw out_of_range("offset");
-        } else if (size > (size_t)((UnicodeString*)mString)->length() - offset) {
+        } else if (size > mLength - offset) {
             throw out_of_range("size");
         }
 
-        return ((UnicodeString*)mString)->indexOf(*((UnicodeString*)str.mString), offset, size);
+        StringChars chars(*this), pattern(str);
+        const Char* result = Text::Searcher(StringView(pattern.Data(), str.mLength)).Find(chars.Data() + offset, size);
+        return result ? (int)(result - chars.Data()) : -1;
     }
 
     int String::IndexOfAny(const std::vector<Char>& chars) const
     {
-        int result = -1;
-
-        for (const Char& ch : chars) {
-            if ((result = IndexOf(ch)) != -1) {
-                break;
-            }
-        }
-
-        return result;
+        return FindAny(chars, 0, mLength, false);
     }
 
     int String::IndexOfAny(const std::vector<Char>& chars, size_t offset) const
     {
-        int result = -1;
-
-        for (const Char& ch : chars) {
-            if ((result = IndexOf(ch, offset)) != -1) {
-                break;
-            }
+        if (offset > mLength) {
+            throw out_of_range("offset");
         }
 
-        return result;
+        return FindAny(chars, offset, mLength - offset, false);
     }
 
     int String::IndexOfAny(const std::vector<Char>& chars, size_t offset, size_t size) const
     {
-        int result = -1;
-
-        for (const Char& ch : chars) {
-            if ((result = IndexOf(ch, offset, size)) != -1) {
-                break;
-            }
+        if (offset > mLength) {
+            throw out_of_range("offset");
+        } else if (size > mLength - offset) {
+            throw out_of_range("size");
         }
 
-        return result;
+        return FindAny(chars, offset, size, false);
     }
 
     String String::Insert(size_t startIndex, Char ch) const
     {
-        if (startIndex > (size_t)((UnicodeString*)mString)->length()) {
+        if (startIndex > mLength) {
             throw out_of_range("startIndex");
         }
 
-        auto result = new UnicodeString(*((UnicodeString*)mString));
-        result->insert(startIndex, ch);
-        return String(result);
+        return Insert(startIndex, String(ch));
     }
 
     String String::Insert(size_t startIndex, String str) const
     {
-        if (startIndex > (size_t)((UnicodeString*)mString)->length()) {
+        if (startIndex > mLength) {
             throw out_of_range("startIndex");
         }
 
-        auto result = new UnicodeString(*((UnicodeString*)mString));
-        result->insert(startIndex, *((UnicodeString*)str.mString));
-        return String(result);
+        return Insert(startIndex, str, 0, str.mLength);
     }
 
     String String::Insert(size_t startIndex, String str, size_t offset, size_t size) const
     {
-        if (startIndex > (size_t)((UnicodeString*)mString)->length()) {
+        if (startIndex > mLength) {
             throw out_of_range("startIndex");
-        } else if (offset > (size_t)((UnicodeString*)mString)->length()) {
+        } else if (offset > str.mLength) {
             throw out_of_range("offset");
-        } else if (size > (size_t)((UnicodeString*)mString)->length() - offset) {
+        } else if (size > str.mLength - offset) {
             throw out_of_range("size");
         }
 
-        auto result = new UnicodeString(*((UnicodeString*)mString));
-        result->insert(startIndex, *((UnicodeString*)str.mString), offset, size);
-        return String(result);
+        String result;
+        Char* data = result.Initialize(mLength + size);
+        Read(data, 0, startIndex);
+        str.Read(data + startIndex, offset, size);
+        Read(data + startIndex + size, startIndex, mLength - startIndex);
+        return result;
     }
 
     int String::LastIndexOf(Char ch) const
     {
-        return ((UnicodeString*)mString)->lastIndexOf(ch);
+        return Find(ch, 0, mLength, true);
     }
 
     int String::LastIndexOf(String str) const
     {
-        return ((UnicodeString*)mString)->lastIndexOf(*((UnicodeString*)str.mString));
+        StringChars chars(*this), pattern(str);
+        return UnicodeString(TRUE, chars.Data(), (int32_t)mLength).lastIndexOf(pattern.Data(), (int32_t)str.mLength, 0);
     }
 
     int String::LastIndexOf(Char ch, size_t offset) const
     {
-        if (offset > (size_t)((UnicodeString*)mString)->length()) {
+        if (offset > mLength) {
             throw out_of_range("offset");
         }
 
-        return ((UnicodeString*)mString)->lastIndexOf(ch, offset);
+        return Find(ch, offset, mLength - offset, true);
     }
 
     int String::LastIndexOf(String str, size_t offset) const
     {
-        if (offset > (size_t)((UnicodeString*)mString)->length()) {
+        if (offset > mLength) {
             throw out_of_range("offset");
         }
 
-        return ((UnicodeString*)mString)->lastIndexOf(*((UnicodeString*)str.mString), offset);
+        StringChars chars(*this), pattern(str);
+        return UnicodeString(TRUE, chars.Data(), (int32_t)mLength).lastIndexOf(pattern.Data(), (int32_t)str.mLength, offset);
     }
 
     int String::LastIndexOf(Char ch, size_t offset, size_t size) const
     {
-        if (offset > (size_t)((UnicodeString*)mString)->length()) {
+        if (offset > mLength) {
             throw out_of_range("offset");
-        } else if (size > (size_t)((UnicodeString*)mString)->length() - offset) {
+        } else if (size > mLength - offset) {
             throw out_of_range("size");
         }
 
-        return ((UnicodeString*)mString)->lastIndexOf(ch, offset, size);
+        return Find(ch, offset, size, true);
     }
 
     int String::LastIndexOf(String str, size_t offset, size_t size) const
     {
-        if (offset > (size_t)((UnicodeString*)mString)->length()) {
+        if (offset > mLength) {
             throw out_of_range("offset");
-        } else if (size > (size_t)((UnicodeString*)mString)->length() - offset) {
+        } else if (size > mLength - offset) {
             throw out_of_range("size");
         }
 
-        return ((UnicodeString*)mString)->lastIndexOf(*((UnicodeString*)str.mString), offset, size);
+        StringChars chars(*this), pattern(str);
+        return UnicodeString(TRUE, chars.Data(), (int32_t)mLength).lastIndexOf(pattern.Data(), 0, (int32_t)str.mLength, offset, size);
     }
 
     int String::LastIndexOfAny(const std::vector<Char>& chars) const
     {
-        int result = -1;
-
-        for (const Char& ch : chars) {
-            if ((result = LastIndexOf(ch)) != -1) {
-                break;
-            }
-        }
-
-        return result;
+        return FindAny(chars, 0, mLength, true);
     }
 
     int String::LastIndexOfAny(const std::vector<Char>& chars, size_t offset) const
     {
-        int result = -1;
-
-        for (const Char& ch : chars) {
-            if ((result = LastIndexOf(ch, offset)) != -1) {
-                break;
-            }
+        if (offset > mLength) {
+            throw out_of_range("offset");
         }
 
-        return result;
+        return FindAny(chars, offset, mLength - offset, true);
     }
 
     int String::LastIndexOfAny(const std::vector<Char>& chars, size_t offset, size_t size) const
     {
-        int result = -1;
-
-        for (const Char& ch : chars) {
-            if ((result = LastIndexOf(ch, offset, size)) != -1) {
-                break;
-            }
+        if (offset > mLength) {
+            throw out_of_range("offset");
+        } else if (size > mLength - offset) {
+            throw out_of_range("size");
         }
 
-        return result;
+        return FindAny(chars, offset, size, true);
     }
 
     String String::Remove(size_t startIndex) const
     {
-        if (startIndex > (size_t)((UnicodeString*)mString)->length()) {
+        if (startIndex > mLength) {
             throw out_of_range("startIndex");
         }
 
-        auto result = new UnicodeString(*((UnicodeString*)mString));
-        result->remove(startIndex);
-        return String(result);
+        return String(*this, 0, startIndex);
     }
 
     String String::Remove(size_t startIndex, size_t count) const
     {
-        if (startIndex > (size_t)((UnicodeString*)mString)->length()) {
+        if (startIndex > mLength) {
             throw out_of_range("startIndex");
-        } else if (count > (size_t)((UnicodeString*)mString)->length() - startIndex) {
+        } else if (count > mLength - startIndex) {
             throw out_of_range("count");
         }
 
-        auto result = new UnicodeString(*((UnicodeString*)mString));
-        result->remove(startIndex, count);
-        return String(result);
+        String result;
+        Char* data = result.Initialize(mLength - count);
+        Read(data, 0, startIndex);
+        Read(data + startIndex, startIndex + count, mLength - startIndex - count);
+        return result;
     }
 
     String String::Replace(Char oldCh, Char newCh) const
     {
-        auto result = new UnicodeString(*((UnicodeString*)mString));
-        result->findAndReplace(UnicodeString(oldCh), UnicodeString(newCh));
-        return String(result);
+        if (U16_IS_SURROGATE(oldCh) || U16_IS_SURROGATE(newCh)) {
+            StringChars chars(*this);
+            UnicodeString result(chars.Data(), (int32_t)mLength);
+            result.findAndReplace(UnicodeString(oldCh), UnicodeString(newCh));
+            return String(result.getTerminatedBuffer(), 0, result.length());
+        }
+
+        String result(*this, 0, mLength);
+        Char* data = result.MutableData();
+
+        for (size_t i = 0; i < mLength; i++) {
+            if (data[i] == oldCh) {
+                data[i] = newCh;
+            }
+        }
+
+        return result;
     }
 
     String String::Replace(String oldStr, String newStr) const
     {
-        auto result = new UnicodeString(*((UnicodeString*)mString));
-        result->findAndReplace(*((UnicodeString*)oldStr.mString), *((UnicodeString*)newStr.mString));
-        return String(result);
+        if (oldStr.IsEmpty()) {
+            return *this;
+        }
+
+        StringChars chars(*this), pattern(oldStr);
+        Text::Searcher searcher(StringView(pattern.Data(), oldStr.mLength));
+        const Char* data = chars.Data();
+        vector<size_t> matches;
+
+        for (const Char* match = searcher.Find(data, mLength); match; match = searcher.Find(match + oldStr.mLength, data + mLength - match - oldStr.mLength)) {
+            matches.push_back(match - data);
+        }
+
+        if (matches.empty()) {
+            return *this;
+        }
+
+        String result;
+        Char* it = result.Initialize(mLength - matches.size() * oldStr.mLength + matches.size() * newStr.mLength);
+        size_t previous = 0;
+
+        for (size_t index : matches) {
+            CopyChars(it, data + previous, index - previous);
+            it += index - previous;
+            newStr.Read(it, 0, newStr.mLength);
+            it += newStr.mLength;
+            previous = index + oldStr.mLength;
+        }
+
+        CopyChars(it, data + previous, mLength - previous);
+        return result;
+    }
+
+    String String::ReplaceAll(const vector<pair<String, String>>& replacements) const
+    {
+        return Text::MultiReplacer(replacements).Replace(*this);
     }
 
     String String::Reverse() const
     {
-        auto result = new UnicodeString(*((UnicodeString*)mString));
-        result->reverse();
-        return String(result);
+        return Reverse(0, mLength);
     }
 
     String String::Reverse(size_t startIndex, size_t count) const
     {
-        if (startIndex > (size_t)((UnicodeString*)mString)->length()) {
+        if (startIndex > mLength) {
             throw out_of_range("startIndex");
-        } else if (count > (size_t)((UnicodeString*)mString)->length() - startIndex) {
+        } else if (count > mLength - startIndex) {
             throw out_of_range("count");
         }
 
-        auto result = new UnicodeString(*((UnicodeString*)mString));
-        result->reverse(startIndex, count);
-        return String(result);
-    }
-
-    vector<String> String::Split(const vector<Char>& delimiter, StringSplitOption option) const
-    {
-        vector<String> result;
-        int32_t previousIndex = 0;
-
-        for (int32_t i = 0; i < ((UnicodeString*)mString)->length(); i++) {
-            for (auto ch : delimiter) {
-                if (((UnicodeString*)mString)->operator[](i) == ch) {
-                    String str;
+        String result(*this, 0, mLength);
+        Char* data = result.MutableData() + startIndex;
+        bool hasSurrogates = false;
 
-                    if (option == StringSplitOption::RemoveEmptyEntries && i == previousIndex) {
-                        continue;
-                    } else if (i != previousIndex) {
-                        str = this->Substring(previousIndex, i);
-                    }
+        for (size_t left = 0, right = count; left + 1 < right;) {
+            Char swap = data[left];
+            hasSurrogates |= U16_IS_SURROGATE(swap) || U16_IS_SURROGATE(data[right - 1]);
+            data[left++] = data[--right];
+            data[right] = swap;
+        }
 
-                    result.push_back(str);
-                    previousIndex = i + 1;
-                }
+        // Surrogate pairs have been reversed as well and are restored here.
+        for (size_t i = 0; hasSurrogates && i + 1 < count; i++) {
+            if (U16_IS_TRAIL(data[i]) && U16_IS_LEAD(data[i + 1])) {
+                Char swap = data[i];
+                data[i] = data[i + 1];
+                data[++i] = swap;
             }
         }
 
         return result;
     }
 
+    vector<String> String::Split(const vector<Char>& delimiter, StringSplitOption option) const
+    {
+        return Split(delimiter, (size_t)-1, option);
+    }
+
     vector<String> String::Split(const vector<Char>& delimiter, size_t count, StringSplitOption option) const
     {
+        StringChars chars(*this);
         vector<String> result;
-        int32_t previousIndex = 0;
-
-        for (int32_t i = 0; i < ((UnicodeString*)mString)->length(); i++) {
-            for (auto ch : delimiter) {
-                if (((UnicodeString*)mString)->operator[](i) == ch) {
-                    String str;
-
-                    if (option == StringSplitOption::RemoveEmptyEntries && i == previousIndex) {
-                        continue;
-                    } else if (i != previousIndex) {
-                        str = this->Substring(previousIndex, i);
-                    }
-
-                    result.push_back(str);
-                    previousIndex = i + 1;
-
-                    if (result.size() == count) {
-                        break;
-                    }
-                }
 
-                if (result.size() == count) {
-                    break;
-                }
-            }
+        for (StringView part : Text::SplitEnumerator(StringView(chars.Data(), mLength), delimiter, count, option)) {
+            result.push_back(part.ToString());
         }
 
         return result;
@@ -655,58 +1023,16 @@ namespace Lupus {
 
     vector<String> String::Split(const String& str, StringSplitOption option) const
     {
-        vector<String> result;
-        int32_t previousIndex = 0;
-        int32_t savedIndex = -1;
-
-        for (int32_t index = ((UnicodeString*)mString)->indexOf(str.Data(), str.Length(), 0); index != -1; savedIndex = index, index = ((UnicodeString*)mString)->indexOf(str.Data(), str.Length(), index + 1)) {
-            String tmp;
-
-            if (option == StringSplitOption::RemoveEmptyEntries && index == previousIndex) {
-                continue;
-            } else if (index != previousIndex) {
-                tmp = Substring(previousIndex, index - previousIndex);
-            }
-
-            result.push_back(tmp);
-            previousIndex = index + str.Length();
-        }
-
-        if (savedIndex != previousIndex && (size_t)previousIndex < Length() - 1) {
-            result.push_back(Substring(previousIndex));
-        }
-
-        return result;
+        return Split(str, (size_t)-1, option);
     }
 
     vector<String> String::Split(const String& str, size_t count, StringSplitOption option) const
     {
+        StringChars chars(*this);
         vector<String> result;
-        int32_t previousIndex = 0;
-        int32_t savedIndex = -1;
-
-        for (int32_t index = ((UnicodeString*)mString)->indexOf(str.Data(), str.Length(), 0); index != -1; savedIndex = index, index = ((UnicodeString*)mString)->indexOf(str.Data(), str.Length(), index + 1)) {
-            String tmp;
 
-            if (option == StringSplitOption::RemoveEmptyEntries && index == previousIndex) {
-                continue;
-            } else if (index != previousIndex) {
-                tmp = Substring(previousIndex, index - previousIndex);
-            }
-
-            result.push_back(tmp);
-            previousIndex = index + str.Length();
-
-            if (result.size() == count) {
-                break;
-            }
-        }
-
-
-        if (result.size() < count) {
-            if (savedIndex != previousIndex && (size_t)previousIndex < Length() - 1) {
-                result.push_back(Substring(previousIndex));
-            }
+        for (StringView part : Text::SplitEnumerator(StringView(chars.Data(), mLength), str, count, option)) {
+            result.push_back(part.ToString());
         }
 
         return result;
@@ -714,195 +1040,444 @@ namespace Lupus {
 
     bool String::StartsWith(String str) const
     {
-        return ((UnicodeString*)mString)->startsWith(*((UnicodeString*)str.mString)) == TRUE;
+        return mLength >= str.mLength && CompareUnits(*this, 0, str.mLength, str, 0, str.mLength) == 0;
     }
 
     bool String::StartsWith(String str, size_t offset, size_t size) const
     {
-        if (offset > (size_t)((UnicodeString*)mString)->length()) {
+        if (offset > str.mLength) {
             throw out_of_range("offset");
-        } else if (size > (size_t)((UnicodeString*)mString)->length() - offset) {
+        } else if (size > str.mLength - offset) {
             throw out_of_range("size");
         }
 
-        return ((UnicodeString*)mString)->startsWith(*((UnicodeString*)str.mString), offset, size) == TRUE;
+        return mLength >= size && CompareUnits(*this, 0, size, str, offset, size) == 0;
     }
 
     String String::Substring(size_t startIndex) const
     {
-        if (startIndex > (size_t)((UnicodeString*)mString)->length()) {
+        if (startIndex > mLength) {
             throw out_of_range("startIndex");
         }
 
-        return String(new UnicodeString(((UnicodeString*)mString)->getTerminatedBuffer() + startIndex));
+        return String(*this, startIndex, mLength - startIndex);
     }
 
     String String::Substring(size_t startIndex, size_t count) const
     {
-        if (startIndex > (size_t)((UnicodeString*)mString)->length()) {
+        if (startIndex > mLength) {
             throw out_of_range("startIndex");
-        } else if (count > (size_t)((UnicodeString*)mString)->length() - startIndex) {
+        } else if (count > mLength - startIndex) {
             throw out_of_range("count");
         }
 
-        return String(new UnicodeString(((UnicodeString*)mString)->getTerminatedBuffer() + startIndex, count));
+        return String(*this, startIndex, count);
     }
 
     String String::ToLower() const
     {
-        auto result = new UnicodeString(*((UnicodeString*)mString));
-        result->toLower();
-        return String(result);
+        String result;
+        bool fast = !HasLocaleCasing();
+
+        // Every Latin-1 letter has a Latin-1 lower case form.
+        if (fast && mLength > SmallCapacity && mBuffer->Compact) {
+            const uint8_t* bytes = mBuffer->Bytes();
+            uint8_t* data = result.InitializeCompact(mLength);
+
+            for (size_t i = 0; i < mLength; i++) {
+                uint8_t byte = bytes[i];
+                data[i] = ((byte >= 'A' && byte <= 'Z') || (byte >= 0xC0 && byte <= 0xDE && byte != 0xD7)) ? byte + 0x20 : byte;
+            }
+
+            result.mBuffer->Ascii.store(mBuffer->Ascii.load(memory_order_relaxed), memory_order_relaxed);
+            return result;
+        }
+
+        StringChars chars(*this);
+
+        if (fast && IsAscii()) {
+            Text::ToLowerAscii(result.Initialize(mLength), chars.Data(), mLength);
+            result.MarkAscii(true);
+            return result;
+        }
+
+        UErrorCode error = U_ZERO_ERROR;
+        int32_t length = u_strToLower(result.Initialize(mLength), (int32_t)mLength + 1, chars.Data(), (int32_t)mLength, nullptr, &error);
+
+        if (error == U_BUFFER_OVERFLOW_ERROR || (size_t)length != mLength) {
+            result.Release();
+            error = U_ZERO_ERROR;
+            u_strToLower(result.Initialize(length), length + 1, chars.Data(), (int32_t)mLength, nullptr, &error);
+        }
+
+        return result;
     }
 
     String String::ToUpper() const
     {
-        auto result = new UnicodeString(*((UnicodeString*)mString));
-        result->toUpper();
-        return String(result);
+        String result;
+        bool fast = !HasLocaleCasing();
+
+        // Apart from micro sign, sharp s and y with diaeresis, Latin-1 letters
+        // have Latin-1 upper case forms; strings with those go through ICU.
+        if (fast && mLength > SmallCapacity && mBuffer->Compact) {
+            const uint8_t* bytes = mBuffer->Bytes();
+
+            if (!memchr(bytes, 0xB5, mLength) && !memchr(bytes, 0xDF, mLength) && !memchr(bytes, 0xFF, mLength)) {
+                uint8_t* data = result.InitializeCompact(mLength);
+
+                for (size_t i = 0; i < mLength; i++) {
+                    uint8_t byte = bytes[i];
+                    data[i] = ((byte >= 'a' && byte <= 'z') || (byte >= 0xE0 && byte <= 0xFE && byte != 0xF7)) ? byte - 0x20 : byte;
+                }
+
+                result.mBuffer->Ascii.store(mBuffer->Ascii.load(memory_order_relaxed), memory_order_relaxed);
+                return result;
+            }
+        }
+
+        StringChars chars(*this);
+
+        if (fast && IsAscii()) {
+            Text::ToUpperAscii(result.Initialize(mLength), chars.Data(), mLength);
+            result.MarkAscii(true);
+            return result;
+        }
+
+        UErrorCode error = U_ZERO_ERROR;
+        int32_t length = u_strToUpper(result.Initialize(mLength), (int32_t)mLength + 1, chars.Data(), (int32_t)mLength, nullptr, &error);
+
+        if (error == U_BUFFER_OVERFLOW_ERROR || (size_t)length != mLength) {
+            result.Release();
+            error = U_ZERO_ERROR;
+            u_strToUpper(result.Initialize(length), length + 1, chars.Data(), (int32_t)mLength, nullptr, &error);
+        }
+
+        return result;
     }
 
     string String::ToUTF8() const
     {
-        string result;
-        return ((UnicodeString*)mString)->toUTF8String<string>(result);
+        if (mLength > SmallCapacity) {
+            Buffer::Utf8Cache* cache = mBuffer->Utf8.load(memory_order_acquire);
+
+            CountUtf8(sUtf8Requests);
+
+            if (cache) {
+                CountUtf8(sUtf8Hits);
+                return string(cache->Data, cache->Length);
+            } else if (mBuffer->Compact) {
+                const uint8_t* bytes = mBuffer->Bytes();
+                string result(Text::MeasureLatin1(bytes, mLength), '\0');
+                Text::EncodeLatin1((uint8_t*)&result[0], bytes, mLength);
+                return result;
+            }
+        }
+
+        string result(mLength * 3, '\0');
+        UErrorCode error = U_ZERO_ERROR;
+        int32_t length = 0;
+
+        u_strToUTF8WithSub(&result[0], (int32_t)result.size(), &length, Data(), (int32_t)mLength, 0xFFFD, nullptr, &error);
+        result.resize(U_SUCCESS(error) ? length : 0);
+        return result;
+    }
+
+    StringUtf8 String::Utf8() const
+    {
+        StringUtf8 result;
+        UErrorCode error = U_ZERO_ERROR;
+        int32_t length = 0;
+
+        if (mLength <= SmallCapacity) {
+            u_strToUTF8WithSub(result.mSmall, (int32_t)StringUtf8::SmallCapacity, &length, mSmall, (int32_t)mLength, 0xFFFD, nullptr, &error);
+            result.mLength = U_SUCCESS(error) ? length : 0;
+            result.mSmall[result.mLength] = 0;
+            return result;
+        }
+
+        Buffer::Utf8Cache* cache = mBuffer->Utf8.load(memory_order_acquire);
+
+        CountUtf8(sUtf8Requests);
+
+        if (cache) {
+            CountUtf8(sUtf8Hits);
+        } else {
+            bool ascii = IsAscii();
+
+            if (ascii) {
+                length = (int32_t)mLength;
+            } else if (mBuffer->Compact) {
+                length = (int32_t)Text::MeasureLatin1(mBuffer->Bytes(), mLength);
+            } else {
+                u_strToUTF8WithSub(nullptr, 0, &length, mBuffer->Data, (int32_t)mLength, 0xFFFD, nullptr, &error);
+                length = (error != U_BUFFER_OVERFLOW_ERROR && U_FAILURE(error)) ? 0 : length;
+            }
+
+            Buffer::Utf8Cache* created = static_cast<Buffer::Utf8Cache*>(::operator new(sizeof(Buffer::Utf8Cache) + length));
+            created->Length = length;
+
+            if (ascii && mBuffer->Compact) {
+                memcpy(created->Data, mBuffer->Bytes(), mLength);
+            } else if (ascii) {
+                Text::NarrowLatin1((uint8_t*)created->Data, mBuffer->Data, mLength, 0x7F);
+            } else if (mBuffer->Compact) {
+                Text::EncodeLatin1((uint8_t*)created->Data, mBuffer->Bytes(), mLength);
+            } else if (length > 0) {
+                error = U_ZERO_ERROR;
+                u_strToUTF8WithSub(created->Data, length, nullptr, mBuffer->Data, (int32_t)mLength, 0xFFFD, nullptr, &error);
+            }
+
+            created->Data[length] = 0;
+
+            // Another thread may have encoded the same buffer meanwhile.
+            if (mBuffer->Utf8.compare_exchange_strong(cache, created, memory_order_acq_rel)) {
+                cache = created;
+                CountUtf8(sUtf8Encoded);
+                CountUtf8(sUtf8Bytes, length);
+            } else {
+                ::operator delete(created);
+            }
+        }
+
+        result.mData = cache->Data;
+        result.mLength = cache->Length;
+        return result;
     }
 
     u16string String::ToUTF16() const
     {
-        return u16string((const char16_t*)((UnicodeString*)mString)->getTerminatedBuffer());
+        StringChars chars(*this);
+        return u16string((const char16_t*)chars.Data(), mLength);
     }
 
     u32string String::ToUTF32() const
     {
-        UErrorCode errorCode;
-        Char32* utf32 = new Char32[((UnicodeString*)mString)->countChar32()];
-        ((UnicodeString*)mString)->toUTF32(force_cast<UChar32*>(utf32), ((UnicodeString*)mString)->countChar32(), errorCode);
+        StringChars chars(*this);
+        UErrorCode error = U_ZERO_ERROR;
+        int32_t length = 0;
 
-        if (errorCode != U_ZERO_ERROR) {
+        u_strToUTF32(nullptr, 0, &length, chars.Data(), (int32_t)mLength, &error);
+
+        if (error != U_BUFFER_OVERFLOW_ERROR && U_FAILURE(error)) {
+            throw runtime_error("Error while converting to UTF32");
+        }
+
+        u32string result(length, U'\0');
+        error = U_ZERO_ERROR;
+        u_strToUTF32(force_cast<UChar32*>(&result[0]), length + 1, nullptr, chars.Data(), (int32_t)mLength, &error);
+
+        if (U_FAILURE(error)) {
             throw runtime_error("Error while converting to UTF32");
         }
 
-        u32string result((char32_t*)utf32);
-        delete utf32;
         return result;
     }
 
     String String::Trim() const
     {
-        auto result = new UnicodeString(*((UnicodeString*)mString));
-        result->trim();
-        return String(result);
+        StringChars chars(*this);
+        StringView view = StringView(chars.Data(), mLength).Trim();
+
+        if (view.Length() == mLength) {
+            return *this;
+        }
+
+        return String(*this, view.Data() - chars.Data(), view.Length());
     }
 
     bool String::operator==(String str) const
     {
-        return ((UnicodeString*)mString)->operator==(*((UnicodeString*)str.mString)) == TRUE;
+        if (mLength != str.mLength) {
+            return false;
+        } else if (mLength <= SmallCapacity) {
+            return memcmp(mSmall, str.mSmall, mLength * sizeof(Char)) == 0;
+        } else if (mBuffer == str.mBuffer) {
+            return true;
+        } else if (mBuffer->Compact && str.mBuffer->Compact) {
+            return memcmp(mBuffer->Bytes(), str.mBuffer->Bytes(), mLength) == 0;
+        } else if (mBuffer->Compact != str.mBuffer->Compact) {
+            const uint8_t* bytes = (mBuffer->Compact ? mBuffer : str.mBuffer)->Bytes();
+            const Char* data = (mBuffer->Compact ? str.mBuffer : mBuffer)->Data;
+
+            for (size_t i = 0; i < mLength; i++) {
+                if (data[i] != bytes[i]) {
+                    return false;
+                }
+            }
+
+            return true;
+        }
+
+        return memcmp(mBuffer->Data, str.mBuffer->Data, mLength * sizeof(Char)) == 0;
     }
 
     bool String::operator!=(String str) const
     {
-        return ((UnicodeString*)mString)->operator!=(*((UnicodeString*)str.mString)) == TRUE;
+        return !(*this == str);
     }
 
     bool String::operator<(String str) const
     {
-        return ((UnicodeString*)mString)->operator<(*((UnicodeString*)str.mString)) == TRUE;
+        return Compare(str) < 0;
     }
 
     bool String::operator>(String str) const
     {
-        return ((UnicodeString*)mString)->operator>(*((UnicodeString*)str.mString)) == TRUE;
+        return Compare(str) > 0;
     }
 
     bool String::operator<=(String str) const
     {
-        return ((UnicodeString*)mString)->operator<=(*((UnicodeString*)str.mString)) == TRUE;
+        return Compare(str) <= 0;
     }
 
     bool String::operator>=(String str) const
     {
-        return ((UnicodeString*)mString)->operator>=(*((UnicodeString*)str.mString)) == TRUE;
+        return Compare(str) >= 0;
     }
 
-    String String::operator+(Char ch) const
+    String& String::operator=(Char ch)
     {
-        auto result = new UnicodeString(*((UnicodeString*)mString));
-        result->append(ch);
-        return String(result);
+        Release();
+        Initialize(1)[0] = ch;
+        return *this;
     }
 
-    String String::operator+(const String& str) const
+    String& String::operator=(const String& str)
     {
-        auto result = new UnicodeString(*((UnicodeString*)mString));
-        result->append(*((UnicodeString*)str.mString));
-        return String(result);
+        if (this != &str) {
+            String copy(str);
+            *this = std::move(copy);
+        }
+
+        return *this;
     }
 
-    String& String::operator=(Char ch)
+    String& String::operator=(String&& str)
     {
-        if (ReleaseRef() == 0) {
-            delete mString;
-            delete mCount;
+        if (this != &str) {
+            Release();
+            mLength = str.mLength;
+
+            if (mLength <= SmallCapacity) {
+                CopyChars(mSmall, str.mSmall, mLength + 1);
+            } else {
+                mBuffer = str.mBuffer;
+                str.mLength = 0;
+                str.mSmall[0] = 0;
+            }
         }
 
-        mString = new UnicodeString(ch);
-        mCount = new size_t(1);
-#ifdef _DEBUG
-        mDebugString = ToUTF8();
-#endif
         return *this;
     }
 
-    String& String::operator=(const String& str)
+    String& String::operator+=(Char ch)
+    {
+        return *this += String(ch);
+    }
+
+    String& String::operator+=(const String& str)
     {
-        if (ReleaseRef() == 0) {
-            delete mString;
-            delete mCount;
+        size_t length = mLength + str.mLength;
+
+        if (str.mLength == 0) {
+            return *this;
+        } else if (mLength > SmallCapacity && !mBuffer->Compact && mBuffer->RefCount.load(memory_order_acquire) == 1 && mBuffer->Capacity >= length) {
+            str.Read(mBuffer->Data + mLength, 0, str.mLength);
+            mBuffer->Data[length] = 0;
+            mBuffer->Invalidate();
+            mLength = length;
+            return *this;
+        } else if (length <= SmallCapacity) {
+            memmove(mSmall + mLength, str.mSmall, str.mLength * sizeof(Char));
+            mSmall[length] = 0;
+            mLength = length;
+            return *this;
         }
 
-        mString = str.mString;
-        mCount = str.mCount;
-        AddRef();
-#ifdef _DEBUG
-        mDebugString = ToUTF8();
-#endif
+        // Grow geometrically so repeated appends stay amortized linear.
+        Buffer* buffer = Buffer::Create(max(length, mLength + mLength / 2));
+        Read(buffer->Data, 0, mLength);
+        str.Read(buffer->Data + mLength, 0, str.mLength);
+        buffer->Data[length] = 0;
+        Release();
+        mBuffer = buffer;
+        mLength = length;
         return *this;
     }
 
-    String& String::operator=(String&& str)
+    String& String::operator+=(const char* str)
     {
-        mString = str.mString;
-        mCount = str.mCount;
-        str.mString = nullptr;
-        str.mCount = nullptr;
-#ifdef _DEBUG
-        mDebugString = ToUTF8();
-#endif
-        return *this;
+        return *this += StringConcat(str);
     }
 
-    String& String::operator+=(Char ch)
+    String& String::operator+=(const Char* str)
     {
-        *((UnicodeString*)mString) += ch;
-#ifdef _DEBUG
-        mDebugString = ToUTF8();
-#endif
-        return *this;
+        return *this += StringConcat(str);
     }
 
-    String& String::operator+=(const String& str)
+    String& String::operator+=(const StringConcat& concat)
     {
-        *((UnicodeString*)mString) += *((UnicodeString*)str.mString);
-#ifdef _DEBUG
-        mDebugString = ToUTF8();
-#endif
+        size_t count = concat.Measure();
+        size_t length = mLength + count;
+
+        // The operands may refer to this string, so its length is only
+        // updated after they have been written behind the current end.
+        if (count == 0) {
+            return *this;
+        } else if (mLength > SmallCapacity && !mBuffer->Compact && mBuffer->RefCount.load(memory_order_acquire) == 1 && mBuffer->Capacity >= length) {
+            concat.Write(mBuffer->Data + mLength);
+            mBuffer->Data[length] = 0;
+            mBuffer->Invalidate();
+            mLength = length;
+            return *this;
+        } else if (length <= SmallCapacity) {
+            concat.Write(mSmall + mLength);
+            mSmall[length] = 0;
+            mLength = length;
+            return *this;
+        }
+
+        Buffer* buffer = Buffer::Create(max(length, mLength + mLength / 2));
+        Read(buffer->Data, 0, mLength);
+        concat.Write(buffer->Data + mLength);
+        buffer->Data[length] = 0;
+        Release();
+        mBuffer = buffer;
+        mLength = length;
         return *this;
     }
 
     String String::FromUTF8(const string& str)
     {
-        return String(new UnicodeString(UnicodeString::fromUTF8(StringPiece(str.c_str(), str.length()))));
+        String result;
+        UErrorCode error = U_ZERO_ERROR;
+        int32_t length = 0;
+        size_t latin1 = 0;
+
+        if (str.length() > SmallCapacity && MeasureLatin1(str.data(), str.length(), &latin1) && latin1 > SmallCapacity) {
+            uint8_t* bytes = result.InitializeCompact(latin1);
+
+            for (size_t i = 0; i < str.length(); i++) {
+                uint8_t byte = (uint8_t)str[i];
+                *bytes++ = byte < 0x80 ? byte : (uint8_t)((byte << 6) | (str[++i] & 0x3F));
+            }
+
+            result.MarkAscii(latin1 == str.length());
+            return result;
+        }
+
+        u_strFromUTF8WithSub(nullptr, 0, &length, str.data(), (int32_t)str.length(), 0xFFFD, nullptr, &error);
+
+        if (error != U_BUFFER_OVERFLOW_ERROR && U_FAILURE(error)) {
+            return result;
+        }
+
+        error = U_ZERO_ERROR;
+        u_strFromUTF8WithSub(result.Initialize(length), length + 1, nullptr, str.data(), (int32_t)str.length(), 0xFFFD, nullptr, &error);
+        result.Compact();
+        return result;
     }
 
     String String::FromUTF16(const u16string& str)
@@ -912,22 +1487,107 @@ namespace Lupus {
 
     String String::FromUTF32(const u32string& str)
     {
-        return String(new UnicodeString(UnicodeString::fromUTF32((const UChar32*)str.data(), str.length())));
+        String result;
+        UErrorCode error = U_ZERO_ERROR;
+        int32_t length = 0;
+
+        u_strFromUTF32WithSub(nullptr, 0, &length, (const UChar32*)str.data(), (int32_t)str.length(), 0xFFFD, nullptr, &error);
+
+        if (error != U_BUFFER_OVERFLOW_ERROR && U_FAILURE(error)) {
+            return result;
+        }
+
+        error = U_ZERO_ERROR;
+        u_strFromUTF32WithSub(result.Initialize(length), length + 1, nullptr, (const UChar32*)str.data(), (int32_t)str.length(), 0xFFFD, nullptr, &error);
+        result.Compact();
+        return result;
+    }
+
+    String String::Intern(const String& str)
+    {
+        if (str.mLength <= SmallCapacity) {
+            return str;
+        }
+
+        InternPool* pool = GetInternPool();
+        lock_guard<mutex> lock(pool->Lock);
+        auto result = pool->Entries.insert(str);
+
+        pool->Statistics.Lookups++;
+
+        if (!result.second) {
+            const String& pooled = *result.first;
+
+            pool->Statistics.Hits++;
+
+            // A buffer with other owners stays alive, so replacing it saves nothing.
+            if (str.mBuffer != pooled.mBuffer && str.mBuffer->RefCount.load(memory_order_relaxed) == 1) {
+                pool->Statistics.BytesSaved += str.mBuffer->Size();
+            }
+        }
+
+        return *result.first;
+    }
+
+    String String::IsInterned(const String& str)
+    {
+        if (str.mLength <= SmallCapacity) {
+            return str;
+        }
+
+        InternPool* pool = GetInternPool();
+        lock_guard<mutex> lock(pool->Lock);
+        auto it = pool->Entries.find(str);
+
+        pool->Statistics.Lookups++;
+
+        if (it == pool->Entries.end()) {
+            return str;
+        }
+
+        pool->Statistics.Hits++;
+
+        if (str.mBuffer != it->mBuffer && str.mBuffer->RefCount.load(memory_order_relaxed) == 1) {
+            pool->Statistics.BytesSaved += str.mBuffer->Size();
+        }
+
+        return *it;
+    }
+
+    StringInternStatistics String::InternStatistics()
+    {
+        InternPool* pool = GetInternPool();
+        lock_guard<mutex> lock(pool->Lock);
+        StringInternStatistics result = pool->Statistics;
+
+        result.Count = pool->Entries.size();
+        return result;
+    }
+
+    StringUtf8Statistics String::Utf8Statistics()
+    {
+        StringUtf8Statistics result;
+
+        result.Requests = sUtf8Requests.load(memory_order_relaxed);
+        result.Hits = sUtf8Hits.load(memory_order_relaxed);
+        result.Encoded = sUtf8Encoded.load(memory_order_relaxed);
+        result.Bytes = sUtf8Bytes.load(memory_order_relaxed);
+        return result;
     }
 
     size_t String::AddRef()
     {
-        if (mCount) {
-            return (++(*mCount));
+        if (mLength > SmallCapacity) {
+            return mBuffer->RefCount.fetch_add(1, memory_order_relaxed) + 1;
         } else {
-            return 0;
+            return 1;
         }
     }
 
     size_t String::ReleaseRef()
     {
-        if (mCount) {
-            return (--(*mCount));
+        if (mLength > SmallCapacity) {
+            return mBuffer->RefCount.fetch_sub(1, memory_order_acq_rel) - 1;
         } else {
             return 0;
         }
@@ -935,10 +1595,10 @@ namespace Lupus {
 
     size_t String::RefCount() const
     {
-        if (mCount) {
-            return *mCount;
+        if (mLength > SmallCapacity) {
+            return mBuffer->RefCount.load(memory_order_acquire);
         } else {
-            return 0;
+            return 1;
         }
     }
 
@@ -947,6 +1607,434 @@ namespace Lupus {
         return ((length / Capacity) + 1) * Capacity;
     }
 
+    Char* String::Initialize(size_t length)
+    {
+        Char* data = mSmall;
+
+        if (length > SmallCapacity) {
+            mBuffer = Buffer::Create(length);
+            data = mBuffer->Data;
+        }
+
+        mLength = length;
+        data[length] = 0;
+        return data;
+    }
+
+    uint8_t* String::InitializeCompact(size_t length)
+    {
+        mBuffer = Buffer::CreateCompact(length);
+        mLength = length;
+        mBuffer->Bytes()[length] = 0;
+        return mBuffer->Bytes();
+    }
+
+    void String::Assign(const Char* data, size_t length)
+    {
+        if (length > SmallCapacity && IsLatin1(data, length)) {
+            uint8_t* bytes = InitializeCompact(length);
+
+            for (size_t i = 0; i < length; i++) {
+                bytes[i] = (uint8_t)data[i];
+            }
+        } else {
+            CopyChars(Initialize(length), data, length);
+        }
+    }
+
+    void String::Compact()
+    {
+        if (mLength <= SmallCapacity || mBuffer->Compact || !IsLatin1(mBuffer->Data, mLength)) {
+            return;
+        }
+
+        Buffer* buffer = mBuffer;
+        size_t length = mLength;
+        Assign(buffer->Data, length);
+        mBuffer->Ascii.store(buffer->Ascii.load(memory_order_relaxed), memory_order_relaxed);
+        Buffer::Release(buffer);
+    }
+
+    void String::Read(Char* dst, size_t offset, size_t count) const
+    {
+        if (mLength <= SmallCapacity) {
+            CopyChars(dst, mSmall + offset, count);
+        } else {
+            mBuffer->CopyTo(dst, offset, count);
+        }
+    }
+
+    int String::Find(Char ch, size_t offset, size_t size, bool last) const
+    {
+        if (mLength <= SmallCapacity) {
+            return FindChar(mSmall, mLength, offset, size, ch, last);
+        } else if (mBuffer->Compact) {
+            return FindByte(mBuffer->Bytes(), offset, size, ch, last);
+        } else {
+            return FindChar(mBuffer->Data, mLength, offset, size, ch, last);
+        }
+    }
+
+    int String::FindAny(const vector<Char>& chars, size_t offset, size_t size, bool last) const
+    {
+        if (mLength <= SmallCapacity) {
+            return FindAnyChar(mSmall, mLength, offset, size, chars, last);
+        } else if (mBuffer->Compact) {
+            return FindAnyByte(mBuffer->Bytes(), offset, size, chars, last);
+        } else {
+            return FindAnyChar(mBuffer->Data, mLength, offset, size, chars, last);
+        }
+    }
+
+    int String::CompareUnits(const String& lhs, size_t lhsOffset, size_t lhsSize, const String& rhs, size_t rhsOffset, size_t rhsSize)
+    {
+        bool lhsCompact = lhs.mLength > SmallCapacity && lhs.mBuffer->Compact;
+        bool rhsCompact = rhs.mLength > SmallCapacity && rhs.mBuffer->Compact;
+        const Char* lhsChars = lhs.mLength > SmallCapacity ? lhs.mBuffer->Data : lhs.mSmall;
+        const Char* rhsChars = rhs.mLength > SmallCapacity ? rhs.mBuffer->Data : rhs.mSmall;
+
+        if (lhsCompact && rhsCompact) {
+            // Latin-1 bytes sort like their code units.
+            int result = memcmp(lhs.mBuffer->Bytes() + lhsOffset, rhs.mBuffer->Bytes() + rhsOffset, min(lhsSize, rhsSize));
+
+            if (result != 0) {
+                return result < 0 ? -1 : 1;
+            }
+
+            return (lhsSize > rhsSize) - (lhsSize < rhsSize);
+        } else if (lhsCompact) {
+            return CompareRanges(lhs.mBuffer->Bytes() + lhsOffset, lhsSize, rhsChars + rhsOffset, rhsSize);
+        } else if (rhsCompact) {
+            return CompareRanges(lhsChars + lhsOffset, lhsSize, rhs.mBuffer->Bytes() + rhsOffset, rhsSize);
+        } else {
+            return CompareRanges(lhsChars + lhsOffset, lhsSize, rhsChars + rhsOffset, rhsSize);
+        }
+    }
+
+    Char* String::MutableData()
+    {
+        if (mLength <= SmallCapacity) {
+            return mSmall;
+        } else if (mBuffer->Compact || mBuffer->RefCount.load(memory_order_acquire) > 1) {
+            Buffer* buffer = Buffer::Create(mLength);
+            mBuffer->CopyTo(buffer->Data, 0, mLength + 1);
+
+            // The other owners may have let go in the meantime.
+            if (ReleaseRef() == 0) {
+                Buffer::Destroy(mBuffer);
+            }
+
+            mBuffer = buffer;
+        }
+
+        // The caller is about to write, so the cached values become stale.
+        mBuffer->Invalidate();
+        return mBuffer->Data;
+    }
+
+    void String::MarkAscii(bool ascii)
+    {
+        if (mLength > SmallCapacity) {
+            mBuffer->Ascii.store(ascii ? Buffer::AsciiOnly : Buffer::NotAscii, memory_order_relaxed);
+        }
+    }
+
+    void String::Release()
+    {
+        if (ReleaseRef() == 0 && mLength > SmallCapacity) {
+            Buffer::Destroy(mBuffer);
+        }
+
+        mLength = 0;
+        mSmall[0] = 0;
+    }
+
+    StringUtf8::StringUtf8() :
+        mData(mSmall)
+    {
+        mSmall[0] = 0;
+    }
+
+    StringUtf8::StringUtf8(const StringUtf8& str) :
+        mData(mSmall)
+    {
+        *this = str;
+    }
+
+    const char* StringUtf8::Data() const
+    {
+        return mData;
+    }
+
+    bool StringUtf8::IsEmpty() const
+    {
+        return mLength == 0;
+    }
+
+    size_t StringUtf8::Length() const
+    {
+        return mLength;
+    }
+
+    string StringUtf8::ToStdString() const
+    {
+        return string(mData, mLength);
+    }
+
+    StringUtf8& StringUtf8::operator=(const StringUtf8& str)
+    {
+        if (this == &str) {
+            return *this;
+        } else if (str.mData == str.mSmall) {
+            memcpy(mSmall, str.mSmall, str.mLength + 1);
+            mData = mSmall;
+        } else {
+            mData = str.mData;
+        }
+
+        mLength = str.mLength;
+        return *this;
+    }
+
+    StringConcat::StringConcat(const StringConcat& concat) :
+        mCount(0)
+    {
+        *this = concat;
+    }
+
+    StringConcat::StringConcat(StringConcat&& concat) :
+        mCount(0)
+    {
+        *this = move(concat);
+    }
+
+    StringConcat& StringConcat::operator=(const StringConcat& concat)
+    {
+        if (this != &concat) {
+            Clear();
+            Splice(Operand(concat));
+        }
+
+        return *this;
+    }
+
+    StringConcat& StringConcat::operator=(StringConcat&& concat)
+    {
+        if (this != &concat) {
+            Clear();
+
+            for (size_t i = 0; i < concat.mCount; i++) {
+                mOperands[i] = concat.mOperands[i];
+            }
+
+            mCount = concat.mCount;
+            concat.mCount = 0;
+        }
+
+        return *this;
+    }
+
+    const Char* StringConcat::Data() const
+    {
+        const Operand& operand = mOperands[0];
+
+        if (mCount == 1 && operand.mType == Operand::Type::String) {
+            return static_cast<const String*>(operand.mPointer)->Data();
+        } else if (mCount != 1 || (operand.mType != Operand::Type::Small && (operand.mType != Operand::Type::Buffer || static_cast<const String::Buffer*>(operand.mPointer)->Compact))) {
+            Collapse();
+        }
+
+        if (operand.mType == Operand::Type::Small) {
+            return operand.mSmall;
+        } else {
+            return static_cast<const String::Buffer*>(operand.mPointer)->Data;
+        }
+    }
+
+    size_t StringConcat::Length() const
+    {
+        return Measure();
+    }
+
+    String StringConcat::ToString() const
+    {
+        return String(*this);
+    }
+
+    void StringConcat::Splice(const Operand& operand)
+    {
+        if (operand.mType == Operand::Type::Concat || operand.mType == Operand::Type::MovedConcat) {
+            const StringConcat* concat = static_cast<const StringConcat*>(operand.mPointer);
+            size_t count = concat->mCount;
+
+            // A moved concatenation hands over the buffers it holds.
+            for (size_t i = 0; i < count; i++) {
+                Append(concat->mOperands[i]);
+
+                if (concat->mOperands[i].mType == Operand::Type::Buffer) {
+                    if (operand.mType == Operand::Type::MovedConcat) {
+                        concat->mOperands[i].mType = Operand::Type::None;
+                    } else {
+                        AddRef(concat->mOperands[i].mPointer);
+                    }
+                }
+            }
+        } else {
+            Collapse();
+            mOperands[mCount++] = operand;
+        }
+    }
+
+    void StringConcat::Collapse() const
+    {
+        String str;
+        Write(str.Initialize(Measure()));
+        Clear();
+        Take(mOperands[0], str);
+        mCount = 1;
+    }
+
+    void StringConcat::Clear() const
+    {
+        for (size_t i = 0; i < mCount; i++) {
+            if (mOperands[i].mType == Operand::Type::Buffer) {
+                Release(mOperands[i].mPointer);
+            }
+        }
+
+        mCount = 0;
+    }
+
+    void StringConcat::Take(Operand& operand, String& str)
+    {
+        operand.mLength = str.mLength;
+
+        if (str.mLength <= String::SmallCapacity) {
+            operand.mType = Operand::Type::Small;
+            CopyChars(operand.mSmall, str.mSmall, str.mLength + 1);
+        } else {
+            operand.mType = Operand::Type::Buffer;
+            operand.mPointer = str.mBuffer;
+            str.mLength = 0;
+            str.mSmall[0] = 0;
+        }
+    }
+
+    void StringConcat::AddRef(const void* buffer)
+    {
+        static_cast<String::Buffer*>(const_cast<void*>(buffer))->RefCount.fetch_add(1, memory_order_relaxed);
+    }
+
+    void StringConcat::Release(const void* buffer)
+    {
+        String::Buffer::Release(static_cast<String::Buffer*>(const_cast<void*>(buffer)));
+    }
+
+    size_t StringConcat::Measure(const Operand& operand)
+    {
+        switch (operand.mType) {
+            case Operand::Type::String:
+                return static_cast<const String*>(operand.mPointer)->mLength;
+            case Operand::Type::Small:
+            case Operand::Type::Buffer:
+                return operand.mLength;
+            case Operand::Type::Char:
+                return 1;
+            case Operand::Type::Chars:
+                operand.mLength = char_traits<Char>::length(static_cast<const Char*>(operand.mPointer));
+                return operand.mLength;
+            case Operand::Type::Utf8: {
+                const char* str = static_cast<const char*>(operand.mPointer);
+                size_t length = strlen(str);
+                size_t i = 0;
+                UErrorCode error = U_ZERO_ERROR;
+                int32_t size = 0;
+
+                while (i < length && (uint8_t)str[i] < 0x80) {
+                    i++;
+                }
+
+                // Remember ASCII operands so Write only widens them.
+                if (i == length) {
+                    operand.mType = Operand::Type::Ascii;
+                    operand.mLength = length;
+                    return length;
+                }
+
+                u_strFromUTF8WithSub(nullptr, 0, &size, str, (int32_t)length, 0xFFFD, nullptr, &error);
+                operand.mLength = (error != U_BUFFER_OVERFLOW_ERROR && U_FAILURE(error)) ? 0 : size;
+                return operand.mLength;
+            }
+            case Operand::Type::Ascii:
+                return operand.mLength;
+            default:
+                return 0;
+        }
+    }
+
+    Char* StringConcat::Write(const Operand& operand, Char* it)
+    {
+        switch (operand.mType) {
+            case Operand::Type::String: {
+                const String* str = static_cast<const String*>(operand.mPointer);
+                str->Read(it, 0, str->mLength);
+                return it + str->mLength;
+            }
+            case Operand::Type::Small:
+                CopyChars(it, operand.mSmall, operand.mLength);
+                return it + operand.mLength;
+            case Operand::Type::Buffer:
+                static_cast<const String::Buffer*>(operand.mPointer)->CopyTo(it, 0, operand.mLength);
+                return it + operand.mLength;
+            case Operand::Type::Char:
+                *it = (Char)operand.mLength;
+                return it + 1;
+            case Operand::Type::Chars:
+                CopyChars(it, static_cast<const Char*>(operand.mPointer), operand.mLength);
+                return it + operand.mLength;
+            case Operand::Type::Utf8: {
+                UErrorCode error = U_ZERO_ERROR;
+
+                if (operand.mLength > 0) {
+                    u_strFromUTF8WithSub(it, (int32_t)operand.mLength, nullptr, static_cast<const char*>(operand.mPointer), -1, 0xFFFD, nullptr, &error);
+                }
+
+                return it + operand.mLength;
+            }
+            case Operand::Type::Ascii: {
+                const char* str = static_cast<const char*>(operand.mPointer);
+
+                for (size_t i = 0; i < operand.mLength; i++) {
+                    it[i] = (Char)str[i];
+                }
+
+                return it + operand.mLength;
+            }
+            default:
+                return it;
+        }
+    }
+
+    size_t StringConcat::Measure() const
+    {
+        size_t length = 0;
+
+        for (size_t i = 0; i < mCount; i++) {
+            length += Measure(mOperands[i]);
+        }
+
+        return length;
+    }
+
+    Char* StringConcat::Write(Char* it) const
+    {
+        for (size_t i = 0; i < mCount; i++) {
+            it = Write(mOperands[i], it);
+        }
+
+        return it;
+    }
+
     Char ToChar(char ch)
     {
         return String(std::string(1, ch))[0];
@@ -26,6 +26,9 @@
 #include "IClonable.h"
 #include <vector>
 #include <functional>
+#include <iterator>
+#include <type_traits>
+#include <utility>
 
 #ifdef _MSC_VER
 #pragma warning(push)
@@ -41,6 +44,19 @@ namespace Lupus {
     typedef char32_t Char32;
 #endif
 
+    class StringChars;
+    class StringConcat;
+    class StringUtf8;
+    class StringView;
+
+    namespace Text {
+        class Encoding;
+        class FormatArgument;
+        class FormatString;
+        class MultiReplacer;
+        class StringBuilder;
+    }
+
     LUPUSCORE_API Char ToChar(char);
     LUPUSCORE_API Char ToChar(wchar_t);
 
@@ -54,19 +70,90 @@ namespace Lupus {
         CaseInsensitive
     };
 
+    //! Counters of the String::Intern pool.
+    struct StringInternStatistics
+    {
+        size_t Count;       //!< Number of pooled strings
+        size_t Lookups;     //!< Calls of Intern and IsInterned on heap strings
+        size_t Hits;        //!< Lookups answered from the pool
+        size_t BytesSaved;  //!< Heap bytes of unshared duplicates replaced by a pooled string
+    };
+
+    //! Counters of the UTF-8 cache behind String::Utf8(). Only debug
+    //! builds (_DEBUG) count; release builds report zeros.
+    struct StringUtf8Statistics
+    {
+        size_t Requests;    //!< Calls of Utf8 and ToUTF8 on heap strings
+        size_t Hits;        //!< Requests answered from the cache
+        size_t Encoded;     //!< Encodings added to the cache
+        size_t Bytes;       //!< Total size of the added encodings
+    };
+
+    //! Unicode string with value semantics.
+    //!
+    //! Copies share their characters until one of them is modified. The
+    //! shared reference count is atomic: different String objects may be
+    //! copied, read and modified on different threads even if they share
+    //! storage, so Clone() is never needed to pass a string to a thread.
+    //! A single String object must not be modified while another thread
+    //! reads or modifies the same object; the non-const operator[] and
+    //! begin()/end() count as modifications.
     class LUPUSCORE_API String
     {
     public:
 
+        /**
+         * Iterator over the characters of a const string. Strings stored as
+         * Latin-1 are read byte by byte, so iterating them never widens
+         * them; the characters are therefore returned by value.
+         */
+        class ConstIterator
+        {
+        public:
+
+            typedef std::random_access_iterator_tag iterator_category;
+            typedef Char value_type;
+            typedef ptrdiff_t difference_type;
+            typedef const Char* pointer;
+            typedef Char reference;
+
+            inline ConstIterator() : mChars(nullptr), mBytes(nullptr) {}
+            inline explicit ConstIterator(const Char* chars) : mChars(chars), mBytes(nullptr) {}
+            inline explicit ConstIterator(const uint8_t* bytes) : mChars(nullptr), mBytes(bytes) {}
+
+            inline Char operator*() const { return mBytes ? (Char)*mBytes : *mChars; }
+            inline Char operator[](difference_type n) const { return mBytes ? (Char)mBytes[n] : mChars[n]; }
+            inline ConstIterator& operator++() { return *this += 1; }
+            inline ConstIterator operator++(int) { ConstIterator it = *this; *this += 1; return it; }
+            inline ConstIterator& operator--() { return *this -= 1; }
+            inline ConstIterator operator--(int) { ConstIterator it = *this; *this -= 1; return it; }
+            inline ConstIterator& operator+=(difference_type n) { mBytes ? (void)(mBytes += n) : (void)(mChars += n); return *this; }
+            inline ConstIterator& operator-=(difference_type n) { return *this += -n; }
+            inline ConstIterator operator+(difference_type n) const { ConstIterator it = *this; return it += n; }
+            inline ConstIterator operator-(difference_type n) const { ConstIterator it = *this; return it += -n; }
+            inline difference_type operator-(const ConstIterator& it) const { return mBytes ? mBytes - it.mBytes : mChars - it.mChars; }
+            inline bool operator==(const ConstIterator& it) const { return mChars == it.mChars && mBytes == it.mBytes; }
+            inline bool operator!=(const ConstIterator& it) const { return !(*this == it); }
+            inline bool operator<(const ConstIterator& it) const { return *this - it < 0; }
+            inline bool operator>(const ConstIterator& it) const { return *this - it > 0; }
+            inline bool operator<=(const ConstIterator& it) const { return *this - it <= 0; }
+            inline bool operator>=(const ConstIterator& it) const { return *this - it >= 0; }
+
+        private:
+
+            const Char* mChars;
+            const uint8_t* mBytes;
+        };
+
         typedef Char* iterator;
-        typedef const Char* const_iterator;
+        typedef ConstIterator const_iterator;
 
         inline iterator begin() { return &this->operator[](0); }
-        inline const_iterator begin() const { return &this->operator[](0); }
-        inline const_iterator cbegin() const { return &this->operator[](0); }
+        const_iterator begin() const NOEXCEPT;
+        inline const_iterator cbegin() const { return this->begin(); }
         inline iterator end() { return &this->operator[](this->Length()); }
-        inline const_iterator end() const { return &this->operator[](this->Length()); }
-        inline const_iterator cend() const { return &this->operator[](this->Length()); }
+        inline const_iterator end() const { return this->begin() + this->Length(); }
+        inline const_iterator cend() const { return this->end(); }
 
         String();
         String(Char ch, size_t count = 1) NOEXCEPT;
@@ -78,13 +165,26 @@ namespace Lupus {
         String(const String& str) NOEXCEPT;
         String(const String& str, size_t offset, size_t size) throw(std::out_of_range);
         String(String&&) NOEXCEPT;
+        //! Materializes a concatenation with a single allocation.
+        String(const StringConcat& concat) NOEXCEPT;
         virtual ~String();
 
         Char& operator[](size_t index) throw(std::out_of_range);
+        //! Widens compact strings like Data(); read characters through
+        //! const_iterator to avoid that.
         const Char& operator[](size_t index) const throw(std::out_of_range);
         virtual String Clone() const NOEXCEPT;
+        /**
+         * UTF-16 characters of the string. Heap strings whose characters
+         * all fit into Latin-1 are stored with one byte per character; they
+         * are widened on the first call and keep the copy in their shared
+         * buffer, which then costs three bytes per character. The member
+         * functions of String and const_iterator never widen them.
+         */
         virtual const Char* Data() const NOEXCEPT;
         virtual const Char* Data(size_t startIndex) const throw(std::out_of_range);
+        //! True if every character is ASCII. Cached for heap strings.
+        virtual bool IsAscii() const NOEXCEPT;
         virtual bool IsEmpty() const NOEXCEPT;
         virtual size_t Length() const NOEXCEPT;
 
@@ -98,6 +198,9 @@ namespace Lupus {
         virtual void CopyTo(size_t srcIndex, std::vector<Char>& dst, size_t dstIndex, size_t count) const throw(std::out_of_range);
         virtual bool EndsWith(String str) const NOEXCEPT;
         virtual bool EndsWith(String str, size_t offset, size_t size) const throw(std::out_of_range);
+        //! Hash over the UTF-16 code units. The case sensitive value is
+        //! cached in the shared buffer; the insensitive one uses case folding.
+        virtual size_t GetHashCode(StringCaseSensitivity = StringCaseSensitivity::CaseSensitive) const NOEXCEPT;
         virtual int IndexOf(Char ch) const NOEXCEPT;
         virtual int IndexOf(String str) const NOEXCEPT;
         virtual int IndexOf(Char ch, size_t offset) const throw(std::out_of_range);
@@ -123,6 +226,8 @@ namespace Lupus {
         virtual String Remove(size_t startIndex, size_t count) const throw(std::out_of_range);
         virtual String Replace(Char oldCh, Char newCh) const NOEXCEPT;
         virtual String Replace(String oldStr, String newStr) const throw(std::out_of_range);
+        //! Replaces all pairs in one pass, see Text::MultiReplacer.
+        virtual String ReplaceAll(const std::vector<std::pair<String, String>>& replacements) const NOEXCEPT;
         virtual String Reverse() const NOEXCEPT;
         virtual String Reverse(size_t startIndex, size_t count) const throw(std::out_of_range);
         virtual std::vector<String> Split(const std::vector<Char>& delimiter, StringSplitOption = StringSplitOption::None) const throw(format_error);
@@ -136,6 +241,14 @@ namespace Lupus {
         virtual String ToLower() const NOEXCEPT;
         virtual String ToUpper() const NOEXCEPT;
         virtual std::string ToUTF8() const NOEXCEPT;
+        /**
+         * Returns the UTF-8 encoding without copying it. Heap strings encode
+         * once and keep the result in their shared buffer until they are
+         * modified, so repeated calls on the same or a copied string only
+         * return a pointer. Prefer this over ToUTF8() for strings that are
+         * handed to C APIs again and again, e.g. statement names.
+         */
+        virtual StringUtf8 Utf8() const NOEXCEPT;
         virtual std::u16string ToUTF16() const NOEXCEPT;
         virtual std::u32string ToUTF32() const throw(std::runtime_error);
         virtual String Trim() const NOEXCEPT;
@@ -146,18 +259,58 @@ namespace Lupus {
         bool operator>(String str) const NOEXCEPT;
         bool operator<=(String str) const NOEXCEPT;
         bool operator>=(String str) const NOEXCEPT;
-        String operator+(Char ch) const NOEXCEPT;
-        String operator+(const String& str) const NOEXCEPT;
         String& operator=(Char ch) NOEXCEPT;
         String& operator=(const String& str) NOEXCEPT;
         String& operator=(String&&);
         String& operator+=(Char ch) NOEXCEPT;
         String& operator+=(const String& str) NOEXCEPT;
+        String& operator+=(const char* str) NOEXCEPT;
+        String& operator+=(const Char* str) NOEXCEPT;
+        String& operator+=(const StringConcat& concat) NOEXCEPT;
 
         static String FromUTF8(const std::string& str);
         static String FromUTF16(const std::u16string& str);
         static String FromUTF32(const std::u32string& str);
 
+        /**
+         * Composite formatting as in .NET: "{index[,alignment][:format]}"
+         * with "{{" and "}}" for literal braces. Integers accept D, X and x
+         * with an optional minimum digit count, floating point numbers F, E
+         * and G with an optional precision; without a format they are
+         * written as by Float::ToString. All arguments are written into
+         * one buffer that is sized before the first character is copied.
+         *
+         * \param[in] format Composite format string.
+         * \param[in] args Integers, floating point numbers, bool, Char,
+         *                 String, StringView or null-terminated strings.
+         * \returns The formatted string.
+         */
+        template <typename... Args>
+        static String Format(const String& format, const Args&... args) throw(format_error);
+        //! Formats with a format string that has been parsed in advance.
+        template <typename... Args>
+        static String Format(const Text::FormatString& format, const Args&... args) throw(format_error);
+        //! Appends the formatted text to builder and returns builder.
+        template <typename... Args>
+        static Text::StringBuilder& FormatTo(Text::StringBuilder& builder, const String& format, const Args&... args) throw(format_error);
+        //! \sa String::FormatTo(Text::StringBuilder&, const String&, const Args&...)
+        template <typename... Args>
+        static Text::StringBuilder& FormatTo(Text::StringBuilder& builder, const Text::FormatString& format, const Args&... args) throw(format_error);
+
+        /**
+         * Returns the pooled string equal to str and adds str to the pool if
+         * there is none yet. All strings returned for equal input share one
+         * buffer, so comparing them is a pointer check. Pooled strings are
+         * never released; intern only bounded sets such as identifiers.
+         * Strings of up to 15 characters live inside the object; they are
+         * returned as they are and never enter the pool.
+         */
+        static String Intern(const String& str) NOEXCEPT;
+        //! Returns the pooled string equal to str, or str itself if none is pooled.
+        static String IsInterned(const String& str) NOEXCEPT;
+        static StringInternStatistics InternStatistics() NOEXCEPT;
+        static StringUtf8Statistics Utf8Statistics() NOEXCEPT;
+
     protected:
 
         size_t AddRef();
@@ -169,15 +322,186 @@ namespace Lupus {
 
     private:
 
-        explicit String(void*);
+        friend class StringChars;
+        friend class StringConcat;
+        friend class StringView;
+        friend class Utf8View;
+        friend class Text::Encoding;
+        friend class Text::FormatArgument;
+        friend class Text::MultiReplacer;
+        friend class Text::StringBuilder;
+
+        struct Buffer;
+
+        //! Strings up to this length are stored inside the object itself.
+        static const size_t SmallCapacity = 15;
+
+        Char* Initialize(size_t length);
+        //! Heap storage of one Latin-1 byte per character, see String::Buffer.
+        uint8_t* InitializeCompact(size_t length);
+        void Assign(const Char* data, size_t length);
+        //! Switches a freshly built heap string to compact storage if it fits.
+        void Compact();
+        void Read(Char* dst, size_t offset, size_t count) const;
+        //! Position of ch or any of chars within [offset, offset + size), or -1.
+        int Find(Char ch, size_t offset, size_t size, bool last) const;
+        int FindAny(const std::vector<Char>& chars, size_t offset, size_t size, bool last) const;
+        Char* MutableData();
+        //! Records the ASCII flag when a constructor already knows it.
+        void MarkAscii(bool ascii);
+        void Release();
+
+        //! Compares two ranges by code unit without widening compact strings.
+        static int CompareUnits(const String& lhs, size_t lhsOffset, size_t lhsSize, const String& rhs, size_t rhsOffset, size_t rhsSize);
+        static String FormatArguments(const String& format, const Text::FormatArgument* args, size_t count) throw(format_error);
+        static String FormatArguments(const Text::FormatString& format, const Text::FormatArgument* args, size_t count) throw(format_error);
+        static Text::StringBuilder& FormatArgumentsTo(Text::StringBuilder& builder, const String& format, const Text::FormatArgument* args, size_t count) throw(format_error);
+        static Text::StringBuilder& FormatArgumentsTo(Text::StringBuilder& builder, const Text::FormatString& format, const Text::FormatArgument* args, size_t count) throw(format_error);
+
+        union {
+            Buffer* mBuffer;
+            Char mSmall[SmallCapacity + 1];
+        };
+        size_t mLength = 0;
+    };
 
-        void* mString = nullptr;
-        size_t* mCount = nullptr;
-#ifdef _DEBUG
-        std::string mDebugString;
-#endif
+    //! UTF-8 encoding of a String as returned by String::Utf8().
+    //!
+    //! Refers to the encoding cached in the string's buffer; strings short
+    //! enough to live inside the String object are encoded into this object
+    //! instead. The bytes are null terminated and stay valid as long as the
+    //! String is neither modified nor destroyed.
+    class LUPUSCORE_API StringUtf8
+    {
+    public:
+
+        StringUtf8() NOEXCEPT;
+        StringUtf8(const StringUtf8& str) NOEXCEPT;
+        ~StringUtf8() = default;
+
+        const char* Data() const NOEXCEPT;
+        bool IsEmpty() const NOEXCEPT;
+        size_t Length() const NOEXCEPT;
+        std::string ToStdString() const NOEXCEPT;
+
+        StringUtf8& operator=(const StringUtf8& str) NOEXCEPT;
+
+    private:
+
+        friend class String;
+
+        //! Worst case for a string stored inside the object plus terminator.
+        static const size_t SmallCapacity = 3 * 15 + 1;
+
+        const char* mData;
+        size_t mLength = 0;
+        char mSmall[SmallCapacity];
     };
 
+    namespace Text {
+        //! Kind of value held by a FormatArgument.
+        enum class FormatArgumentType {
+            None,
+            Boolean,
+            Character,
+            Integer,
+            Unsigned,
+            Float,
+            String,
+            Utf8,
+            Latin1
+        };
+
+        //! Type erased argument of String::Format. Strings are referenced,
+        //! not copied; an argument is only valid during the Format call.
+        class LUPUSCORE_API FormatArgument
+        {
+        public:
+
+            inline FormatArgument() : mType(FormatArgumentType::None) { mUnsigned = 0; }
+            inline FormatArgument(bool value) : mType(FormatArgumentType::Boolean) { mUnsigned = value ? 1 : 0; }
+            inline FormatArgument(Char value) : mType(FormatArgumentType::Character) { mUnsigned = value; }
+            inline FormatArgument(char value) : mType(FormatArgumentType::Character) { mUnsigned = (uint8_t)value; }
+            inline FormatArgument(signed char value) : mType(FormatArgumentType::Integer), mSize(sizeof(value)) { mInteger = value; }
+            inline FormatArgument(short value) : mType(FormatArgumentType::Integer), mSize(sizeof(value)) { mInteger = value; }
+            inline FormatArgument(int value) : mType(FormatArgumentType::Integer), mSize(sizeof(value)) { mInteger = value; }
+            inline FormatArgument(long value) : mType(FormatArgumentType::Integer), mSize(sizeof(value)) { mInteger = value; }
+            inline FormatArgument(long long value) : mType(FormatArgumentType::Integer), mSize(sizeof(value)) { mInteger = value; }
+            inline FormatArgument(unsigned char value) : mType(FormatArgumentType::Unsigned), mSize(sizeof(value)) { mUnsigned = value; }
+            inline FormatArgument(unsigned short value) : mType(FormatArgumentType::Unsigned), mSize(sizeof(value)) { mUnsigned = value; }
+            inline FormatArgument(unsigned int value) : mType(FormatArgumentType::Unsigned), mSize(sizeof(value)) { mUnsigned = value; }
+            inline FormatArgument(unsigned long value) : mType(FormatArgumentType::Unsigned), mSize(sizeof(value)) { mUnsigned = value; }
+            inline FormatArgument(unsigned long long value) : mType(FormatArgumentType::Unsigned), mSize(sizeof(value)) { mUnsigned = value; }
+            inline FormatArgument(float value) : mType(FormatArgumentType::Float), mSize(sizeof(value)) { mFloat = value; }
+            inline FormatArgument(double value) : mType(FormatArgumentType::Float), mSize(sizeof(value)) { mFloat = value; }
+            inline FormatArgument(long double value) : mType(FormatArgumentType::Float), mSize(sizeof(double)) { mFloat = (double)value; }
+            //! Compact strings are passed as their Latin-1 bytes.
+            FormatArgument(const String& value) NOEXCEPT;
+            inline FormatArgument(const Char* value) : mType(FormatArgumentType::String), mLength(std::char_traits<Char>::length(value)) { mString = value; }
+            //! UTF-8 string.
+            inline FormatArgument(const char* value) : mType(FormatArgumentType::Utf8), mLength(std::char_traits<char>::length(value)) { mUtf8 = value; }
+            FormatArgument(const StringView& value) NOEXCEPT;
+
+            inline FormatArgumentType Type() const { return mType; }
+            //! Size in bytes of the original integer or floating point type.
+            inline size_t Size() const { return mSize; }
+            inline long long IntegerValue() const { return mInteger; }
+            inline unsigned long long UnsignedValue() const { return mUnsigned; }
+            inline double FloatValue() const { return mFloat; }
+            inline const Char* StringValue() const { return mString; }
+            inline const char* Utf8Value() const { return mUtf8; }
+            inline const uint8_t* Latin1Value() const { return mLatin1; }
+            //! Length of a String, Utf8 or Latin1 argument in code units.
+            inline size_t Length() const { return mLength; }
+
+        private:
+
+            FormatArgumentType mType;
+
+            union {
+                long long mInteger;
+                unsigned long long mUnsigned;
+                double mFloat;
+                const Char* mString;
+                const char* mUtf8;
+                const uint8_t* mLatin1;
+            };
+
+            union {
+                size_t mSize;
+                size_t mLength;
+            };
+        };
+    }
+
+    template <typename... Args>
+    inline String String::Format(const String& format, const Args&... args) throw(format_error)
+    {
+        const Text::FormatArgument arguments[] = { Text::FormatArgument(args)..., Text::FormatArgument() };
+        return FormatArguments(format, arguments, sizeof...(Args));
+    }
+
+    template <typename... Args>
+    inline String String::Format(const Text::FormatString& format, const Args&... args) throw(format_error)
+    {
+        const Text::FormatArgument arguments[] = { Text::FormatArgument(args)..., Text::FormatArgument() };
+        return FormatArguments(format, arguments, sizeof...(Args));
+    }
+
+    template <typename... Args>
+    inline Text::StringBuilder& String::FormatTo(Text::StringBuilder& builder, const String& format, const Args&... args) throw(format_error)
+    {
+        const Text::FormatArgument arguments[] = { Text::FormatArgument(args)..., Text::FormatArgument() };
+        return FormatArgumentsTo(builder, format, arguments, sizeof...(Args));
+    }
+
+    template <typename... Args>
+    inline Text::StringBuilder& String::FormatTo(Text::StringBuilder& builder, const Text::FormatString& format, const Args&... args) throw(format_error)
+    {
+        const Text::FormatArgument arguments[] = { Text::FormatArgument(args)..., Text::FormatArgument() };
+        return FormatArgumentsTo(builder, format, arguments, sizeof...(Args));
+    }
+
     template <typename CharT>
     inline String operator==(CharT lhs, const String& rhs)
     {
@@ -226,17 +550,152 @@ namespace Lupus {
         return String(lhs) >= rhs;
     }
 
-    template <typename CharT>
-    inline String operator+(CharT lhs, const String& rhs)
+    /**
+     * Pending result of operator+ on strings. A concatenation records its
+     * operands; converting it to String measures them all and copies each
+     * once into a single buffer. Temporary String operands are moved into
+     * the concatenation and nested concatenations are flattened, so the
+     * result may be kept in an auto variable, though not in a reference.
+     * Named strings and character pointers are referenced and have to
+     * outlive the concatenation.
+     */
+    class LUPUSCORE_API StringConcat
     {
-        return String(lhs) + rhs;
-    }
+    public:
 
-    template <typename CharT>
-    inline String operator+(const CharT* lhs, const String& rhs)
+        /**
+         * One side of a concatenation. An operand made from a temporary
+         * string owns its characters until it is appended, so it must
+         * only be used as an argument of operator+.
+         */
+        class Operand
+        {
+        public:
+
+            inline Operand(const String& str) : mType(Type::String), mPointer(&str), mLength(0) {}
+            //! Temporary string, its characters are moved into the operand.
+            inline Operand(String&& str) { StringConcat::Take(*this, str); }
+            inline Operand(Char ch) : mType(Type::Char), mPointer(nullptr), mLength(ch) {}
+            //! UTF-8 string.
+            inline Operand(const char* str) : mType(Type::Utf8), mPointer(str), mLength(0) {}
+            inline Operand(const Char* str) : mType(Type::Chars), mPointer(str), mLength(0) {}
+            inline Operand(const StringConcat& concat) : mType(Type::Concat), mPointer(&concat), mLength(0) {}
+            //! Temporary concatenation, its operands are moved.
+            inline Operand(StringConcat&& concat) : mType(Type::MovedConcat), mPointer(&concat), mLength(0) {}
+
+        private:
+
+            friend class String;
+            friend class StringConcat;
+
+            enum class Type { None, String, Small, Buffer, Char, Chars, Utf8, Ascii, Concat, MovedConcat };
+
+            inline Operand() {}
+
+            mutable Type mType;
+            //! String buffer for Type::Buffer, which holds a reference.
+            const void* mPointer;
+            mutable size_t mLength;
+            //! Characters of a short temporary string.
+            Char mSmall[String::SmallCapacity + 1];
+        };
+
+        //! Single operand, so that cond ? a + b : "" compiles.
+        inline StringConcat(const char* str) : mCount(0) { Append(str); }
+        //! \sa StringConcat::StringConcat(const char*)
+        inline StringConcat(const Char* str) : mCount(0) { Append(str); }
+        inline StringConcat(const Operand& lhs, const Operand& rhs) : mCount(0) { Append(lhs); Append(rhs); }
+        StringConcat(const StringConcat& concat);
+        StringConcat(StringConcat&& concat) NOEXCEPT;
+
+        inline ~StringConcat()
+        {
+            for (size_t i = 0; i < mCount; i++) {
+                if (mOperands[i].mType == Operand::Type::Buffer) {
+                    Release(mOperands[i].mPointer);
+                }
+            }
+        }
+
+        StringConcat& operator=(const StringConcat& concat);
+        StringConcat& operator=(StringConcat&& concat) NOEXCEPT;
+
+        /**
+         * Materializes the concatenation. The pointer stays valid as long
+         * as the concatenation is alive and unchanged.
+         */
+        const Char* Data() const;
+        //! Length of the concatenated string in characters.
+        size_t Length() const NOEXCEPT;
+        String ToString() const NOEXCEPT;
+
+        //! Appends to a temporary concatenation in place. Other operands
+        //! go through the free operator+ and copy the concatenation.
+        template <typename T>
+        friend inline typename std::enable_if<std::is_same<T, StringConcat>::value, StringConcat&&>::type operator+(T&& lhs, Operand rhs)
+        {
+            lhs.Append(rhs);
+            return std::move(lhs);
+        }
+
+    private:
+
+        friend class String;
+
+        //! Operands kept before the concatenation is materialized.
+        static const size_t Capacity = 8;
+
+        static void Take(Operand& operand, String& str);
+        static void AddRef(const void* buffer);
+        static void Release(const void* buffer);
+        static size_t Measure(const Operand& operand);
+        static Char* Write(const Operand& operand, Char* it);
+
+        inline void Append(const Operand& operand)
+        {
+            if (mCount < Capacity && operand.mType < Operand::Type::Concat) {
+                mOperands[mCount++] = operand;
+            } else {
+                Splice(operand);
+            }
+        }
+
+        void Splice(const Operand& operand);
+        void Collapse() const;
+        void Clear() const;
+        size_t Measure() const;
+        Char* Write(Char* it) const;
+
+        mutable Operand mOperands[Capacity];
+        mutable size_t mCount;
+    };
+
+    inline StringConcat operator+(StringConcat::Operand lhs, StringConcat::Operand rhs) { return StringConcat(lhs, rhs); }
+
+    inline bool operator==(const StringConcat& lhs, const String& rhs) { return String(lhs) == rhs; }
+    inline bool operator!=(const StringConcat& lhs, const String& rhs) { return String(lhs) != rhs; }
+    inline bool operator<(const StringConcat& lhs, const String& rhs) { return String(lhs) < rhs; }
+    inline bool operator>(const StringConcat& lhs, const String& rhs) { return String(lhs) > rhs; }
+    inline bool operator<=(const StringConcat& lhs, const String& rhs) { return String(lhs) <= rhs; }
+    inline bool operator>=(const StringConcat& lhs, const String& rhs) { return String(lhs) >= rhs; }
+
+    //! Hash for String keys that ignore case, e.g. HTTP header names.
+    struct StringCaseInsensitiveHash
     {
-        return String(lhs) + rhs;
-    }
+        size_t operator()(const String& str) const
+        {
+            return str.GetHashCode(StringCaseSensitivity::CaseInsensitive);
+        }
+    };
+
+    //! Key comparison matching StringCaseInsensitiveHash.
+    struct StringCaseInsensitiveEqual
+    {
+        bool operator()(const String& lhs, const String& rhs) const
+        {
+            return lhs.Compare(rhs, StringCaseSensitivity::CaseInsensitive) == 0;
+        }
+    };
 }
 
 namespace std {
@@ -252,7 +711,7 @@ namespace std {
 
         result_type operator()(const Lupus::String& str) const
         {
-            return hash<string>()(str.ToUTF8());
+            return str.GetHashCode();
         }
     };
 }
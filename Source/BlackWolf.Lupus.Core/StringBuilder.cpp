@@ -0,0 +1,273 @@
+/**
+ * Copyright (C) 2014 David Wolf <d.wolf@live.at>
+ *
+ * This file is part of Lupus.
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include "StringBuilder.h"
+#include "Float.h"
+#include "Integer.h"
+#include "Internal/StringBuffer.h"
+#include <algorithm>
+#include <cstring>
+
+using namespace std;
+
+namespace Lupus {
+    namespace Text {
+        static const size_t sMinimumCapacity = 32;
+
+        StringBuilder::StringBuilder()
+        {
+        }
+
+        StringBuilder::StringBuilder(size_t capacity)
+        {
+            Reserve(capacity);
+        }
+
+        StringBuilder::StringBuilder(StringView str)
+        {
+            Append(str);
+        }
+
+        StringBuilder::~StringBuilder()
+        {
+            if (mBuffer) {
+                String::Buffer::Release(mBuffer);
+            }
+        }
+
+        StringBuilder& StringBuilder::Append(Char ch)
+        {
+            *Grow(1) = ch;
+            mBuffer->Data[++mLength] = 0;
+            return *this;
+        }
+
+        StringBuilder& StringBuilder::Append(Char ch, size_t count)
+        {
+            if (count == 0) {
+                return *this;
+            }
+
+            Char* data = Grow(count);
+
+            for (size_t i = 0; i < count; i++) {
+                data[i] = ch;
+            }
+
+            mLength += count;
+            mBuffer->Data[mLength] = 0;
+            return *this;
+        }
+
+        StringBuilder& StringBuilder::Append(char ch)
+        {
+            return Append((Char)(uint8_t)ch);
+        }
+
+        StringBuilder& StringBuilder::Append(const String& str)
+        {
+            if (str.IsEmpty()) {
+                return *this;
+            }
+
+            // Read() widens compact strings without attaching a copy to them.
+            str.Read(Grow(str.Length()), 0, str.Length());
+            mLength += str.Length();
+            mBuffer->Data[mLength] = 0;
+            return *this;
+        }
+
+        StringBuilder& StringBuilder::Append(StringView str)
+        {
+            if (str.IsEmpty()) {
+                return *this;
+            }
+
+            memcpy(Grow(str.Length()), str.Data(), str.Length() * sizeof(Char));
+            mLength += str.Length();
+            mBuffer->Data[mLength] = 0;
+            return *this;
+        }
+
+        StringBuilder& StringBuilder::Append(const Char* str)
+        {
+            return Append(StringView(str));
+        }
+
+        StringBuilder& StringBuilder::Append(const char* str)
+        {
+            size_t length = strlen(str);
+
+            for (size_t i = 0; i < length; i++) {
+                if ((uint8_t)str[i] >= 0x80) {
+                    return Append(String(str));
+                }
+            }
+
+            if (length == 0) {
+                return *this;
+            }
+
+            Char* data = Grow(length);
+
+            for (size_t i = 0; i < length; i++) {
+                data[i] = (Char)str[i];
+            }
+
+            mLength += length;
+            mBuffer->Data[mLength] = 0;
+            return *this;
+        }
+
+        StringBuilder& StringBuilder::Append(int value)
+        {
+            return Append((long long)value);
+        }
+
+        StringBuilder& StringBuilder::Append(long value)
+        {
+            return Append((long long)value);
+        }
+
+        StringBuilder& StringBuilder::Append(long long value)
+        {
+            mLength += Integer::FormatTo(value, Grow(Integer::MaxLength));
+            mBuffer->Data[mLength] = 0;
+            return *this;
+        }
+
+        StringBuilder& StringBuilder::Append(unsigned int value)
+        {
+            return Append((unsigned long long)value);
+        }
+
+        StringBuilder& StringBuilder::Append(unsigned long value)
+        {
+            return Append((unsigned long long)value);
+        }
+
+        StringBuilder& StringBuilder::Append(unsigned long long value)
+        {
+            mLength += Integer::FormatTo(value, Grow(Integer::MaxLength));
+            mBuffer->Data[mLength] = 0;
+            return *this;
+        }
+
+        StringBuilder& StringBuilder::Append(double value)
+        {
+            mLength += Float::FormatTo(value, Grow(Float::MaxLength));
+            mBuffer->Data[mLength] = 0;
+            return *this;
+        }
+
+        size_t StringBuilder::Capacity() const
+        {
+            return mBuffer ? mBuffer->Capacity : 0;
+        }
+
+        void StringBuilder::Clear()
+        {
+            mLength = 0;
+
+            if (mBuffer && mBuffer->RefCount.load(memory_order_acquire) > 1) {
+                String::Buffer::Release(mBuffer);
+                mBuffer = nullptr;
+            } else if (mBuffer) {
+                mBuffer->Data[0] = 0;
+            }
+        }
+
+        bool StringBuilder::IsEmpty() const
+        {
+            return mLength == 0;
+        }
+
+        size_t StringBuilder::Length() const
+        {
+            return mLength;
+        }
+
+        void StringBuilder::Reserve(size_t capacity)
+        {
+            if (capacity > Capacity()) {
+                Reallocate(capacity);
+            }
+        }
+
+        String StringBuilder::ToString() const
+        {
+            String result;
+
+            if (mLength <= String::SmallCapacity) {
+                if (mLength > 0) {
+                    memcpy(result.Initialize(mLength), mBuffer->Data, mLength * sizeof(Char));
+                }
+            } else {
+                // Hand over the buffer; the next append copies it.
+                mBuffer->RefCount.fetch_add(1, memory_order_relaxed);
+                result.mBuffer = mBuffer;
+                result.mLength = mLength;
+            }
+
+            return result;
+        }
+
+        StringBuilder& StringBuilder::operator+=(Char ch)
+        {
+            return Append(ch);
+        }
+
+        StringBuilder& StringBuilder::operator+=(const String& str)
+        {
+            return Append(str);
+        }
+
+        Char* StringBuilder::Grow(size_t count)
+        {
+            size_t length = mLength + count;
+
+            if (!mBuffer) {
+                Reallocate(max(length, sMinimumCapacity));
+            } else if (mBuffer->Capacity < length) {
+                Reallocate(max(length, mBuffer->Capacity + mBuffer->Capacity / 2));
+            } else if (mBuffer->RefCount.load(memory_order_acquire) > 1) {
+                Reallocate(mBuffer->Capacity);
+            }
+
+            mBuffer->Invalidate();
+            return mBuffer->Data + mLength;
+        }
+
+        void StringBuilder::Reallocate(size_t capacity)
+        {
+            String::Buffer* buffer = String::Buffer::Create(capacity);
+
+            if (mBuffer) {
+                memcpy(buffer->Data, mBuffer->Data, mLength * sizeof(Char));
+                String::Buffer::Release(mBuffer);
+            }
+
+            buffer->Data[mLength] = 0;
+            mBuffer = buffer;
+        }
+    }
+}
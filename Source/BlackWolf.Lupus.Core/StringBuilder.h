@@ -0,0 +1,82 @@
+/**
+ * Copyright (C) 2014 David Wolf <d.wolf@live.at>
+ *
+ * This file is part of Lupus.
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#pragma once
+
+#include "String.h"
+#include "StringView.h"
+
+namespace Lupus {
+    namespace Text {
+        //! Mutable character buffer for building strings piece by piece.
+        //!
+        //! The capacity grows geometrically, so a sequence of appends costs
+        //! amortized linear time. ToString() hands the buffer to the
+        //! returned String without copying; the next append after that
+        //! copies the characters once.
+        class LUPUSCORE_API StringBuilder : public NonCopyable
+        {
+        public:
+
+            StringBuilder() NOEXCEPT;
+            explicit StringBuilder(size_t capacity) NOEXCEPT;
+            explicit StringBuilder(StringView str) NOEXCEPT;
+            virtual ~StringBuilder();
+
+            virtual StringBuilder& Append(Char ch) NOEXCEPT;
+            virtual StringBuilder& Append(Char ch, size_t count) NOEXCEPT;
+            //! Appends an ASCII character; keeps ' ' from binding to Append(int).
+            virtual StringBuilder& Append(char ch) NOEXCEPT;
+            virtual StringBuilder& Append(const String& str) NOEXCEPT;
+            virtual StringBuilder& Append(StringView str) NOEXCEPT;
+            virtual StringBuilder& Append(const Char* str) NOEXCEPT;
+            virtual StringBuilder& Append(const char* str) NOEXCEPT;
+            virtual StringBuilder& Append(int value) NOEXCEPT;
+            virtual StringBuilder& Append(long value) NOEXCEPT;
+            virtual StringBuilder& Append(long long value) NOEXCEPT;
+            virtual StringBuilder& Append(unsigned int value) NOEXCEPT;
+            virtual StringBuilder& Append(unsigned long value) NOEXCEPT;
+            virtual StringBuilder& Append(unsigned long long value) NOEXCEPT;
+            virtual StringBuilder& Append(double value) NOEXCEPT;
+            virtual size_t Capacity() const NOEXCEPT;
+            virtual void Clear() NOEXCEPT;
+            virtual bool IsEmpty() const NOEXCEPT;
+            virtual size_t Length() const NOEXCEPT;
+            //! Ensures room for at least capacity characters.
+            virtual void Reserve(size_t capacity) NOEXCEPT;
+            virtual String ToString() const NOEXCEPT;
+
+            StringBuilder& operator+=(Char ch) NOEXCEPT;
+            StringBuilder& operator+=(const String& str) NOEXCEPT;
+
+        private:
+
+            friend class FormatWriter;
+
+            Char* Grow(size_t count);
+            void Reallocate(size_t capacity);
+
+            String::Buffer* mBuffer = nullptr;
+            size_t mLength = 0;
+        };
+    }
+}
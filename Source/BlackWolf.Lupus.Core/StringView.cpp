@@ -0,0 +1,288 @@
+/**
+ * Copyright (C) 2014 David Wolf <d.wolf@live.at>
+ *
+ * This file is part of Lupus.
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include "StringView.h"
+#include "Internal/CharSearch.h"
+#include "Searcher.h"
+#include "SplitEnumerator.h"
+#include <unicode/uchar.h>
+#include <unicode/ustring.h>
+#include <unicode/utf16.h>
+#include <algorithm>
+
+using namespace std;
+
+#ifdef _MSC_VER
+#pragma warning(push)
+#pragma warning(disable: 4267)
+#endif
+
+namespace Lupus {
+    static const Char sEmptyView[1] = { 0 };
+
+    static inline int FindFirst(const Char* data, size_t length, const Char* str, size_t size, size_t offset)
+    {
+        if (size == 0 || offset > length) {
+            return -1;
+        }
+
+        const Char* result = Text::Searcher(StringView(str, size)).Find(data + offset, length - offset);
+        return result ? (int)(result - data) : -1;
+    }
+
+    static inline int FindChar(const Char* data, size_t length, size_t offset, Char ch)
+    {
+        // Surrogates only match when unpaired; ICU knows how to tell.
+        const Char* result = U16_IS_SURROGATE(ch) ? u_memchr(data + offset, ch, (int32_t)(length - offset)) : Text::FindChar(data + offset, length - offset, ch);
+        return result ? (int)(result - data) : -1;
+    }
+
+    StringView::StringView() :
+        mData(sEmptyView), mLength(0)
+    {
+    }
+
+    StringView::StringView(const Char* str) :
+        mData(str), mLength(u_strlen(str))
+    {
+    }
+
+    StringView::StringView(const Char* str, size_t length) :
+        mData(str), mLength(length)
+    {
+    }
+
+    StringView::StringView(const String& str) :
+        mData(str.Data()), mLength(str.Length())
+    {
+    }
+
+    const Char& StringView::operator[](size_t index) const
+    {
+        if (index >= mLength) {
+            throw out_of_range("index");
+        }
+
+        return mData[index];
+    }
+
+    const Char* StringView::Data() const
+    {
+        return mData;
+    }
+
+    bool StringView::IsEmpty() const
+    {
+        return mLength == 0;
+    }
+
+    size_t StringView::Length() const
+    {
+        return mLength;
+    }
+
+    int StringView::Compare(StringView str, StringCaseSensitivity sens) const
+    {
+        UErrorCode error = U_ZERO_ERROR;
+        int32_t result = 0;
+
+        switch (sens) {
+            case StringCaseSensitivity::CaseSensitive:
+                result = u_strCompare(mData, (int32_t)mLength, str.mData, (int32_t)str.mLength, FALSE);
+                break;
+            case StringCaseSensitivity::CaseInsensitive:
+                // ASCII is folded here; ICU takes over at the first other character.
+                if (Text::CompareIgnoreCaseAscii(mData, str.mData, min(mLength, str.mLength), &result)) {
+                    return result != 0 ? result : (mLength > str.mLength) - (mLength < str.mLength);
+                }
+
+                result = u_strCaseCompare(mData, (int32_t)mLength, str.mData, (int32_t)str.mLength, U_FOLD_CASE_DEFAULT, &error);
+                break;
+        }
+
+        return (result > 0) - (result < 0);
+    }
+
+    bool StringView::Contains(StringView str) const
+    {
+        return IndexOf(str) != -1;
+    }
+
+    bool StringView::EndsWith(StringView str) const
+    {
+        return str.mLength <= mLength && memcmp(mData + mLength - str.mLength, str.mData, str.mLength * sizeof(Char)) == 0;
+    }
+
+    int StringView::IndexOf(Char ch) const
+    {
+        return FindChar(mData, mLength, 0, ch);
+    }
+
+    int StringView::IndexOf(StringView str) const
+    {
+        return FindFirst(mData, mLength, str.mData, str.mLength, 0);
+    }
+
+    int StringView::IndexOf(Char ch, size_t offset) const
+    {
+        if (offset > mLength) {
+            throw out_of_range("offset");
+        }
+
+        return FindChar(mData, mLength, offset, ch);
+    }
+
+    int StringView::IndexOf(StringView str, size_t offset) const
+    {
+        if (offset > mLength) {
+            throw out_of_range("offset");
+        }
+
+        return FindFirst(mData, mLength, str.mData, str.mLength, offset);
+    }
+
+    int StringView::IndexOfAny(const vector<Char>& chars) const
+    {
+        const Char* result = Text::FindAnyChar(mData, mLength, chars.data(), chars.size());
+        return result ? (int)(result - mData) : -1;
+    }
+
+    int StringView::LastIndexOf(Char ch) const
+    {
+        const Char* result = U16_IS_SURROGATE(ch) ? u_memrchr(mData, ch, (int32_t)mLength) : Text::FindLastChar(mData, mLength, ch);
+        return result ? (int)(result - mData) : -1;
+    }
+
+    int StringView::LastIndexOf(StringView str) const
+    {
+        if (str.mLength == 0) {
+            return -1;
+        }
+
+        const Char* result = u_strFindLast(mData, (int32_t)mLength, str.mData, (int32_t)str.mLength);
+        return result ? (int)(result - mData) : -1;
+    }
+
+    vector<StringView> StringView::Split(const vector<Char>& delimiter, StringSplitOption option) const
+    {
+        Text::SplitEnumerator parts(*this, delimiter, option);
+        return vector<StringView>(parts.begin(), parts.end());
+    }
+
+    vector<StringView> StringView::Split(StringView delimiter, StringSplitOption option) const
+    {
+        return Split(delimiter, (size_t)-1, option);
+    }
+
+    vector<StringView> StringView::Split(StringView delimiter, size_t count, StringSplitOption option) const
+    {
+        Text::SplitEnumerator parts(*this, delimiter, count, option);
+        return vector<StringView>(parts.begin(), parts.end());
+    }
+
+    bool StringView::StartsWith(StringView str) const
+    {
+        return str.mLength <= mLength && memcmp(mData, str.mData, str.mLength * sizeof(Char)) == 0;
+    }
+
+    StringView StringView::Substring(size_t startIndex) const
+    {
+        if (startIndex > mLength) {
+            throw out_of_range("startIndex");
+        }
+
+        return StringView(mData + startIndex, mLength - startIndex);
+    }
+
+    StringView StringView::Substring(size_t startIndex, size_t count) const
+    {
+        if (startIndex > mLength) {
+            throw out_of_range("startIndex");
+        } else if (count > mLength - startIndex) {
+            throw out_of_range("count");
+        }
+
+        return StringView(mData + startIndex, count);
+    }
+
+    String StringView::ToString() const
+    {
+        String result;
+        Char* data = result.Initialize(mLength);
+
+        if (mLength > 0) {
+            memcpy(data, mData, mLength * sizeof(Char));
+        }
+
+        return result;
+    }
+
+    StringView StringView::Trim() const
+    {
+        int32_t start = 0;
+        int32_t end = (int32_t)mLength;
+        UChar32 c;
+
+        while (start < end) {
+            int32_t next = start;
+            U16_NEXT(mData, next, end, c);
+
+            if (!(c == 0x20 || u_isWhitespace(c))) {
+                break;
+            }
+
+            start = next;
+        }
+
+        while (end > start) {
+            int32_t previous = end;
+            U16_PREV(mData, start, previous, c);
+
+            if (!(c == 0x20 || u_isWhitespace(c))) {
+                break;
+            }
+
+            end = previous;
+        }
+
+        return StringView(mData + start, end - start);
+    }
+
+    bool StringView::operator==(StringView str) const
+    {
+        return mLength == str.mLength && memcmp(mData, str.mData, mLength * sizeof(Char)) == 0;
+    }
+
+    bool StringView::operator!=(StringView str) const
+    {
+        return !(*this == str);
+    }
+
+    bool StringView::operator<(StringView str) const
+    {
+        return Compare(str) < 0;
+    }
+}
+
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
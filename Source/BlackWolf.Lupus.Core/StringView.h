@@ -0,0 +1,100 @@
+/**
+ * Copyright (C) 2014 David Wolf <d.wolf@live.at>
+ *
+ * This file is part of Lupus.
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#pragma once
+
+#include "String.h"
+
+#ifdef _MSC_VER
+#pragma warning(push)
+#pragma warning(disable: 4251)
+#endif
+
+namespace Lupus {
+    //! Read-only window into the characters of a String or a Char array.
+    //!
+    //! A view does not own its characters. It stays valid as long as the
+    //! viewed String object is neither modified, moved nor destroyed. Short
+    //! strings are stored inside the String object itself, so a view of a
+    //! temporary String must not outlive the expression. Slicing a view
+    //! never allocates; call ToString() to keep a value.
+    class LUPUSCORE_API StringView
+    {
+    public:
+
+        typedef const Char* iterator;
+        typedef const Char* const_iterator;
+
+        inline const_iterator begin() const { return mData; }
+        inline const_iterator cbegin() const { return mData; }
+        inline const_iterator end() const { return mData + mLength; }
+        inline const_iterator cend() const { return mData + mLength; }
+
+        StringView() NOEXCEPT;
+        StringView(const Char* str) NOEXCEPT;
+        StringView(const Char* str, size_t length) NOEXCEPT;
+        //! Views the UTF-16 characters of str. A String stored as Latin-1
+        //! is widened as by String::Data() and keeps the copy; the search
+        //! and compare members of String itself never widen it.
+        StringView(const String& str) NOEXCEPT;
+        StringView(const StringView&) = default;
+        ~StringView() = default;
+
+        const Char& operator[](size_t index) const throw(std::out_of_range);
+        const Char* Data() const NOEXCEPT;
+        bool IsEmpty() const NOEXCEPT;
+        size_t Length() const NOEXCEPT;
+
+        int Compare(StringView str, StringCaseSensitivity = StringCaseSensitivity::CaseSensitive) const NOEXCEPT;
+        bool Contains(StringView str) const NOEXCEPT;
+        bool EndsWith(StringView str) const NOEXCEPT;
+        int IndexOf(Char ch) const NOEXCEPT;
+        int IndexOf(StringView str) const NOEXCEPT;
+        int IndexOf(Char ch, size_t offset) const throw(std::out_of_range);
+        int IndexOf(StringView str, size_t offset) const throw(std::out_of_range);
+        int IndexOfAny(const std::vector<Char>& chars) const NOEXCEPT;
+        int LastIndexOf(Char ch) const NOEXCEPT;
+        int LastIndexOf(StringView str) const NOEXCEPT;
+        std::vector<StringView> Split(const std::vector<Char>& delimiter, StringSplitOption = StringSplitOption::None) const NOEXCEPT;
+        std::vector<StringView> Split(StringView delimiter, StringSplitOption = StringSplitOption::None) const NOEXCEPT;
+        std::vector<StringView> Split(StringView delimiter, size_t count, StringSplitOption = StringSplitOption::None) const NOEXCEPT;
+        bool StartsWith(StringView str) const NOEXCEPT;
+        StringView Substring(size_t startIndex) const throw(std::out_of_range);
+        StringView Substring(size_t startIndex, size_t count) const throw(std::out_of_range);
+        String ToString() const NOEXCEPT;
+        StringView Trim() const NOEXCEPT;
+
+        bool operator==(StringView str) const NOEXCEPT;
+        bool operator!=(StringView str) const NOEXCEPT;
+        bool operator<(StringView str) const NOEXCEPT;
+        StringView& operator=(const StringView&) = default;
+
+    private:
+
+        const Char* mData;
+        size_t mLength;
+    };
+}
+
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
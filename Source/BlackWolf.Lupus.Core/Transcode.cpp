@@ -0,0 +1,583 @@
+/**
+ * Copyright (C) 2014 David Wolf <d.wolf@live.at>
+ *
+ * This file is part of Lupus.
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include "Internal/Transcode.h"
+#include "Internal/Simd.h"
+
+namespace Lupus {
+    namespace Text {
+        static inline bool IsSurrogate(Char ch)
+        {
+            return (ch & 0xF800) == 0xD800;
+        }
+
+        static inline bool IsHighSurrogate(Char ch)
+        {
+            return (ch & 0xFC00) == 0xD800;
+        }
+
+        static inline bool IsLowSurrogate(Char ch)
+        {
+            return (ch & 0xFC00) == 0xDC00;
+        }
+
+        static inline Char ReadUnit(const uint8_t* src, bool bigEndian)
+        {
+            return bigEndian ? (Char)((src[0] << 8) | src[1]) : (Char)(src[0] | (src[1] << 8));
+        }
+
+        static inline void WriteUnit(uint8_t* dst, Char ch, bool bigEndian)
+        {
+            dst[bigEndian ? 0 : 1] = (uint8_t)((uint16_t)ch >> 8);
+            dst[bigEndian ? 1 : 0] = (uint8_t)ch;
+        }
+
+#ifdef LUPUS_SSE2
+        static inline unsigned PopCount(unsigned mask)
+        {
+            mask = mask - ((mask >> 1) & 0x55555555);
+            mask = (mask & 0x33333333) + ((mask >> 2) & 0x33333333);
+            return (((mask + (mask >> 4)) & 0x0F0F0F0F) * 0x01010101) >> 24;
+        }
+
+        //! Swaps the bytes of every code unit.
+        static inline __m128i SwapBytes(__m128i block)
+        {
+            return _mm_or_si128(_mm_slli_epi16(block, 8), _mm_srli_epi16(block, 8));
+        }
+
+        //! Nonzero if any code unit of the block is a surrogate.
+        static inline unsigned HasSurrogate(__m128i block)
+        {
+            return (unsigned)_mm_movemask_epi8(_mm_cmpeq_epi16(
+                _mm_and_si128(block, _mm_set1_epi16((short)0xF800)), _mm_set1_epi16((short)0xD800)));
+        }
+#endif
+
+        bool CopyAscii(uint8_t* dst, const uint8_t* src, size_t length)
+        {
+            size_t i = 0;
+
+#ifdef LUPUS_SSE2
+            for (; length - i >= 16; i += 16) {
+                __m128i block = _mm_loadu_si128((const __m128i*)(src + i));
+
+                if (_mm_movemask_epi8(block)) {
+                    return false;
+                }
+
+                _mm_storeu_si128((__m128i*)(dst + i), block);
+            }
+#endif
+
+            for (; i < length; i++) {
+                if (src[i] >= 0x80) {
+                    return false;
+                }
+
+                dst[i] = src[i];
+            }
+
+            return true;
+        }
+
+        void WidenLatin1(Char* dst, const uint8_t* src, size_t length)
+        {
+            size_t i = 0;
+
+#ifdef LUPUS_SSE2
+            const __m128i zero = _mm_setzero_si128();
+
+            for (; length - i >= 16; i += 16) {
+                __m128i block = _mm_loadu_si128((const __m128i*)(src + i));
+                _mm_storeu_si128((__m128i*)(dst + i), _mm_unpacklo_epi8(block, zero));
+                _mm_storeu_si128((__m128i*)(dst + i + 8), _mm_unpackhi_epi8(block, zero));
+            }
+#endif
+
+            for (; i < length; i++) {
+                dst[i] = (Char)src[i];
+            }
+        }
+
+        bool NarrowLatin1(uint8_t* dst, const Char* src, size_t length, Char limit)
+        {
+            size_t i = 0;
+
+#ifdef LUPUS_SSE2
+            const __m128i zero = _mm_setzero_si128();
+            const __m128i high = _mm_set1_epi16((short)~(uint16_t)limit);
+
+            for (; length - i >= 16; i += 16) {
+                __m128i low = _mm_loadu_si128((const __m128i*)(src + i));
+                __m128i next = _mm_loadu_si128((const __m128i*)(src + i + 8));
+
+                if (_mm_movemask_epi8(_mm_cmpeq_epi16(_mm_and_si128(_mm_or_si128(low, next), high), zero)) != 0xFFFF) {
+                    return false;
+                }
+
+                _mm_storeu_si128((__m128i*)(dst + i), _mm_packus_epi16(low, next));
+            }
+#endif
+
+            for (; i < length; i++) {
+                if ((uint16_t)src[i] > (uint16_t)limit) {
+                    return false;
+                }
+
+                dst[i] = (uint8_t)src[i];
+            }
+
+            return true;
+        }
+
+        bool MeasureUtf8(const uint8_t* data, size_t size, size_t* length, bool* latin1)
+        {
+            size_t count = 0;
+            bool narrow = true;
+            size_t i = 0;
+
+            while (i < size) {
+                // Blocks that are not all ASCII go through the scalar loop,
+                // which stops at the end of the block.
+                size_t stop = size;
+
+#ifdef LUPUS_SSE2
+                if (size - i >= 16) {
+                    __m128i block = _mm_loadu_si128((const __m128i*)(data + i));
+                    unsigned mask = (unsigned)_mm_movemask_epi8(block);
+
+                    if (!mask) {
+                        i += 16;
+                        count += 16;
+                        continue;
+                    }
+
+                    // Blocks of ASCII and two byte sequences are validated at
+                    // once: every lead byte C2-DF must be followed by a trail
+                    // byte 80-BF and every trail byte preceded by a lead. A lead
+                    // in the last byte is left to the next block.
+                    __m128i two = _mm_and_si128(_mm_cmpgt_epi8(block, _mm_set1_epi8((char)0xC1)), _mm_cmplt_epi8(block, _mm_set1_epi8((char)0xE0)));
+                    unsigned leads = (unsigned)_mm_movemask_epi8(two);
+                    unsigned trails = (unsigned)_mm_movemask_epi8(_mm_cmplt_epi8(block, _mm_set1_epi8((char)0xC0)));
+
+                    if ((leads | trails) == mask && trails == ((leads << 1) & 0xFFFF)) {
+                        size_t used = (leads & 0x8000) ? 15 : 16;
+
+                        if (_mm_movemask_epi8(_mm_and_si128(two, _mm_cmpgt_epi8(block, _mm_set1_epi8((char)0xC3))))) {
+                            narrow = false;
+                        }
+
+                        i += used;
+                        count += used - PopCount(trails);
+                        continue;
+                    }
+
+                    stop = i + 16;
+                }
+#endif
+
+                while (i < stop) {
+                    uint8_t byte = data[i];
+
+                    if (byte < 0x80) {
+                        i++;
+                        count++;
+                        continue;
+                    }
+
+                    // Well-formed sequences after table 3-7 of the Unicode standard.
+                    size_t extra;
+                    uint8_t min = 0x80;
+                    uint8_t max = 0xBF;
+
+                    if (byte < 0xC2) {
+                        return false;
+                    } else if (byte < 0xE0) {
+                        extra = 1;
+                    } else if (byte < 0xF0) {
+                        extra = 2;
+                        min = (byte == 0xE0) ? 0xA0 : 0x80;
+                        max = (byte == 0xED) ? 0x9F : 0xBF;
+                    } else if (byte < 0xF5) {
+                        extra = 3;
+                        min = (byte == 0xF0) ? 0x90 : 0x80;
+                        max = (byte == 0xF4) ? 0x8F : 0xBF;
+                    } else {
+                        return false;
+                    }
+
+                    if (size - i <= extra || data[i + 1] < min || data[i + 1] > max) {
+                        return false;
+                    }
+
+                    for (size_t k = 2; k <= extra; k++) {
+                        if ((data[i + k] & 0xC0) != 0x80) {
+                            return false;
+                        }
+                    }
+
+                    if (byte > 0xC3) {
+                        narrow = false;
+                    }
+
+                    count += (extra == 3) ? 2 : 1;
+                    i += extra + 1;
+                }
+            }
+
+            *length = count;
+            *latin1 = narrow;
+            return true;
+        }
+
+        void DecodeUtf8(Char* dst, const uint8_t* src, size_t size)
+        {
+            const uint8_t* end = src + size;
+
+#ifdef LUPUS_SSE2
+            const __m128i zero = _mm_setzero_si128();
+#endif
+
+            while (src < end) {
+                const uint8_t* stop = end;
+
+#ifdef LUPUS_SSE2
+                if (end - src >= 16) {
+                    __m128i block = _mm_loadu_si128((const __m128i*)src);
+
+                    if (!_mm_movemask_epi8(block)) {
+                        _mm_storeu_si128((__m128i*)dst, _mm_unpacklo_epi8(block, zero));
+                        _mm_storeu_si128((__m128i*)(dst + 8), _mm_unpackhi_epi8(block, zero));
+                        src += 16;
+                        dst += 16;
+                        continue;
+                    }
+
+                    stop = src + 16;
+                }
+#endif
+
+                while (src < stop) {
+                    uint8_t byte = *src;
+
+                    if (byte < 0x80) {
+                        *dst++ = (Char)byte;
+                        src++;
+                    } else if (byte < 0xE0) {
+                        *dst++ = (Char)(((byte & 0x1F) << 6) | (src[1] & 0x3F));
+                        src += 2;
+                    } else if (byte < 0xF0) {
+                        *dst++ = (Char)(((byte & 0x0F) << 12) | ((src[1] & 0x3F) << 6) | (src[2] & 0x3F));
+                        src += 3;
+                    } else {
+                        uint32_t ch = ((byte & 0x07) << 18) | ((src[1] & 0x3F) << 12) | ((src[2] & 0x3F) << 6) | (src[3] & 0x3F);
+                        ch -= 0x10000;
+                        *dst++ = (Char)(0xD800 | (ch >> 10));
+                        *dst++ = (Char)(0xDC00 | (ch & 0x3FF));
+                        src += 4;
+                    }
+                }
+            }
+        }
+
+        void DecodeUtf8Latin1(uint8_t* dst, const uint8_t* src, size_t size)
+        {
+            const uint8_t* end = src + size;
+
+            while (src < end) {
+                const uint8_t* stop = end;
+
+#ifdef LUPUS_SSE2
+                if (end - src >= 16) {
+                    __m128i block = _mm_loadu_si128((const __m128i*)src);
+
+                    if (!_mm_movemask_epi8(block)) {
+                        _mm_storeu_si128((__m128i*)dst, block);
+                        src += 16;
+                        dst += 16;
+                        continue;
+                    }
+
+                    stop = src + 16;
+                }
+#endif
+
+                while (src < stop) {
+                    if (*src < 0x80) {
+                        *dst++ = *src++;
+                    } else {
+                        *dst++ = (uint8_t)((src[0] << 6) | (src[1] & 0x3F));
+                        src += 2;
+                    }
+                }
+            }
+        }
+
+        bool MeasureUtf16(const Char* data, size_t length, size_t* size)
+        {
+            size_t count = 0;
+            size_t i = 0;
+
+#ifdef LUPUS_SSE2
+            const __m128i zero = _mm_setzero_si128();
+            const __m128i ascii = _mm_set1_epi16((short)0xFF80);
+            const __m128i narrow = _mm_set1_epi16((short)0xF800);
+#endif
+
+            while (i < length) {
+#ifdef LUPUS_SSE2
+                // Three bytes per code unit, less one for each below 0x800
+                // and another one for each below 0x80.
+                if (length - i >= 8) {
+                    __m128i block = _mm_loadu_si128((const __m128i*)(data + i));
+
+                    if (!HasSurrogate(block)) {
+                        unsigned one = (unsigned)_mm_movemask_epi8(_mm_cmpeq_epi16(_mm_and_si128(block, ascii), zero));
+                        unsigned two = (unsigned)_mm_movemask_epi8(_mm_cmpeq_epi16(_mm_and_si128(block, narrow), zero));
+                        count += 24 - (PopCount(one) + PopCount(two)) / 2;
+                        i += 8;
+                        continue;
+                    }
+                }
+#endif
+                Char ch = data[i];
+
+                if ((uint16_t)ch < 0x80) {
+                    count += 1;
+                } else if ((uint16_t)ch < 0x800) {
+                    count += 2;
+                } else if (!IsSurrogate(ch)) {
+                    count += 3;
+                } else if (IsHighSurrogate(ch) && i + 1 < length && IsLowSurrogate(data[i + 1])) {
+                    count += 4;
+                    i++;
+                } else {
+                    return false;
+                }
+
+                i++;
+            }
+
+            *size = count;
+            return true;
+        }
+
+        void EncodeUtf8(uint8_t* dst, const Char* src, size_t length)
+        {
+            const Char* end = src + length;
+
+#ifdef LUPUS_SSE2
+            const __m128i zero = _mm_setzero_si128();
+            const __m128i ascii = _mm_set1_epi16((short)0xFF80);
+#endif
+
+            while (src < end) {
+                const Char* stop = end;
+
+#ifdef LUPUS_SSE2
+                if (end - src >= 16) {
+                    __m128i low = _mm_loadu_si128((const __m128i*)src);
+                    __m128i next = _mm_loadu_si128((const __m128i*)(src + 8));
+
+                    if (_mm_movemask_epi8(_mm_cmpeq_epi16(_mm_and_si128(_mm_or_si128(low, next), ascii), zero)) == 0xFFFF) {
+                        _mm_storeu_si128((__m128i*)dst, _mm_packus_epi16(low, next));
+                        src += 16;
+                        dst += 16;
+                        continue;
+                    }
+
+                    stop = src + 16;
+                }
+#endif
+
+                while (src < stop) {
+                    uint32_t ch = (uint16_t)*src++;
+
+                    if (ch < 0x80) {
+                        *dst++ = (uint8_t)ch;
+                    } else if (ch < 0x800) {
+                        *dst++ = (uint8_t)(0xC0 | (ch >> 6));
+                        *dst++ = (uint8_t)(0x80 | (ch & 0x3F));
+                    } else if (!IsSurrogate((Char)ch)) {
+                        *dst++ = (uint8_t)(0xE0 | (ch >> 12));
+                        *dst++ = (uint8_t)(0x80 | ((ch >> 6) & 0x3F));
+                        *dst++ = (uint8_t)(0x80 | (ch & 0x3F));
+                    } else {
+                        ch = 0x10000 + ((ch - 0xD800) << 10) + ((uint16_t)*src++ - 0xDC00);
+                        *dst++ = (uint8_t)(0xF0 | (ch >> 18));
+                        *dst++ = (uint8_t)(0x80 | ((ch >> 12) & 0x3F));
+                        *dst++ = (uint8_t)(0x80 | ((ch >> 6) & 0x3F));
+                        *dst++ = (uint8_t)(0x80 | (ch & 0x3F));
+                    }
+                }
+            }
+        }
+
+        size_t MeasureLatin1(const uint8_t* data, size_t length)
+        {
+            size_t size = length;
+            size_t i = 0;
+
+#ifdef LUPUS_SSE2
+            for (; length - i >= 16; i += 16) {
+                size += PopCount((unsigned)_mm_movemask_epi8(_mm_loadu_si128((const __m128i*)(data + i))));
+            }
+#endif
+
+            for (; i < length; i++) {
+                size += data[i] >> 7;
+            }
+
+            return size;
+        }
+
+        void EncodeLatin1(uint8_t* dst, const uint8_t* src, size_t length)
+        {
+            const uint8_t* end = src + length;
+
+            while (src < end) {
+                const uint8_t* stop = end;
+
+#ifdef LUPUS_SSE2
+                if (end - src >= 16) {
+                    __m128i block = _mm_loadu_si128((const __m128i*)src);
+
+                    if (!_mm_movemask_epi8(block)) {
+                        _mm_storeu_si128((__m128i*)dst, block);
+                        src += 16;
+                        dst += 16;
+                        continue;
+                    }
+
+                    stop = src + 16;
+                }
+#endif
+
+                while (src < stop) {
+                    uint8_t byte = *src++;
+
+                    if (byte < 0x80) {
+                        *dst++ = byte;
+                    } else {
+                        *dst++ = (uint8_t)(0xC0 | (byte >> 6));
+                        *dst++ = (uint8_t)(0x80 | (byte & 0x3F));
+                    }
+                }
+            }
+        }
+
+        bool ReadUtf16(Char* dst, const uint8_t* src, size_t length, bool bigEndian)
+        {
+            size_t i = 0;
+
+            while (i < length) {
+#ifdef LUPUS_SSE2
+                if (length - i >= 8) {
+                    __m128i block = _mm_loadu_si128((const __m128i*)(src + i * 2));
+
+                    if (bigEndian) {
+                        block = SwapBytes(block);
+                    }
+
+                    if (!HasSurrogate(block)) {
+                        _mm_storeu_si128((__m128i*)(dst + i), block);
+                        i += 8;
+                        continue;
+                    }
+                }
+#endif
+                Char ch = ReadUnit(src + i * 2, bigEndian);
+
+                if (IsSurrogate(ch)) {
+                    if (!IsHighSurrogate(ch) || i + 1 == length || !IsLowSurrogate(ReadUnit(src + i * 2 + 2, bigEndian))) {
+                        return false;
+                    }
+
+                    dst[i] = ch;
+                    dst[i + 1] = ReadUnit(src + i * 2 + 2, bigEndian);
+                    i += 2;
+                } else {
+                    dst[i++] = ch;
+                }
+            }
+
+            return true;
+        }
+
+        bool WriteUtf16(uint8_t* dst, const Char* src, size_t length, bool bigEndian)
+        {
+            size_t i = 0;
+
+            while (i < length) {
+#ifdef LUPUS_SSE2
+                if (length - i >= 8) {
+                    __m128i block = _mm_loadu_si128((const __m128i*)(src + i));
+
+                    if (!HasSurrogate(block)) {
+                        _mm_storeu_si128((__m128i*)(dst + i * 2), bigEndian ? SwapBytes(block) : block);
+                        i += 8;
+                        continue;
+                    }
+                }
+#endif
+                Char ch = src[i];
+
+                if (IsSurrogate(ch)) {
+                    if (!IsHighSurrogate(ch) || i + 1 == length || !IsLowSurrogate(src[i + 1])) {
+                        return false;
+                    }
+
+                    WriteUnit(dst + i * 2, ch, bigEndian);
+                    WriteUnit(dst + i * 2 + 2, src[i + 1], bigEndian);
+                    i += 2;
+                } else {
+                    WriteUnit(dst + i * 2, ch, bigEndian);
+                    i++;
+                }
+            }
+
+            return true;
+        }
+
+        void WriteUtf16(uint8_t* dst, const uint8_t* src, size_t length, bool bigEndian)
+        {
+            size_t i = 0;
+
+#ifdef LUPUS_SSE2
+            const __m128i zero = _mm_setzero_si128();
+
+            for (; length - i >= 16; i += 16) {
+                __m128i block = _mm_loadu_si128((const __m128i*)(src + i));
+                __m128i low = bigEndian ? _mm_unpacklo_epi8(zero, block) : _mm_unpacklo_epi8(block, zero);
+                __m128i high = bigEndian ? _mm_unpackhi_epi8(zero, block) : _mm_unpackhi_epi8(block, zero);
+                _mm_storeu_si128((__m128i*)(dst + i * 2), low);
+                _mm_storeu_si128((__m128i*)(dst + i * 2 + 16), high);
+            }
+#endif
+
+            for (; i < length; i++) {
+                WriteUnit(dst + i * 2, (Char)src[i], bigEndian);
+            }
+        }
+    }
+}
@@ -0,0 +1,170 @@
+/**
+ * Copyright (C) 2014 David Wolf <d.wolf@live.at>
+ *
+ * This file is part of Lupus.
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include "Utf8String.h"
+#include "Utf8View.h"
+#include "Internal/StringBuffer.h"
+#include <unicode/ustring.h>
+
+using namespace std;
+
+namespace Lupus {
+    Utf8String::Utf8String()
+    {
+    }
+
+    Utf8String::Utf8String(const char* str) :
+        mData(str)
+    {
+    }
+
+    Utf8String::Utf8String(const char* str, size_t length) :
+        mData(str, length)
+    {
+    }
+
+    Utf8String::Utf8String(const string& str) :
+        mData(str)
+    {
+    }
+
+    Utf8String::Utf8String(string&& str) :
+        mData(move(str))
+    {
+    }
+
+    Utf8String::Utf8String(const String& str)
+    {
+        StringChars chars(str);
+        const Char* data = chars.Data();
+        size_t length = str.Length();
+        size_t ascii = 0;
+
+        while (ascii < length && data[ascii] < 0x80) {
+            ascii++;
+        }
+
+        if (ascii == length) {
+            mData.resize(length);
+
+            for (size_t i = 0; i < length; i++) {
+                mData[i] = (char)data[i];
+            }
+
+            return;
+        }
+
+        UErrorCode error = U_ZERO_ERROR;
+        int32_t size = 0;
+
+        u_strToUTF8WithSub(nullptr, 0, &size, data, (int32_t)length, 0xFFFD, nullptr, &error);
+
+        if (error != U_BUFFER_OVERFLOW_ERROR && U_FAILURE(error)) {
+            return;
+        }
+
+        error = U_ZERO_ERROR;
+        mData.resize(size);
+        u_strToUTF8WithSub(&mData[0], size, nullptr, data, (int32_t)length, 0xFFFD, nullptr, &error);
+    }
+
+    Utf8String::Utf8String(Utf8String&& str) :
+        mData(move(str.mData))
+    {
+    }
+
+    const char* Utf8String::Data() const
+    {
+        return mData.c_str();
+    }
+
+    bool Utf8String::IsEmpty() const
+    {
+        return mData.empty();
+    }
+
+    size_t Utf8String::Length() const
+    {
+        return mData.size();
+    }
+
+    Utf8String& Utf8String::Append(const char* str, size_t length)
+    {
+        mData.append(str, length);
+        return *this;
+    }
+
+    Utf8String& Utf8String::Append(const Utf8String& str)
+    {
+        mData.append(str.mData);
+        return *this;
+    }
+
+    void Utf8String::Clear()
+    {
+        mData.clear();
+    }
+
+    String Utf8String::ToString() const
+    {
+        return Utf8View(*this).ToString();
+    }
+
+    const string& Utf8String::ToStdString() const
+    {
+        return mData;
+    }
+
+    bool Utf8String::operator==(const Utf8String& str) const
+    {
+        return mData == str.mData;
+    }
+
+    bool Utf8String::operator!=(const Utf8String& str) const
+    {
+        return mData != str.mData;
+    }
+
+    bool Utf8String::operator<(const Utf8String& str) const
+    {
+        return mData < str.mData;
+    }
+
+    Utf8String Utf8String::operator+(const Utf8String& str) const
+    {
+        Utf8String result;
+        result.mData.reserve(mData.size() + str.mData.size());
+        result.mData.append(mData).append(str.mData);
+        return result;
+    }
+
+    Utf8String& Utf8String::operator+=(const Utf8String& str)
+    {
+        return Append(str);
+    }
+
+    Utf8String& Utf8String::operator=(Utf8String&& str)
+    {
+        mData = move(str.mData);
+        return *this;
+    }
+}
@@ -0,0 +1,111 @@
+/**
+ * Copyright (C) 2014 David Wolf <d.wolf@live.at>
+ *
+ * This file is part of Lupus.
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#pragma once
+
+#include "String.h"
+#include <string>
+
+#ifdef _MSC_VER
+#pragma warning(push)
+#pragma warning(disable: 4251)
+#endif
+
+namespace Lupus {
+    //! Owning UTF-8 string for data that arrives or leaves as bytes.
+    //!
+    //! Sockets, libpq and the dynamic loader speak UTF-8; keeping such data
+    //! in a Utf8String avoids the round trip through UTF-16. Lengths and
+    //! offsets count bytes. The characters are always null terminated, so
+    //! Data() can be passed to C APIs directly. Searching, splitting and
+    //! parsing are provided by Utf8View.
+    class LUPUSCORE_API Utf8String
+    {
+    public:
+
+        typedef const char* const_iterator;
+
+        inline const_iterator begin() const { return mData.data(); }
+        inline const_iterator cbegin() const { return mData.data(); }
+        inline const_iterator end() const { return mData.data() + mData.size(); }
+        inline const_iterator cend() const { return mData.data() + mData.size(); }
+
+        Utf8String() NOEXCEPT;
+        Utf8String(const char* str) NOEXCEPT;
+        Utf8String(const char* str, size_t length) NOEXCEPT;
+        //! Explicit, so that a std::string argument picks the String
+        //! overload of functions that take either.
+        explicit Utf8String(const std::string& str) NOEXCEPT;
+        //! \sa Utf8String::Utf8String(const std::string&)
+        explicit Utf8String(std::string&& str) NOEXCEPT;
+        //! Transcodes str; ASCII is narrowed without going through ICU.
+        explicit Utf8String(const String& str) NOEXCEPT;
+        Utf8String(const Utf8String&) = default;
+        Utf8String(Utf8String&& str) NOEXCEPT;
+        ~Utf8String() = default;
+
+        const char* Data() const NOEXCEPT;
+        bool IsEmpty() const NOEXCEPT;
+        size_t Length() const NOEXCEPT;
+
+        Utf8String& Append(const char* str, size_t length) NOEXCEPT;
+        Utf8String& Append(const Utf8String& str) NOEXCEPT;
+        void Clear() NOEXCEPT;
+        //! Transcodes to UTF-16; ASCII is widened without going through ICU.
+        String ToString() const NOEXCEPT;
+        const std::string& ToStdString() const NOEXCEPT;
+
+        bool operator==(const Utf8String& str) const NOEXCEPT;
+        bool operator!=(const Utf8String& str) const NOEXCEPT;
+        bool operator<(const Utf8String& str) const NOEXCEPT;
+        Utf8String operator+(const Utf8String& str) const NOEXCEPT;
+        Utf8String& operator+=(const Utf8String& str) NOEXCEPT;
+        Utf8String& operator=(const Utf8String&) = default;
+        Utf8String& operator=(Utf8String&& str) NOEXCEPT;
+
+    private:
+
+        std::string mData;
+    };
+}
+
+namespace std {
+    template <>
+    struct hash < Lupus::Utf8String >
+    {
+        typedef Lupus::Utf8String argument_type;
+        typedef std::size_t result_type;
+
+        hash() = default;
+        hash(const hash&) = default;
+        ~hash() = default;
+
+        result_type operator()(const Lupus::Utf8String& str) const
+        {
+            return std::hash<std::string>()(str.ToStdString());
+        }
+    };
+}
+
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
@@ -0,0 +1,452 @@
+/**
+ * Copyright (C) 2014 David Wolf <d.wolf@live.at>
+ *
+ * This file is part of Lupus.
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include "Utf8View.h"
+#include "StringView.h"
+#include <unicode/uchar.h>
+#include <unicode/ustring.h>
+#include <unicode/utf8.h>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+
+using namespace std;
+
+#ifdef _MSC_VER
+#pragma warning(push)
+#pragma warning(disable: 4267)
+#endif
+
+namespace Lupus {
+    static const char sEmptyView[1] = { 0 };
+
+    static inline int FindFirst(const char* data, size_t length, const char* str, size_t size, size_t offset)
+    {
+        if (size == 0 || size > length) {
+            return -1;
+        }
+
+        const char* last = data + length - size;
+
+        for (const char* it = data + offset; it <= last; it++) {
+            it = (const char*)memchr(it, str[0], last - it + 1);
+
+            if (!it) {
+                break;
+            } else if (memcmp(it + 1, str + 1, size - 1) == 0) {
+                return (int)(it - data);
+            }
+        }
+
+        return -1;
+    }
+
+    static inline char ToLowerAscii(char ch)
+    {
+        return ch >= 'A' && ch <= 'Z' ? ch + ('a' - 'A') : ch;
+    }
+
+    static inline int Digit(char ch)
+    {
+        if (ch >= '0' && ch <= '9') {
+            return ch - '0';
+        } else if (ch >= 'a' && ch <= 'z') {
+            return ch - 'a' + 10;
+        } else if (ch >= 'A' && ch <= 'Z') {
+            return ch - 'A' + 10;
+        }
+
+        return 36;
+    }
+
+    // Accumulates the digits of str with overflow checks; negative values
+    // are only accepted if T is signed.
+    template <typename T>
+    static bool ParseInteger(const char* str, size_t length, IntegerBase base, T& result)
+    {
+        const unsigned radix = base == IntegerBase::Octal ? 8 : base == IntegerBase::Hexadecimal ? 16 : 10;
+        const char* it = str;
+        const char* end = str + length;
+        bool negative = false;
+
+        if (it != end && (*it == '+' || *it == '-')) {
+            negative = *it++ == '-';
+
+            if (negative && !numeric_limits<T>::is_signed) {
+                return false;
+            }
+        }
+
+        if (radix == 16 && end - it > 2 && it[0] == '0' && (it[1] == 'x' || it[1] == 'X')) {
+            it += 2;
+        }
+
+        if (it == end) {
+            return false;
+        }
+
+        typedef unsigned long long Unsigned;
+        const Unsigned limit = negative ? (Unsigned)numeric_limits<T>::max() + 1 : (Unsigned)numeric_limits<T>::max();
+        Unsigned value = 0;
+
+        for (; it != end; it++) {
+            unsigned digit = (unsigned)Digit(*it);
+
+            if (digit >= radix || value > (limit - digit) / radix) {
+                return false;
+            }
+
+            value = value * radix + digit;
+        }
+
+        result = negative ? (T)(0 - value) : (T)value;
+        return true;
+    }
+
+    Utf8View::Utf8View() :
+        mData(sEmptyView), mLength(0)
+    {
+    }
+
+    Utf8View::Utf8View(const char* str) :
+        mData(str), mLength(strlen(str))
+    {
+    }
+
+    Utf8View::Utf8View(const char* str, size_t length) :
+        mData(str), mLength(length)
+    {
+    }
+
+    Utf8View::Utf8View(const string& str) :
+        mData(str.data()), mLength(str.size())
+    {
+    }
+
+    Utf8View::Utf8View(const Utf8String& str) :
+        mData(str.Data()), mLength(str.Length())
+    {
+    }
+
+    const char& Utf8View::operator[](size_t index) const
+    {
+        if (index >= mLength) {
+            throw out_of_range("index");
+        }
+
+        return mData[index];
+    }
+
+    const char* Utf8View::Data() const
+    {
+        return mData;
+    }
+
+    bool Utf8View::IsEmpty() const
+    {
+        return mLength == 0;
+    }
+
+    size_t Utf8View::Length() const
+    {
+        return mLength;
+    }
+
+    int Utf8View::Compare(Utf8View str, StringCaseSensitivity sens) const
+    {
+        size_t length = min(mLength, str.mLength);
+        int result = 0;
+
+        if (sens == StringCaseSensitivity::CaseSensitive) {
+            // Byte order of UTF-8 is code point order.
+            result = length > 0 ? memcmp(mData, str.mData, length) : 0;
+        } else {
+            for (size_t i = 0; i < length && result == 0; i++) {
+                if ((uint8_t)mData[i] >= 0x80 || (uint8_t)str.mData[i] >= 0x80) {
+                    return ToString().Compare(str.ToString(), sens);
+                }
+
+                result = (uint8_t)ToLowerAscii(mData[i]) - (uint8_t)ToLowerAscii(str.mData[i]);
+            }
+        }
+
+        if (result == 0) {
+            result = (mLength > str.mLength) - (mLength < str.mLength);
+        }
+
+        return (result > 0) - (result < 0);
+    }
+
+    bool Utf8View::Contains(Utf8View str) const
+    {
+        return IndexOf(str) != -1;
+    }
+
+    bool Utf8View::EndsWith(Utf8View str) const
+    {
+        return str.mLength <= mLength && memcmp(mData + mLength - str.mLength, str.mData, str.mLength) == 0;
+    }
+
+    int Utf8View::IndexOf(char ch) const
+    {
+        const char* result = (const char*)memchr(mData, ch, mLength);
+        return result ? (int)(result - mData) : -1;
+    }
+
+    int Utf8View::IndexOf(Utf8View str) const
+    {
+        return FindFirst(mData, mLength, str.mData, str.mLength, 0);
+    }
+
+    int Utf8View::IndexOf(char ch, size_t offset) const
+    {
+        if (offset > mLength) {
+            throw out_of_range("offset");
+        }
+
+        const char* result = (const char*)memchr(mData + offset, ch, mLength - offset);
+        return result ? (int)(result - mData) : -1;
+    }
+
+    int Utf8View::IndexOf(Utf8View str, size_t offset) const
+    {
+        if (offset > mLength) {
+            throw out_of_range("offset");
+        }
+
+        return FindFirst(mData, mLength, str.mData, str.mLength, offset);
+    }
+
+    int Utf8View::LastIndexOf(char ch) const
+    {
+        for (size_t i = mLength; i > 0; i--) {
+            if (mData[i - 1] == ch) {
+                return (int)(i - 1);
+            }
+        }
+
+        return -1;
+    }
+
+    int Utf8View::LastIndexOf(Utf8View str) const
+    {
+        if (str.mLength == 0 || str.mLength > mLength) {
+            return -1;
+        }
+
+        for (size_t i = mLength - str.mLength + 1; i > 0; i--) {
+            if (memcmp(mData + i - 1, str.mData, str.mLength) == 0) {
+                return (int)(i - 1);
+            }
+        }
+
+        return -1;
+    }
+
+    vector<Utf8View> Utf8View::Split(char delimiter, StringSplitOption option) const
+    {
+        return Split(Utf8View(&delimiter, 1), (size_t)-1, option);
+    }
+
+    vector<Utf8View> Utf8View::Split(Utf8View delimiter, StringSplitOption option) const
+    {
+        return Split(delimiter, (size_t)-1, option);
+    }
+
+    vector<Utf8View> Utf8View::Split(Utf8View delimiter, size_t count, StringSplitOption option) const
+    {
+        vector<Utf8View> result;
+        size_t previous = 0;
+
+        if (count == 0) {
+            return result;
+        }
+
+        for (int index = FindFirst(mData, mLength, delimiter.mData, delimiter.mLength, 0); index != -1 && result.size() + 1 < count; index = FindFirst(mData, mLength, delimiter.mData, delimiter.mLength, previous)) {
+            if (option == StringSplitOption::None || (size_t)index != previous) {
+                result.push_back(Utf8View(mData + previous, index - previous));
+            }
+
+            previous = index + delimiter.mLength;
+        }
+
+        if (option == StringSplitOption::None || previous < mLength) {
+            result.push_back(Utf8View(mData + previous, mLength - previous));
+        }
+
+        return result;
+    }
+
+    bool Utf8View::StartsWith(Utf8View str) const
+    {
+        return str.mLength <= mLength && memcmp(mData, str.mData, str.mLength) == 0;
+    }
+
+    Utf8View Utf8View::Substring(size_t startIndex) const
+    {
+        if (startIndex > mLength) {
+            throw out_of_range("startIndex");
+        }
+
+        return Utf8View(mData + startIndex, mLength - startIndex);
+    }
+
+    Utf8View Utf8View::Substring(size_t startIndex, size_t count) const
+    {
+        if (startIndex > mLength) {
+            throw out_of_range("startIndex");
+        } else if (count > mLength - startIndex) {
+            throw out_of_range("count");
+        }
+
+        return Utf8View(mData + startIndex, count);
+    }
+
+    String Utf8View::ToString() const
+    {
+        String result;
+        size_t ascii = 0;
+
+        while (ascii < mLength && (uint8_t)mData[ascii] < 0x80) {
+            ascii++;
+        }
+
+        if (ascii == mLength && mLength > String::SmallCapacity) {
+            memcpy(result.InitializeCompact(mLength), mData, mLength);
+            result.MarkAscii(true);
+            return result;
+        } else if (ascii == mLength) {
+            Char* data = result.Initialize(mLength);
+
+            for (size_t i = 0; i < mLength; i++) {
+                data[i] = (Char)mData[i];
+            }
+
+            result.MarkAscii(true);
+            return result;
+        }
+
+        UErrorCode error = U_ZERO_ERROR;
+        int32_t length = 0;
+
+        u_strFromUTF8WithSub(nullptr, 0, &length, mData, (int32_t)mLength, 0xFFFD, nullptr, &error);
+
+        if (error != U_BUFFER_OVERFLOW_ERROR && U_FAILURE(error)) {
+            return result;
+        }
+
+        error = U_ZERO_ERROR;
+        u_strFromUTF8WithSub(result.Initialize(length), length + 1, nullptr, mData, (int32_t)mLength, 0xFFFD, nullptr, &error);
+        result.Compact();
+        return result;
+    }
+
+    Utf8String Utf8View::ToUtf8String() const
+    {
+        return Utf8String(mData, mLength);
+    }
+
+    Utf8View Utf8View::Trim() const
+    {
+        int32_t start = 0;
+        int32_t end = (int32_t)mLength;
+        UChar32 c;
+
+        while (start < end) {
+            int32_t next = start;
+            U8_NEXT(mData, next, end, c);
+
+            if (!(c == 0x20 || u_isWhitespace(c))) {
+                break;
+            }
+
+            start = next;
+        }
+
+        while (end > start) {
+            int32_t previous = end;
+            U8_PREV(mData, start, previous, c);
+
+            if (!(c == 0x20 || u_isWhitespace(c))) {
+                break;
+            }
+
+            end = previous;
+        }
+
+        return Utf8View(mData + start, end - start);
+    }
+
+    bool Utf8View::TryParse(int& result, IntegerBase base) const
+    {
+        return ParseInteger(mData, mLength, base, result);
+    }
+
+    bool Utf8View::TryParse(long long& result, IntegerBase base) const
+    {
+        return ParseInteger(mData, mLength, base, result);
+    }
+
+    bool Utf8View::TryParse(unsigned int& result, IntegerBase base) const
+    {
+        return ParseInteger(mData, mLength, base, result);
+    }
+
+    bool Utf8View::TryParse(unsigned long long& result, IntegerBase base) const
+    {
+        return ParseInteger(mData, mLength, base, result);
+    }
+
+    bool Utf8View::TryParse(double& result) const
+    {
+        char buffer[64];
+        char* end = nullptr;
+
+        if (mLength == 0 || mLength >= sizeof(buffer) || (uint8_t)mData[0] <= 0x20) {
+            return false;
+        }
+
+        memcpy(buffer, mData, mLength);
+        buffer[mLength] = 0;
+        result = strtod(buffer, &end);
+        return end == buffer + mLength;
+    }
+
+    bool Utf8View::operator==(Utf8View str) const
+    {
+        return mLength == str.mLength && memcmp(mData, str.mData, mLength) == 0;
+    }
+
+    bool Utf8View::operator!=(Utf8View str) const
+    {
+        return !(*this == str);
+    }
+
+    bool Utf8View::operator<(Utf8View str) const
+    {
+        return Compare(str) < 0;
+    }
+}
+
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
@@ -0,0 +1,116 @@
+/**
+ * Copyright (C) 2014 David Wolf <d.wolf@live.at>
+ *
+ * This file is part of Lupus.
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#pragma once
+
+#include "Utf8String.h"
+#include "Integer.h"
+#include <vector>
+
+#ifdef _MSC_VER
+#pragma warning(push)
+#pragma warning(disable: 4251)
+#endif
+
+namespace Lupus {
+    //! Read-only window into UTF-8 bytes, the counterpart of StringView.
+    //!
+    //! A view does not own its bytes and is not null terminated. Lengths
+    //! and offsets count bytes; searching for a well-formed needle never
+    //! matches inside a multibyte sequence. Case insensitive comparison
+    //! folds ASCII directly and falls back to String for anything else.
+    class LUPUSCORE_API Utf8View
+    {
+    public:
+
+        typedef const char* iterator;
+        typedef const char* const_iterator;
+
+        inline const_iterator begin() const { return mData; }
+        inline const_iterator cbegin() const { return mData; }
+        inline const_iterator end() const { return mData + mLength; }
+        inline const_iterator cend() const { return mData + mLength; }
+
+        Utf8View() NOEXCEPT;
+        Utf8View(const char* str) NOEXCEPT;
+        Utf8View(const char* str, size_t length) NOEXCEPT;
+        Utf8View(const std::string& str) NOEXCEPT;
+        Utf8View(const Utf8String& str) NOEXCEPT;
+        Utf8View(const Utf8View&) = default;
+        ~Utf8View() = default;
+
+        const char& operator[](size_t index) const throw(std::out_of_range);
+        const char* Data() const NOEXCEPT;
+        bool IsEmpty() const NOEXCEPT;
+        size_t Length() const NOEXCEPT;
+
+        int Compare(Utf8View str, StringCaseSensitivity = StringCaseSensitivity::CaseSensitive) const NOEXCEPT;
+        bool Contains(Utf8View str) const NOEXCEPT;
+        bool EndsWith(Utf8View str) const NOEXCEPT;
+        int IndexOf(char ch) const NOEXCEPT;
+        int IndexOf(Utf8View str) const NOEXCEPT;
+        int IndexOf(char ch, size_t offset) const throw(std::out_of_range);
+        int IndexOf(Utf8View str, size_t offset) const throw(std::out_of_range);
+        int LastIndexOf(char ch) const NOEXCEPT;
+        int LastIndexOf(Utf8View str) const NOEXCEPT;
+        std::vector<Utf8View> Split(char delimiter, StringSplitOption = StringSplitOption::None) const NOEXCEPT;
+        std::vector<Utf8View> Split(Utf8View delimiter, StringSplitOption = StringSplitOption::None) const NOEXCEPT;
+        std::vector<Utf8View> Split(Utf8View delimiter, size_t count, StringSplitOption = StringSplitOption::None) const NOEXCEPT;
+        bool StartsWith(Utf8View str) const NOEXCEPT;
+        Utf8View Substring(size_t startIndex) const throw(std::out_of_range);
+        Utf8View Substring(size_t startIndex, size_t count) const throw(std::out_of_range);
+        //! Transcodes to UTF-16; ASCII is widened without going through ICU.
+        String ToString() const NOEXCEPT;
+        Utf8String ToUtf8String() const NOEXCEPT;
+        Utf8View Trim() const NOEXCEPT;
+
+        /**
+         * Parses the whole view as an integer without leading or trailing
+         * blanks. Hexadecimal values may start with 0x.
+         *
+         * \returns False if the view is not a number or does not fit.
+         */
+        bool TryParse(int& result, IntegerBase base = IntegerBase::Decimal) const NOEXCEPT;
+        //! \sa Utf8View::TryParse(int&, IntegerBase)
+        bool TryParse(long long& result, IntegerBase base = IntegerBase::Decimal) const NOEXCEPT;
+        //! \sa Utf8View::TryParse(int&, IntegerBase)
+        bool TryParse(unsigned int& result, IntegerBase base = IntegerBase::Decimal) const NOEXCEPT;
+        //! \sa Utf8View::TryParse(int&, IntegerBase)
+        bool TryParse(unsigned long long& result, IntegerBase base = IntegerBase::Decimal) const NOEXCEPT;
+        //! Parses the whole view as a floating point number.
+        bool TryParse(double& result) const NOEXCEPT;
+
+        bool operator==(Utf8View str) const NOEXCEPT;
+        bool operator!=(Utf8View str) const NOEXCEPT;
+        bool operator<(Utf8View str) const NOEXCEPT;
+        Utf8View& operator=(const Utf8View&) = default;
+
+    private:
+
+        const char* mData;
+        size_t mLength;
+    };
+}
+
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
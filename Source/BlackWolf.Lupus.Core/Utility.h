@@ -139,6 +139,7 @@ namespace Lupus {
 
     typedef std::unordered_map<class String, class String> NameValueCollection;
     typedef std::pair<class String, class String> NameValuePair;
+    typedef std::unordered_map<class String, class String, struct StringCaseInsensitiveHash, struct StringCaseInsensitiveEqual> CaseInsensitiveNameValueCollection;
 
     template <typename TValue>
     using NameCollection = std::unordered_map < class String, TValue > ;
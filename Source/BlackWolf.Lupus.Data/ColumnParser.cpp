@@ -0,0 +1,169 @@
+/**
+ * Copyright (C) 2014 David Wolf <d.wolf@live.at>
+ *
+ * This file is part of Lupus.
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include "ColumnParser.h"
+#include <BlackWolf.Lupus.Core/Float.h>
+#include <BlackWolf.Lupus.Core/Integer.h>
+#include <algorithm>
+#include <cstring>
+#include <thread>
+
+using namespace std;
+
+namespace Lupus {
+    namespace Data {
+        //! Columns are split into chunks of at least this many cells per thread.
+        static const size_t sChunkSize = 16384;
+
+        static size_t WorkerCount(size_t count)
+        {
+            size_t workers = thread::hardware_concurrency();
+
+            if (count < 2 * sChunkSize || workers < 2) {
+                return 1;
+            }
+
+            return min(workers, count / sChunkSize);
+        }
+
+        //! Runs function(worker) for every worker; the calling thread is worker 0.
+        template <typename Function>
+        static void ParallelFor(size_t workers, const Function& function)
+        {
+            vector<thread> threads;
+
+            for (size_t i = 1; i < workers; i++) {
+                threads.push_back(thread([&function, i] { function(i); }));
+            }
+
+            function(0);
+
+            for (thread& t : threads) {
+                t.join();
+            }
+        }
+
+        // Digits are converted eight at a time by the SWAR kernels in
+        // Integer::FromChars and Float::FromChars.
+        static inline bool ParseCell(const char* cell, size_t length, int64_t& result)
+        {
+            long long value;
+
+            if (cell == nullptr || length == 0 || Integer::FromChars(cell, cell + length, value) != length) {
+                return false;
+            }
+
+            result = value;
+            return true;
+        }
+
+        static inline bool ParseCell(const char* cell, size_t length, double& result)
+        {
+            double value;
+
+            if (cell == nullptr || length == 0 || Float::FromChars(cell, cell + length, value) != length) {
+                return false;
+            }
+
+            result = value;
+            return true;
+        }
+
+        template <typename T>
+        static NumericColumn<T> ParseCells(const char* const* cells, const size_t* lengths, size_t count)
+        {
+            NumericColumn<T> column;
+            column.Values.resize(count);
+            column.Validity.resize((count + 7) / 8);
+
+            size_t bytes = column.Validity.size();
+            size_t workers = WorkerCount(count);
+            T* values = column.Values.data();
+            uint8_t* validity = column.Validity.data();
+
+            // Chunks start at multiples of eight rows, so no two threads
+            // write to the same validity byte.
+            ParallelFor(workers, [&](size_t worker) {
+                size_t first = bytes * worker / workers * 8;
+                size_t last = min(count, bytes * (worker + 1) / workers * 8);
+
+                for (size_t i = first; i < last; i += 8) {
+                    size_t end = min(last, i + 8);
+                    unsigned bits = 0;
+
+                    for (size_t j = i; j < end; j++) {
+                        bits |= (unsigned)ParseCell(cells[j], lengths[j], values[j]) << (j - i);
+                    }
+
+                    validity[i / 8] = (uint8_t)bits;
+                }
+            });
+
+            return column;
+        }
+
+        template <typename T>
+        static NumericColumn<T> ParseDelimited(const char* buffer, size_t size, char delimiter)
+        {
+            vector<const char*> cells;
+            vector<size_t> lengths;
+            const char* it = buffer;
+            const char* end = buffer + size;
+
+            for (;;) {
+                const char* next = (const char*)memchr(it, delimiter, end - it);
+                const char* stop = next ? next : end;
+
+                cells.push_back(it);
+                lengths.push_back(stop - it);
+
+                if (!next) {
+                    break;
+                }
+
+                it = next + 1;
+            }
+
+            return ParseCells<T>(cells.data(), lengths.data(), cells.size());
+        }
+
+        NumericColumn<int64_t> ColumnParser::ParseInteger(const char* const* cells, const size_t* lengths, size_t count)
+        {
+            return ParseCells<int64_t>(cells, lengths, count);
+        }
+
+        NumericColumn<int64_t> ColumnParser::ParseInteger(const char* buffer, size_t size, char delimiter)
+        {
+            return ParseDelimited<int64_t>(buffer, size, delimiter);
+        }
+
+        NumericColumn<double> ColumnParser::ParseDouble(const char* const* cells, const size_t* lengths, size_t count)
+        {
+            return ParseCells<double>(cells, lengths, count);
+        }
+
+        NumericColumn<double> ColumnParser::ParseDouble(const char* buffer, size_t size, char delimiter)
+        {
+            return ParseDelimited<double>(buffer, size, delimiter);
+        }
+    }
+}
@@ -0,0 +1,75 @@
+/**
+ * Copyright (C) 2014 David Wolf <d.wolf@live.at>
+ *
+ * This file is part of Lupus.
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#pragma once
+
+#include "Utility.h"
+#include <cstdint>
+#include <vector>
+
+#ifdef _MSC_VER
+#pragma warning(push)
+#pragma warning(disable: 4251)
+#endif
+
+namespace Lupus {
+    namespace Data {
+        /**
+         * Numbers of one column. Bit (row % 8) of Validity[row / 8] is set
+         * if the row held a number; rows without one hold 0.
+         */
+        template <typename T>
+        struct NumericColumn
+        {
+            std::vector<T> Values;
+            std::vector<uint8_t> Validity;
+
+            bool IsValid(size_t row) const NOEXCEPT
+            {
+                return ((Validity[row / 8] >> (row % 8)) & 1) != 0;
+            }
+        };
+
+        /**
+         * Parses whole columns of numbers in text form, as PQgetvalue
+         * returns them, by the rules of Integer::FromChars and
+         * Float::FromChars. A cell must hold the number alone; null
+         * pointers, empty cells and anything else are invalid. Large
+         * columns are split across several threads.
+         */
+        class LUPUSDATA_API ColumnParser
+        {
+        public:
+
+            static NumericColumn<int64_t> ParseInteger(const char* const* cells, const size_t* lengths, size_t count) NOEXCEPT;
+            //! Every delimiter ends a cell, so n delimiters give n + 1 cells.
+            static NumericColumn<int64_t> ParseInteger(const char* buffer, size_t size, char delimiter) NOEXCEPT;
+            static NumericColumn<double> ParseDouble(const char* const* cells, const size_t* lengths, size_t count) NOEXCEPT;
+            //! \sa ColumnParser::ParseInteger(const char*, size_t, char)
+            static NumericColumn<double> ParseDouble(const char* buffer, size_t size, char delimiter) NOEXCEPT;
+        };
+    }
+}
+
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
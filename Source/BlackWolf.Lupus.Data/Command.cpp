@@ -27,6 +27,16 @@ using namespace std;
 
 namespace Lupus {
     namespace Data {
+        void Command::Text(const Utf8String& text)
+        {
+            Text(text.ToString());
+        }
+
+        void Command::Text(const char* text)
+        {
+            Text(Utf8String(text));
+        }
+
         Task<int> Command::ExecuteNonQueryAsync()
         {
             return Task<int>([this]() {
@@ -27,6 +27,7 @@
 #include <memory>
 #include <functional>
 #include <BlackWolf.Lupus.Core/String.h>
+#include <BlackWolf.Lupus.Core/Utf8String.h>
 #include <BlackWolf.Lupus.Core/Task.h>
 
 namespace Lupus {
@@ -46,6 +47,10 @@ namespace Lupus {
             virtual Task<std::vector<NameCollection<Any>>> ExecuteScalarAsync() NOEXCEPT;
 
             virtual void Text(const String&) NOEXCEPT = 0;
+            //! Sets the command text from UTF-8; the default converts it to String.
+            virtual void Text(const Utf8String&) NOEXCEPT;
+            //! Keeps literals from being ambiguous between both overloads.
+            void Text(const char*) NOEXCEPT;
             virtual String& Text() NOEXCEPT = 0;
             virtual const String& Text() const NOEXCEPT = 0;
             virtual std::vector<std::shared_ptr<Parameter>>& Parameters() NOEXCEPT = 0;
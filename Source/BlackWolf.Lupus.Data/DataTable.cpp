@@ -21,14 +21,63 @@
  * THE SOFTWARE.
  */
 #include "DataTable.h"
+#include "ColumnParser.h"
 #include "DataColumn.h"
 #include "DataRow.h"
 #include "IDataReader.h"
+#include <BlackWolf.Lupus.Core/Utf8View.h>
 
 using namespace std;
 
 namespace Lupus {
     namespace Data {
+        static bool IsIntegerType(DataType type)
+        {
+            switch (type) {
+                case DataType::SmallInt:
+                case DataType::Integer:
+                case DataType::Integer8:
+                case DataType::Serial:
+                case DataType::Serial8:
+                    return true;
+                default:
+                    return false;
+            }
+        }
+
+        static bool IsFloatType(DataType type)
+        {
+            switch (type) {
+                case DataType::Float:
+                case DataType::DoublePrecision:
+                case DataType::Real:
+                case DataType::SmallFloat:
+                    return true;
+                default:
+                    return false;
+            }
+        }
+
+        static bool IsTextType(DataType type)
+        {
+            switch (type) {
+                case DataType::Character:
+                case DataType::CharacterVarying:
+                case DataType::Text:
+                    return true;
+                default:
+                    return false;
+            }
+        }
+
+        template <typename T>
+        static void StoreColumn(vector<NameCollection<Any>>& rows, const String& name, const NumericColumn<T>& column)
+        {
+            for (size_t i = 0; i < rows.size(); i++) {
+                rows[i][name] = column.IsValid(i) ? Any(column.Values[i]) : Any();
+            }
+        }
+
         void DataTable::Load(shared_ptr<IDataReader> reader)
         {
             if (reader->Depth() == 0) {
@@ -36,22 +85,59 @@ namespace Lupus {
             }
 
             const int fieldCount = reader->FieldCount();
+            vector<String> names;
+            vector<NameCollection<Any>> rows;
+            // Numeric cells are kept as text and parsed a column at a time.
+            vector<vector<const char*>> cells(fieldCount);
+            vector<vector<size_t>> lengths(fieldCount);
+            vector<bool> numeric;
+            vector<bool> text;
 
+            // Every row is keyed by the same names, so they share one pooled buffer.
             for (int i = 0; i < fieldCount; i++) {
+                names.push_back(String::Intern(reader->ColumnName(i)));
                 mColumns.push_back(make_shared<DataColumn>(
-                    reader->ColumnName(i), reader->Type(i), i
+                    names[i], reader->Type(i), i
                 ));
+                // Binary numbers are decoded by the reader cell by cell.
+                numeric.push_back((IsIntegerType(reader->Type(i)) || IsFloatType(reader->Type(i))) && !reader->IsBinary(i));
+                text.push_back(IsTextType(reader->Type(i)));
             }
 
             do {
                 NameCollection<Any> row;
 
                 for (int i = 0; i < fieldCount; i++) {
-                    row[reader->ColumnName(i)] = reader->Value(i);
+                    if (numeric[i]) {
+                        size_t length = 0;
+                        cells[i].push_back(reader->RawValue(i, length));
+                        lengths[i].push_back(length);
+                    } else if (text[i]) {
+                        // Copied while the reader still owns the cell; Latin-1 text takes a byte per character.
+                        size_t length = 0;
+                        const char* data = reader->RawValue(i, length);
+                        row[names[i]] = data ? Any(Utf8View(data, length).ToString()) : Any();
+                    } else {
+                        row[names[i]] = reader->Value(i);
+                    }
                 }
 
-                mRows.push_back(make_shared<DataRow>(row));
+                rows.push_back(move(row));
             } while (reader->NextResult());
+
+            for (int i = 0; i < fieldCount; i++) {
+                if (!numeric[i]) {
+                    continue;
+                } else if (IsIntegerType(mColumns[i]->Type())) {
+                    StoreColumn(rows, names[i], ColumnParser::ParseInteger(cells[i].data(), lengths[i].data(), rows.size()));
+                } else if (IsFloatType(mColumns[i]->Type())) {
+                    StoreColumn(rows, names[i], ColumnParser::ParseDouble(cells[i].data(), lengths[i].data(), rows.size()));
+                }
+            }
+
+            for (NameCollection<Any>& row : rows) {
+                mRows.push_back(make_shared<DataRow>(row));
+            }
         }
 
         vector<shared_ptr<DataRow>> DataTable::Rows() const
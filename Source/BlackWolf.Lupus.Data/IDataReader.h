@@ -39,6 +39,11 @@ namespace Lupus {
             virtual int ColumnNumber(const String&) const NOEXCEPT = 0;
             virtual DataType Type(int) const NOEXCEPT = 0;
             virtual Any Value(int) const NOEXCEPT = 0;
+            //! Cell as sent by the server without conversion, nullptr if NULL.
+            virtual const char* RawValue(int, size_t& length) const NOEXCEPT = 0;
+            //! True if RawValue() is in the binary format of the server
+            //! rather than text; Value() decodes it either way.
+            virtual bool IsBinary(int) const NOEXCEPT = 0;
             virtual bool IsNull(int) const NOEXCEPT = 0;
             virtual bool NextResult() NOEXCEPT = 0;
         };
@@ -38,6 +38,8 @@ namespace Lupus {
                 virtual ~PgCommand();
 
                 virtual void Text(const String&) NOEXCEPT override;
+                //! Kept as UTF-8 and sent to the server without conversion.
+                virtual void Text(const Utf8String&) NOEXCEPT override;
                 virtual String& Text() NOEXCEPT override;
                 virtual const String& Text() const NOEXCEPT override;
                 virtual std::vector<std::shared_ptr<Parameter>>& Parameters() NOEXCEPT override;
@@ -47,16 +49,27 @@ namespace Lupus {
                 virtual int ExecuteNonQuery() throw(sql_error) override;
                 virtual std::shared_ptr<IDataReader> ExecuteReader() throw(sql_error) override;
                 virtual std::vector<NameCollection<Any>> ExecuteScalar() throw(sql_error) override;
+                //! Readers of a prepared query with NUMERIC columns get binary
+                //! results when every column has a binary decoder.
                 virtual bool Prepare() throw(sql_error) override;
 
             private:
 
-                pg_result* GetResult() throw(sql_error);
+                //! \param resultFormat 0 for text, 1 for binary results.
+                pg_result* GetResult(int resultFormat) throw(sql_error);
 
                 pg_conn* mPgConn = nullptr;
                 bool mPrepared = false;
+                //! Set by Prepare() if the result has NUMERIC columns and all
+                //! columns can be read in binary.
+                bool mBinaryResult = false;
                 String mName = "";
-                String mQuery = "";
+                // Either representation may be the current one; String is built on
+                // demand and caches its own UTF-8 form, see String::Utf8().
+                mutable String mQuery = "";
+                mutable bool mHasQuery = true;
+                Utf8String mQueryUtf8;
+                bool mHasQueryUtf8 = false;
                 std::vector<std::shared_ptr<Parameter>> mParameters;
             };
         }
@@ -43,6 +43,8 @@ namespace Lupus {
                 virtual int ColumnNumber(const String&) const NOEXCEPT override;
                 virtual DataType Type(int) const NOEXCEPT override;
                 virtual Any Value(int) const NOEXCEPT override;
+                virtual const char* RawValue(int, size_t& length) const NOEXCEPT override;
+                virtual bool IsBinary(int) const NOEXCEPT override;
                 virtual bool IsNull(int) const NOEXCEPT override;
                 virtual bool NextResult() NOEXCEPT override;
 
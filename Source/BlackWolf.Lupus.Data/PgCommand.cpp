@@ -38,6 +38,32 @@ using namespace std;
 namespace Lupus {
     namespace Data {
         namespace Postgres {
+            //! Commands report PGRES_COMMAND_OK, queries PGRES_TUPLES_OK.
+            static bool Succeeded(PGresult* result)
+            {
+                ExecStatusType status = PQresultStatus(result);
+                return (status == PGRES_COMMAND_OK || status == PGRES_TUPLES_OK);
+            }
+
+            //! Types whose binary format PgDataReader decodes.
+            static bool HasBinaryDecoder(Oid type)
+            {
+                switch (type) {
+                    case INT2OID:
+                    case INT4OID:
+                    case INT8OID:
+                    case FLOAT4OID:
+                    case FLOAT8OID:
+                    case NUMERICOID:
+                    case TEXTOID:
+                    case VARCHAROID:
+                    case BPCHAROID:
+                        return true;
+                    default:
+                        return false;
+                }
+            }
+
             PgCommand::PgCommand(PGconn* conn)
             {
                 mPgConn = conn;
@@ -47,18 +73,36 @@ namespace Lupus {
             {
             }
 
-            void PgCommand::Text(const String& PgCommand)
+            void PgCommand::Text(const String& query)
+            {
+                mQuery = query;
+                mHasQuery = true;
+                mHasQueryUtf8 = false;
+            }
+
+            void PgCommand::Text(const Utf8String& query)
             {
-                mQuery = PgCommand;
+                mQueryUtf8 = query;
+                mHasQueryUtf8 = true;
+                mHasQuery = false;
             }
 
             String& PgCommand::Text()
             {
+                static_cast<const PgCommand*>(this)->Text();
+
+                // The caller may change the text through the reference.
+                mHasQueryUtf8 = false;
                 return mQuery;
             }
 
             const String& PgCommand::Text() const
             {
+                if (!mHasQuery) {
+                    mQuery = mQueryUtf8.ToString();
+                    mHasQuery = true;
+                }
+
                 return mQuery;
             }
 
@@ -81,7 +125,7 @@ namespace Lupus {
             
             int PgCommand::ExecuteNonQuery()
             {
-                PGresult* result = GetResult();
+                PGresult* result = GetResult(0);
                 int rows = PQntuples(result);
                 PQclear(result);
                 return rows;
@@ -89,13 +133,13 @@ namespace Lupus {
             
             shared_ptr<IDataReader> PgCommand::ExecuteReader()
             {
-                return make_shared<PgDataReader>(GetResult());
+                return make_shared<PgDataReader>(GetResult(mBinaryResult ? 1 : 0));
             }
             
             vector<NameCollection<Any>> PgCommand::ExecuteScalar()
             {
                 vector<NameCollection<Any>> scalar;
-                PGresult* result = GetResult();
+                PGresult* result = GetResult(0);
                 
                 if (!result) {
                     return scalar;
@@ -149,61 +193,84 @@ namespace Lupus {
                 });
 
                 mName = RandomString(8);
-                PGresult* result = PQprepare(mPgConn, mName.ToUTF8().c_str(), mQuery.ToUTF8().c_str(), (int)paramTypes.size(), paramTypes.data());
+                PGresult* result = PQprepare(mPgConn, mName.Utf8().Data(), mHasQueryUtf8 ? mQueryUtf8.Data() : mQuery.Utf8().Data(), (int)paramTypes.size(), paramTypes.data());
 
                 if (!result) {
                     throw sql_error("database is not connected");
                 }
 
                 mPrepared = (PQresultStatus(result) == PGRES_COMMAND_OK);
+                mBinaryResult = false;
                 PQclear(result);
+
+                // NUMERIC is decoded from its digit groups, which is cheaper than
+                // its text, as long as every other column can be read in binary
+                // too; libpq only chooses one format for the whole result.
+                if (mPrepared && (result = PQdescribePrepared(mPgConn, mName.Utf8().Data()))) {
+                    int fields = PQnfields(result);
+                    bool numeric = false;
+                    bool decodable = true;
+
+                    for (int i = 0; i < fields; i++) {
+                        numeric |= (PQftype(result, i) == NUMERICOID);
+                        decodable &= HasBinaryDecoder(PQftype(result, i));
+                    }
+
+                    mBinaryResult = numeric && decodable;
+                    PQclear(result);
+                }
+
                 return mPrepared;
             }
 
-            PGresult* PgCommand::GetResult()
+            PGresult* PgCommand::GetResult(int resultFormat)
             {
                 PGresult* result = nullptr;
 
                 if (!mPrepared) {
-                    if (!(result = PQexec(mPgConn, mQuery.ToUTF8().c_str()))) {
+                    if (!(result = PQexec(mPgConn, mHasQueryUtf8 ? mQueryUtf8.Data() : mQuery.Utf8().Data()))) {
                         throw sql_error("database is not connected");
-                    } else if (PQresultStatus(result) != PGRES_COMMAND_OK) {
+                    } else if (!Succeeded(result)) {
+                        PQclear(result);
                         throw sql_error("error while executing command");
                     } else {
                         return result;
                     }
                 }
 
+                vector<StringUtf8> values;
                 vector<const char*> paramValues;
                 vector<int> paramFormats, paramLengths;
+                values.reserve(mParameters.size());
                 paramValues.reserve(mParameters.size());
                 paramFormats.reserve(mParameters.size());
                 paramLengths.reserve(mParameters.size());
 
-                for_each(begin(mParameters), end(mParameters), [&paramValues, &paramLengths, &paramFormats](shared_ptr<Parameter>& param) {
-                    String value = boost::any_cast<String>(param->Value());
-                    paramLengths.push_back((int)value.Length());
+                // Values given as UTF-8 are passed through; String values reuse
+                // the encoding cached by earlier executions. values is never
+                // reallocated, so the pointers into it stay valid.
+                for (const shared_ptr<Parameter>& param : mParameters) {
+                    const Any& value = param->Value();
 
-                    if (value.IsEmpty()) {
-                        char* buffer = new char[value.Length()];
-                        strncpy_s(buffer, value.Length(), value.ToUTF8().c_str(), value.Length());
-                        paramValues.push_back(buffer);
+                    if (value.type() == typeid(Utf8String)) {
+                        const Utf8String& str = boost::any_cast<const Utf8String&>(value);
+                        paramValues.push_back(str.Data());
+                        paramLengths.push_back((int)str.Length());
                     } else {
-                        paramValues.push_back("");
+                        values.push_back(boost::any_cast<const String&>(value).Utf8());
+                        paramValues.push_back(values.back().Data());
+                        paramLengths.push_back((int)values.back().Length());
                     }
 
                     paramFormats.push_back(0); // 0 = String, 1 = binär
-                });
-
-                result = PQexecPrepared(mPgConn, mName.ToUTF8().c_str(), (int)mParameters.size(), paramValues.data(), paramLengths.data(), paramFormats.data(), 0);
+                }
 
-                for_each(begin(paramValues), end(paramValues), [](const char* s) {
-                    delete s;
-                });
+                result = PQexecPrepared(mPgConn, mName.Utf8().Data(), (int)mParameters.size(), paramValues.data(), paramLengths.data(), paramFormats.data(), resultFormat);
 
                 if (!result) {
                     throw sql_error("database is not connected");
-                } else if (PQresultStatus(result) != PGRES_COMMAND_OK) {
+                } else if (!Succeeded(result)) {
+                    PQclear(result);
                     throw sql_error("error while executing command");
                 }
 
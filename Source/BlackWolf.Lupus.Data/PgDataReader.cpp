@@ -22,13 +22,89 @@
  */
 #include "Internal/PgDataReader.h"
 #include "Internal/PgOid.h"
+#include <BlackWolf.Lupus.Core/Decimal.h>
 #include <postgres/libpq-fe.h>
+#include <algorithm>
+#include <cstring>
+#include <limits>
 
 using namespace std;
 
 namespace Lupus {
     namespace Data {
         namespace Postgres {
+            //! Sign words of the binary NUMERIC format without a Decimal value.
+            static const uint16_t sNumericNaN = 0xC000;
+            static const uint16_t sNumericPositiveInfinity = 0xD000;
+            static const uint16_t sNumericNegativeInfinity = 0xF000;
+
+            static inline uint64_t ReadBigEndian(const char* data, size_t size)
+            {
+                uint64_t value = 0;
+
+                for (size_t i = 0; i < size; i++) {
+                    value = (value << 8) | (uint8_t)data[i];
+                }
+
+                return value;
+            }
+
+            /**
+             * Decodes the binary NUMERIC format. NaN and infinities become
+             * doubles; malformed values and values beyond Decimal give an
+             * empty Any.
+             */
+            static Any DecodeNumeric(const char* data, size_t length)
+            {
+                Decimal result;
+
+                if (length >= 8) {
+                    switch ((uint16_t)ReadBigEndian(data + 4, 2)) {
+                        case sNumericNaN:
+                            return numeric_limits<double>::quiet_NaN();
+                        case sNumericPositiveInfinity:
+                            return numeric_limits<double>::infinity();
+                        case sNumericNegativeInfinity:
+                            return -numeric_limits<double>::infinity();
+                    }
+                }
+
+                if (!Decimal::FromNumeric((const uint8_t*)data, length, result)) {
+                    return Any();
+                }
+
+                return result;
+            }
+
+            //! Decodes the binary formats of the types PgCommand requests in
+            //! binary; text types are the same in both formats.
+            static Any DecodeBinary(Oid type, const char* data, size_t length)
+            {
+                uint64_t bits = ReadBigEndian(data, min<size_t>(length, 8));
+                uint32_t low = (uint32_t)bits;
+                float single;
+                double value;
+
+                switch (type) {
+                    case INT2OID:
+                        return length == 2 ? Any((int64_t)(int16_t)bits) : Any();
+                    case INT4OID:
+                        return length == 4 ? Any((int64_t)(int32_t)bits) : Any();
+                    case INT8OID:
+                        return length == 8 ? Any((int64_t)bits) : Any();
+                    case FLOAT4OID:
+                        memcpy(&single, &low, sizeof(single));
+                        return length == 4 ? Any((double)single) : Any();
+                    case FLOAT8OID:
+                        memcpy(&value, &bits, sizeof(value));
+                        return length == 8 ? Any(value) : Any();
+                    case NUMERICOID:
+                        return DecodeNumeric(data, length);
+                    default:
+                        return data;
+                }
+            }
+
             PgDataReader::PgDataReader(PGresult* result)
             {
                 mPgResult = result;
@@ -56,7 +132,7 @@ namespace Lupus {
             
             int PgDataReader::ColumnNumber(const String& str) const
             {
-                return PQfnumber(mPgResult, str.ToUTF8().c_str());
+                return PQfnumber(mPgResult, str.Utf8().Data());
             }
             
             DataType PgDataReader::Type(int i) const
@@ -82,9 +158,38 @@ namespace Lupus {
             
             Any PgDataReader::Value(int i) const
             {
+                if (PQgetisnull(mPgResult, mCurrent, i) == 0) {
+                    const char* data = PQgetvalue(mPgResult, mCurrent, i);
+                    size_t length = (size_t)PQgetlength(mPgResult, mCurrent, i);
+                    Decimal value;
+
+                    // NUMERIC text is parsed without building a String first.
+                    if (PQfformat(mPgResult, i) == 1) {
+                        return DecodeBinary(PQftype(mPgResult, i), data, length);
+                    } else if (PQftype(mPgResult, i) == NUMERICOID && Decimal::FromChars(data, data + length, value) == length) {
+                        return value;
+                    }
+                }
+
+                return PQgetvalue(mPgResult, mCurrent, i);
+            }
+
+            const char* PgDataReader::RawValue(int i, size_t& length) const
+            {
+                if (PQgetisnull(mPgResult, mCurrent, i) == 1) {
+                    length = 0;
+                    return nullptr;
+                }
+
+                length = (size_t)PQgetlength(mPgResult, mCurrent, i);
                 return PQgetvalue(mPgResult, mCurrent, i);
             }
             
+            bool PgDataReader::IsBinary(int i) const
+            {
+                return (PQfformat(mPgResult, i) == 1);
+            }
+
             bool PgDataReader::IsNull(int i) const
             {
                 return (PQgetisnull(mPgResult, mCurrent, i) == 1);
@@ -92,7 +197,7 @@ namespace Lupus {
             
             bool PgDataReader::NextResult()
             {
-                return (++mCurrent >= PQntuples(mPgResult));
+                return (++mCurrent < PQntuples(mPgResult));
             }
         }
     }
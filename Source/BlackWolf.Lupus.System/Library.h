@@ -26,6 +26,7 @@
 #include <functional>
 #include <boost/noncopyable.hpp>
 #include <BlackWolf.Lupus.Core/String.h>
+#include <BlackWolf.Lupus.Core/Utf8String.h>
 
 namespace Lupus {
     namespace System {
@@ -33,8 +34,16 @@ namespace Lupus {
         {
         public:
             Library(String path) throw(io_error);
+            //! UTF-8 path; passed to the loader without conversion on Unix.
+            Library(const Utf8String& path) throw(io_error);
+            //! \sa Library::Library(const Utf8String&)
+            Library(const char* path) throw(io_error);
             virtual ~Library();
             virtual void* GetFunctionHandle(String functionName) NOEXCEPT;
+            //! Symbol names are looked up as UTF-8 on every platform.
+            virtual void* GetFunctionHandle(const Utf8String& functionName) NOEXCEPT;
+            //! \sa Library::GetFunctionHandle(const Utf8String&)
+            virtual void* GetFunctionHandle(const char* functionName) NOEXCEPT;
 
             template <typename ReturnType, typename... Args>
             std::function<ReturnType(Args...)> GetFunction(String functionName) NOEXCEPT
@@ -42,6 +51,18 @@ namespace Lupus {
                 return std::function<ReturnType(Args...)>((ReturnType(*)(Args...))(GetFunctionHandle(functionName)));
             }
 
+            template <typename ReturnType, typename... Args>
+            std::function<ReturnType(Args...)> GetFunction(const Utf8String& functionName) NOEXCEPT
+            {
+                return std::function<ReturnType(Args...)>((ReturnType(*)(Args...))(GetFunctionHandle(functionName)));
+            }
+
+            template <typename ReturnType, typename... Args>
+            std::function<ReturnType(Args...)> GetFunction(const char* functionName) NOEXCEPT
+            {
+                return std::function<ReturnType(Args...)>((ReturnType(*)(Args...))(GetFunctionHandle(functionName)));
+            }
+
         private:
 
             uintptr_t mHandle = 0;
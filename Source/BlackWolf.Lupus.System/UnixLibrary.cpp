@@ -27,11 +27,20 @@
 
 namespace Lupus {
     namespace System {
-        Library::Library(String path)
+        Library::Library(String path) :
+            Library(path.ToUTF8().c_str())
         {
-            if (!(mHandle = force_cast<uintptr_t>(dlopen(path.ToUTF8().c_str(), RTLD_NOW)))) {
-                // TODO: Information eintragen sobald String::Format implementiert ist.
-                throw io_error();
+        }
+
+        Library::Library(const Utf8String& path) :
+            Library(path.Data())
+        {
+        }
+
+        Library::Library(const char* path)
+        {
+            if (!(mHandle = force_cast<uintptr_t>(dlopen(path, RTLD_NOW)))) {
+                throw io_error(String::Format("Could not load library {0}: {1}", path, dlerror()).ToUTF8());
             }
         }
 
@@ -44,12 +53,22 @@ namespace Lupus {
         }
 
         void* Library::GetFunctionHandle(String name)
+        {
+            return GetFunctionHandle(name.Utf8().Data());
+        }
+
+        void* Library::GetFunctionHandle(const Utf8String& name)
+        {
+            return GetFunctionHandle(name.Data());
+        }
+
+        void* Library::GetFunctionHandle(const char* name)
         {
             if (!mHandle) {
                 return nullptr;
             }
 
-            return dlsym(force_cast<void*>(mHandle), name.ToUTF8().c_str());
+            return dlsym(force_cast<void*>(mHandle), name);
         }
     }
 }
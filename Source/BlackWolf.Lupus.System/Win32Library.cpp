@@ -29,11 +29,20 @@ namespace Lupus {
         Library::Library(String path)
         {
             if (!(mHandle = force_cast<uintptr_t>(LoadLibraryW(path.Data())))) {
-                // TODO: Information eintragen sobald String::Format implementiert ist.
-                throw io_error();
+                throw io_error(String::Format("Could not load library {0} (error {1})", path, GetLastError()).ToUTF8());
             }
         }
 
+        Library::Library(const Utf8String& path) :
+            Library(path.ToString())
+        {
+        }
+
+        Library::Library(const char* path) :
+            Library(Utf8String(path).ToString())
+        {
+        }
+
         Library::~Library()
         {
             if (mHandle) {
@@ -43,12 +52,22 @@ namespace Lupus {
         }
 
         void* Library::GetFunctionHandle(String name)
+        {
+            return GetFunctionHandle(name.Utf8().Data());
+        }
+
+        void* Library::GetFunctionHandle(const Utf8String& name)
+        {
+            return GetFunctionHandle(name.Data());
+        }
+
+        void* Library::GetFunctionHandle(const char* name)
         {
             if (!mHandle) {
                 return nullptr;
             }
 
-            return force_cast<void*>(GetProcAddress(force_cast<HMODULE>(mHandle), name.ToUTF8().c_str()));
+            return force_cast<void*>(GetProcAddress(force_cast<HMODULE>(mHandle), name));
         }
     }
 }
@@ -0,0 +1,183 @@
+#include "Benchmark.h"
+#include <memory>
+#include <string>
+#include <vector>
+#include <Windows.h>
+#include <Psapi.h>
+#include <BlackWolf.Lupus.Core/Float.h>
+#include <BlackWolf.Lupus.Core/Integer.h>
+#include <BlackWolf.Lupus.Core/String.h>
+#include <BlackWolf.Lupus.Data/ColumnParser.h>
+#include <BlackWolf.Lupus.Data/DataTable.h>
+#include <BlackWolf.Lupus.Data/IDataReader.h>
+
+using namespace std;
+using namespace Lupus;
+using namespace Lupus::Data;
+
+// A column of cells in the form PQgetvalue hands them out: null
+// terminated strings with their lengths, and the same text joined by
+// delimiters.
+struct TextColumn
+{
+    string Values;
+    string Buffer;
+    vector<const char*> Cells;
+    vector<size_t> Lengths;
+};
+
+static TextColumn MakeColumn(size_t count, bool fractional)
+{
+    TextColumn column;
+    vector<size_t> offsets;
+
+    for (size_t i = 0; i < count; i++) {
+        string cell = to_string((long long)(i * 7919 % 10000000) - 5000000);
+
+        if (fractional) {
+            cell += "." + to_string(i % 1000);
+        }
+
+        offsets.push_back(column.Values.size());
+        column.Lengths.push_back(cell.size());
+        column.Values.append(cell.c_str(), cell.size() + 1);
+        column.Buffer += cell;
+        column.Buffer += i + 1 < count ? "\n" : "";
+    }
+
+    for (size_t offset : offsets) {
+        column.Cells.push_back(column.Values.data() + offset);
+    }
+
+    return column;
+}
+
+template <typename Body>
+static void MeasureCells(const char* name, size_t count, Body body)
+{
+    printf("  %-52s %12.1f ns/cell\n", name, SecondsPerCall(body) / count * 1e9);
+}
+
+// 1M cells parsed by ColumnParser, and one String plus TryParse per cell
+// the way DataTable::Load converted them before.
+void ColumnParse()
+{
+    const size_t count = 1000000;
+    TextColumn integers = MakeColumn(count, false);
+    TextColumn doubles = MakeColumn(count, true);
+
+    MeasureCells("ParseInteger", count, [&] {
+        sSink += ColumnParser::ParseInteger(integers.Cells.data(), integers.Lengths.data(), count).Values.size();
+    });
+    MeasureCells("ParseInteger, delimited buffer", count, [&] {
+        sSink += ColumnParser::ParseInteger(integers.Buffer.data(), integers.Buffer.size(), '\n').Values.size();
+    });
+    MeasureCells("String + Integer::TryParse", count, [&] {
+        for (size_t i = 0; i < count; i++) {
+            long long value;
+            sSink += Integer::TryParse(String(integers.Cells[i]), value);
+        }
+    });
+    MeasureCells("ParseDouble", count, [&] {
+        sSink += ColumnParser::ParseDouble(doubles.Cells.data(), doubles.Lengths.data(), count).Values.size();
+    });
+    MeasureCells("ParseDouble, delimited buffer", count, [&] {
+        sSink += ColumnParser::ParseDouble(doubles.Buffer.data(), doubles.Buffer.size(), '\n').Values.size();
+    });
+    MeasureCells("String + Float::TryParse", count, [&] {
+        for (size_t i = 0; i < count; i++) {
+            double value;
+            sSink += Float::TryParse(String(doubles.Cells[i]), value);
+        }
+    });
+}
+
+// Result of a query with text columns only, every cell held as UTF-8 the
+// way PQgetvalue hands it out.
+class TextReader : public IDataReader
+{
+public:
+
+    TextReader(size_t rows, int columns, const string& prefix) :
+        mColumns(columns)
+    {
+        for (size_t i = 0; i < rows; i++) {
+            for (int j = 0; j < columns; j++) {
+                mCells.push_back(prefix + to_string(i) + ", column " + to_string(j));
+            }
+        }
+    }
+
+    virtual int Depth() const NOEXCEPT override { return 1; }
+    virtual int FieldCount() const NOEXCEPT override { return mColumns; }
+    virtual String ColumnName(int i) const NOEXCEPT override { return Integer::ToString(i); }
+    virtual int ColumnNumber(const String&) const NOEXCEPT override { return -1; }
+    virtual DataType Type(int) const NOEXCEPT override { return DataType::Text; }
+    virtual Any Value(int i) const NOEXCEPT override { return Any(Cell(i).c_str()); }
+    virtual bool IsBinary(int) const NOEXCEPT override { return false; }
+    virtual bool IsNull(int) const NOEXCEPT override { return false; }
+
+    virtual const char* RawValue(int i, size_t& length) const NOEXCEPT override
+    {
+        length = Cell(i).size();
+        return Cell(i).c_str();
+    }
+
+    virtual bool NextResult() NOEXCEPT override
+    {
+        return (mCurrent += mColumns) < mCells.size();
+    }
+
+private:
+
+    const string& Cell(int i) const
+    {
+        return mCells[mCurrent + i];
+    }
+
+    vector<string> mCells;
+    size_t mCurrent = 0;
+    int mColumns;
+};
+
+// Committed private bytes of the process.
+static size_t ProcessMemory()
+{
+    PROCESS_MEMORY_COUNTERS counters;
+    GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters));
+    return counters.PagefileUsage;
+}
+
+// Loads a table to warm up the heap, then reports what a second table
+// of the same rows keeps. Both stay in tables, so that the next case does
+// not reuse their memory.
+static void MeasureLoad(const char* name, size_t rows, int columns, const string& prefix, vector<unique_ptr<DataTable>>& tables)
+{
+    for (int i = 0; i < 2; i++) {
+        auto reader = make_shared<TextReader>(rows, columns, prefix);
+        tables.push_back(unique_ptr<DataTable>(new DataTable()));
+        size_t before = ProcessMemory();
+        auto start = chrono::high_resolution_clock::now();
+
+        tables.back()->Load(reader);
+
+        double seconds = ElapsedSeconds(start);
+        size_t bytes = ProcessMemory() - before;
+
+        if (i == 1) {
+            printf("  %-52s %8.1f MB %6.1f B/cell %6.0f ms\n", name, bytes / 1048576.0, (double)bytes / (rows * columns), seconds * 1e3);
+        }
+    }
+}
+
+// Memory of the table DataTable::Load builds from 100k rows of 8 text
+// columns. Cells of about 40 characters that fit Latin-1 are stored with
+// one byte per character; with a euro sign in place of the sharp s they
+// are stored as UTF-16.
+void DataTableLoad()
+{
+    vector<unique_ptr<DataTable>> tables;
+
+    MeasureLoad("Latin-1 text, 100k rows x 8 columns", 100000, 8, "Stra\xC3\x9F" "e, K\xC3\xA4rntner Ring, row ", tables);
+    MeasureLoad("non-Latin-1 text, 100k rows x 8 columns", 100000, 8, "Stra\xE2\x82\xAC" "e, K\xC3\xA4rntner Ring, row ", tables);
+}
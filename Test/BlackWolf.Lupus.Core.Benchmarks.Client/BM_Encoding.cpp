@@ -0,0 +1,95 @@
+#include "Benchmark.h"
+#include <string>
+#include <vector>
+#include <BlackWolf.Lupus.Core/Encoding.h>
+#include <BlackWolf.Lupus.Core/String.h>
+#include <BlackWolf.Lupus.Core/StringBuilder.h>
+#include <unicode/ucnv.h>
+
+using namespace std;
+using namespace Lupus;
+using namespace Lupus::Text;
+
+// The conversions of one HTTP request: 100 bytes of UTF-8 body decoded
+// and a 130-character header encoded as ASCII, through the shared
+// Encoding instances and with a converter opened per call, the way every
+// Encoding factory call worked before.
+void EncodingRequest()
+{
+    string body(100, 'b');
+    vector<uint8_t> bytes(body.begin(), body.end());
+    String header(string(130, 'h').c_str());
+    vector<UChar> chars(header.Length(), (UChar)'h');
+    vector<UChar> buffer(bytes.size() + 1);
+    vector<char> encoded(chars.size() + 1);
+
+    Measure("Encoding::UTF8/ASCII, per request", [&] {
+        sSink += Encoding::UTF8()->GetString(bytes).Length();
+        sSink += Encoding::ASCII()->GetBytes(header).size();
+    });
+    Measure("ucnv_open per conversion, per request", [&] {
+        UErrorCode error = U_ZERO_ERROR;
+        UConverter* utf8 = ucnv_open("UTF-8", &error);
+        sSink += ucnv_toUChars(utf8, buffer.data(), (int32_t)buffer.size(), (const char*)bytes.data(), (int32_t)bytes.size(), &error);
+        ucnv_close(utf8);
+
+        UConverter* ascii = ucnv_open("US-ASCII", &error);
+        sSink += ucnv_fromUChars(ascii, encoded.data(), (int32_t)encoded.size(), chars.data(), (int32_t)chars.size(), &error);
+        ucnv_close(ascii);
+    });
+    Measure("Encoding::GetEncoding(\"iso-8859-1\")", [&] { sSink += Encoding::GetEncoding("iso-8859-1") != nullptr; });
+    Measure("ucnv_open/ucnv_close(\"iso-8859-1\")", [&] {
+        UErrorCode error = U_ZERO_ERROR;
+        UConverter* converter = ucnv_open("iso-8859-1", &error);
+        sSink += converter != nullptr;
+        ucnv_close(converter);
+    });
+}
+
+static void MeasureCharset(const char* charset, const char* label, const String& text)
+{
+    auto encoding = Encoding::GetEncoding(charset);
+    vector<uint8_t> bytes = encoding->GetBytes(text);
+    UErrorCode error = U_ZERO_ERROR;
+    UConverter* converter = ucnv_open(charset, &error);
+    vector<UChar> chars(text.Length() + 1);
+    vector<char> encoded(bytes.size() + 1);
+    int32_t length = ucnv_toUChars(converter, chars.data(), (int32_t)chars.size(), (const char*)bytes.data(), (int32_t)bytes.size(), &error);
+
+    Throughput(string(label) + ", GetString", bytes.size(), [&] { sSink += encoding->GetString(bytes).Length(); });
+    Throughput(string(label) + ", ucnv_toUChars", bytes.size(), [&] {
+        UErrorCode error = U_ZERO_ERROR;
+        sSink += ucnv_toUChars(converter, chars.data(), (int32_t)chars.size(), (const char*)bytes.data(), (int32_t)bytes.size(), &error);
+    });
+    Throughput(string(label) + ", GetBytes", bytes.size(), [&] { sSink += encoding->GetBytes(text).size(); });
+    Throughput(string(label) + ", ucnv_fromUChars", bytes.size(), [&] {
+        UErrorCode error = U_ZERO_ERROR;
+        sSink += ucnv_fromUChars(converter, encoded.data(), (int32_t)encoded.size(), chars.data(), length, &error);
+    });
+
+    ucnv_close(converter);
+}
+
+// 1Mi characters decoded and encoded by the built-in transcoders and by
+// an open ICU converter, which every charset went through before. Rates
+// are bytes of encoded text per second.
+void EncodingTranscode()
+{
+    const size_t length = 1 << 20;
+    String ascii(string(length, 'a').c_str());
+    StringBuilder latin1, cyrillic, cjk;
+
+    for (size_t i = 0; i < length; i++) {
+        latin1.Append((Char)(0x41 + i % 0xBE));
+        cyrillic.Append((Char)(i % 4 ? 0x430 + i % 32 : ' '));
+        cjk.Append((Char)(0x4E00 + i % 0x5000));
+    }
+
+    MeasureCharset("US-ASCII", "ASCII", ascii);
+    MeasureCharset("ISO-8859-1", "Latin-1", latin1.ToString());
+    MeasureCharset("UTF-8", "UTF-8 ASCII", ascii);
+    MeasureCharset("UTF-8", "UTF-8 Cyrillic", cyrillic.ToString());
+    MeasureCharset("UTF-8", "UTF-8 CJK", cjk.ToString());
+    MeasureCharset("UTF-16LE", "UTF-16LE", cjk.ToString());
+    MeasureCharset("UTF-16BE", "UTF-16BE", cjk.ToString());
+}
@@ -0,0 +1,260 @@
+#include "Benchmark.h"
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <BlackWolf.Lupus.Core/Decimal.h>
+#include <BlackWolf.Lupus.Core/Float.h>
+#include <BlackWolf.Lupus.Core/Integer.h>
+#include <BlackWolf.Lupus.Core/String.h>
+
+#ifdef _MSC_VER
+#define snprintf sprintf_s
+#define sscanf sscanf_s
+#endif
+
+using namespace std;
+using namespace Lupus;
+
+// 1000 integers of every length formatted by Integer, and through
+// snprintf into a String the way Integer::ToString did before.
+void IntegerFormat()
+{
+    vector<long long> values;
+    long long value = 7;
+
+    for (int i = 0; i < 1000; i++) {
+        values.push_back(i % 2 ? value : -value);
+        value = value * 10 + 3 < 100000000000000000LL ? value * 10 + 3 : 7;
+    }
+
+    Measure("ToString, decimal, 1000 values", [&] {
+        for (long long value : values) {
+            sSink += Integer::ToString(value).Length();
+        }
+    });
+    Measure("snprintf %lld + String, 1000 values", [&] {
+        for (long long value : values) {
+            char buffer[32];
+            snprintf(buffer, sizeof(buffer), "%lld", value);
+            sSink += String(buffer).Length();
+        }
+    });
+    Measure("ToString, hexadecimal, 1000 values", [&] {
+        for (long long value : values) {
+            sSink += Integer::ToString(value, IntegerBase::Hexadecimal).Length();
+        }
+    });
+    Measure("snprintf %#llx + String, 1000 values", [&] {
+        for (long long value : values) {
+            char buffer[32];
+            snprintf(buffer, sizeof(buffer), "%#llx", value);
+            sSink += String(buffer).Length();
+        }
+    });
+    Measure("FormatTo(Char*), decimal, 1000 values", [&] {
+        for (long long value : values) {
+            Char buffer[Integer::MaxLength + 1];
+            sSink += Integer::FormatTo(value, buffer);
+        }
+    });
+    Measure("snprintf %lld, 1000 values", [&] {
+        for (long long value : values) {
+            char buffer[32];
+            sSink += snprintf(buffer, sizeof(buffer), "%lld", value);
+        }
+    });
+}
+
+static vector<String> Digits(size_t count, size_t maxDigits)
+{
+    vector<String> strings;
+    string digits;
+
+    for (size_t i = 0; i < count; i++) {
+        digits.push_back((char)('1' + i % 9));
+
+        if (digits.size() > maxDigits) {
+            digits = "-4";
+        }
+
+        strings.push_back(String(digits.c_str()));
+    }
+
+    return strings;
+}
+
+// 1000 numbers of up to 4 and of up to 18 digits parsed by
+// TryParse, and with sscanf over a UTF-8 copy the way TryParse did
+// before. FromChars on the raw bytes shows the cost without a String.
+void IntegerParse()
+{
+    vector<String> shortNumbers = Digits(1000, 4);
+    vector<String> longNumbers = Digits(1000, 18);
+    vector<string> longBytes;
+
+    for (const String& str : longNumbers) {
+        longBytes.push_back(str.ToUTF8());
+    }
+
+    Measure("TryParse, up to 4 digits, 1000 values", [&] {
+        for (const String& str : shortNumbers) {
+            long long value;
+            sSink += Integer::TryParse(str, value) ? (size_t)value : 0;
+        }
+    });
+    Measure("sscanf %lld of ToUTF8, up to 4 digits, 1000 values", [&] {
+        for (const String& str : shortNumbers) {
+            long long value;
+            sSink += sscanf(str.ToUTF8().c_str(), "%lld", &value) == 1 ? (size_t)value : 0;
+        }
+    });
+    Measure("TryParse, up to 18 digits, 1000 values", [&] {
+        for (const String& str : longNumbers) {
+            long long value;
+            sSink += Integer::TryParse(str, value) ? (size_t)value : 0;
+        }
+    });
+    Measure("sscanf %lld of ToUTF8, up to 18 digits, 1000 values", [&] {
+        for (const String& str : longNumbers) {
+            long long value;
+            sSink += sscanf(str.ToUTF8().c_str(), "%lld", &value) == 1 ? (size_t)value : 0;
+        }
+    });
+    Measure("FromChars(char*), up to 18 digits, 1000 values", [&] {
+        for (const string& str : longBytes) {
+            long long value;
+            sSink += Integer::FromChars(str.data(), str.data() + str.size(), value) ? (size_t)value : 0;
+        }
+    });
+}
+
+// 1000 values of the form x.yyy formatted and parsed by Float, and with
+// snprintf and sscanf the way Float did before. The shortest round trip
+// form of Float differs from the fixed six decimals of "%lf".
+void FloatConvert()
+{
+    vector<double> values;
+    vector<String> strings;
+
+    for (int i = 0; i < 1000; i++) {
+        values.push_back(i / 7 + (i % 1000) / 1000.0);
+        strings.push_back(Float::ToString(values.back()));
+    }
+
+    Measure("ToString, 1000 values", [&] {
+        for (double value : values) {
+            sSink += Float::ToString(value).Length();
+        }
+    });
+    Measure("snprintf %lf + String, 1000 values", [&] {
+        for (double value : values) {
+            char buffer[32];
+            snprintf(buffer, sizeof(buffer), "%lf", value);
+            sSink += String(buffer).Length();
+        }
+    });
+    Measure("TryParse, 1000 values", [&] {
+        for (const String& str : strings) {
+            double value;
+            sSink += Float::TryParse(str, value) ? (size_t)value : 0;
+        }
+    });
+    Measure("sscanf %lf of ToUTF8, 1000 values", [&] {
+        for (const String& str : strings) {
+            double value;
+            sSink += sscanf(str.ToUTF8().c_str(), "%lf", &value) == 1 ? (size_t)value : 0;
+        }
+    });
+}
+
+// Binary NUMERIC of integer.fraction with two decimals: groups of four
+// digits, most significant first, behind a big-endian header.
+static vector<uint8_t> Numeric(int integer, int fraction)
+{
+    vector<uint16_t> words;
+
+    if (integer >= 10000) {
+        words.push_back(0);
+        words.push_back(1);
+        words.push_back((uint16_t)(integer / 10000));
+    } else {
+        words.push_back(0);
+        words.push_back(0);
+    }
+
+    words.push_back(0);
+    words.push_back(2);
+    words.push_back((uint16_t)(integer % 10000));
+    words.push_back((uint16_t)(fraction * 100));
+    words[0] = (uint16_t)(words.size() - 4);
+
+    vector<uint8_t> buffer;
+
+    for (uint16_t word : words) {
+        buffer.push_back((uint8_t)(word >> 8));
+        buffer.push_back((uint8_t)word);
+    }
+
+    return buffer;
+}
+
+// 1000 amounts like "123456.78" read, summed, multiplied and written by
+// Decimal, against String + Float::TryParse, which callers used before.
+// FromNumeric reads the same amounts in binary NUMERIC format.
+void DecimalArithmetic()
+{
+    vector<string> amounts;
+    vector<vector<uint8_t>> numerics;
+    vector<Decimal> values;
+
+    for (int i = 0; i < 1000; i++) {
+        amounts.push_back(to_string(i * 7919 % 1000000) + "." + to_string(10 + i % 90));
+        numerics.push_back(Numeric(i * 7919 % 1000000, 10 + i % 90));
+        values.push_back(Decimal::Parse(amounts.back().c_str()));
+    }
+
+    Decimal rate(119, 2);
+
+    Measure("String + Float::TryParse, 1000 values", [&] {
+        for (const string& amount : amounts) {
+            double value;
+            sSink += Float::TryParse(String(amount.c_str()), value);
+        }
+    });
+    Measure("Decimal::FromChars, 1000 values", [&] {
+        for (const string& amount : amounts) {
+            Decimal value;
+            sSink += Decimal::FromChars(amount.data(), amount.data() + amount.size(), value);
+        }
+    });
+    Measure("Decimal::FromNumeric, 1000 values", [&] {
+        for (const vector<uint8_t>& numeric : numerics) {
+            Decimal value;
+            sSink += Decimal::FromNumeric(numeric.data(), numeric.size(), value);
+        }
+    });
+    Measure("sum, 1000 values", [&] {
+        Decimal sum;
+
+        for (const Decimal& value : values) {
+            sum += value;
+        }
+
+        sSink += (size_t)sum.Low();
+    });
+    Measure("multiply and add, 1000 values", [&] {
+        Decimal sum;
+
+        for (const Decimal& value : values) {
+            sum += value * rate;
+        }
+
+        sSink += (size_t)sum.Low();
+    });
+    Measure("FormatTo(Char*), 1000 values", [&] {
+        for (const Decimal& value : values) {
+            Char buffer[Decimal::MaxLength + 1];
+            sSink += value.FormatTo(buffer);
+        }
+    });
+}
@@ -0,0 +1,236 @@
+#include "Benchmark.h"
+#include <algorithm>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include <BlackWolf.Lupus.Core/Integer.h>
+#include <BlackWolf.Lupus.Core/String.h>
+#include <BlackWolf.Lupus.Core/StringBuilder.h>
+#include <unicode/unistr.h>
+
+using namespace std;
+using namespace Lupus;
+using namespace Lupus::Text;
+
+// Inline and single-block storage against ICU's UnicodeString, which
+// backed String before.
+void StringStorage()
+{
+    String host("Host");
+    String url("http://www.example.org/index.html");
+    String accept("text/html,application/xhtml+xml,application/xml;q=0.9,*/*;q=0.8");
+    icu::UnicodeString icuHost = icu::UnicodeString::fromUTF8("Host");
+    icu::UnicodeString icuUrl = icu::UnicodeString::fromUTF8("http://www.example.org/index.html");
+    icu::UnicodeString icuAccept = icu::UnicodeString::fromUTF8("text/html,application/xhtml+xml,application/xml;q=0.9,*/*;q=0.8");
+
+    Measure("String(\"Host\")", [&] { String str("Host"); sSink += str.Length(); });
+    Measure("UnicodeString::fromUTF8(\"Host\")", [&] { sSink += icu::UnicodeString::fromUTF8("Host").length(); });
+    Measure("String::Substring(0, 11)", [&] { sSink += url.Substring(0, 11).Length(); });
+    Measure("UnicodeString(str, 0, 11)", [&] { sSink += icu::UnicodeString(icuUrl, 0, 11).length(); });
+    Measure("String short + short", [&] { String str = host + host; sSink += str.Length(); });
+    Measure("UnicodeString short + short", [&] { icu::UnicodeString str = icuHost + icuHost; sSink += str.length(); });
+    Measure("String::Split(',') of an Accept header", [&] { sSink += accept.Split(vector<Char>(1, ',')).size(); });
+    Measure("UnicodeString indexOf/tempSubString split", [&] {
+        vector<icu::UnicodeString> parts;
+        int32_t start = 0;
+
+        for (int32_t end; (end = icuAccept.indexOf((UChar)',', start)) >= 0; start = end + 1) {
+            parts.push_back(icuAccept.tempSubString(start, end - start));
+        }
+
+        parts.push_back(icuAccept.tempSubString(start));
+        sSink += parts.size();
+    });
+}
+
+// Copies and releases one shared heap string on 1 to n threads. Without
+// contention on the reference count the total rate grows with the threads.
+void StringCopy()
+{
+    const String shared("a shared string that is long enough to live on the heap");
+    const size_t copies = 2000000;
+    size_t maxThreads = max<size_t>(thread::hardware_concurrency(), 1);
+
+    Measure("copy and release", [&] { String copy(shared); sSink += copy.Length(); });
+
+    for (size_t count = 1; count <= maxThreads; count *= 2) {
+        vector<thread> threads;
+        auto start = chrono::high_resolution_clock::now();
+
+        for (size_t t = 0; t < count; t++) {
+            threads.push_back(thread([&] {
+                size_t length = 0;
+
+                for (size_t i = 0; i < copies; i++) {
+                    String copy(shared);
+                    length += copy.Length();
+                }
+
+                sSink += length;
+            }));
+        }
+
+        for (auto& thread : threads) {
+            thread.join();
+        }
+
+        printf("  copies on %2u threads %42.1f M/s\n", (unsigned)count, count * copies / ElapsedSeconds(start) / 1e6);
+    }
+}
+
+// A status line and 20 headers, the way HttpListenerResponse::ToString
+// writes them, appended to a String and to a StringBuilder.
+void StringBuilderAppend()
+{
+    vector<pair<String, String>> headers;
+
+    for (int i = 0; i < 20; i++) {
+        headers.push_back(make_pair(String("X-Header-Name-") + String(Integer::ToString(i)), String("some header value of typical length")));
+    }
+
+    Measure("String +=", [&] {
+        String str("HTTP/1.1 200 OK\r\n");
+
+        for (auto& header : headers) {
+            str += header.first;
+            str += ": ";
+            str += header.second;
+            str += "\r\n";
+        }
+
+        sSink += str.Length();
+    });
+    Measure("StringBuilder::Append", [&] {
+        StringBuilder builder;
+        builder.Append("HTTP/1.1 200 OK\r\n");
+
+        for (auto& header : headers) {
+            builder.Append(header.first).Append(": ").Append(header.second).Append("\r\n");
+        }
+
+        sSink += builder.ToString().Length();
+    });
+}
+
+// How std::hash<String> hashed before: through a UTF-8 copy of the key.
+struct Utf8Hash
+{
+    size_t operator()(const String& str) const
+    {
+        return hash<string>()(str.ToUTF8());
+    }
+};
+
+template <typename Map>
+static void MeasureMap(const char* insert, const char* lookup, const vector<String>& keys)
+{
+    Map lookupMap;
+
+    for (size_t i = 0; i < keys.size(); i++) {
+        lookupMap[keys[i]] = (int)i;
+    }
+
+    Measure(insert, [&] {
+        Map map;
+
+        for (const String& key : keys) {
+            map[key] = 1;
+        }
+
+        sSink += map.size();
+    });
+    Measure(lookup, [&] {
+        for (const String& key : keys) {
+            sSink += lookupMap.find(key)->second;
+        }
+    });
+}
+
+// Maps of 500 header-like keys, hashed over UTF-16 with the cached
+// GetHashCode and over a UTF-8 copy.
+void StringHash()
+{
+    const char* prefixes[] = { "Accept", "Content", "X-Forwarded", "Cache", "If-Modified" };
+    vector<String> keys;
+
+    for (int i = 0; i < 500; i++) {
+        keys.push_back(String((string(prefixes[i % 5]) + "-Header-" + to_string(i)).c_str()));
+    }
+
+    MeasureMap<unordered_map<String, int>>("GetHashCode map, insert 500 keys", "GetHashCode map, look up 500 keys", keys);
+    MeasureMap<unordered_map<String, int, Utf8Hash>>("UTF-8 hash map, insert 500 keys", "UTF-8 hash map, look up 500 keys", keys);
+}
+
+// Column names of a 100k-row load: every row brings its own copies of
+// the same 16 names, which the pool replaces by one shared buffer.
+void StringIntern()
+{
+    vector<String> names;
+
+    for (int i = 0; i < 16; i++) {
+        names.push_back(String(("customer_column_name_" + to_string(i)).c_str()));
+    }
+
+    String copy(names[3].ToUTF8().c_str());
+    StringInternStatistics before = String::InternStatistics();
+    vector<String> rows;
+
+    for (int row = 0; row < 100000; row++) {
+        for (const String& name : names) {
+            rows.push_back(String::Intern(String(name.ToUTF8().c_str())));
+        }
+    }
+
+    StringInternStatistics after = String::InternStatistics();
+
+    Measure("Intern, pooled", [&] { sSink += String::Intern(copy).Length(); });
+    Measure("IsInterned, pooled", [&] { sSink += String::IsInterned(copy).Length(); });
+    Measure("copy of a fresh string", [&] { String str(copy); sSink += str.Length(); });
+    printf("  %-52s %12.1f MB\n", "heap bytes saved over 1.6M names", (after.BytesSaved - before.BytesSaved) / 1e6);
+    printf("  %-52s %12u\n", "pooled strings", (unsigned)after.Count);
+}
+
+// Concatenation chains that fit inline and that need the heap, evaluated
+// lazily in one allocation and step by step through String temporaries,
+// which is how operator+ worked before.
+void StringConcatenation()
+{
+    String version("1.1");
+    String code("200 OK");
+    String host("www.example.org");
+    String port("8080");
+    String path("/search/index.html");
+    String value("lupus+string+concatenation");
+
+    Measure("\"HTTP/\" + version + ... (inline), lazy", [&] {
+        String str = "HTTP/" + version + " " + code + "\r\n";
+        sSink += str.Length();
+    });
+    Measure("\"HTTP/\" + version + ... (inline), temporaries", [&] {
+        String str = String(String(String(String("HTTP/") + version) + String(" ")) + code) + String("\r\n");
+        sSink += str.Length();
+    });
+    Measure("\"http://\" + host + ... (heap), lazy", [&] {
+        String str = "http://" + host + ":" + port + path + "?q=" + value;
+        sSink += str.Length();
+    });
+    Measure("\"http://\" + host + ... (heap), temporaries", [&] {
+        String str = String(String(String(String(String(String("http://") + host) + String(":")) + port) + path) + String("?q=")) + value;
+        sSink += str.Length();
+    });
+}
+
+// A query text that PgCommand hands to libpq on every execution, encoded
+// once and cached with Utf8() and encoded per call with ToUTF8(). The
+// second query carries a character outside Latin-1 and is kept wide.
+void StringUtf8Cache()
+{
+    String query("SELECT id, name, email FROM customers WHERE id = $1 ORDER BY name");
+    String wide = query + String((Char)0x2192);
+
+    Measure("Utf8(), 65-char query", [&] { sSink += strlen(query.Utf8().Data()); });
+    Measure("ToUTF8(), 65-char query", [&] { sSink += strlen(query.ToUTF8().c_str()); });
+    Measure("Utf8(), 66-char query, not Latin-1", [&] { sSink += strlen(wide.Utf8().Data()); });
+    Measure("ToUTF8(), 66-char query, not Latin-1", [&] { sSink += strlen(wide.ToUTF8().c_str()); });
+}
@@ -0,0 +1,330 @@
+#include "Benchmark.h"
+#include <algorithm>
+#include <functional>
+#include <regex>
+#include <string>
+#include <vector>
+#include <BlackWolf.Lupus.Core/Collator.h>
+#include <BlackWolf.Lupus.Core/Format.h>
+#include <BlackWolf.Lupus.Core/Integer.h>
+#include <BlackWolf.Lupus.Core/MultiReplacer.h>
+#include <BlackWolf.Lupus.Core/Regex.h>
+#include <BlackWolf.Lupus.Core/Searcher.h>
+#include <BlackWolf.Lupus.Core/SplitEnumerator.h>
+#include <BlackWolf.Lupus.Core/String.h>
+#include <BlackWolf.Lupus.Core/StringBuilder.h>
+#include <unicode/uchar.h>
+#include <unicode/ustring.h>
+
+using namespace std;
+using namespace Lupus;
+using namespace Lupus::Text;
+
+static string Name(const char* prefix, size_t length)
+{
+    return prefix + to_string(length) + " chars";
+}
+
+// Scans without a match over UTF-16 text (one character outside Latin-1
+// keeps the string wide), over compact Latin-1 text, and through ICU's
+// u_memchr and u_strpbrk, which String used before. Rates are bytes of
+// the string's storage per second.
+void CharSearch()
+{
+    const size_t lengths[] = { 256, 4096 };
+    vector<Char> separators;
+    separators.push_back(',');
+    separators.push_back(';');
+    separators.push_back('=');
+    const UChar icuSeparators[] = { ',', ';', '=', 0 };
+
+    for (size_t length : lengths) {
+        String wide = String((Char)0x100, 1) + String('a', length - 1);
+        String compact('a', length);
+        const UChar* data = (const UChar*)wide.Data();
+
+        Throughput(Name("IndexOf(Char), UTF-16, ", length), 2 * length, [&] { sSink += wide.IndexOf('#'); });
+        Throughput(Name("IndexOf(Char), Latin-1, ", length), length, [&] { sSink += compact.IndexOf('#'); });
+        Throughput(Name("u_memchr, ", length), 2 * length, [&] { sSink += (size_t)u_memchr(data, '#', (int32_t)length); });
+        Throughput(Name("IndexOfAny(3 chars), UTF-16, ", length), 2 * length, [&] { sSink += wide.IndexOfAny(separators); });
+        Throughput(Name("u_strpbrk(3 chars), ", length), 2 * length, [&] { sSink += (size_t)u_strpbrk(data, icuSeparators); });
+    }
+}
+
+// Needles of 4 to 70 characters found at the end of a 2M-character
+// UTF-16 body, with a precompiled Searcher, with String::IndexOf and
+// with ICU's u_strFindFirst, which String used before.
+void SubstringSearch()
+{
+    const size_t lengths[] = { 4, 16, 32, 48, 70 };
+    const size_t bodyLength = 2000000;
+    const char* words = "lorem ipsum dolor sit amet, consectetur adipiscing elit; ";
+    const char* filler = "abcdefghijklmnopqrstuvwxyz0123456789abcdefghijklmnopqrstuvwxyz0123456789";
+    StringBuilder builder;
+
+    builder.Append((Char)0x100);
+
+    while (builder.Length() < bodyLength) {
+        builder.Append(words);
+    }
+
+    String text = builder.ToString();
+
+    for (size_t length : lengths) {
+        String needle(("Z" + string(filler, length - 2) + "Q").c_str());
+        String body = text + needle;
+        Searcher searcher(needle);
+        StringView view(body);
+        const UChar* data = (const UChar*)view.Data();
+        const UChar* pattern = (const UChar*)needle.Data();
+        size_t bytes = 2 * body.Length();
+
+        Throughput(Name("Searcher::IndexOf, ", length), bytes, [&] { sSink += searcher.IndexOf(view); });
+        Throughput(Name("String::IndexOf(String), ", length), bytes, [&] { sSink += body.IndexOf(needle); });
+        Throughput(Name("u_strFindFirst, ", length), bytes, [&] {
+            sSink += (size_t)u_strFindFirst(data, (int32_t)body.Length(), pattern, (int32_t)needle.Length());
+        });
+    }
+}
+
+// A request header cut into lines and its Cookie line into pairs, once
+// with String::Split and once with SplitEnumerator, which hands out
+// views instead of a vector of Strings.
+void SplitHeader()
+{
+    String header(
+        "GET /index.html?id=42&lang=en&page=3 HTTP/1.1\r\n"
+        "Host: www.example.org\r\n"
+        "User-Agent: Mozilla/5.0 (Windows NT 6.1; WOW64; rv:31.0) Gecko/20100101 Firefox/31.0\r\n"
+        "Accept: text/html,application/xhtml+xml,application/xml;q=0.9,*/*;q=0.8\r\n"
+        "Accept-Language: de-DE,de;q=0.8,en-US;q=0.5,en;q=0.3\r\n"
+        "Accept-Encoding: gzip, deflate\r\n"
+        "Cookie: session=0123456789abcdef; theme=dark; lang=en; tracking=off; cart=17\r\n"
+        "Connection: keep-alive\r\n");
+    String cookie("session=0123456789abcdef; theme=dark; lang=en; tracking=off; cart=17");
+
+    Measure("String::Split, header lines", [&] {
+        sSink += header.Split("\r\n", StringSplitOption::RemoveEmptyEntries).size();
+    });
+    Measure("SplitEnumerator, header lines", [&] {
+        for (const StringView& line : SplitEnumerator(header, "\r\n", StringSplitOption::RemoveEmptyEntries)) {
+            sSink += line.Length();
+        }
+    });
+    Measure("String::Split, cookie pairs", [&] {
+        for (const String& pair : cookie.Split(";")) {
+            sSink += pair.Split("=").size();
+        }
+    });
+    Measure("SplitEnumerator, cookie pairs", [&] {
+        for (const StringView& pair : SplitEnumerator(cookie, ';')) {
+            sSink += pair.IndexOf('=');
+        }
+    });
+}
+
+// ASCII text of 12 to 1024 characters mapped to lower case and compared
+// case insensitively with a copy that differs only in case, against
+// ICU's u_strToLower and u_strCaseCompare, which String used before.
+void CaseMapping()
+{
+    const size_t lengths[] = { 12, 64, 1024 };
+    const char* words = "Content-Type Application/JSON; Charset=UTF-8 ";
+
+    for (size_t length : lengths) {
+        string text;
+
+        while (text.size() < length) {
+            text += words;
+        }
+
+        text.resize(length);
+
+        String mixed(text.c_str());
+        String upper = mixed.ToUpper();
+        vector<UChar> data(length), upperData(length), buffer(length);
+
+        for (size_t i = 0; i < length; i++) {
+            data[i] = (UChar)text[i];
+            upperData[i] = (UChar)u_toupper(text[i]);
+        }
+
+        Measure(Name("String::ToLower, ", length), [&] { sSink += mixed.ToLower().Length(); });
+        Measure(Name("u_strToLower, ", length), [&] {
+            UErrorCode error = U_ZERO_ERROR;
+            sSink += u_strToLower(buffer.data(), (int32_t)length, data.data(), (int32_t)length, "", &error);
+        });
+        Measure(Name("String::Compare(CaseInsensitive), ", length), [&] {
+            sSink += mixed.Compare(upper, StringCaseSensitivity::CaseInsensitive);
+        });
+        Measure(Name("u_strCaseCompare, ", length), [&] {
+            UErrorCode error = U_ZERO_ERROR;
+            sSink += u_strCaseCompare(data.data(), (int32_t)length, upperData.data(), (int32_t)length, U_FOLD_CASE_DEFAULT, &error);
+        });
+    }
+}
+
+// "host:port (n bytes)" with one String and two integers, built with a
+// + chain of temporaries as before and with the Format variants.
+void FormatEndpoint()
+{
+    String host("www.example.org");
+    int port = 8080;
+    int bytes = 1432;
+    FormatString parsed("{0}:{1} ({2} bytes)");
+    StringBuilder builder;
+
+    Measure("+ chain with Integer::ToString", [&] {
+        String str = host + ":" + String(Integer::ToString(port)) + " (" + String(Integer::ToString(bytes)) + " bytes)";
+        sSink += str.Length();
+    });
+    Measure("String::Format(const char*)", [&] { sSink += String::Format("{0}:{1} ({2} bytes)", host, port, bytes).Length(); });
+    Measure("String::Format(FormatString)", [&] { sSink += String::Format(parsed, host, port, bytes).Length(); });
+    Measure("String::FormatTo, reused StringBuilder", [&] {
+        builder.Clear();
+        sSink += String::FormatTo(builder, parsed, host, port, bytes).Length();
+    });
+}
+
+static String ReplaceChained(const String& str, const vector<pair<String, String>>& pairs)
+{
+    String result(str);
+
+    for (auto& pair : pairs) {
+        result = result.Replace(pair.first, pair.second);
+    }
+
+    return result;
+}
+
+// A 1M-character UTF-16 body rewritten by one MultiReplacer pass and by
+// one String::Replace call per pair, as callers did before: HTML escaping
+// with about 100k matches, the same pairs without a match, and a template
+// with 200 placeholders. Rates are bytes of input per second.
+void MultiReplace()
+{
+    const size_t length = 1000000;
+    vector<pair<String, String>> escapes;
+    vector<pair<String, String>> keys;
+    StringBuilder html, plain, document;
+
+    escapes.push_back(make_pair(String("&"), String("&amp;")));
+    escapes.push_back(make_pair(String("<"), String("&lt;")));
+    escapes.push_back(make_pair(String(">"), String("&gt;")));
+    escapes.push_back(make_pair(String("\""), String("&quot;")));
+    escapes.push_back(make_pair(String("'"), String("&#39;")));
+
+    for (int i = 0; i < 200; i++) {
+        keys.push_back(make_pair(String(("{{key" + to_string(i) + "}}").c_str()), String(("value " + to_string(i)).c_str())));
+    }
+
+    html.Append((Char)0x100);
+    plain.Append((Char)0x100);
+    document.Append((Char)0x100);
+
+    for (int i = 0; html.Length() < length; i++) {
+        html.Append("<b>Tom</b> & Jerry walked to the market on Sunday. ");
+        plain.Append("Tom and Jerry walked to the market on Sunday. ");
+        document.Append("Dear ").Append(keys[i % 200].first).Append(", your order is ready. ");
+    }
+
+    String htmlText = html.ToString();
+    String plainText = plain.ToString();
+    String documentText = document.ToString();
+    MultiReplacer escaper(escapes);
+    MultiReplacer expander(keys);
+
+    Throughput("HTML escape, 5 pairs, chained Replace", 2 * htmlText.Length(), [&] { sSink += ReplaceChained(htmlText, escapes).Length(); });
+    Throughput("HTML escape, 5 pairs, MultiReplacer", 2 * htmlText.Length(), [&] { sSink += escaper.Replace(htmlText).Length(); });
+    Throughput("no match, 5 pairs, chained Replace", 2 * plainText.Length(), [&] { sSink += ReplaceChained(plainText, escapes).Length(); });
+    Throughput("no match, 5 pairs, MultiReplacer", 2 * plainText.Length(), [&] { sSink += escaper.Replace(plainText).Length(); });
+    Throughput("template, 200 keys, chained Replace", 2 * documentText.Length(), [&] { sSink += ReplaceChained(documentText, keys).Length(); });
+    Throughput("template, 200 keys, MultiReplacer", 2 * documentText.Length(), [&] { sSink += expander.Replace(documentText).Length(); });
+}
+
+// 100k ASCII characters with an address every few words, searched with
+// (\w+)@(\w+)\.com by Regex and by std::wregex, which callers would
+// otherwise use. The IsMatch case passes the pattern as a string on every
+// call, so it measures the pattern cache.
+void RegexSearch()
+{
+    const char* pattern = "(\\w+)@(\\w+)\\.com";
+    const wchar_t* widePattern = L"(\\w+)@(\\w+)\\.com";
+    string text;
+
+    for (int i = 0; text.size() < 100000; i++) {
+        text += "some words before user" + to_string(i) + "@example.com and after it; ";
+    }
+
+    String input(text.c_str());
+    wstring wideInput(text.begin(), text.end());
+    String shortInput("contact: someone@example.com");
+    wstring wideShortInput(L"contact: someone@example.com");
+    Regex regex(pattern);
+    wregex wideRegex(widePattern);
+
+    Measure("Regex::Matches, iterate all, 100k chars", [&] {
+        for (const RegexMatch& match : regex.Matches(input)) {
+            sSink += match.Length();
+        }
+    });
+    Measure("wsregex_iterator, iterate all, 100k chars", [&] {
+        for (wsregex_iterator it(wideInput.begin(), wideInput.end(), wideRegex), end; it != end; ++it) {
+            sSink += it->length();
+        }
+    });
+    Measure("Regex::Replace \"$2/$1\", 100k chars", [&] { sSink += regex.Replace(input, "$2/$1").Length(); });
+    Measure("regex_replace \"$2/$1\", 100k chars", [&] { sSink += regex_replace(wideInput, wideRegex, L"$2/$1").size(); });
+    Measure("Regex::IsMatch(input, pattern), short input", [&] { sSink += Regex::IsMatch(shortInput, pattern); });
+    Measure("regex_search(input, wregex(pattern)), short input", [&] {
+        sSink += regex_search(wideShortInput, wregex(widePattern));
+    });
+}
+
+static void MeasureSort(const char* name, const vector<String>& names, function<void(vector<String>&)> sort)
+{
+    double seconds = SecondsPerCall([&] {
+        vector<String> copy(names);
+        sort(copy);
+        sSink += copy.front().Length();
+    });
+
+    printf("  %-52s %12.1f ms\n", name, seconds * 1e3);
+}
+
+// 200k file names sorted by std::sort with a comparison per pair, as
+// callers did before, and by Collator::Sort, which compares precomputed
+// keys. Both include copying the unsorted names.
+void CollatorSort()
+{
+    const char* words[] = { "Report", "invoice", "Photo", "backup", "Draft", "scan", "\xC3\x9C" "bersicht", "notes" };
+    const char* extensions[] = { ".pdf", ".JPG", ".docx", ".txt" };
+    vector<String> names;
+    uint32_t seed = 12345;
+
+    for (int i = 0; i < 200000; i++) {
+        seed = seed * 1103515245 + 12345;
+        names.push_back(String((string(words[seed >> 8 & 7]) + "_" + to_string(seed >> 12 & 0xFFFF) + extensions[seed >> 28 & 3]).c_str()));
+    }
+
+    Collator collator("en");
+
+    MeasureSort("case sensitive, std::sort + Compare", names, [](vector<String>& v) {
+        std::sort(v.begin(), v.end(), [](const String& lhs, const String& rhs) { return lhs.Compare(rhs) < 0; });
+    });
+    MeasureSort("case sensitive, Collator::Sort", names, [](vector<String>& v) {
+        Collator::Sort(v, StringCaseSensitivity::CaseSensitive);
+    });
+    MeasureSort("case insensitive, std::sort + Compare", names, [](vector<String>& v) {
+        std::sort(v.begin(), v.end(), [](const String& lhs, const String& rhs) {
+            return lhs.Compare(rhs, StringCaseSensitivity::CaseInsensitive) < 0;
+        });
+    });
+    MeasureSort("case insensitive, Collator::Sort", names, [](vector<String>& v) {
+        Collator::Sort(v, StringCaseSensitivity::CaseInsensitive);
+    });
+    MeasureSort("collator \"en\", std::sort + Compare", names, [&](vector<String>& v) {
+        std::sort(v.begin(), v.end(), [&](const String& lhs, const String& rhs) { return collator.Compare(lhs, rhs) < 0; });
+    });
+    MeasureSort("collator \"en\", Sort", names, [&](vector<String>& v) { collator.Sort(v); });
+}
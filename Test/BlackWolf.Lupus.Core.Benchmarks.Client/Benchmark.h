@@ -0,0 +1,74 @@
+#pragma once
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+
+// Results are added here so that the optimizer keeps the measured work.
+static volatile size_t sSink = 0;
+
+inline double ElapsedSeconds(std::chrono::high_resolution_clock::time_point start)
+{
+    return std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+}
+
+// Runs body in batches of doubling size until one batch takes a quarter
+// of a second, so that coarse system clocks still give stable numbers,
+// and returns the seconds per call of that batch.
+template <typename Body>
+double SecondsPerCall(Body body)
+{
+    body();
+
+    for (size_t iterations = 1;; iterations *= 2) {
+        auto start = std::chrono::high_resolution_clock::now();
+
+        for (size_t i = 0; i < iterations; i++) {
+            body();
+        }
+
+        double elapsed = ElapsedSeconds(start);
+
+        if (elapsed >= 0.25) {
+            return elapsed / iterations;
+        }
+    }
+}
+
+// Prints the time per call of body.
+template <typename Body>
+void Measure(const std::string& name, Body body)
+{
+    printf("  %-52s %12.1f ns\n", name.c_str(), SecondsPerCall(body) * 1e9);
+}
+
+// Prints the rate of body, which processes bytes bytes per call.
+template <typename Body>
+void Throughput(const std::string& name, size_t bytes, Body body)
+{
+    printf("  %-52s %12.2f GB/s\n", name.c_str(), bytes / SecondsPerCall(body) / 1e9);
+}
+
+void StringStorage();
+void StringCopy();
+void StringBuilderAppend();
+void StringHash();
+void StringIntern();
+void StringConcatenation();
+void StringUtf8Cache();
+void CharSearch();
+void SubstringSearch();
+void SplitHeader();
+void CaseMapping();
+void FormatEndpoint();
+void MultiReplace();
+void RegexSearch();
+void CollatorSort();
+void IntegerFormat();
+void IntegerParse();
+void FloatConvert();
+void DecimalArithmetic();
+void ColumnParse();
+void DataTableLoad();
+void EncodingRequest();
+void EncodingTranscode();
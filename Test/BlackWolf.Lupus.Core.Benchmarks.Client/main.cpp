@@ -0,0 +1,56 @@
+#include <cstdlib>
+#include <cwchar>
+#include "Benchmark.h"
+
+using namespace std;
+
+// Each request that claims a speed-up keeps its measurement here, named
+// after the feature it measures.
+static const struct {
+    const wchar_t* name;
+    void (*run)();
+} sBenchmarks[] = {
+    { L"StringStorage", StringStorage },
+    { L"StringCopy", StringCopy },
+    { L"StringBuilderAppend", StringBuilderAppend },
+    { L"StringHash", StringHash },
+    { L"StringIntern", StringIntern },
+    { L"StringConcatenation", StringConcatenation },
+    { L"StringUtf8Cache", StringUtf8Cache },
+    { L"CharSearch", CharSearch },
+    { L"SubstringSearch", SubstringSearch },
+    { L"SplitHeader", SplitHeader },
+    { L"CaseMapping", CaseMapping },
+    { L"FormatEndpoint", FormatEndpoint },
+    { L"MultiReplace", MultiReplace },
+    { L"RegexSearch", RegexSearch },
+    { L"CollatorSort", CollatorSort },
+    { L"IntegerFormat", IntegerFormat },
+    { L"IntegerParse", IntegerParse },
+    { L"FloatConvert", FloatConvert },
+    { L"DecimalArithmetic", DecimalArithmetic },
+    { L"ColumnParse", ColumnParse },
+    { L"DataTableLoad", DataTableLoad },
+    { L"EncodingRequest", EncodingRequest },
+    { L"EncodingTranscode", EncodingTranscode },
+};
+
+// Runs every benchmark whose name contains one of the arguments, or all
+// of them without arguments.
+int wmain(int argc, wchar_t** argv)
+{
+    for (auto& benchmark : sBenchmarks) {
+        bool selected = argc < 2;
+
+        for (int i = 1; i < argc && !selected; i++) {
+            selected = wcsstr(benchmark.name, argv[i]) != nullptr;
+        }
+
+        if (selected) {
+            printf("%ls\n", benchmark.name);
+            benchmark.run();
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
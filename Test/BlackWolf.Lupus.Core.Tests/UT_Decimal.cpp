@@ -0,0 +1,234 @@
+#include "stdafx.h"
+#include <BlackWolf.Lupus.Core/Decimal.h>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace std;
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace Lupus;
+
+namespace UnitTests
+{
+    static string Text(const Decimal& value)
+    {
+        uint8_t buffer[Decimal::MaxLength];
+        return string((const char*)buffer, value.FormatTo(buffer));
+    }
+
+    static long long Power(unsigned exponent)
+    {
+        long long result = 1;
+
+        while (exponent--) {
+            result *= 10;
+        }
+
+        return result;
+    }
+
+    // Coefficients below 10^9 with up to nine digits after the point, so
+    // that sums and products stay exact in 64 bits.
+    static Decimal Small(mt19937_64& random, long long& coefficient, unsigned& scale)
+    {
+        coefficient = (long long)(random() % Power(1 + random() % 9));
+        coefficient = random() % 2 ? -coefficient : coefficient;
+        scale = random() % 10;
+        return Decimal(coefficient, scale);
+    }
+
+    // Up to 38 digits with any scale.
+    static Decimal Large(mt19937_64& random)
+    {
+        string digits;
+
+        for (size_t i = 0, length = 1 + random() % 38; i < length; i++) {
+            digits.push_back((char)('0' + random() % 10));
+        }
+
+        unsigned scale = random() % (digits.size() + 1);
+        digits.insert(digits.size() - scale, ".");
+
+        if (random() % 2) {
+            digits.insert(0, "-");
+        }
+
+        Decimal result;
+        Assert::AreEqual(digits.size(), Decimal::FromChars(digits.data(), digits.data() + digits.size(), result));
+        return result;
+    }
+
+    // Binary NUMERIC as PostgreSQL sends it: digit count, weight, sign and
+    // display scale, then the base 10000 digits, all big-endian.
+    static vector<uint8_t> Numeric(int weight, uint16_t sign, uint16_t scale, const vector<uint16_t>& groups)
+    {
+        vector<uint8_t> buffer;
+        uint16_t header[] = { (uint16_t)groups.size(), (uint16_t)weight, sign, scale };
+
+        for (uint16_t word : header) {
+            buffer.push_back((uint8_t)(word >> 8));
+            buffer.push_back((uint8_t)word);
+        }
+
+        for (uint16_t group : groups) {
+            buffer.push_back((uint8_t)(group >> 8));
+            buffer.push_back((uint8_t)group);
+        }
+
+        return buffer;
+    }
+
+    static string FromNumeric(const vector<uint8_t>& buffer)
+    {
+        Decimal result;
+
+        if (!Decimal::FromNumeric(buffer.data(), buffer.size(), result)) {
+            return "(none)";
+        }
+
+        return Text(result);
+    }
+
+    TEST_CLASS(DecimalTests)
+    {
+    public:
+
+        TEST_METHOD(ArithmeticMatchesIntegers)
+        {
+            mt19937_64 random(11);
+
+            for (int iteration = 0; iteration < 100000; iteration++) {
+                long long lhs, rhs;
+                unsigned lhsScale, rhsScale;
+                Decimal a = Small(random, lhs, lhsScale);
+                Decimal b = Small(random, rhs, rhsScale);
+                unsigned scale = max(lhsScale, rhsScale);
+                long long lhsAligned = lhs * Power(scale - lhsScale);
+                long long rhsAligned = rhs * Power(scale - rhsScale);
+
+                Assert::AreEqual(Text(Decimal(lhsAligned + rhsAligned, scale)).c_str(), Text(a + b).c_str(), L"Add");
+                Assert::AreEqual(Text(Decimal(lhsAligned - rhsAligned, scale)).c_str(), Text(a - b).c_str(), L"Subtract");
+                Assert::AreEqual(Text(Decimal(lhs * rhs, lhsScale + rhsScale)).c_str(), Text(a * b).c_str(), L"Multiply");
+                Assert::AreEqual((lhsAligned > rhsAligned) - (lhsAligned < rhsAligned), a.Compare(b), L"Compare");
+
+                if (rhs != 0) {
+                    // An exact quotient comes back as the dividend's factor.
+                    Assert::IsTrue((a * b) / b == a, L"Divide");
+                }
+
+                // Half to even on the integer coefficient.
+                unsigned target = random() % (lhsScale + 1);
+                long long divisor = Power(lhsScale - target);
+                long long quotient = lhs / divisor;
+                long long remainder = llabs(lhs % divisor) * 2;
+
+                if (remainder > divisor || (remainder == divisor && quotient % 2 != 0)) {
+                    quotient += lhs < 0 ? -1 : 1;
+                }
+
+                Assert::AreEqual(Text(Decimal(quotient, target)).c_str(), Text(a.Round(target)).c_str(), L"Round");
+                Assert::AreEqual(strtod(Text(a).c_str(), nullptr), a.ToDouble(), L"ToDouble");
+            }
+        }
+
+        TEST_METHOD(LargeValuesKeepIdentities)
+        {
+            mt19937_64 random(5);
+
+            for (int iteration = 0; iteration < 50000; iteration++) {
+                Decimal a = Large(random);
+                Decimal b = Large(random);
+                string text = Text(a);
+                Decimal parsed;
+
+                Assert::AreEqual(text.size(), Decimal::FromChars(text.data(), text.data() + text.size(), parsed));
+                Assert::AreEqual(text.c_str(), Text(parsed).c_str());
+                Assert::AreEqual(strtod(text.c_str(), nullptr), a.ToDouble(), L"ToDouble");
+                Assert::AreEqual(-a.Compare(b), b.Compare(a));
+
+                try {
+                    Decimal sum = a + b;
+
+                    // Exact as long as the sum kept both scales.
+                    if (sum.Scale() == max(a.Scale(), b.Scale())) {
+                        Assert::IsTrue(sum - b == a, L"Add");
+                    }
+                } catch (overflow_error&) {
+                }
+
+                try {
+                    Decimal product = a * b;
+
+                    if (!b.IsZero() && product.Scale() == a.Scale() + b.Scale()) {
+                        Assert::IsTrue(product / b == a, L"Multiply");
+                    }
+                } catch (overflow_error&) {
+                }
+            }
+        }
+
+        TEST_METHOD(RoundingAndErrors)
+        {
+            Decimal largest = Decimal::Parse(String(string(38, '9').c_str()));
+
+            Assert::AreEqual("0.33333333333333333333333333333333333333", Text(Decimal(1) / Decimal(3)).c_str());
+            Assert::AreEqual("0.66666666666666666666666666666666666667", Text(Decimal(2) / Decimal(3)).c_str());
+            Assert::AreEqual("2", Text(Decimal(25, 1).Round(0)).c_str());
+            Assert::AreEqual("4", Text(Decimal(35, 1).Round(0)).c_str());
+            Assert::AreEqual("-12.50", Text(Decimal(-125, 1).Round(2)).c_str());
+            Assert::IsTrue(Decimal(15, 1) == Decimal(150, 2));
+            Assert::AreEqual("-12.50", Decimal::Parse(String("-12.50")).ToString().ToUTF8().c_str());
+            Assert::AreEqual("1250", Text(Decimal::Parse(String("1.25e3"))).c_str());
+
+            Decimal parsed;
+            Assert::IsTrue(Decimal::TryParse(String("  +12.50xyz"), parsed));
+            Assert::AreEqual("12.50", Text(parsed).c_str());
+            Assert::IsFalse(Decimal::TryParse(String("abc"), parsed));
+
+            Assert::ExpectException<overflow_error>([&] { largest * Decimal(10); });
+            Assert::ExpectException<overflow_error>([&] { largest + largest; });
+            Assert::ExpectException<domain_error>([] { Decimal(1) / Decimal(); });
+            Assert::ExpectException<out_of_range>([] { Decimal(1, Decimal::MaxScale + 1); });
+        }
+
+        TEST_METHOD(NumericDigitGroups)
+        {
+            // 1234.5678 and -1234.5678
+            Assert::AreEqual("1234.5678", FromNumeric(Numeric(0, 0x0000, 4, { 1234, 5678 })).c_str());
+            Assert::AreEqual("-1234.5678", FromNumeric(Numeric(0, 0x4000, 4, { 1234, 5678 })).c_str());
+            // Weight below 0: 0.0012 and -0.00000123 start two groups down.
+            Assert::AreEqual("0.0012", FromNumeric(Numeric(-1, 0x0000, 4, { 12 })).c_str());
+            Assert::AreEqual("-0.00000123", FromNumeric(Numeric(-2, 0x4000, 8, { 123 })).c_str());
+            Assert::AreEqual("-0.00000012", FromNumeric(Numeric(-2, 0x4000, 8, { 12, 3000 })).c_str());
+            // The display scale keeps trailing zeros and rounds half to even.
+            Assert::AreEqual("12.50", FromNumeric(Numeric(0, 0x0000, 2, { 12, 5000 })).c_str());
+            Assert::AreEqual("100000000.000", FromNumeric(Numeric(2, 0x0000, 3, { 1 })).c_str());
+            Assert::AreEqual("12.34", FromNumeric(Numeric(0, 0x0000, 2, { 12, 3450 })).c_str());
+            Assert::AreEqual("12.36", FromNumeric(Numeric(0, 0x0000, 2, { 12, 3550 })).c_str());
+            // Zero has no groups.
+            Assert::AreEqual("0.00", FromNumeric(Numeric(0, 0x0000, 2, {})).c_str());
+            // More than 16 groups, most of them beyond scale 38.
+            vector<uint16_t> many(20, 1111);
+            Assert::AreEqual("0.11111111111111111111111111111111111111", FromNumeric(Numeric(-1, 0x0000, 38, many)).c_str());
+
+            // NaN and the infinities have no Decimal.
+            Assert::AreEqual("(none)", FromNumeric(Numeric(0, 0xC000, 0, {})).c_str());
+            Assert::AreEqual("(none)", FromNumeric(Numeric(0, 0xD000, 0, {})).c_str());
+            Assert::AreEqual("(none)", FromNumeric(Numeric(0, 0xF000, 0, {})).c_str());
+            // Malformed: groups above 9999, a truncated buffer, a short header
+            // and a value beyond 38 digits.
+            Assert::AreEqual("(none)", FromNumeric(Numeric(0, 0x0000, 0, { 10000 })).c_str());
+            vector<uint8_t> truncated = Numeric(0, 0x0000, 0, { 1, 2 });
+            truncated.pop_back();
+            Assert::AreEqual("(none)", FromNumeric(truncated).c_str());
+            Assert::AreEqual("(none)", FromNumeric(vector<uint8_t>(6, 0)).c_str());
+            Assert::AreEqual("(none)", FromNumeric(Numeric(10, 0x0000, 0, { 1 })).c_str());
+
+            uint16_t groups[] = { 1234, 5678 };
+            Decimal result;
+            Assert::IsTrue(Decimal::FromDigitGroups(groups, 2, -1, true, 8, result));
+            Assert::AreEqual("-0.12345678", Text(result).c_str());
+        }
+    };
+}
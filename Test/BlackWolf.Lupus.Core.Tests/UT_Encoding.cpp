@@ -0,0 +1,199 @@
+#include "stdafx.h"
+#include <BlackWolf.Lupus.Core/Encoding.h>
+#include <unicode/ucnv.h>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace Lupus;
+using namespace Lupus::Text;
+
+namespace UnitTests
+{
+    // Encodings converted by the built-in transcoders.
+    static const char* sTranscoded[] = { "US-ASCII", "ISO-8859-1", "UTF-8", "UTF-16LE", "UTF-16BE" };
+
+    static u16string IcuDecode(const char* name, const vector<uint8_t>& bytes)
+    {
+        UErrorCode error = U_ZERO_ERROR;
+        UConverter* converter = ucnv_open(name, &error);
+        u16string result(bytes.size() * 2 + 1, 0);
+        int32_t length = ucnv_toUChars(converter, (UChar*)&result[0], (int32_t)result.size(), (const char*)bytes.data(), (int32_t)bytes.size(), &error);
+
+        ucnv_close(converter);
+        result.resize(length);
+        return result;
+    }
+
+    static vector<uint8_t> IcuEncode(const char* name, const u16string& str)
+    {
+        UErrorCode error = U_ZERO_ERROR;
+        UConverter* converter = ucnv_open(name, &error);
+        vector<char> result(str.size() * 4 + 16);
+        int32_t length = ucnv_fromUChars(converter, result.data(), (int32_t)result.size(), (const UChar*)str.data(), (int32_t)str.size(), &error);
+
+        ucnv_close(converter);
+        return vector<uint8_t>(result.begin(), result.begin() + length);
+    }
+
+    // Mostly ASCII or Latin-1 with some longer sequences, supplementary
+    // characters and lone surrogates, which ICU substitutes.
+    static u16string RandomText(mt19937& random)
+    {
+        size_t length = random() % 4 ? random() % 24 : random() % 200;
+        int mode = random() % 5;
+        u16string result;
+
+        for (size_t i = 0; i < length; i++) {
+            uint32_t value = random();
+
+            switch (mode) {
+                case 0:
+                    result.push_back(1 + value % 0x7F);
+                    break;
+                case 1:
+                    result.push_back(1 + value % 0xFF);
+                    break;
+                case 2:
+                    result.push_back(value % 8 ? 1 + value % 0x7F : 1 + value % 0x7FF);
+                    break;
+                case 3: {
+                    uint32_t ch = value % 4 ? 1 + value % 0x7F : 0x10000 + (value >> 8) % 0x100000;
+                    result.push_back(ch < 0x10000 ? (char16_t)ch : (char16_t)(0xD800 | ((ch - 0x10000) >> 10)));
+
+                    if (ch >= 0x10000) {
+                        result.push_back((char16_t)(0xDC00 | (ch & 0x3FF)));
+                    }
+
+                    break;
+                }
+                default:
+                    result.push_back(value % 3 ? 1 + value % 0x7F : 1 + value % 0xFFFF);
+                    break;
+            }
+        }
+
+        return result;
+    }
+
+    TEST_CLASS(EncodingTests)
+    {
+    public:
+
+        TEST_METHOD(SharedInstances)
+        {
+            Assert::IsTrue(Encoding::UTF8() == Encoding::UTF8());
+            Assert::IsTrue(Encoding::ASCII() == Encoding::ASCII());
+            Assert::IsTrue(Encoding::GetEncoding(String("UTF-8")) == Encoding::UTF8());
+            Assert::IsTrue(Encoding::GetEncoding(String("utf8")) == Encoding::GetEncoding(String("UTF-8")));
+            Assert::IsTrue(Encoding::GetEncoding(String("latin1")) == Encoding::GetEncoding(String("ISO-8859-1")));
+            Assert::IsTrue(Encoding::GetEncoding(String("no such encoding")) == nullptr);
+        }
+
+        TEST_METHOD(TranscodersMatchIcu)
+        {
+            mt19937 random(7);
+
+            for (int iteration = 0; iteration < 20000; iteration++) {
+                u16string text = RandomText(random);
+                String str = String::FromUTF16(text);
+
+                for (const char* name : sTranscoded) {
+                    auto encoding = Encoding::GetEncoding(String(name));
+                    size_t offset = random() % (text.size() + 1);
+                    size_t count = random() % (text.size() - offset + 1);
+
+                    Assert::IsTrue(IcuEncode(name, text.substr(offset, count)) == encoding->GetBytes(str, offset, count), L"GetBytes");
+
+                    // Valid input, corrupted in places or cut off.
+                    vector<uint8_t> bytes = IcuEncode(name, text);
+
+                    if (random() % 3 == 0 && !bytes.empty()) {
+                        bytes[random() % bytes.size()] = (uint8_t)random();
+                    }
+
+                    if (random() % 5 == 0) {
+                        bytes.resize(random() % (bytes.size() + 1));
+                    }
+
+                    Assert::IsTrue(IcuDecode(name, bytes) == encoding->GetString(bytes).ToUTF16(), L"GetString");
+                }
+            }
+        }
+
+        TEST_METHOD(Utf8DecoderMatchesIcu)
+        {
+            // Two-byte sequences mixed with stray continuation bytes, cut
+            // sequences and three-byte sequences, in blocks large enough
+            // for the vectorized path.
+            mt19937 random(9);
+            auto utf8 = Encoding::UTF8();
+
+            for (int iteration = 0; iteration < 50000; iteration++) {
+                vector<uint8_t> bytes;
+                size_t length = 16 + random() % 64;
+
+                while (bytes.size() < length) {
+                    uint32_t kind = random() % 20;
+
+                    if (kind < 6) {
+                        bytes.push_back((uint8_t)(0x20 + random() % 0x5F));
+                    } else if (kind < 16) {
+                        bytes.push_back((uint8_t)(0xC2 + random() % 30));
+                        bytes.push_back((uint8_t)(0x80 + random() % 64));
+                    } else if (kind == 16) {
+                        bytes.push_back((uint8_t)(0x80 + random() % 64));
+                    } else if (kind == 17) {
+                        bytes.push_back((uint8_t)(0xC0 + random() % 32));
+                    } else if (kind == 18) {
+                        bytes.push_back((uint8_t)(0xE0 + random() % 16));
+                        bytes.push_back((uint8_t)(0x80 + random() % 64));
+                        bytes.push_back((uint8_t)(0x80 + random() % 64));
+                    } else {
+                        bytes.push_back((uint8_t)random());
+                    }
+                }
+
+                if (random() % 2) {
+                    bytes.resize(length);
+                }
+
+                Assert::IsTrue(IcuDecode("UTF-8", bytes) == utf8->GetString(bytes).ToUTF16());
+            }
+        }
+
+        TEST_METHOD(ConvertersAcrossThreads)
+        {
+            // Every thread converts with the same instances; each call has
+            // to borrow its own converter from the pool.
+            const size_t threadCount = 8;
+            const char* names[] = { "UTF-8", "UTF-16LE", "Shift_JIS", "windows-1252" };
+            vector<thread> threads;
+            vector<int> failures(threadCount, 0);
+
+            for (size_t t = 0; t < threadCount; t++) {
+                threads.push_back(thread([&, t] {
+                    for (int i = 0; i < 2000; i++) {
+                        auto encoding = Encoding::GetEncoding(String(names[(t + i) % 4]));
+                        String str(("thread " + to_string(t) + " iteration " + to_string(i)).c_str());
+
+                        if (encoding->GetString(encoding->GetBytes(str)) != str) {
+                            failures[t]++;
+                        }
+                    }
+                }));
+            }
+
+            for (auto& thread : threads) {
+                thread.join();
+            }
+
+            for (size_t t = 0; t < threadCount; t++) {
+                Assert::AreEqual(0, failures[t]);
+            }
+        }
+    };
+}
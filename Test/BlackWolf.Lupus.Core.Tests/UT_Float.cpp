@@ -0,0 +1,203 @@
+#include "stdafx.h"
+#include <BlackWolf.Lupus.Core/Float.h>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <string>
+
+using namespace std;
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace Lupus;
+
+namespace UnitTests
+{
+    static string Format(double value)
+    {
+        uint8_t buffer[Float::MaxLength];
+        return string((const char*)buffer, Float::FormatTo(value, buffer));
+    }
+
+    static string Format(float value)
+    {
+        uint8_t buffer[Float::MaxLength];
+        return string((const char*)buffer, Float::FormatTo(value, buffer));
+    }
+
+    // Significant digits without sign, point, exponent and trailing zeros.
+    static string Digits(const string& str)
+    {
+        string digits;
+
+        for (char ch : str) {
+            if (ch == 'e') {
+                break;
+            } else if (ch >= '0' && ch <= '9' && (ch != '0' || !digits.empty())) {
+                digits.push_back(ch);
+            }
+        }
+
+        return digits.erase(digits.find_last_not_of('0') + 1);
+    }
+
+    // Fewest digits printf needs for strtod to read the value back.
+    template <typename T>
+    static string ShortestDigits(T value, int maxDigits)
+    {
+        char buffer[64];
+
+        for (int digits = 1; digits <= maxDigits; digits++) {
+            sprintf_s(buffer, sizeof(buffer), "%.*e", digits - 1, (double)value);
+
+            if ((T)strtod(buffer, nullptr) == value) {
+                break;
+            }
+        }
+
+        return Digits(buffer);
+    }
+
+    static bool SameBits(double lhs, double rhs)
+    {
+        return memcmp(&lhs, &rhs, sizeof(double)) == 0;
+    }
+
+    static bool SameBits(float lhs, float rhs)
+    {
+        return memcmp(&lhs, &rhs, sizeof(float)) == 0;
+    }
+
+    TEST_CLASS(FloatTests)
+    {
+    public:
+
+        TEST_METHOD(FormatRoundTripsThroughStrtod)
+        {
+            mt19937_64 random(42);
+
+            for (int iteration = 0; iteration < 100000; iteration++) {
+                uint64_t bits = random();
+                double value;
+                memcpy(&value, &bits, sizeof(value));
+
+                if (value != value || std::isinf(value)) {
+                    continue;
+                }
+
+                string str = Format(value);
+                Assert::IsTrue(SameBits(value, strtod(str.c_str(), nullptr)), L"double round trip");
+                Assert::AreEqual(ShortestDigits(value, 17).c_str(), Digits(str).c_str());
+
+                float single;
+                uint32_t singleBits = (uint32_t)bits;
+                memcpy(&single, &singleBits, sizeof(single));
+
+                if (single != single || std::isinf(single)) {
+                    continue;
+                }
+
+                str = Format(single);
+                Assert::IsTrue(SameBits(single, strtof(str.c_str(), nullptr)), L"float round trip");
+                Assert::AreEqual(ShortestDigits(single, 9).c_str(), Digits(str).c_str());
+            }
+        }
+
+        TEST_METHOD(FormatNotation)
+        {
+            Assert::AreEqual("0.1", Format(0.1).c_str());
+            Assert::AreEqual("0.30000000000000004", Format(0.1 + 0.2).c_str());
+            Assert::AreEqual("100", Format(100.0).c_str());
+            Assert::AreEqual("-0", Format(-0.0).c_str());
+            Assert::AreEqual("1e+21", Format(1e21).c_str());
+            Assert::AreEqual("1e-7", Format(1e-7).c_str());
+            Assert::AreEqual("5e-324", Format(5e-324).c_str());
+            Assert::AreEqual("1.7976931348623157e+308", Format(numeric_limits<double>::max()).c_str());
+            Assert::AreEqual("0.1", Format(0.1f).c_str());
+            Assert::AreEqual("3.4028235e+38", Format(numeric_limits<float>::max()).c_str());
+            Assert::AreEqual("nan", Format(numeric_limits<double>::quiet_NaN()).c_str());
+            Assert::AreEqual("-inf", Format(-numeric_limits<double>::infinity()).c_str());
+            Assert::AreEqual("0.30000000000000004", String::Format("{0}", 0.1 + 0.2).ToUTF8().c_str());
+            Assert::AreEqual("0.33333334", String::Format("{0}", 1.0f / 3).ToUTF8().c_str());
+        }
+
+        TEST_METHOD(ParseMatchesStrtod)
+        {
+            mt19937_64 random(7);
+            char buffer[64];
+
+            for (int iteration = 0; iteration < 100000; iteration++) {
+                string str;
+
+                if (iteration % 2) {
+                    uint64_t bits = random();
+                    double value;
+                    memcpy(&value, &bits, sizeof(value));
+
+                    if (value != value || std::isinf(value)) {
+                        continue;
+                    }
+
+                    sprintf_s(buffer, sizeof(buffer), "%.*e", (int)(random() % 20), value);
+                    str = buffer;
+                } else {
+                    // Long digit strings and extreme exponents stress the
+                    // slow path behind Eisel-Lemire.
+                    for (size_t i = 0, length = 1 + random() % 25; i < length; i++) {
+                        str.push_back((char)('0' + random() % 10));
+                    }
+
+                    if (random() % 2) {
+                        str.insert(random() % str.size(), ".");
+                    }
+
+                    if (random() % 2) {
+                        str += "e" + to_string((int)(random() % 700) - 350);
+                    }
+                }
+
+                double value = 1;
+                float single = 1;
+                size_t length = Float::FromChars(str.data(), str.data() + str.size(), value);
+
+                Assert::AreEqual(str.size(), length);
+                Assert::IsTrue(SameBits(strtod(str.c_str(), nullptr), value), L"double");
+                Float::FromChars(str.data(), str.data() + str.size(), single);
+                Assert::IsTrue(SameBits(strtof(str.c_str(), nullptr), single), L"float");
+            }
+        }
+
+        TEST_METHOD(ParseHardCases)
+        {
+            const char* cases[] = {
+                "2.2250738585072011e-308", "2.2250738585072012e-308", "4.9406564584124654e-324",
+                "2.4703282292062327e-324", "2.4703282292062328e-324", "1.7976931348623158e308",
+                "1.7976931348623159e308", "9007199254740993", "9007199254740992.5",
+                "9007199254740993.0000000000000000000000000000001", "7.038531e-26",
+                "1.00000005960464477539062499", "1.000000059604644775390625", "1.00000005960464477539062501",
+                "3.4028235677973366e38", "1e-45", "7e-46", "123456789012345678901234567890", "1e400", "1e-400",
+                "-0.0e10", "0.1", ".5", "5."
+            };
+
+            for (const char* str : cases) {
+                double value = 1;
+                float single = 1;
+
+                Assert::AreEqual(strlen(str), Float::FromChars(str, str + strlen(str), value));
+                Assert::IsTrue(SameBits(strtod(str, nullptr), value), L"double");
+                Float::FromChars(str, str + strlen(str), single);
+                Assert::IsTrue(SameBits(strtof(str, nullptr), single), L"float");
+            }
+
+            double value = 1;
+            Assert::AreEqual((size_t)0, Float::FromChars("+5", "+5" + 2, value));
+            Assert::AreEqual((size_t)0, Float::FromChars(" 5", " 5" + 2, value));
+            Assert::AreEqual((size_t)3, Float::FromChars("1.5junk", "1.5junk" + 7, value));
+            Assert::IsTrue(Float::TryParse(String("  -12.5e1xyz"), value));
+            Assert::AreEqual(-125.0, value);
+            Assert::IsFalse(Float::TryParse(String("abc"), value));
+            Assert::IsFalse(Float::TryParse(String(""), value));
+        }
+    };
+}
@@ -0,0 +1,71 @@
+#include "stdafx.h"
+#include <BlackWolf.Lupus.Core/Format.h>
+#include <BlackWolf.Lupus.Core/StringBuilder.h>
+#include <BlackWolf.Lupus.Core/StringView.h>
+#include <limits>
+
+using namespace std;
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace Lupus;
+using namespace Lupus::Text;
+
+namespace UnitTests
+{
+    TEST_CLASS(FormatTests)
+    {
+    public:
+
+        TEST_METHOD(Arguments)
+        {
+            String world("world");
+
+            Assert::AreEqual("hello world", String::Format("hello {0}", world).ToUTF8().c_str());
+            Assert::AreEqual("1+2=3", String::Format("{0}+{1}={2}", 1, 2u, 3LL).ToUTF8().c_str());
+            Assert::AreEqual("True False x", String::Format("{0} {1} {2}", true, false, 'x').ToUTF8().c_str());
+            Assert::AreEqual("caf\xc3\xa9", String::Format("{0}", "caf\xc3\xa9").ToUTF8().c_str());
+            Assert::AreEqual("orl", String::Format("{0}", StringView(world).Substring(1, 3)).ToUTF8().c_str());
+            Assert::AreEqual("a long string exceeding the inline capacitya", String::Format("{1}{0}", "a", String("a long string exceeding the inline capacity")).ToUTF8().c_str());
+            Assert::AreEqual("{7}", String::Format("{{{0}}}", 7).ToUTF8().c_str());
+            Assert::AreEqual("a}b{c", String::Format("a}}b{{c").ToUTF8().c_str());
+        }
+
+        TEST_METHOD(AlignmentAndFormats)
+        {
+            Assert::AreEqual("   42|42   |", String::Format("{0,5}|{0,-5}|", 42).ToUTF8().c_str());
+            Assert::AreEqual("    ab", String::Format("{0,6}", "ab").ToUTF8().c_str());
+            Assert::AreEqual("caf\xc3\xa9  |", String::Format("{0,-6}|", "caf\xc3\xa9").ToUTF8().c_str());
+            Assert::AreEqual("FF|000000ff|FFFFFFFF", String::Format("{0:X}|{0:x8}|{1:X}", 255, -1).ToUTF8().c_str());
+            Assert::AreEqual("FFFF", String::Format("{0:X}", (short)-1).ToUTF8().c_str());
+            Assert::AreEqual("00042|-00042", String::Format("{0:D5}|{1:D5}", 42, -42).ToUTF8().c_str());
+            Assert::AreEqual("-9223372036854775808", String::Format("{0:D}", numeric_limits<long long>::min()).ToUTF8().c_str());
+            Assert::AreEqual("18446744073709551615", String::Format("{0}", numeric_limits<unsigned long long>::max()).ToUTF8().c_str());
+            Assert::AreEqual("3.14|3.142", String::Format("{0:F}|{0:F3}", 3.14159).ToUTF8().c_str());
+            Assert::AreEqual("1.23E+04", String::Format("{0:E2}", 12345.0).ToUTF8().c_str());
+        }
+
+        TEST_METHOD(ParsedFormatAndBuilder)
+        {
+            FormatString format("{0}:{1,3}");
+            StringBuilder builder;
+
+            Assert::AreEqual("host: 80", String::Format(format, "host", 80).ToUTF8().c_str());
+
+            builder.Append(String("x="));
+            String::FormatTo(builder, "{0}", 5);
+            String::FormatTo(builder, format, "y", 1);
+            Assert::AreEqual("x=5y:  1", builder.ToString().ToUTF8().c_str());
+        }
+
+        TEST_METHOD(InvalidFormats)
+        {
+            const char* invalid[] = { "{", "}", "{1}", "{a}", "{0", "{0:Q}", "{0,}" };
+
+            for (const char* format : invalid) {
+                Assert::ExpectException<format_error>([&] { String::Format(format, 1); });
+            }
+
+            Assert::ExpectException<format_error>([] { String::Format(FormatString("{0}:{1,3}"), 1); });
+            Assert::ExpectException<format_error>([] { String::Format("{0:X}", 1.5); });
+        }
+    };
+}
@@ -0,0 +1,119 @@
+#include "stdafx.h"
+#include <BlackWolf.Lupus.Core/HttpListenerRequest.h>
+#include <BlackWolf.Lupus.Core/Cookie.h>
+#include <BlackWolf.Lupus.Core/Version.h>
+#include <memory>
+#include <string>
+
+using namespace std;
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace Lupus;
+using namespace Lupus::Net;
+
+namespace UnitTests
+{
+    static shared_ptr<HttpListenerRequest> Parse(const string& request)
+    {
+        return make_shared<HttpListenerRequest>(Utf8View(request), nullptr, nullptr);
+    }
+
+    static bool HasItem(const NameValueCollection& items, const char* name, const String& value)
+    {
+        auto it = items.find(name);
+        return it != items.end() && it->second == value;
+    }
+
+    TEST_CLASS(HttpListenerRequestTests)
+    {
+    public:
+
+        TEST_METHOD(RequestLineAndHeaders)
+        {
+            auto request = Parse(
+                "POST /submit HTTP/1.1\r\n"
+                "Host: www.example.org\r\n"
+                "Accept: text/html,application/xhtml+xml;q=0.9\r\n"
+                "Accept-Language: de-AT,en\r\n"
+                "User-Agent: UnitTests\r\n"
+                "\r\n"
+                "body");
+
+            Assert::IsTrue(request->HttpMethod() == "POST");
+            Assert::AreEqual(1, request->ProtocolVersion()->Major());
+            Assert::AreEqual(1, request->ProtocolVersion()->Minor());
+            Assert::IsTrue(request->UserAgent() == "UnitTests");
+            Assert::AreEqual((size_t)4, request->Headers().size());
+            Assert::AreEqual((int64_t)4, request->ContentLength());
+
+            // Only the part before the first parameter counts.
+            Assert::AreEqual((size_t)2, request->AcceptTypes().size());
+            Assert::IsTrue(request->AcceptTypes()[0] == "text/html");
+            Assert::IsTrue(request->AcceptTypes()[1] == "application/xhtml+xml");
+            Assert::AreEqual((size_t)2, request->UserLanguages().size());
+            Assert::IsTrue(request->UserLanguages()[1] == "en");
+        }
+
+        TEST_METHOD(LinesWithoutSeparatorAreSkipped)
+        {
+            auto request = Parse(
+                "GET / HTTP/1.1\r\n"
+                "Host: localhost\r\n"
+                "Broken\r\n"
+                "X-No-Space:value\r\n"
+                "X-Empty: \r\n"
+                "\r\n");
+
+            Assert::AreEqual((size_t)2, request->Headers().size());
+            Assert::IsTrue(HasItem(request->Headers(), "Host", "localhost"));
+            Assert::IsTrue(HasItem(request->Headers(), "X-Empty", ""));
+            Assert::IsFalse(request->HasEntityBody());
+        }
+
+        TEST_METHOD(QueryItemsWithoutValue)
+        {
+            auto request = Parse(
+                "GET /search?q=lupus&debug&empty=&&x=1 HTTP/1.1\r\n"
+                "Host: localhost\r\n"
+                "\r\n");
+            const NameValueCollection& query = request->QueryString();
+
+            Assert::AreEqual((size_t)4, query.size());
+            Assert::IsTrue(HasItem(query, "q", "lupus"));
+            Assert::IsTrue(HasItem(query, "debug", ""));
+            Assert::IsTrue(HasItem(query, "empty", ""));
+            Assert::IsTrue(HasItem(query, "x", "1"));
+        }
+
+        TEST_METHOD(CookieNamesAreTrimmed)
+        {
+            auto request = Parse(
+                "GET / HTTP/1.1\r\n"
+                "Host: localhost\r\n"
+                "Cookie: session=0123456789abcdef;  theme = dark ; flag;;last=1\r\n"
+                "\r\n");
+            const CookieCollection& cookies = request->Cookies();
+
+            Assert::AreEqual((size_t)4, cookies.size());
+            Assert::IsTrue(cookies.at("session")->Value() == "0123456789abcdef");
+            Assert::IsTrue(cookies.at("theme")->Name() == "theme");
+            Assert::IsTrue(cookies.at("flag")->Value().IsEmpty());
+            Assert::IsTrue(cookies.at("last")->Value() == "1");
+        }
+
+        TEST_METHOD(RawHeaderIsUtf8)
+        {
+            string header =
+                "GET / HTTP/1.1\r\n"
+                "Host: localhost\r\n"
+                "X-Name: J\xC3\xBCrgen M\xC3\xBCller \xE2\x82\xAC\r\n"
+                "\r\n";
+            auto request = Parse(header + "rest");
+            String name = String::FromUTF8("J\xC3\xBCrgen M\xC3\xBCller \xE2\x82\xAC");
+
+            Assert::IsTrue(request->RawHeader() == String::FromUTF8(header));
+            Assert::AreEqual(header.size() - 4, request->RawHeader().Length());
+            Assert::IsTrue(HasItem(request->Headers(), "X-Name", name));
+            Assert::AreEqual((int64_t)4, request->ContentLength());
+        }
+    };
+}
@@ -0,0 +1,168 @@
+#include "stdafx.h"
+#include <BlackWolf.Lupus.Core/MultiReplacer.h>
+#include <BlackWolf.Lupus.Core/String.h>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace std;
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace Lupus;
+using namespace Lupus::Text;
+
+namespace UnitTests
+{
+    typedef vector<pair<u16string, u16string>> Pairs;
+
+    static u16string Units(const char* str)
+    {
+        u16string result;
+
+        for (; *str; str++) {
+            result.push_back((uint8_t)*str);
+        }
+
+        return result;
+    }
+
+    static String Replace(const Pairs& pairs, const u16string& text)
+    {
+        vector<pair<String, String>> replacements;
+
+        for (const auto& pair : pairs) {
+            replacements.push_back(make_pair(String::FromUTF16(pair.first), String::FromUTF16(pair.second)));
+        }
+
+        return MultiReplacer(replacements).Replace(String::FromUTF16(text));
+    }
+
+    // Scans left to right and takes the longest pattern starting at each
+    // position, the first registered one of equal patterns.
+    static u16string Reference(const Pairs& pairs, const u16string& text)
+    {
+        u16string result;
+
+        for (size_t i = 0; i < text.size();) {
+            const pair<u16string, u16string>* best = nullptr;
+
+            for (const auto& pair : pairs) {
+                if (!pair.first.empty() && text.compare(i, pair.first.size(), pair.first) == 0 && (!best || pair.first.size() > best->first.size())) {
+                    best = &pair;
+                }
+            }
+
+            if (best) {
+                result += best->second;
+                i += best->first.size();
+            } else {
+                result.push_back(text[i++]);
+            }
+        }
+
+        return result;
+    }
+
+    // Random text over a small alphabet, so that patterns overlap and
+    // match often. Without the last letters the text fits Latin-1 and
+    // long strings become compact.
+    static u16string RandomUnits(mt19937& random, size_t length, size_t letters)
+    {
+        static const char16_t alphabet[] = { 'a', 'b', 'c', 0xE9, 0x100, 0x20AC };
+        u16string result;
+
+        for (size_t i = 0; i < length; i++) {
+            result.push_back(alphabet[random() % letters]);
+        }
+
+        return result;
+    }
+
+    TEST_CLASS(MultiReplacerTests)
+    {
+    public:
+
+        TEST_METHOD(OverlappingPatterns)
+        {
+            Pairs pairs = { { Units("aba"), Units("1") }, { Units("bab"), Units("2") } };
+
+            // The leftmost match wins, and the text it replaced is not searched again.
+            Assert::IsTrue(Replace(pairs, Units("ababab")).ToUTF16() == Units("12"));
+            Assert::IsTrue(Replace(pairs, Units("abababa")).ToUTF16() == Units("12a"));
+            Assert::IsTrue(Replace(pairs, Units("xbabax")).ToUTF16() == Units("x2ax"));
+        }
+
+        TEST_METHOD(PrefixPatterns)
+        {
+            Pairs shortFirst = { { Units("a"), Units("1") }, { Units("ab"), Units("2") }, { Units("abc"), Units("3") } };
+            Pairs longFirst = { { Units("abc"), Units("3") }, { Units("ab"), Units("2") }, { Units("a"), Units("1") } };
+
+            // The longest match at a position wins, whatever the order.
+            Assert::IsTrue(Replace(shortFirst, Units("abcaba")).ToUTF16() == Units("321"));
+            Assert::IsTrue(Replace(longFirst, Units("abcaba")).ToUTF16() == Units("321"));
+
+            // Of equal patterns the first one registered wins.
+            Pairs equal = { { Units("ab"), Units("1") }, { Units("ab"), Units("2") } };
+            Assert::IsTrue(Replace(equal, Units("abab")).ToUTF16() == Units("11"));
+        }
+
+        TEST_METHOD(EmptyPattern)
+        {
+            Pairs pairs = { { u16string(), Units("x") }, { Units("b"), Units("y") } };
+            Pairs empty = { { u16string(), Units("x") } };
+            String text = String::FromUTF16(Units("abc, long enough for the heap"));
+
+            Assert::IsTrue(Replace(pairs, Units("abc")).ToUTF16() == Units("ayc"));
+            Assert::IsTrue(Replace(empty, Units("abc")).ToUTF16() == Units("abc"));
+            Assert::IsTrue(MultiReplacer(vector<pair<String, String>>()).Replace(text) == text);
+            Assert::IsTrue(Replace(pairs, u16string()).IsEmpty());
+        }
+
+        TEST_METHOD(ReplacementsAreNotSearched)
+        {
+            Pairs pairs = { { Units("a"), Units("ab") }, { Units("b"), Units("a") } };
+
+            Assert::IsTrue(Replace(pairs, Units("aabb")).ToUTF16() == Units("ababaa"));
+
+            // Swapping two patterns in one pass.
+            Pairs swap = { { Units("cat"), Units("dog") }, { Units("dog"), Units("cat") } };
+            Assert::IsTrue(Replace(swap, Units("cat and dog")).ToUTF16() == Units("dog and cat"));
+        }
+
+        TEST_METHOD(CompactAndNonCompactInputs)
+        {
+            u16string latin1 = Units("Stra");
+            latin1.push_back(0xDF);
+            latin1 += Units("e, long enough for the heap, Stra");
+            latin1.push_back(0xDF);
+            latin1 += Units("e");
+            u16string euro = latin1;
+            euro[4] = 0x20AC;
+
+            u16string sharp(1, 0xDF), ss = Units("ss"), euroSign(1, 0x20AC);
+            Pairs pairs = { { sharp, ss }, { euroSign, Units("EUR") }, { Units("e,"), sharp } };
+
+            Assert::IsTrue(Replace(pairs, latin1).ToUTF16() == Reference(pairs, latin1));
+            Assert::IsTrue(Replace(pairs, euro).ToUTF16() == Reference(pairs, euro));
+            Assert::IsTrue(Replace(pairs, latin1).ToUTF16() != latin1);
+        }
+
+        TEST_METHOD(MatchesReference)
+        {
+            mt19937 random(15);
+
+            for (int iteration = 0; iteration < 3000; iteration++) {
+                size_t letters = random() % 2 ? 4 : 6;
+                Pairs pairs;
+
+                for (size_t i = 0, count = 1 + random() % 5; i < count; i++) {
+                    pairs.push_back(make_pair(RandomUnits(random, random() % 4, letters), RandomUnits(random, random() % 4, letters)));
+                }
+
+                u16string text = RandomUnits(random, random() % 80, letters);
+
+                Assert::IsTrue(Replace(pairs, text).ToUTF16() == Reference(pairs, text));
+            }
+        }
+    };
+}
@@ -0,0 +1,103 @@
+#include "stdafx.h"
+#include <BlackWolf.Lupus.Core/Regex.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace Lupus;
+using namespace Lupus::Text;
+
+namespace UnitTests
+{
+    TEST_CLASS(RegexTests)
+    {
+    public:
+
+        TEST_METHOD(MatchAndGroups)
+        {
+            String input("GET /index.html HTTP/1.1");
+            Regex regex(String("^(\\w+) (\\S+)(?: (x))? HTTP/(\\d)\\.(\\d)$"));
+            RegexMatch match = regex.Match(StringView(input));
+
+            Assert::IsTrue(match.Success());
+            Assert::AreEqual((size_t)0, match.Index());
+            Assert::AreEqual(input.Length(), match.Length());
+            Assert::AreEqual((size_t)6, match.GroupCount());
+            Assert::AreEqual("GET", match.Group(1).ToString().ToUTF8().c_str());
+            Assert::AreEqual("/index.html", match.Group(2).ToString().ToUTF8().c_str());
+            Assert::AreEqual(-1, match.GroupIndex(3));
+            Assert::IsTrue(match.Group(3).IsEmpty());
+            Assert::AreEqual(21, match.GroupIndex(4));
+            Assert::ExpectException<out_of_range>([&] { match.Group(6); });
+
+            Assert::IsFalse(regex.IsMatch(StringView(String("GET /"))));
+            Assert::IsFalse(regex.Match(StringView(String("GET /"))).Success());
+            Assert::IsTrue(Regex::IsMatch(StringView(String("CONTENT-type")), String("^content-TYPE$"), RegexOptions::IgnoreCase));
+        }
+
+        TEST_METHOD(MatchesReplaceAndSplit)
+        {
+            String input("a=1; bb=22; ccc=333");
+            Regex regex(String("(\\w+)=(\\d+)"));
+            vector<string> keys;
+
+            for (const RegexMatch& match : regex.Matches(StringView(input))) {
+                keys.push_back(match.Group(1).ToString().ToUTF8() + ":" + to_string(match.Index()));
+            }
+
+            Assert::AreEqual((size_t)3, keys.size());
+            Assert::AreEqual("a:0", keys[0].c_str());
+            Assert::AreEqual("bb:5", keys[1].c_str());
+            Assert::AreEqual("ccc:12", keys[2].c_str());
+
+            Assert::AreEqual("1=a; 22=bb; 333=ccc", regex.Replace(input, String("$2=$1")).ToUTF8().c_str());
+            Assert::AreEqual("$a; $bb; $ccc", regex.Replace(input, String("\\$$1")).ToUTF8().c_str());
+
+            vector<String> parts = Regex::Split(input, String(";\\s*"));
+            Assert::AreEqual((size_t)3, parts.size());
+            Assert::AreEqual("bb=22", parts[1].ToUTF8().c_str());
+
+            Assert::ExpectException<format_error>([] { Regex(String("(unclosed")); });
+        }
+
+        TEST_METHOD(SharedBetweenThreads)
+        {
+            // One compiled pattern, many concurrent searches; the cache is
+            // kept small so that other threads evict and recompile patterns.
+            const size_t threadCount = 8;
+            size_t cacheSize = Regex::CacheSize();
+            Regex regex(String("(\\d+)-(\\d+)"));
+            vector<thread> threads;
+            vector<int> failures(threadCount, 0);
+
+            Regex::CacheSize(2);
+
+            for (size_t t = 0; t < threadCount; t++) {
+                threads.push_back(thread([&, t] {
+                    for (int i = 0; i < 2000; i++) {
+                        String input(("range " + to_string(i) + "-" + to_string(t) + " end").c_str());
+                        RegexMatch match = regex.Match(StringView(input));
+                        String pattern(("x" + to_string(i % 5)).c_str());
+
+                        if (!match.Success() || match.Group(2).ToString() != String(to_string(t).c_str()) ||
+                            Regex::IsMatch(StringView(input), pattern)) {
+                            failures[t]++;
+                        }
+                    }
+                }));
+            }
+
+            for (auto& thread : threads) {
+                thread.join();
+            }
+
+            Regex::CacheSize(cacheSize);
+
+            for (size_t t = 0; t < threadCount; t++) {
+                Assert::AreEqual(0, failures[t]);
+            }
+        }
+    };
+}
@@ -0,0 +1,92 @@
+#include "stdafx.h"
+#include <BlackWolf.Lupus.Core/Searcher.h>
+#include <unicode/ustring.h>
+#include <random>
+#include <string>
+
+using namespace std;
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace Lupus;
+using namespace Lupus::Text;
+
+namespace UnitTests
+{
+    // Few distinct characters make partial matches and periodic patterns
+    // likely, which is where Two-Way differs from a naive search.
+    static u16string RandomText(mt19937& random, size_t length, size_t letters)
+    {
+        static const char16_t alphabet[] = { 'a', 'b', 'c', 0xE9, 0xD83D, 0xDE00 };
+        u16string result;
+
+        for (size_t i = 0; i < length; i++) {
+            result.push_back(alphabet[random() % letters]);
+        }
+
+        return result;
+    }
+
+    static int IcuIndexOf(const u16string& text, const u16string& pattern, size_t offset)
+    {
+        const UChar* data = (const UChar*)text.data();
+        const UChar* match = u_strFindFirst(data + offset, (int32_t)(text.size() - offset), (const UChar*)pattern.data(), (int32_t)pattern.size());
+        return match ? (int)(match - data) : -1;
+    }
+
+    TEST_CLASS(SearcherTests)
+    {
+    public:
+
+        TEST_METHOD(MatchesIcu)
+        {
+            mt19937 random(11);
+
+            for (int iteration = 0; iteration < 20000; iteration++) {
+                size_t letters = 2 + random() % 5;
+                u16string text = RandomText(random, random() % 300, letters);
+                u16string pattern = RandomText(random, 1 + random() % (random() % 4 ? 8 : 80), letters);
+
+                // Plant the pattern now and then, long patterns rarely occur by chance.
+                if (random() % 2 && pattern.size() <= text.size()) {
+                    text.replace(random() % (text.size() - pattern.size() + 1), pattern.size(), pattern);
+                }
+
+                String str = String::FromUTF16(text);
+                String patternStr = String::FromUTF16(pattern);
+                Searcher searcher(patternStr);
+                size_t offset = random() % (text.size() + 1);
+
+                Assert::AreEqual(IcuIndexOf(text, pattern, 0), searcher.IndexOf(StringView(str)), L"IndexOf");
+                Assert::AreEqual(IcuIndexOf(text, pattern, offset), searcher.IndexOf(StringView(str), offset), L"IndexOf offset");
+                Assert::AreEqual(IcuIndexOf(text, pattern, 0), str.IndexOf(patternStr), L"String::IndexOf");
+            }
+        }
+
+        TEST_METHOD(CopiesKeepTheirPattern)
+        {
+            String text("a long text with a pattern that needs the Two-Way search to find it, pattern included");
+            Searcher searcher(String("pattern that needs the Two-Way search to find it"));
+            Searcher copy(searcher);
+
+            {
+                Searcher other(String("something else"));
+                other = searcher;
+                searcher = Searcher(String("text"));
+                copy = other;
+            }
+
+            Assert::AreEqual(19, copy.IndexOf(StringView(text)));
+            Assert::AreEqual(7, searcher.IndexOf(StringView(text)));
+            Assert::IsTrue(copy.Pattern().ToString() == String("pattern that needs the Two-Way search to find it"));
+        }
+
+        TEST_METHOD(OffsetOutOfRange)
+        {
+            String text("short");
+            Searcher searcher(String("t"));
+
+            Assert::AreEqual(4, searcher.IndexOf(StringView(text), 4));
+            Assert::AreEqual(-1, searcher.IndexOf(StringView(text), 5));
+            Assert::ExpectException<out_of_range>([&] { searcher.IndexOf(StringView(text), 6); });
+        }
+    };
+}
@@ -0,0 +1,515 @@
+#include "stdafx.h"
+#include <BlackWolf.Lupus.Core/String.h>
+#include <unicode/uchar.h>
+#include <unicode/ustring.h>
+#include <unicode/utf16.h>
+#include <unicode/locid.h>
+#include <algorithm>
+#include <random>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+using namespace std;
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace Lupus;
+
+namespace UnitTests
+{
+    // Builds the reference text without u"" literals, which VS2013 lacks.
+    static u16string Units(const char* str)
+    {
+        u16string result;
+
+        for (; *str; str++) {
+            result.push_back((uint8_t)*str);
+        }
+
+        return result;
+    }
+
+    static bool Equals(const String& str, const u16string& expected)
+    {
+        return str.ToUTF16() == expected;
+    }
+
+    // Random text over a small alphabet, so that searches hit often. Some
+    // strings are Latin-1 only and become compact, others are not.
+    static u16string RandomUnits(mt19937& random, size_t length)
+    {
+        static const char16_t alphabet[] = { 'a', 'b', 'c', ' ', 0xE9, 0x100, 0xD83D, 0xDE00 };
+        size_t size = random() % 2 ? 4 : 8;
+        u16string result;
+
+        for (size_t i = 0; i < length; i++) {
+            result.push_back(alphabet[random() % size]);
+        }
+
+        return result;
+    }
+
+    static u16string IcuCaseMap(const u16string& text, bool upper)
+    {
+        UErrorCode error = U_ZERO_ERROR;
+        u16string result(text.size() * 3 + 1, 0);
+        const UChar* src = (const UChar*)text.data();
+        int32_t length = upper ?
+            u_strToUpper((UChar*)&result[0], (int32_t)result.size(), src, (int32_t)text.size(), nullptr, &error) :
+            u_strToLower((UChar*)&result[0], (int32_t)result.size(), src, (int32_t)text.size(), nullptr, &error);
+        result.resize(length);
+        return result;
+    }
+
+    // Restores the default ICU locale when a test ends, also on failure.
+    class DefaultLocale
+    {
+    public:
+
+        DefaultLocale(const char* language) : mPrevious(icu::Locale::getDefault())
+        {
+            UErrorCode error = U_ZERO_ERROR;
+            icu::Locale::setDefault(icu::Locale(language), error);
+        }
+
+        ~DefaultLocale()
+        {
+            UErrorCode error = U_ZERO_ERROR;
+            icu::Locale::setDefault(mPrevious, error);
+        }
+
+    private:
+
+        icu::Locale mPrevious;
+    };
+
+    static int Sign(int value)
+    {
+        return (value > 0) - (value < 0);
+    }
+
+    static String Name(size_t index)
+    {
+        return String(("a name long enough to be stored on the heap #" + to_string(index)).c_str());
+    }
+
+    TEST_CLASS(StringTests)
+    {
+    public:
+
+        TEST_METHOD(LengthsAroundInlineCapacity)
+        {
+            const char* alphabet = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789";
+
+            for (size_t length = 0; length <= 40; length++) {
+                string text(alphabet, length);
+                String str(text.c_str());
+
+                Assert::AreEqual(length, str.Length());
+                Assert::AreEqual(text.c_str(), str.ToUTF8().c_str());
+                Assert::IsTrue(str == String(str.Data()));
+
+                String appended = str.Append(String("xyz"));
+                Assert::AreEqual((text + "xyz").c_str(), appended.ToUTF8().c_str());
+
+                for (size_t i = 0; i <= length; i++) {
+                    Assert::AreEqual(text.substr(i).c_str(), str.Substring(i).ToUTF8().c_str());
+                    Assert::AreEqual(text.substr(0, i).c_str(), str.Substring(0, i).ToUTF8().c_str());
+                }
+            }
+        }
+
+        TEST_METHOD(CopiesAreIndependent)
+        {
+            String small("short");
+            String large("a string that does not fit into the object");
+            String smallCopy = small;
+            String largeCopy = large;
+
+            smallCopy[0] = 'S';
+            largeCopy[0] = 'A';
+
+            Assert::AreEqual("short", small.ToUTF8().c_str());
+            Assert::AreEqual("Short", smallCopy.ToUTF8().c_str());
+            Assert::AreEqual("a string that does not fit into the object", large.ToUTF8().c_str());
+            Assert::AreEqual("A string that does not fit into the object", largeCopy.ToUTF8().c_str());
+
+            String moved(std::move(largeCopy));
+            Assert::IsTrue(largeCopy.IsEmpty());
+            Assert::AreEqual("A string that does not fit into the object", moved.ToUTF8().c_str());
+
+            largeCopy = moved;
+            moved += "!";
+            Assert::AreEqual(largeCopy.Length() + 1, moved.Length());
+        }
+
+        TEST_METHOD(SharedCopiesAcrossThreads)
+        {
+            // Every thread copies, modifies and reassigns strings that share
+            // one buffer; a lost or doubled reference shows up as a wrong
+            // character or a crash, and under a thread sanitizer as a race.
+            const String shared("a shared string that is long enough to live on the heap");
+            const size_t threadCount = 8;
+            const int iterations = 20000;
+            vector<String> slots(threadCount, shared);
+            vector<thread> threads;
+            vector<int> failures(threadCount, 0);
+
+            for (size_t t = 0; t < threadCount; t++) {
+                threads.push_back(thread([&, t] {
+                    for (int i = 0; i < iterations; i++) {
+                        String copy = shared;
+                        String other = slots[t];
+
+                        copy += "!";
+                        other[0] = 'X';
+
+                        if (copy.Length() != shared.Length() + 1 || shared[0] != 'a' || other[1] != ' ') {
+                            failures[t]++;
+                        }
+
+                        slots[t] = (i & 1) ? shared : copy;
+                    }
+                }));
+            }
+
+            for (auto& thread : threads) {
+                thread.join();
+            }
+
+            for (size_t t = 0; t < threadCount; t++) {
+                Assert::AreEqual(0, failures[t]);
+                Assert::IsTrue(slots[t] == shared);
+            }
+
+            Assert::AreEqual("a shared string that is long enough to live on the heap", shared.ToUTF8().c_str());
+        }
+
+        TEST_METHOD(HashCodesIgnoreStorage)
+        {
+            const char* text = "Accept-Encoding: gzip, deflate, br";
+            String compact(text);
+            String wide = String::FromUTF16(Units(text));
+            String slice = String(string("xx") + text).Substring(2);
+
+            Assert::IsTrue(compact.GetHashCode() == wide.GetHashCode());
+            Assert::IsTrue(compact.GetHashCode() == slice.GetHashCode());
+            Assert::IsTrue(String("short").GetHashCode() == String::FromUTF16(Units("short")).GetHashCode());
+
+            // The cached value belongs to the shared buffer, not to a copy
+            // that has been modified since.
+            String copy = compact;
+            size_t hash = compact.GetHashCode();
+            copy[0] = 'a';
+            Assert::IsTrue(copy.GetHashCode() == String("accept-Encoding: gzip, deflate, br").GetHashCode());
+            Assert::IsTrue(compact.GetHashCode() == hash);
+
+            String upper("CONTENT-TYPE");
+            String lower("content-type");
+            Assert::IsTrue(upper.GetHashCode(StringCaseSensitivity::CaseInsensitive) == lower.GetHashCode(StringCaseSensitivity::CaseInsensitive));
+
+            unordered_map<String, int, StringCaseInsensitiveHash, StringCaseInsensitiveEqual> headers;
+            headers[String("Content-Length")] = 1;
+            headers[String("content-length")]++;
+            Assert::AreEqual((size_t)1, headers.size());
+            Assert::AreEqual(2, headers[String("CONTENT-LENGTH")]);
+        }
+
+        TEST_METHOD(InternAcrossThreads)
+        {
+            const size_t threadCount = 8;
+            const size_t nameCount = 64;
+            vector<vector<String>> results(threadCount);
+            vector<thread> threads;
+            StringInternStatistics before = String::InternStatistics();
+
+            for (size_t t = 0; t < threadCount; t++) {
+                threads.push_back(thread([&, t] {
+                    for (size_t i = 0; i < nameCount; i++) {
+                        // Fresh buffers every time, so only the pool can unify them.
+                        results[t].push_back(String::Intern(String(("UnitTests.InternAcrossThreads.Name" + to_string(i)).c_str())));
+                    }
+                }));
+            }
+
+            for (auto& thread : threads) {
+                thread.join();
+            }
+
+            for (size_t i = 0; i < nameCount; i++) {
+                String name(("UnitTests.InternAcrossThreads.Name" + to_string(i)).c_str());
+                const Char* pooled = String::IsInterned(name).Data();
+
+                for (size_t t = 0; t < threadCount; t++) {
+                    Assert::IsTrue(results[t][i] == name);
+                    Assert::IsTrue(results[t][i].Data() == pooled);
+                }
+            }
+
+            StringInternStatistics after = String::InternStatistics();
+            Assert::IsTrue(after.Count - before.Count == nameCount);
+            Assert::IsTrue(after.Hits - before.Hits >= (threadCount - 1) * nameCount);
+
+            String small("tiny");
+            Assert::IsTrue(String::Intern(small) == small);
+            Assert::IsTrue(String::InternStatistics().Count == after.Count);
+
+            String unknown("UnitTests.InternAcrossThreads.Unknown");
+            Assert::IsTrue(String::IsInterned(unknown).Data() == unknown.Data());
+        }
+
+        TEST_METHOD(CharacterSearchMatchesScan)
+        {
+            mt19937 random(7);
+
+            for (int iteration = 0; iteration < 2000; iteration++) {
+                u16string text = RandomUnits(random, random() % 100);
+                String str = String::FromUTF16(text);
+                Char ch = (Char)RandomUnits(random, 1)[0];
+                vector<Char> any = { (Char)RandomUnits(random, 1)[0], (Char)RandomUnits(random, 1)[0] };
+                size_t offset = random() % (text.size() + 1);
+                size_t count = random() % (text.size() - offset + 1);
+                int first = -1, last = -1, firstAny = -1, lastAny = -1;
+
+                for (size_t i = offset; i < offset + count; i++) {
+                    // Like ICU, a surrogate is only found where it is unpaired
+                    // within the searched range.
+                    bool paired = (i > offset && U16_IS_TRAIL(text[i]) && U16_IS_LEAD(text[i - 1])) ||
+                        (i + 1 < offset + count && U16_IS_LEAD(text[i]) && U16_IS_TRAIL(text[i + 1]));
+                    bool isAny = !paired && (text[i] == any[0] || text[i] == any[1]);
+
+                    if (paired) {
+                        continue;
+                    } else if (text[i] == ch) {
+                        last = (int)i;
+                        first = first < 0 ? (int)i : first;
+                    }
+
+                    if (isAny) {
+                        lastAny = (int)i;
+                        firstAny = firstAny < 0 ? (int)i : firstAny;
+                    }
+                }
+
+                Assert::AreEqual(first, str.IndexOf(ch, offset, count), L"IndexOf");
+                Assert::AreEqual(firstAny, str.IndexOfAny(any, offset, count), L"IndexOfAny");
+                Assert::AreEqual(last, str.LastIndexOf(ch, offset, count), L"LastIndexOf");
+                Assert::AreEqual(lastAny, str.LastIndexOfAny(any, offset, count), L"LastIndexOfAny");
+
+
+                if (!U16_IS_SURROGATE(ch)) {
+                    Assert::AreEqual((int)text.find(ch), str.IndexOf(ch));
+                    Assert::AreEqual((int)text.rfind(ch), str.LastIndexOf(ch));
+                }
+            }
+        }
+
+        TEST_METHOD(CaseMappingMatchesIcu)
+        {
+            // ASCII, Latin-1 letters with and without Latin-1 case partners,
+            // and two characters outside Latin-1.
+            static const char16_t alphabet[] = { 'a', 'Z', 'q', 'M', '0', ' ', '@', '[', 0xE9, 0xC9, 0xF7, 0xB5, 0xDF, 0xFF, 0x130, 0x3A3 };
+            mt19937 random(5);
+
+            for (int iteration = 0; iteration < 5000; iteration++) {
+                size_t letters = random() % 3 == 0 ? 8 : random() % 2 ? 14 : 16;
+                u16string lhs, rhs;
+
+                for (size_t i = 0, length = random() % 40; i < length; i++) {
+                    lhs.push_back(alphabet[random() % letters]);
+                }
+
+                // Mostly the same text in another case, so that comparisons
+                // get past the first character.
+                rhs = random() % 4 ? IcuCaseMap(lhs, random() % 2 == 0) : lhs;
+
+                if (!rhs.empty() && random() % 2) {
+                    rhs[random() % rhs.size()] = alphabet[random() % letters];
+                }
+
+                String lhsStr = String::FromUTF16(lhs);
+                String rhsStr = String::FromUTF16(rhs);
+                UErrorCode error = U_ZERO_ERROR;
+                int expected = u_strCaseCompare((const UChar*)lhs.data(), (int32_t)lhs.size(), (const UChar*)rhs.data(), (int32_t)rhs.size(), U_FOLD_CASE_DEFAULT, &error);
+
+                Assert::IsTrue(Equals(lhsStr.ToUpper(), IcuCaseMap(lhs, true)), L"ToUpper");
+                Assert::IsTrue(Equals(lhsStr.ToLower(), IcuCaseMap(lhs, false)), L"ToLower");
+                Assert::AreEqual(Sign(expected), Sign(lhsStr.Compare(rhsStr, StringCaseSensitivity::CaseInsensitive)), L"Compare");
+                Assert::AreEqual(Sign(lhs.compare(rhs)), Sign(lhsStr.Compare(rhsStr)), L"Compare case sensitive");
+            }
+        }
+
+        TEST_METHOD(CaseMappingFollowsDefaultLocale)
+        {
+            u16string ascii = Units("Istanbul, Izmir and Diyarbakir, long enough for the heap");
+            u16string latin1 = ascii;
+            latin1[1] = 0xCD;
+            latin1[2] = 0xEC;
+            const char* const languages[] = { "tr", "az", "lt", "en" };
+
+            for (const char* language : languages) {
+                DefaultLocale locale(language);
+
+                for (const u16string& text : { ascii.substr(0, 8), ascii, latin1 }) {
+                    String str = String::FromUTF16(text);
+
+                    Assert::IsTrue(Equals(str.ToUpper(), IcuCaseMap(text, true)), L"ToUpper");
+                    Assert::IsTrue(Equals(str.ToLower(), IcuCaseMap(text, false)), L"ToLower");
+                }
+            }
+
+            DefaultLocale turkish("tr");
+            Assert::AreEqual((int)0x131, (int)String::FromUTF16(Units("I")).ToLower()[0]);
+            Assert::AreEqual((int)0x130, (int)String::FromUTF16(Units("i")).ToUpper()[0]);
+        }
+
+        TEST_METHOD(ConcatenationOwnsTemporaries)
+        {
+            // The temporaries die at the end of the statement; the auto
+            // variables must not refer to them afterwards.
+            auto line = "Host: " + Name(1) + "\r\n";
+            auto nested = (Name(2) + String(" = ")) + (Name(3) + ";");
+            String expected = String("Host: ") + Name(1) + String("\r\n");
+
+            Assert::IsTrue(String(line) == expected);
+            Assert::AreEqual(expected.Length(), line.Length());
+            Assert::AreEqual(expected.ToUTF8().c_str(), String(line.Data()).ToUTF8().c_str());
+            Assert::IsTrue(String(nested) == String(Name(2).ToUTF8() + " = " + Name(3).ToUTF8() + ";"));
+
+            // More operands than a concatenation holds collapse into a string.
+            String many = Name(0) + Name(1) + Name(2) + Name(3) + Name(4) + Name(5) + Name(6) + Name(7) + Name(8) + Name(9) + Name(10);
+            string reference;
+
+            for (size_t i = 0; i <= 10; i++) {
+                reference += Name(i).ToUTF8();
+            }
+
+            Assert::AreEqual(reference.c_str(), many.ToUTF8().c_str());
+
+            String appended("start");
+            appended += Name(4) + "|" + Name(5);
+            Assert::AreEqual(("start" + Name(4).ToUTF8() + "|" + Name(5).ToUTF8()).c_str(), appended.ToUTF8().c_str());
+        }
+
+        TEST_METHOD(CompactStringsMatchUtf16)
+        {
+            // Latin-1 heap strings store one byte per character; every
+            // operation has to give the same result as on the UTF-16 text,
+            // also when compact and UTF-16 strings are mixed.
+            static const char16_t alphabet[] = { 'a', 'b', ' ', 0xE9, 0xFF, 0x100 };
+            mt19937 random(3);
+
+            for (int iteration = 0; iteration < 3000; iteration++) {
+                size_t letters = random() % 3 ? 5 : 6;
+                u16string text, other;
+
+                for (size_t i = 0, length = random() % 60; i < length; i++) {
+                    text.push_back(alphabet[random() % letters]);
+                }
+
+                for (size_t i = 0, length = random() % 4; i < length; i++) {
+                    other.push_back(alphabet[random() % 6]);
+                }
+
+                String str = String::FromUTF16(text);
+                String otherStr = String::FromUTF16(other);
+                size_t offset = random() % (text.size() + 1);
+                size_t count = random() % (text.size() - offset + 1);
+                u16string reversed(text.rbegin(), text.rend());
+                u16string mapped = text;
+
+                replace(mapped.begin(), mapped.end(), (char16_t)'a', (char16_t)0x100);
+
+                Assert::AreEqual(text.size(), str.Length());
+                Assert::IsTrue(Equals(str.Substring(offset, count), text.substr(offset, count)), L"Substring");
+                Assert::IsTrue(Equals(str.Insert(offset, otherStr), u16string(text).insert(offset, other)), L"Insert");
+                Assert::IsTrue(Equals(str.Remove(offset, count), u16string(text).erase(offset, count)), L"Remove");
+                Assert::IsTrue(Equals(str.Reverse(), reversed), L"Reverse");
+                Assert::IsTrue(Equals(String(str + otherStr + str), text + other + text), L"Concatenation");
+                Assert::IsTrue(Equals(str.Replace((Char)'a', (Char)0x100), mapped), L"Replace");
+                Assert::AreEqual(text.compare(0, other.size(), other) == 0 && text.size() >= other.size(), str.StartsWith(otherStr), L"StartsWith");
+                // As in ICU, the empty string is not contained anywhere.
+                Assert::AreEqual(!other.empty() && text.find(other) != u16string::npos, str.Contains(otherStr), L"Contains");
+                Assert::AreEqual(Sign(text.compare(other)), Sign(str.Compare(otherStr)), L"Compare");
+                Assert::AreEqual(Sign(other.compare(text)), Sign(otherStr.Compare(str)), L"Compare reversed");
+                Assert::AreEqual(text == other, str == otherStr, L"Equality");
+
+                size_t first = text.find_first_not_of(' ');
+                size_t last = text.find_last_not_of(' ');
+                u16string trimmed = first == u16string::npos ? u16string() : text.substr(first, last - first + 1);
+                Assert::IsTrue(Equals(str.Trim(), trimmed), L"Trim");
+
+                if (!other.empty()) {
+                    u16string replaced;
+
+                    for (size_t i = 0; i < text.size();) {
+                        if (text.compare(i, other.size(), other) == 0) {
+                            replaced += Units("<>");
+                            i += other.size();
+                        } else {
+                            replaced.push_back(text[i++]);
+                        }
+                    }
+
+                    Assert::IsTrue(Equals(str.Replace(otherStr, String("<>")), replaced), L"Replace string");
+
+                    vector<String> parts = str.Split(otherStr);
+                    size_t start = 0, index = 0;
+
+                    for (size_t match; (match = text.find(other, start)) != u16string::npos; start = match + other.size()) {
+                        Assert::IsTrue(index < parts.size() && Equals(parts[index++], text.substr(start, match - start)), L"Split");
+                    }
+
+                    Assert::IsTrue(index + 1 == parts.size() && Equals(parts[index], text.substr(start)), L"Split rest");
+                }
+            }
+        }
+
+        TEST_METHOD(CompactCharacterAccess)
+        {
+            u16string text = Units("caf");
+            text.push_back(0xE9);
+            text += Units(" au lait, long enough for the heap");
+            const String str = String::FromUTF16(text);
+            const String copy = str;
+
+            // Iterating reads the Latin-1 bytes as they are.
+            Assert::IsTrue(u16string(str.begin(), str.end()) == text);
+            Assert::AreEqual((ptrdiff_t)text.size(), str.end() - str.begin());
+            Assert::IsTrue(find(str.begin(), str.end(), (Char)0xE9) == str.begin() + 3);
+            Assert::AreEqual((Char)0xE9, str.begin()[3]);
+
+            // References stay valid and are shared by copies.
+            const Char* ch = &str[3];
+            Assert::AreEqual((Char)0xE9, *ch);
+            Assert::IsTrue(ch == str.Data() + 3);
+            Assert::IsTrue(ch == &copy[3]);
+            Assert::IsTrue(u16string(str.Data(), str.Data() + str.Length()) == text);
+        }
+
+        TEST_METHOD(NonLatin1Characters)
+        {
+            u16string text = Units("prefix ");
+            text.push_back(0x0100);
+            text.push_back(0xD83D);
+            text.push_back(0xDE00);
+            text += Units(" suffix that is long");
+
+            String str = String::FromUTF16(text);
+            Assert::IsTrue(Equals(str, text));
+            Assert::IsTrue(Equals(str.Substring(7, 3), text.substr(7, 3)));
+            Assert::AreEqual((size_t)3, String::FromUTF16(text.substr(6, 3)).Length());
+            Assert::IsTrue(String::FromUTF8(str.ToUTF8()) == str);
+        }
+
+        TEST_METHOD(OutOfRange)
+        {
+            String str("a string that does not fit into the object");
+
+            Assert::ExpectException<out_of_range>([&] { str.Substring(str.Length() + 1); });
+            Assert::ExpectException<out_of_range>([&] { str.Substring(1, str.Length()); });
+            Assert::ExpectException<out_of_range>([&] { str[str.Length() + 1]; });
+            Assert::ExpectException<out_of_range>([&] { String(str, 2, str.Length()); });
+        }
+    };
+}
@@ -0,0 +1,228 @@
+#include "stdafx.h"
+#include <BlackWolf.Lupus.Core/Utf8String.h>
+#include <BlackWolf.Lupus.Core/Utf8View.h>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace std;
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace Lupus;
+
+namespace UnitTests
+{
+    // ASCII, two, three and four byte sequences, some differing only in case.
+    static const char* const sTokens[] = { "a", "b", "A", " ", "\xC3\xA9", "\xC3\x89", "\xE2\x82\xAC", "\xF0\x9F\x98\x80" };
+
+    // Random UTF-8 text of up to length bytes, so that multibyte sequences
+    // straddle the block boundaries of memchr and memcmp.
+    static string RandomUtf8(mt19937& random, size_t length, size_t tokens)
+    {
+        string result;
+
+        while (result.size() < length) {
+            result += sTokens[random() % tokens];
+        }
+
+        return result;
+    }
+
+    static int Sign(int value)
+    {
+        return (value > 0) - (value < 0);
+    }
+
+    static int Find(const string& text, const string& str, size_t offset)
+    {
+        size_t index = str.empty() ? string::npos : text.find(str, offset);
+        return index == string::npos ? -1 : (int)index;
+    }
+
+    static vector<string> Split(const string& text, const string& delimiter, StringSplitOption option)
+    {
+        vector<string> result;
+        size_t previous = 0;
+
+        for (size_t index; (index = text.find(delimiter, previous)) != string::npos; previous = index + delimiter.size()) {
+            if (option == StringSplitOption::None || index != previous) {
+                result.push_back(text.substr(previous, index - previous));
+            }
+        }
+
+        if (option == StringSplitOption::None || previous < text.size()) {
+            result.push_back(text.substr(previous));
+        }
+
+        return result;
+    }
+
+    static bool Equals(const vector<Utf8View>& parts, const vector<string>& expected)
+    {
+        if (parts.size() != expected.size()) {
+            return false;
+        }
+
+        for (size_t i = 0; i < parts.size(); i++) {
+            if (string(parts[i].Data(), parts[i].Length()) != expected[i]) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    TEST_CLASS(Utf8ViewTests)
+    {
+    public:
+
+        TEST_METHOD(SearchMatchesStdString)
+        {
+            mt19937 random(5);
+
+            for (int iteration = 0; iteration < 20000; iteration++) {
+                size_t tokens = 2 + random() % 7;
+                string text = RandomUtf8(random, random() % 100, tokens);
+                string str = RandomUtf8(random, 1 + random() % 6, tokens);
+
+                if (random() % 2 && str.size() <= text.size()) {
+                    text.replace(random() % (text.size() - str.size() + 1), str.size(), str);
+                    text = String::FromUTF8(text).ToUTF8();
+                }
+
+                Utf8View view(text);
+                size_t offset = random() % (text.size() + 1);
+                int index = view.IndexOf(Utf8View(str));
+
+                Assert::AreEqual(Find(text, str, 0), index, L"IndexOf");
+                Assert::AreEqual(Find(text, str, offset), view.IndexOf(Utf8View(str), offset), L"IndexOf offset");
+                Assert::AreEqual(str.size() > text.size() ? -1 : (int)text.rfind(str), view.LastIndexOf(Utf8View(str)), L"LastIndexOf");
+                Assert::AreEqual(Find(text, str.substr(0, 1), 0), view.IndexOf(str[0]), L"IndexOf char");
+                Assert::AreEqual(Find(text, str.substr(0, 1), offset), view.IndexOf(str[0], offset), L"IndexOf char offset");
+                Assert::AreEqual(text.compare(0, str.size(), str) == 0 && text.size() >= str.size(), view.StartsWith(Utf8View(str)), L"StartsWith");
+                Assert::AreEqual(text.size() >= str.size() && text.compare(text.size() - str.size(), str.size(), str) == 0, view.EndsWith(Utf8View(str)), L"EndsWith");
+
+                // A well-formed needle never matches inside a sequence.
+                Assert::IsTrue(index == -1 || ((uint8_t)text[index] & 0xC0) != 0x80, L"Boundary");
+            }
+        }
+
+        TEST_METHOD(SplitMatchesStdString)
+        {
+            mt19937 random(6);
+
+            for (int iteration = 0; iteration < 10000; iteration++) {
+                size_t tokens = 2 + random() % 7;
+                string text = RandomUtf8(random, random() % 100, tokens);
+                string delimiter = sTokens[random() % tokens];
+                Utf8View view(text);
+
+                Assert::IsTrue(Equals(view.Split(Utf8View(delimiter)), Split(text, delimiter, StringSplitOption::None)), L"Split");
+                Assert::IsTrue(Equals(view.Split(Utf8View(delimiter), StringSplitOption::RemoveEmptyEntries), Split(text, delimiter, StringSplitOption::RemoveEmptyEntries)), L"Split RemoveEmptyEntries");
+            }
+        }
+
+        TEST_METHOD(CompareMatchesString)
+        {
+            mt19937 random(7);
+
+            for (int iteration = 0; iteration < 20000; iteration++) {
+                size_t tokens = 2 + random() % 7;
+                string text = RandomUtf8(random, random() % 40, tokens);
+                string other = RandomUtf8(random, random() % 40, tokens);
+
+                if (random() % 4 == 0) {
+                    // A prefix of text, cut at a character boundary.
+                    size_t length = random() % (text.size() + 1);
+
+                    while (length < text.size() && ((uint8_t)text[length] & 0xC0) == 0x80) {
+                        length--;
+                    }
+
+                    other = text.substr(0, length);
+                }
+
+                Utf8View view(text);
+                String str = view.ToString();
+                String otherStr = Utf8View(other).ToString();
+
+                // Byte order of UTF-8 is code point order, which is UTF-16 order for these tokens.
+                Assert::AreEqual(Sign(text.compare(other)), view.Compare(Utf8View(other)), L"Compare");
+                Assert::AreEqual(Sign(str.Compare(otherStr)), view.Compare(Utf8View(other)), L"Compare String");
+                Assert::AreEqual(Sign(str.Compare(otherStr, StringCaseSensitivity::CaseInsensitive)), view.Compare(Utf8View(other), StringCaseSensitivity::CaseInsensitive), L"Compare case insensitive");
+                Assert::AreEqual(text == other, view == Utf8View(other), L"Equality");
+            }
+        }
+
+        TEST_METHOD(BlockBoundaries)
+        {
+            for (size_t prefix = 0; prefix < 70; prefix++) {
+                string text = string(prefix, 'a') + "\xE2\x82\xAC" + "\xC3\xA9" + string(prefix % 17, 'b');
+                Utf8View view(text);
+
+                Assert::AreEqual((int)prefix, view.IndexOf(Utf8View("\xE2\x82\xAC")));
+                Assert::AreEqual((int)prefix + 3, view.IndexOf(Utf8View("\xC3\xA9")));
+                Assert::AreEqual((int)prefix + 3, view.LastIndexOf(Utf8View("\xC3\xA9")));
+                Assert::AreEqual(-1, view.IndexOf(Utf8View("\xC3\x89")));
+                Assert::AreEqual((size_t)2, view.Split(Utf8View("\xE2\x82\xAC")).size());
+                Assert::AreEqual(prefix + 2 + prefix % 17, view.ToString().Length());
+                Assert::IsTrue(view.Substring(prefix, 5).ToString() == String::FromUTF8("\xE2\x82\xAC\xC3\xA9"));
+            }
+        }
+
+        TEST_METHOD(TrimAndParse)
+        {
+            Utf8View view(" \t 42 \r\n");
+            int value = 0;
+            double number = 0;
+
+            Assert::IsTrue(view.Trim() == Utf8View("42"));
+            Assert::IsTrue(view.Trim().TryParse(value));
+            Assert::AreEqual(42, value);
+            Assert::IsFalse(view.TryParse(value));
+            Assert::IsTrue(Utf8View("0x1F").TryParse(value, IntegerBase::Hexadecimal));
+            Assert::AreEqual(31, value);
+            Assert::IsTrue(Utf8View("-2.5").TryParse(number));
+            Assert::AreEqual(-2.5, number);
+            Assert::IsFalse(Utf8View("99999999999").TryParse(value));
+        }
+    };
+
+    TEST_CLASS(Utf8StringTests)
+    {
+    public:
+
+        TEST_METHOD(RoundTripsThroughString)
+        {
+            mt19937 random(8);
+
+            for (int iteration = 0; iteration < 2000; iteration++) {
+                string text = RandomUtf8(random, random() % 80, 8);
+                String str = String::FromUTF8(text);
+                Utf8String utf8(str);
+
+                Assert::IsTrue(utf8.ToStdString() == text);
+                Assert::IsTrue(utf8.ToString() == str);
+                Assert::AreEqual(text.size(), utf8.Length());
+                Assert::AreEqual('\0', utf8.Data()[utf8.Length()]);
+            }
+        }
+
+        TEST_METHOD(AppendAndCompare)
+        {
+            Utf8String str("caf\xC3\xA9");
+            Utf8String other(string(" au lait"));
+
+            Assert::IsTrue(str + other == Utf8String("caf\xC3\xA9 au lait"));
+            Assert::IsTrue(other < str);
+            Assert::IsTrue(Utf8String("abc", 2) == Utf8String("ab"));
+
+            str += other;
+            str.Append("!", 1);
+            Assert::IsTrue(str.ToString() == String::FromUTF8("caf\xC3\xA9 au lait!"));
+            Assert::AreEqual((size_t)14, str.Length());
+
+            str.Clear();
+            Assert::IsTrue(str.IsEmpty());
+        }
+    };
+}
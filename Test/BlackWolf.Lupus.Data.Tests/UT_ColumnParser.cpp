@@ -0,0 +1,168 @@
+#include "stdafx.h"
+#include <BlackWolf.Lupus.Core/Float.h>
+#include <BlackWolf.Lupus.Core/Integer.h>
+#include <BlackWolf.Lupus.Data/ColumnParser.h>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace std;
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace Lupus;
+using namespace Lupus::Data;
+
+namespace UnitTests
+{
+    // Large enough for ColumnParser to split the column across threads,
+    // and not a multiple of eight, so that the last validity byte is partial.
+    static const size_t sRowCount = 50003;
+
+    // A column of cells in the form PQgetvalue hands them out. Null cells
+    // have a null pointer and are written as empty cells into the
+    // delimited buffer.
+    struct TextColumn
+    {
+        vector<string> Texts;
+        vector<bool> Nulls;
+        vector<const char*> Cells;
+        vector<size_t> Lengths;
+        string Buffer;
+    };
+
+    static string RandomCell(mt19937& random, bool fractional)
+    {
+        static const char* const sMalformed[] = { "-", "+", "12a", " 7", "7 ", "1-2", "0x1F", "--3", ".", "1.2.3", "e5", "1e", "abc" };
+        string cell;
+
+        switch (random() % 8) {
+            case 0:
+                return sMalformed[random() % (sizeof(sMalformed) / sizeof(sMalformed[0]))];
+            case 1:
+                // Too large for int64_t, and for double with an exponent.
+                cell = "9223372036854775808" + string(random() % 4, '9');
+                return fractional ? cell + "e400" : cell;
+            case 2:
+                return random() % 2 ? "-9223372036854775808" : "9223372036854775807";
+            default:
+                cell = (random() % 3 == 0 ? "-" : "") + to_string(random() % (1 + (1ULL << (random() % 60))));
+
+                if (fractional && random() % 2) {
+                    cell += "." + to_string(random() % 100000);
+                }
+
+                if (fractional && random() % 5 == 0) {
+                    cell += "e" + to_string((int)(random() % 40) - 20);
+                }
+
+                return cell;
+        }
+    }
+
+    static TextColumn MakeColumn(bool fractional)
+    {
+        mt19937 random(fractional ? 22 : 21);
+        TextColumn column;
+
+        for (size_t i = 0; i < sRowCount; i++) {
+            bool null = random() % 16 == 0;
+            bool empty = !null && random() % 16 == 0;
+
+            column.Texts.push_back(null || empty ? string() : RandomCell(random, fractional));
+            column.Nulls.push_back(null);
+            column.Buffer += column.Texts.back();
+            column.Buffer += i + 1 < sRowCount ? "|" : "";
+        }
+
+        for (size_t i = 0; i < sRowCount; i++) {
+            column.Cells.push_back(column.Nulls[i] ? nullptr : column.Texts[i].c_str());
+            column.Lengths.push_back(column.Texts[i].size());
+        }
+
+        return column;
+    }
+
+    // The result of FromChars for a cell that must hold the number alone;
+    // invalid cells hold 0.
+    static bool Expected(const string& text, int64_t& value)
+    {
+        long long result = 0;
+        bool valid = !text.empty() && Integer::FromChars(text.data(), text.data() + text.size(), result) == text.size();
+
+        value = valid ? result : 0;
+        return valid;
+    }
+
+    static bool Expected(const string& text, double& value)
+    {
+        double result = 0;
+        bool valid = !text.empty() && Float::FromChars(text.data(), text.data() + text.size(), result) == text.size();
+
+        value = valid ? result : 0;
+        return valid;
+    }
+
+    template <typename T>
+    static void AssertColumn(const TextColumn& column, const NumericColumn<T>& result, bool delimited)
+    {
+        size_t valid = 0;
+
+        Assert::AreEqual(sRowCount, result.Values.size());
+        Assert::AreEqual((sRowCount + 7) / 8, result.Validity.size());
+        // Bits past the last row stay clear.
+        Assert::AreEqual(0, result.Validity.back() >> (sRowCount % 8));
+
+        for (size_t i = 0; i < sRowCount; i++) {
+            T value;
+            bool expected = Expected(column.Texts[i], value);
+
+            if (expected != result.IsValid(i) || value != result.Values[i]) {
+                wstring message = L"Row " + to_wstring(i) + L": " + wstring(column.Texts[i].begin(), column.Texts[i].end());
+                Assert::Fail(message.c_str());
+            }
+
+            valid += expected;
+            Assert::IsFalse(column.Nulls[i] && !delimited && result.IsValid(i), L"Null");
+        }
+
+        // The column mixes both kinds of cells.
+        Assert::IsTrue(valid > sRowCount / 2 && valid < sRowCount);
+    }
+
+    TEST_CLASS(ColumnParserTests)
+    {
+    public:
+
+        TEST_METHOD(ParseIntegerMatchesFromChars)
+        {
+            TextColumn column = MakeColumn(false);
+
+            AssertColumn(column, ColumnParser::ParseInteger(column.Cells.data(), column.Lengths.data(), sRowCount), false);
+            AssertColumn(column, ColumnParser::ParseInteger(column.Buffer.data(), column.Buffer.size(), '|'), true);
+        }
+
+        TEST_METHOD(ParseDoubleMatchesFromChars)
+        {
+            TextColumn column = MakeColumn(true);
+
+            AssertColumn(column, ColumnParser::ParseDouble(column.Cells.data(), column.Lengths.data(), sRowCount), false);
+            AssertColumn(column, ColumnParser::ParseDouble(column.Buffer.data(), column.Buffer.size(), '|'), true);
+        }
+
+        TEST_METHOD(DelimitedEdges)
+        {
+            auto empty = ColumnParser::ParseInteger("", 0, ',');
+            auto edges = ColumnParser::ParseInteger(",1,,-2,", 7, ',');
+
+            Assert::AreEqual((size_t)1, empty.Values.size());
+            Assert::IsFalse(empty.IsValid(0));
+            Assert::AreEqual((size_t)5, edges.Values.size());
+            Assert::IsFalse(edges.IsValid(0));
+            Assert::IsTrue(edges.IsValid(1));
+            Assert::AreEqual((int64_t)1, edges.Values[1]);
+            Assert::IsFalse(edges.IsValid(2));
+            Assert::AreEqual((int64_t)-2, edges.Values[3]);
+            Assert::IsFalse(edges.IsValid(4));
+        }
+    };
+}